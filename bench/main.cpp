@@ -0,0 +1,445 @@
+/**
+ * @file main.cpp
+ * @brief Micro-benchmarks for the parse, serialize and tap hot paths of the open-loop library.
+ * @details Each benchmark is repeated until it has run for at least `--min-time-ms` milliseconds, then
+ *          reports the mean time per operation, the number of heap allocations per operation, and the
+ *          throughput in card bytes per second. Results are printed as a table and, with `--json <path>`,
+ *          written as a JSON document that release pipelines can compare against a stored baseline.
+ *
+ *          Usage: `open_loop_bench [--filter <substring>] [--min-time-ms <ms>] [--json <path>]`
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "open_loop_service.h"
+#include "open_loop_batch.h"
+#include "open_loop_card_cache.h"
+#include "open_loop_deny_list.h"
+#include "open_loop_diff.h"
+#include "open_loop_format.h"
+#include "open_loop_journal.h"
+#include "open_loop_session.h"
+#include "open_loop_tap.h"
+
+using namespace open_loop;
+
+// --- Allocation Counting ---
+//
+// Replacing the global allocation functions lets every benchmark report how many heap allocations a
+// single operation performs. Over-aligned allocations use the library's default aligned operators and
+// are not counted; nothing in the library requests them.
+
+static std::atomic<uint64_t> allocation_count{ 0 };
+
+void* operator new(const std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size != 0 ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](const std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size != 0 ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+/**
+ * @brief Prevents the compiler from discarding a value computed by a benchmark body.
+ */
+template <typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+/**
+ * @struct bench_result
+ * @brief The measurements of one benchmark.
+ */
+struct bench_result {
+    std::string name;
+    uint64_t iterations{ 0 };
+    double ns_per_op{ 0 };
+    double allocations_per_op{ 0 };
+    //! Card bytes processed per operation, used for the throughput column. Zero if not meaningful.
+    size_t bytes_per_op{ 0 };
+
+    [[nodiscard]] double mb_per_second() const {
+        return (bytes_per_op == 0 || ns_per_op == 0) ? 0.0 : (static_cast<double>(bytes_per_op) * 1e3) / ns_per_op;
+    }
+};
+
+/**
+ * @class bench_runner
+ * @brief Runs benchmark bodies with automatic iteration calibration and collects their results.
+ */
+class bench_runner {
+public:
+    bench_runner(std::string filter, const std::chrono::milliseconds min_time)
+        : filter_(std::move(filter)), min_time_(min_time) {}
+
+    /**
+     * @brief Measures `body`, which performs one operation per call.
+     * @param name The benchmark name, in `area/operation` form.
+     * @param bytes_per_op The number of card bytes one operation processes.
+     * @param body The operation to measure.
+     */
+    template <typename Body>
+    void run(const std::string& name, const size_t bytes_per_op, Body&& body) {
+        if (!filter_.empty() && name.find(filter_) == std::string::npos) return;
+
+        // Warm up caches and branch predictors, then grow the batch until one batch takes min_time.
+        for (int i = 0; i < 1000; ++i) body();
+        uint64_t iterations = 1000;
+        for (;;) {
+            const uint64_t allocations_before = allocation_count.load(std::memory_order_relaxed);
+            const auto start = std::chrono::steady_clock::now();
+            for (uint64_t i = 0; i < iterations; ++i) body();
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            const uint64_t allocations = allocation_count.load(std::memory_order_relaxed) - allocations_before;
+
+            if (elapsed >= min_time_ || iterations >= (uint64_t{ 1 } << 34)) {
+                bench_result r;
+                r.name = name;
+                r.iterations = iterations;
+                r.ns_per_op = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / static_cast<double>(iterations);
+                r.allocations_per_op = static_cast<double>(allocations) / static_cast<double>(iterations);
+                r.bytes_per_op = bytes_per_op;
+                print_row(r);
+                results_.push_back(r);
+                return;
+            }
+            iterations *= 4;
+        }
+    }
+
+    [[nodiscard]] const std::vector<bench_result>& results() const noexcept { return results_; }
+
+    static void print_header() {
+        std::cout << std::left << std::setw(40) << "BENCHMARK" << std::right
+                  << std::setw(14) << "NS/OP" << std::setw(14) << "ALLOCS/OP" << std::setw(14) << "MB/S"
+                  << std::setw(16) << "ITERATIONS" << std::endl;
+        std::cout << std::string(98, '-') << std::endl;
+    }
+
+    /**
+     * @brief Writes every result as a JSON document.
+     * @details The format is `{"benchmarks": [{"name", "iterations", "ns_per_op", "allocations_per_op",
+     *          "bytes_per_op", "mb_per_second"}, ...]}`.
+     */
+    void write_json(std::ostream& os) const {
+        os << "{\n  \"library\": \"open_loop\",\n  \"batch_kernel\": \"" << batch_kernel_name() << "\",\n  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results_.size(); ++i) {
+            const bench_result& r = results_[i];
+            os << "    {\"name\": \"" << r.name << "\", \"iterations\": " << r.iterations
+               << std::fixed << std::setprecision(3)
+               << ", \"ns_per_op\": " << r.ns_per_op
+               << ", \"allocations_per_op\": " << r.allocations_per_op
+               << ", \"bytes_per_op\": " << r.bytes_per_op
+               << ", \"mb_per_second\": " << r.mb_per_second() << "}"
+               << (i + 1 < results_.size() ? ",\n" : "\n");
+        }
+        os << "  ]\n}\n";
+    }
+
+private:
+    static void print_row(const bench_result& r) {
+        std::cout << std::left << std::setw(40) << r.name << std::right << std::fixed
+                  << std::setw(14) << std::setprecision(2) << r.ns_per_op
+                  << std::setw(14) << std::setprecision(2) << r.allocations_per_op
+                  << std::setw(14) << std::setprecision(1) << r.mb_per_second()
+                  << std::setw(16) << r.iterations << std::endl;
+    }
+
+    std::string filter_;
+    std::chrono::milliseconds min_time_;
+    std::vector<bench_result> results_;
+};
+
+// --- Benchmark Fixtures ---
+
+constexpr std::time_t EFFECTIVE_DATE = 28399680;
+
+//! Builds a fully populated CSA, matching the golden data used by the tests.
+csa::container make_csa() {
+    csa::container c;
+    c.set_card_effective_date(EFFECTIVE_DATE);
+    c.get_general().set_version(1, 2, 3);
+    csa::terminal term;
+    term.set_acquirer_id(10); term.set_operator_id(1000); term.set_terminal_id("ABCDEF");
+    c.get_validation().set_terminal_info(term);
+    c.get_validation().set_date_and_time(1735689600000ULL);
+    c.get_validation().set_fare_amount(1500);
+    for (uint16_t i = 0; i < csa::history::LOG_COUNT; ++i) {
+        csa::log entry;
+        entry.set_card_effective_date(EFFECTIVE_DATE);
+        entry.set_terminal_info(term);
+        entry.set_date_and_time(1735603200000ULL + (i * 60000ULL));
+        entry.set_txn_sq_no(101 + i);
+        entry.set_card_balance(20000 - (i * 100));
+        c.get_history().add_log(entry);
+    }
+    return c;
+}
+
+//! Builds an OSA with both trip passes populated.
+osa::container make_osa() {
+    osa::container c;
+    c.set_card_effective_date(EFFECTIVE_DATE);
+    c.get_general().set_version(2, 0, 1);
+    c.get_general().set_phone_number("9876543210");
+    for (size_t i = 0; i < osa::container::NUM_TRIP_PASSES; ++i) {
+        c.get_trip_pass(i).set_trips_allotted(40);
+        c.get_trip_pass(i).set_remaining_trips(12);
+        c.get_trip_pass(i).set_pass_expiry(15552000000ULL);
+    }
+    return c;
+}
+
+void register_benchmarks(bench_runner& runner) {
+    const csa::container csa_source = make_csa();
+    const std::array<uint8_t, csa::container::TOTAL_SIZE> csa_image = csa_source.to_array();
+    const osa::container osa_source = make_osa();
+    const std::array<uint8_t, osa::container::BLOCK_SIZE> osa_image = osa_source.to_array();
+
+    // --- CSA Container ---
+
+    csa::container csa_target;
+    csa_target.set_card_effective_date(EFFECTIVE_DATE);
+    runner.run("csa/container_parse", csa::container::TOTAL_SIZE, [&] {
+        csa_target.parse(csa_image.data(), csa_image.size());
+        do_not_optimize(csa_target);
+    });
+    runner.run("csa/container_to_bytes", csa::container::TOTAL_SIZE, [&] {
+        const std::vector<uint8_t> bytes = csa_source.to_bytes();
+        do_not_optimize(bytes.data());
+    });
+    std::array<uint8_t, csa::container::TOTAL_SIZE> csa_out{};
+    runner.run("csa/container_serialize_into", csa::container::TOTAL_SIZE, [&] {
+        csa_source.serialize_into(csa_out.data());
+        do_not_optimize(csa_out);
+    });
+    runner.run("csa/view_latest_balance", csa::container::TOTAL_SIZE, [&] {
+        const csa::view card(csa_image.data(), csa_image.size(), EFFECTIVE_DATE);
+        do_not_optimize(card.get_latest_card_balance());
+    });
+
+    // --- CSA Blocks ---
+
+    csa::history history = csa_source.get_history();
+    const csa::log new_log = csa_source.get_history().get_log(0);
+    runner.run("csa/history_add_log", csa::log::DATA_SIZE, [&] {
+        history.add_log(new_log);
+        do_not_optimize(history);
+    });
+    std::array<uint8_t, csa::container::TOTAL_SIZE> raw_card = csa_image;
+    std::array<uint8_t, csa::log::DATA_SIZE> raw_log{};
+    new_log.serialize_into(raw_log.data());
+    runner.run("csa/history_push_log_into_raw", csa::log::DATA_SIZE, [&] {
+        csa::history::push_log_into(raw_card.data() + csa::container::HISTORY_OFFSET, raw_log.data());
+        do_not_optimize(raw_card);
+    });
+    csa::terminal terminal;
+    runner.run("csa/terminal_set_terminal_id", 0, [&] {
+        terminal.set_terminal_id("A1B2C3");
+        do_not_optimize(terminal);
+    });
+
+    // --- OSA ---
+
+    osa::general general = osa_source.get_general();
+    runner.run("osa/general_set_phone_number", 0, [&] {
+        general.set_phone_number("9876543210");
+        do_not_optimize(general);
+    });
+    runner.run("osa/general_get_phone_number", 0, [&] {
+        const std::string number = general.get_phone_number();
+        do_not_optimize(number.data());
+    });
+    osa::container osa_target;
+    osa_target.set_card_effective_date(EFFECTIVE_DATE);
+    runner.run("osa/container_parse", osa::container::BLOCK_SIZE, [&] {
+        osa_target.parse(osa_image.data(), osa_image.size());
+        do_not_optimize(osa_target);
+    });
+
+    // --- Full Tap (read-modify-write) ---
+
+    // One gate tap: parse the card, record an entry validation and a debit log, then write back only
+    // the changed bytes. The buffer is reset each time so every iteration performs the same writes.
+    std::array<uint8_t, csa::container::TOTAL_SIZE> card = csa_image;
+    csa::container tap;
+    tap.set_card_effective_date(EFFECTIVE_DATE);
+    csa::log debit = new_log;
+    runner.run("tap/csa_read_modify_write", csa::container::TOTAL_SIZE, [&] {
+        card = csa_image;
+        tap.parse(card.data(), card.size());
+        tap.get_validation().set_txn_status(txn_status::ENTRY);
+        debit.set_card_balance(tap.get_history().get_log(0).get_card_balance() - 1500);
+        tap.get_history().add_log(debit);
+        const dirty_ranges dirty = tap.patch_into(card.data());
+        do_not_optimize(dirty);
+    });
+
+    // The same tap through the raw-buffer engine.
+    const csa::tap_engine engine(csa_source.get_validation().get_terminal_info(), 7);
+    const csa::tap_request request{ EFFECTIVE_DATE, 1735700000000ULL, 1500, txn_status::EXIT };
+    runner.run("tap/csa_tap_engine", csa::container::TOTAL_SIZE, [&] {
+        card = csa_image;
+        const csa::tap_result result = engine.apply(card.data(), card.size(), request);
+        do_not_optimize(result);
+    });
+
+    // The same tap on a decoded container through a gate session: parse, record, patch.
+    const csa::gate_context gate(csa_source.get_validation().get_terminal_info(), 7);
+    const csa::card_session session = gate.open(EFFECTIVE_DATE);
+    runner.run("tap/csa_session_record_tap", csa::container::TOTAL_SIZE, [&] {
+        card = csa_image;
+        (void)session.parse(tap, card.data(), card.size());
+        const csa::tap_result result = session.record_tap(tap, request.time_in_milliseconds, request.fare, request.status);
+        const dirty_ranges dirty = tap.patch_into(card.data());
+        do_not_optimize(result);
+        do_not_optimize(dirty);
+    });
+
+    // --- Bulk Decoding ---
+
+    constexpr size_t BATCH_IMAGES = 1024;
+    std::vector<uint8_t> images;
+    images.reserve(BATCH_IMAGES * csa::container::TOTAL_SIZE);
+    for (size_t i = 0; i < BATCH_IMAGES; ++i) images.insert(images.end(), csa_image.begin(), csa_image.end());
+    csa::batch batch;
+    runner.run("batch/csa_decode_1024", BATCH_IMAGES * csa::container::TOTAL_SIZE, [&] {
+        batch.decode(images.data(), images.size());
+        do_not_optimize(batch.get_log_card_balance().data());
+    });
+
+    // --- Card Cache ---
+
+    csa::card_cache card_cache(65536);
+    const csa::compact_card cached = csa::compact_card::from_container(csa_source);
+    for (uint64_t token = 0; token < 65536; ++token) (void)card_cache.assign(token, cached);
+    uint64_t cache_token = 0;
+    runner.run("cache/find_hit_64k", sizeof(csa::compact_card), [&] {
+        cache_token = (cache_token + 7919) & 0xFFFF;
+        csa::compact_card state;
+        do_not_optimize(card_cache.find(cache_token, state));
+        do_not_optimize(state);
+    });
+    runner.run("cache/compare_and_swap_64k", sizeof(csa::compact_card), [&] {
+        cache_token = (cache_token + 7919) & 0xFFFF;
+        do_not_optimize(card_cache.compare_and_swap(cache_token, csa::card_cache::sequence_of(cached), cached));
+    });
+
+    // --- Journal ---
+
+    const std::string journal_path = (std::filesystem::temp_directory_path() / "open_loop_bench.olj").string();
+    std::filesystem::remove(journal_path);
+    {
+        journal::writer journal_out(journal_path, 256, false);
+        const csa::terminal& journal_terminal = csa_source.get_validation().get_terminal_info();
+        uint64_t journal_time = 0;
+        runner.run("journal/append_csa_nosync", journal::format::RECORD_SIZE, [&] {
+            journal_out.append(csa_source, ++journal_time, journal_terminal);
+        });
+    }
+    std::filesystem::remove(journal_path);
+
+    // --- Audit Formatting ---
+
+    std::ostringstream dump;
+    runner.run("format/csa_container_ostream", csa::container::TOTAL_SIZE, [&] {
+        dump.str(std::string());
+        dump << csa_source;
+        do_not_optimize(dump.tellp());
+    });
+    char text_line[format::max_text_size<csa::container>];
+    runner.run("format/csa_container_text", csa::container::TOTAL_SIZE, [&] {
+        do_not_optimize(format::format_to(text_line, csa_source));
+    });
+    char json_line[format::max_json_size<csa::container>];
+    runner.run("format/csa_container_json", csa::container::TOTAL_SIZE, [&] {
+        do_not_optimize(format::format_json_to(json_line, csa_source));
+    });
+
+    // --- Image Diff ---
+
+    csa::container csa_advanced = csa_source;
+    csa_advanced.get_history().add_log(csa_source.get_history().get_log(0));
+    const std::array<uint8_t, csa::container::TOTAL_SIZE> csa_uploaded = csa_advanced.to_array();
+    runner.run("diff/csa_image_advanced", csa::container::TOTAL_SIZE, [&] {
+        do_not_optimize(csa::diff(csa_image.data(), csa_uploaded.data()).shift);
+    });
+
+    // --- Deny List ---
+
+    constexpr uint64_t DENIED_TOKENS = 1000000;
+    deny::builder hot_cards;
+    for (uint64_t i = 0; i < DENIED_TOKENS; ++i) hot_cards.add_card(i * 0x9E3779B97F4A7C15ULL);
+    const deny::snapshot deny_list = deny::snapshot::from_bytes(hot_cards.build(1));
+    uint64_t probe = 0;
+    runner.run("deny/contains_card_hit_1m", 0, [&] {
+        probe = (probe + 7919) % DENIED_TOKENS;
+        do_not_optimize(deny_list.contains_card(probe * 0x9E3779B97F4A7C15ULL));
+    });
+    runner.run("deny/contains_card_miss_1m", 0, [&] {
+        probe = (probe + 7919) % DENIED_TOKENS;
+        do_not_optimize(deny_list.contains_card(probe * 0x9E3779B97F4A7C15ULL + 1));
+    });
+    runner.run("deny/check_csa_view", csa::container::TOTAL_SIZE, [&] {
+        probe = (probe + 7919) % DENIED_TOKENS;
+        do_not_optimize(deny_list.check(csa::view(csa_image.data(), csa_image.size(), EFFECTIVE_DATE), probe + 1));
+    });
+}
+
+int main(const int argc, char** argv) {
+    std::string filter;
+    std::string json_path;
+    long min_time_ms = 200;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) filter = argv[++i];
+        else if (arg == "--json" && i + 1 < argc) json_path = argv[++i];
+        else if (arg == "--min-time-ms" && i + 1 < argc) min_time_ms = std::strtol(argv[++i], nullptr, 10);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--filter <substring>] [--min-time-ms <ms>] [--json <path>]" << std::endl;
+            return 2;
+        }
+    }
+
+    bench_runner runner(filter, std::chrono::milliseconds(min_time_ms));
+    std::cout << "open_loop micro-benchmarks (batch kernel: " << batch_kernel_name() << ")" << std::endl << std::endl;
+    bench_runner::print_header();
+    register_benchmarks(runner);
+
+    if (!json_path.empty()) {
+        std::ofstream out(json_path);
+        if (!out) {
+            std::cerr << "Unable to write " << json_path << std::endl;
+            return 1;
+        }
+        runner.write_json(out);
+        std::cout << std::endl << "Results written to " << json_path << std::endl;
+    }
+    return 0;
+}
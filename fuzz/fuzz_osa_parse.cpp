@@ -0,0 +1,41 @@
+/**
+ * @file fuzz_osa_parse.cpp
+ * @brief libFuzzer entry point for `osa::container::parse()` and the round-trip properties.
+ * @details Any input must either be rejected with `status_code::invalid_size` (and `std::invalid_argument`
+ *          from the throwing `parse()`), or satisfy every property in `round_trip_properties.h`.
+ *          Build with `-DOPEN_LOOP_FUZZ_LIBFUZZER=ON` under Clang, or run the standalone build on a corpus.
+ *
+ * @author Govind Yadav
+ * @version 1.1
+ * @date 2025-09-08
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include "round_trip_properties.h"
+
+using namespace open_loop;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, const size_t size) {
+    osa::container card;
+    card.set_card_effective_date(fuzz::EFFECTIVE_DATE);
+    if (size != osa::container::BLOCK_SIZE) {
+        if (card.try_parse(data, size) != status_code::invalid_size) std::abort();
+        try {
+            card.parse(data, size);
+        } catch (const std::invalid_argument&) {
+            return 0;
+        }
+        std::abort();
+    }
+
+    osa::batch columns;
+    columns.decode(data, size);
+    if (const char* property = fuzz::check_osa_image(data, columns, 0)) {
+        std::fprintf(stderr, "round-trip property failed: %s\n", property);
+        std::abort();
+    }
+    return 0;
+}
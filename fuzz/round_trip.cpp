@@ -0,0 +1,183 @@
+/**
+ * @file round_trip.cpp
+ * @brief Multi-threaded property harness: streams randomized and mutated 96-byte images through every
+ *        decoder and encoder and reports mismatches and throughput.
+ * @details Each worker generates its own images from a per-thread seed, so a run is reproducible from
+ *          `--seed` and `--threads`. Three generators are interleaved:
+ *          - uniformly random bytes, which exercise the non-canonical bits;
+ *          - canonical images with one to four flipped bits, which stay close to real cards;
+ *          - random images whose trailing log slots are zeroed, which exercise partial histories.
+ *
+ *          Every image is checked both as a CSA and as an OSA. The first failing image is printed
+ *          in hex together with the property it broke.
+ *
+ * @usage
+ * @code
+ *     open_loop_round_trip --images 300000000 --threads 16 --seed 7
+ * @endcode
+ *
+ * @author Govind Yadav
+ * @version 1.1
+ * @date 2025-09-08
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "round_trip_properties.h"
+
+using namespace open_loop;
+
+namespace {
+
+    constexpr size_t IMAGE_SIZE = csa::container::TOTAL_SIZE;
+    static_assert(IMAGE_SIZE == osa::container::BLOCK_SIZE, "The harness feeds the same bytes to both areas.");
+
+    //! Images generated and decoded per batch kernel call.
+    constexpr size_t CHUNK_IMAGES = 1024;
+
+    //! A small, fast, seedable generator (SplitMix64); quality is ample for test input.
+    class splitmix64 {
+    public:
+        explicit splitmix64(const uint64_t seed) noexcept : state_(seed) {}
+
+        uint64_t next() noexcept {
+            uint64_t z = (state_ += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+    private:
+        uint64_t state_;
+    };
+
+    void fill_random(splitmix64& rng, uint8_t* image) {
+        for (size_t i = 0; i < IMAGE_SIZE; i += 8) {
+            const uint64_t word = rng.next();
+            std::memcpy(image + i, &word, 8);
+        }
+    }
+
+    //! Writes the next image of the interleaved generators into `image`.
+    void generate(splitmix64& rng, const uint64_t sequence, uint8_t* image) {
+        fill_random(rng, image);
+        switch (sequence % 3) {
+            case 0: return;
+            case 1: {
+                csa::container card;
+                card.set_card_effective_date(fuzz::EFFECTIVE_DATE);
+                if (card.try_parse(image, IMAGE_SIZE) == status_code::ok) card.serialize_into(image);
+                const uint64_t bits = rng.next();
+                for (uint64_t flip = 0; flip <= (bits & 3); ++flip) {
+                    const uint64_t bit = (bits >> (8 + 10 * flip)) % (IMAGE_SIZE * 8);
+                    image[bit / 8] ^= static_cast<uint8_t>(1u << (bit % 8));
+                }
+                return;
+            }
+            default: {
+                const size_t kept = rng.next() % (csa::history::LOG_COUNT + 1);
+                std::memset(image + csa::container::HISTORY_OFFSET + (kept * csa::history::LOG_SIZE_BYTES), 0,
+                            (csa::history::LOG_COUNT - kept) * csa::history::LOG_SIZE_BYTES);
+                return;
+            }
+        }
+    }
+
+    struct options {
+        uint64_t images = 10000000;
+        unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+        uint64_t seed = 1;
+    };
+
+    bool parse_options(const int argc, char** argv, options& out) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (i + 1 >= argc) return false;
+            const char* value = argv[++i];
+            if (arg == "--images") out.images = std::strtoull(value, nullptr, 10);
+            else if (arg == "--threads") out.threads = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+            else if (arg == "--seed") out.seed = std::strtoull(value, nullptr, 10);
+            else return false;
+        }
+        return out.threads > 0;
+    }
+
+    struct first_failure {
+        std::mutex mutex;
+        const char* property = nullptr;
+        std::array<uint8_t, IMAGE_SIZE> image{};
+    };
+
+}
+
+int main(const int argc, char** argv) {
+    options opts;
+    if (!parse_options(argc, argv, opts)) {
+        std::cerr << "usage: " << argv[0] << " [--images N] [--threads T] [--seed S]" << std::endl;
+        return 2;
+    }
+
+    std::atomic<uint64_t> checked{ 0 };
+    std::atomic<uint64_t> mismatches{ 0 };
+    first_failure failure;
+
+    const auto worker = [&](const unsigned id) {
+        splitmix64 rng(opts.seed * 0x100000001B3ULL + id);
+        std::vector<uint8_t> images(CHUNK_IMAGES * IMAGE_SIZE);
+        csa::batch csa_columns;
+        osa::batch osa_columns;
+        // Images are dealt to workers in chunks, round-robin, so the total is exact for any thread count.
+        for (uint64_t first = static_cast<uint64_t>(id) * CHUNK_IMAGES; first < opts.images; first += static_cast<uint64_t>(opts.threads) * CHUNK_IMAGES) {
+            const size_t count = static_cast<size_t>(std::min<uint64_t>(CHUNK_IMAGES, opts.images - first));
+            for (size_t i = 0; i < count; ++i) generate(rng, first + i, images.data() + (i * IMAGE_SIZE));
+            csa_columns.decode(images.data(), count * IMAGE_SIZE);
+            osa_columns.decode(images.data(), count * IMAGE_SIZE);
+
+            uint64_t failed = 0;
+            for (size_t i = 0; i < count; ++i) {
+                const uint8_t* image = images.data() + (i * IMAGE_SIZE);
+                const char* property = fuzz::check_csa_image(image, csa_columns, i);
+                if (property == nullptr) property = fuzz::check_osa_image(image, osa_columns, i);
+                if (property == nullptr) continue;
+                ++failed;
+                const std::lock_guard<std::mutex> lock(failure.mutex);
+                if (failure.property == nullptr) {
+                    failure.property = property;
+                    std::copy_n(image, IMAGE_SIZE, failure.image.begin());
+                }
+            }
+            checked.fetch_add(count, std::memory_order_relaxed);
+            mismatches.fetch_add(failed, std::memory_order_relaxed);
+        }
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    threads.reserve(opts.threads);
+    for (unsigned id = 0; id < opts.threads; ++id) threads.emplace_back(worker, id);
+    for (std::thread& thread : threads) thread.join();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "images     : " << checked.load() << " (each checked as CSA and OSA)" << std::endl
+              << "threads    : " << opts.threads << ", seed " << opts.seed << std::endl
+              << "mismatches : " << mismatches.load() << std::endl
+              << "throughput : " << std::fixed << std::setprecision(0) << (seconds > 0 ? static_cast<double>(checked.load()) / seconds : 0.0)
+              << " images/s (" << std::setprecision(2) << seconds << " s)" << std::endl;
+    if (failure.property == nullptr) return 0;
+
+    std::cout << "first failure: " << failure.property << std::endl << "  ";
+    for (const uint8_t byte : failure.image) std::cout << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte);
+    std::cout << std::dec << std::endl;
+    return 1;
+}
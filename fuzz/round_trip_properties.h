@@ -0,0 +1,279 @@
+/**
+ * @file round_trip_properties.h
+ * @brief The properties every 96-byte image must satisfy, shared by the stress harness and the fuzz targets.
+ * @details The object model (`csa::container`, `osa::container`) is the reference implementation. Each check
+ *          parses one image with it and then holds every other decoder and encoder in the library to the
+ *          same answer:
+ *          - serialization: `to_array()`, `to_bytes()` and `patch_into()` agree, and re-parsing the output is
+ *            a fixed point (arbitrary input may carry non-canonical bits, so the first pass may normalize it);
+ *          - raw views: every `view` getter matches the parsed field;
+ *          - columnar batches: every column of the SIMD or scalar kernels matches the parsed field;
+ *          - `compact_card`, `diff()` and `equals_bytes()` agree with the canonical image;
+ *          - the raw-buffer fast paths (`tap_engine::apply()`, `pass_selector`) write exactly the bytes the
+ *            equivalent container updates produce. Their inputs (terminal, time, fare, journey) are derived
+ *            from the image itself, so every image exercises a different tap.
+ *
+ *          A check returns the name of the first property that failed, or `nullptr`.
+ *
+ * @author Govind Yadav
+ * @version 1.1
+ * @date 2025-09-08
+ */
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <ctime>
+#include <vector>
+#include "open_loop_service.h"
+#include "open_loop_batch.h"
+#include "open_loop_diff.h"
+#include "open_loop_pass.h"
+#include "open_loop_session.h"
+#include "open_loop_tap.h"
+
+namespace open_loop {
+
+    namespace fuzz {
+
+        //! The effective date used for every image, in minutes since the Unix epoch (2024-01-01).
+        constexpr std::time_t EFFECTIVE_DATE = 28399680;
+        constexpr effective_epoch EPOCH{ EFFECTIVE_DATE };
+
+        /**
+         * @brief Draws a tap from the image bytes and checks `tap_engine::apply()` against the container path.
+         * @details The tap time spans 25 bits of minutes, so both valid and overflowing offsets occur, and the
+         *          fare is sometimes above the balance.
+         */
+        inline const char* check_csa_tap(const std::array<uint8_t, csa::container::TOTAL_SIZE>& canonical) {
+            const csa::terminal gate_terminal = csa::terminal::parse(canonical.data() + csa::container::RFU_OFFSET, csa::terminal::DATA_SIZE);
+            const csa::gate_context gate(gate_terminal, detail::read_u16_be(canonical.data() + csa::container::GENERAL_OFFSET));
+            const csa::card_session session = gate.open(EFFECTIVE_DATE);
+            const uint32_t minutes = (detail::read_u24_be(canonical.data() + 3) << 1) | (canonical[95] & 1);
+            const uint64_t time = EPOCH.to_milliseconds(minutes) + (canonical[94] * 200ULL);
+            const uint16_t fare = (canonical[93] & 0x80) != 0 ? detail::read_u16_be(canonical.data() + 91) : uint16_t{ canonical[92] };
+            const txn_status status = static_cast<txn_status>(canonical[90] & 0x0F);
+
+            std::array<uint8_t, csa::container::TOTAL_SIZE> raw = canonical;
+            const csa::tap_result fast = session.apply(raw.data(), raw.size(), time, fare, status);
+            csa::container card;
+            if (session.parse(card, canonical.data(), canonical.size()) != status_code::ok) return "csa.tap.parse";
+            const csa::tap_result slow = session.record_tap(card, time, fare, status);
+            if (fast.status != slow.status) return "csa.tap.status";
+            std::array<uint8_t, csa::container::TOTAL_SIZE> patched = canonical;
+            const dirty_ranges dirty = card.patch_into(patched.data());
+            if (raw != patched) return "csa.tap.bytes";
+            if (!fast.ok()) return nullptr;
+            if (fast.card_balance != slow.card_balance || fast.txn_sq_no != slow.txn_sq_no) return "csa.tap.result";
+            if (fast.dirty.total_bytes() != dirty.total_bytes()) return "csa.tap.dirty";
+            return nullptr;
+        }
+
+        /**
+         * @brief Draws a journey from the image bytes and checks `pass_selector` against a reference
+         *        selection and update on the parsed trip passes.
+         */
+        inline const char* check_osa_passes(const std::array<uint8_t, osa::container::BLOCK_SIZE>& canonical, const osa::container& card) {
+            const uint8_t daily_limit = canonical[0] & 0x07;
+            const osa::pass_selector selector(daily_limit);
+            // Aim the journey at slot 0's route and day half of the time, so that passes are actually applicable.
+            const osa::trip_pass& aim = card.get_trip_pass(canonical[1] & 1);
+            const bool aimed = (canonical[2] & 1) != 0;
+            osa::journey trip;
+            trip.source_id = aimed ? aim.get_source_id() : detail::read_u16_be(canonical.data() + 3);
+            trip.destination_id = aimed ? aim.get_destination_id() : detail::read_u16_be(canonical.data() + 5);
+            const uint64_t start = aim.get_start_date_and_time(), expiry = aim.get_pass_expiry();
+            trip.time_in_milliseconds = aimed && expiry >= start ? start + ((expiry - start) / 2) : detail::read_u24_be(canonical.data() + 7) * 1000ULL;
+            trip.day_indicator = aimed ? aim.get_daily_trip_indicator() : detail::read_u16_be(canonical.data() + 10);
+
+            // Reference: the documented applicability rule and ranking, on the parsed passes.
+            size_t expected = osa::pass_selector::NO_PASS;
+            const uint64_t now = trip.time_in_milliseconds / 1000;
+            for (size_t slot = 0; slot < osa::container::NUM_TRIP_PASSES; ++slot) {
+                const osa::trip_pass& p = card.get_trip_pass(slot);
+                const bool source_any = p.get_source_id() == 0, destination_any = p.get_destination_id() == 0;
+                const bool forward = (source_any || p.get_source_id() == trip.source_id) && (destination_any || p.get_destination_id() == trip.destination_id);
+                const bool reverse = (source_any || p.get_source_id() == trip.destination_id) && (destination_any || p.get_destination_id() == trip.source_id);
+                const uint8_t used_today = p.get_daily_trip_indicator() == trip.day_indicator ? p.get_daily_trip_counter() : 0;
+                const bool applicable = p.get_remaining_trips() != 0 && now >= p.get_start_date_and_time() / 1000 &&
+                                        now <= p.get_pass_expiry() / 1000 && (forward || reverse) &&
+                                        (daily_limit == 0 || used_today < daily_limit);
+                if (!applicable) continue;
+                if (expected == osa::pass_selector::NO_PASS) { expected = slot; continue; }
+                const osa::trip_pass& best = card.get_trip_pass(expected);
+                if (p.get_priority() < best.get_priority() ||
+                    (p.get_priority() == best.get_priority() && p.get_pass_expiry() < best.get_pass_expiry())) expected = slot;
+            }
+            if (selector.select(canonical.data() + osa::pass_selector::REGION_OFFSET, trip) != expected) return "osa.pass.select";
+
+            std::array<uint8_t, osa::container::BLOCK_SIZE> raw = canonical;
+            const osa::pass_result fast = selector.consume(raw.data(), raw.size(), trip);
+            if (fast.ok() != (expected != osa::pass_selector::NO_PASS)) return "osa.pass.status";
+            if (!fast.ok()) return raw == canonical ? nullptr : "osa.pass.untouched";
+            if (fast.slot != expected) return "osa.pass.slot";
+
+            osa::container updated = card;
+            osa::trip_pass& used = updated.get_trip_pass(expected);
+            const bool same_day = used.get_daily_trip_indicator() == trip.day_indicator;
+            const uint8_t counter = used.get_daily_trip_counter();
+            // A card whose pass already holds more trips than allotted cannot be reproduced through setters.
+            if (used.try_set_remaining_trips(static_cast<uint16_t>(used.get_remaining_trips() - 1)) != status_code::ok) return nullptr;
+            used.set_daily_trip_counter(same_day ? static_cast<uint8_t>(counter + (counter != 0xFF)) : uint8_t{ 1 });
+            used.set_daily_trip_indicator(trip.day_indicator);
+            if (updated.to_array() != raw) return "osa.pass.bytes";
+            if (fast.remaining_trips != used.get_remaining_trips() || fast.daily_trip_counter != used.get_daily_trip_counter()) return "osa.pass.result";
+            return nullptr;
+        }
+
+        /**
+         * @brief Checks one CSA image against every property.
+         * @param image What to send: 96 readable bytes.
+         * @param batch A batch that has decoded `image` at position `index`, so that callers can decode
+         *              many images per kernel call.
+         */
+        inline const char* check_csa_image(const uint8_t* image, const csa::batch& batch, const size_t index) {
+            csa::container card;
+            card.set_card_effective_date(EFFECTIVE_DATE);
+            if (card.try_parse(image, csa::container::TOTAL_SIZE) != status_code::ok) return "csa.try_parse";
+
+            // Serialization paths and the re-parse fixed point.
+            const std::array<uint8_t, csa::container::TOTAL_SIZE> canonical = card.to_array();
+            const std::vector<uint8_t> bytes = card.to_bytes();
+            if (!std::equal(bytes.begin(), bytes.end(), canonical.begin(), canonical.end())) return "csa.to_bytes";
+            std::array<uint8_t, csa::container::TOTAL_SIZE> patched{};
+            std::copy_n(image, patched.size(), patched.begin());
+            const dirty_ranges dirty = card.patch_into(patched.data());
+            if (patched != canonical) return "csa.patch_into";
+            if (dirty.empty() != std::equal(canonical.begin(), canonical.end(), image)) return "csa.patch_into.dirty";
+            csa::container again;
+            again.set_card_effective_date(EFFECTIVE_DATE);
+            if (again.try_parse(canonical.data(), canonical.size()) != status_code::ok || !(again == card)) return "csa.reparse";
+            if (again.to_array() != canonical || !again.equals_bytes(canonical.data())) return "csa.fixed_point";
+
+            // Raw view against the parsed blocks.
+            const csa::view view(image, csa::container::TOTAL_SIZE, EFFECTIVE_DATE);
+            const csa::validation& validation = card.get_validation();
+            const csa::history& history = card.get_history();
+            if (view.get_validation_error_code() != validation.get_error_code() ||
+                view.get_validation_product_type() != validation.get_product_type() ||
+                view.get_validation_fare_amount() != validation.get_fare_amount() ||
+                view.get_validation_route_number() != validation.get_route_number() ||
+                view.get_validation_txn_status() != validation.get_txn_status() ||
+                view.get_validation_date_and_time() != validation.get_date_and_time() ||
+                view.get_validation_operator_id() != validation.get_terminal_info().get_operator_id() ||
+                !(view.get_validation_terminal() == validation.get_terminal_info())) return "csa.view.validation";
+            if (view.get_log_count() != history.get_valid_log_count()) return "csa.view.log_count";
+            for (size_t slot = 0; slot < history.get_valid_log_count(); ++slot) {
+                const csa::log& log = history.get_log(slot);
+                if (view.get_log_card_balance(slot) != log.get_card_balance() ||
+                    view.get_log_txn_amount(slot) != log.get_txn_amount() ||
+                    view.get_log_txn_sq_no(slot) != log.get_txn_sq_no() ||
+                    view.get_log_txn_status(slot) != log.get_txn_status() ||
+                    view.get_log_date_and_time(slot) != log.get_date_and_time()) return "csa.view.log";
+            }
+
+            // Columnar batch against the view it mirrors.
+            if (batch.get_validation_fare_amount()[index] != validation.get_fare_amount() ||
+                batch.get_validation_route_number()[index] != validation.get_route_number() ||
+                batch.get_validation_txn_status()[index] != validation.get_txn_status() ||
+                batch.get_validation_date_and_time_offset()[index] != view.get_validation_date_and_time_offset() ||
+                EPOCH.to_milliseconds(batch.get_validation_date_and_time_offset()[index]) != validation.get_date_and_time() ||
+                codec::hex_u24(batch.get_validation_terminal_id()[index]) != validation.get_terminal_info().get_terminal_id_chars()) return "csa.batch.validation";
+            if (batch.get_log_count()[index] != history.get_valid_log_count()) return "csa.batch.log_count";
+            for (size_t slot = 0; slot < history.get_valid_log_count(); ++slot) {
+                const size_t at = csa::batch::log_index(index, slot);
+                const csa::log& log = history.get_log(slot);
+                if (batch.get_log_card_balance()[at] != log.get_card_balance() ||
+                    batch.get_log_txn_amount()[at] != log.get_txn_amount() ||
+                    batch.get_log_txn_sq_no()[at] != log.get_txn_sq_no() ||
+                    batch.get_log_txn_status()[at] != log.get_txn_status() ||
+                    EPOCH.to_milliseconds(batch.get_log_date_and_time_offset()[at]) != log.get_date_and_time()) return "csa.batch.log";
+            }
+
+            // Compact storage and the raw diff.
+            const csa::compact_card compact = csa::compact_card::from_container(card);
+            if (compact.image != canonical || compact.hash() != card.hash() || !(compact.to_container() == card)) return "csa.compact_card";
+            const card_diff d = csa::diff(image, canonical.data());
+            if (d.identical() != std::equal(canonical.begin(), canonical.end(), image)) return "csa.diff";
+            if (!csa::diff(canonical.data(), again.to_array().data()).identical()) return "csa.diff.fixed_point";
+
+            // Raw-buffer tap against the container path.
+            return check_csa_tap(canonical);
+        }
+
+        /**
+         * @brief Checks one OSA image against every property.
+         * @param image What to send: 96 readable bytes.
+         * @param batch A batch that has decoded `image` at position `index`.
+         */
+        inline const char* check_osa_image(const uint8_t* image, const osa::batch& batch, const size_t index) {
+            osa::container card;
+            card.set_card_effective_date(EFFECTIVE_DATE);
+            if (card.try_parse(image, osa::container::BLOCK_SIZE) != status_code::ok) return "osa.try_parse";
+
+            const std::array<uint8_t, osa::container::BLOCK_SIZE> canonical = card.to_array();
+            const std::vector<uint8_t> bytes = card.to_bytes();
+            if (!std::equal(bytes.begin(), bytes.end(), canonical.begin(), canonical.end())) return "osa.to_bytes";
+            std::array<uint8_t, osa::container::BLOCK_SIZE> patched{};
+            std::copy_n(image, patched.size(), patched.begin());
+            const dirty_ranges dirty = card.patch_into(patched.data());
+            if (patched != canonical) return "osa.patch_into";
+            if (dirty.empty() != std::equal(canonical.begin(), canonical.end(), image)) return "osa.patch_into.dirty";
+            osa::container again;
+            again.set_card_effective_date(EFFECTIVE_DATE);
+            if (again.try_parse(canonical.data(), canonical.size()) != status_code::ok || !(again == card)) return "osa.reparse";
+            if (again.to_array() != canonical || !again.equals_bytes(canonical.data())) return "osa.fixed_point";
+
+            const osa::view view(image, osa::container::BLOCK_SIZE, EFFECTIVE_DATE);
+            const osa::transaction_record& validation = card.get_validation();
+            if (view.get_validation_station_id() != validation.get_station_id() ||
+                view.get_validation_fare() != validation.get_fare() ||
+                view.get_validation_txn_status() != validation.get_txn_status() ||
+                view.get_validation_date_and_time() != validation.get_date_and_time()) return "osa.view.validation";
+            for (size_t i = 0; i < osa::container::NUM_TRIP_PASSES; ++i) {
+                const osa::trip_pass& pass = card.get_trip_pass(i);
+                if (view.get_trip_pass_id(i) != pass.get_pass_id() ||
+                    view.get_trip_pass_trips_allotted(i) != pass.get_trips_allotted() ||
+                    view.get_trip_pass_remaining_trips(i) != pass.get_remaining_trips() ||
+                    view.get_trip_pass_source_id(i) != pass.get_source_id() ||
+                    view.get_trip_pass_destination_id(i) != pass.get_destination_id() ||
+                    view.get_trip_pass_daily_trip_counter(i) != pass.get_daily_trip_counter() ||
+                    view.get_trip_pass_daily_trip_indicator(i) != pass.get_daily_trip_indicator() ||
+                    view.get_trip_pass_expiry(i) != pass.get_pass_expiry() ||
+                    view.get_trip_pass_start_date_and_time(i) != pass.get_start_date_and_time()) return "osa.view.trip_pass";
+            }
+
+            if (batch.get_validation_station_id()[index] != validation.get_station_id() ||
+                batch.get_validation_fare()[index] != validation.get_fare() ||
+                batch.get_validation_terminal_id()[index] != view.get_validation_terminal_id() ||
+                batch.get_validation_txn_status()[index] != validation.get_txn_status() ||
+                EPOCH.to_milliseconds(batch.get_validation_date_and_time_offset()[index]) != validation.get_date_and_time() ||
+                batch.get_validation_terminal_id()[index] != validation.get_terminal_id()) return "osa.batch.validation";
+            for (size_t i = 0; i < osa::container::NUM_TRIP_PASSES; ++i) {
+                const size_t at = osa::batch::pass_index(index, i);
+                const osa::trip_pass& pass = card.get_trip_pass(i);
+                if (batch.get_trip_pass_id()[at] != pass.get_pass_id() ||
+                    batch.get_trip_pass_trips_allotted()[at] != pass.get_trips_allotted() ||
+                    batch.get_trip_pass_remaining_trips()[at] != pass.get_remaining_trips() ||
+                    batch.get_trip_pass_priority()[at] != pass.get_priority() ||
+                    batch.get_trip_pass_expiry()[at] * 1000ULL != pass.get_pass_expiry() ||
+                    batch.get_trip_pass_start_date_and_time()[at] * 1000ULL != pass.get_start_date_and_time() ||
+                    batch.get_trip_pass_source_id()[at] != pass.get_source_id() ||
+                    batch.get_trip_pass_destination_id()[at] != pass.get_destination_id() ||
+                    batch.get_trip_pass_daily_trip_counter()[at] != pass.get_daily_trip_counter() ||
+                    batch.get_trip_pass_daily_trip_indicator()[at] != pass.get_daily_trip_indicator()) return "osa.batch.trip_pass";
+            }
+
+            const osa::compact_card compact = osa::compact_card::from_container(card);
+            if (compact.image != canonical || compact.hash() != card.hash() || !(compact.to_container() == card)) return "osa.compact_card";
+            const card_diff d = osa::diff(image, canonical.data());
+            if (d.identical() != std::equal(canonical.begin(), canonical.end(), image)) return "osa.diff";
+
+            // Raw-buffer pass selection against the parsed passes.
+            return check_osa_passes(canonical, card);
+        }
+
+    }
+
+}
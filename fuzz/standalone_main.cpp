@@ -0,0 +1,44 @@
+/**
+ * @file standalone_main.cpp
+ * @brief Replays inputs through a libFuzzer entry point on toolchains without libFuzzer.
+ * @details Each argument is a file (for example a saved crash or a corpus entry) fed to
+ *          `LLVMFuzzerTestOneInput` once. With no arguments, standard input is replayed instead.
+ *
+ * @author Govind Yadav
+ * @version 1.1
+ * @date 2025-09-08
+ */
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace {
+
+    void replay(std::istream& in) {
+        const std::vector<uint8_t> input((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+    }
+
+}
+
+int main(const int argc, char** argv) {
+    if (argc < 2) {
+        replay(std::cin);
+        return 0;
+    }
+    for (int i = 1; i < argc; ++i) {
+        std::ifstream file(argv[i], std::ios::binary);
+        if (!file) {
+            std::cerr << "cannot open " << argv[i] << std::endl;
+            return 2;
+        }
+        replay(file);
+    }
+    std::cout << "replayed " << (argc - 1) << " input(s)" << std::endl;
+    return 0;
+}
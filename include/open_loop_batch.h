@@ -0,0 +1,435 @@
+/**
+ * @file open_loop_batch.h
+ * @brief Bulk, structure-of-arrays decoders for large runs of contiguous 96-byte CSA and OSA images.
+ * @details Back-office reconciliation replays millions of card images at a time. Parsing each image into a
+ *          `csa::container` or `osa::container` builds a full object graph per card, most of which is
+ *          thrown away after a handful of fields are read. The decoders in this header instead write every
+ *          field into its own column (`fare_amount[]`, `card_balance[]`, ...), which is the natural
+ *          input for aggregation and lets the big-endian fields be extracted with byte-shuffle kernels.
+ *
+ *          Each fixed-width field group is pulled out of a 16-byte window with one shuffle that performs
+ *          the byte swap and zero extension for four 32-bit lanes at once. The shuffle is implemented with
+ *          SSSE3 (`pshufb`) on x86, with NEON (`tbl`) on AArch64, and with a portable scalar loop elsewhere.
+ *          All three produce identical results; `batch_kernel_name()` reports which one was compiled in.
+ *
+ *          Time fields are stored exactly as on the card (minutes or seconds offsets), because a batch of
+ *          uploads typically spans many cards with different effective dates.
+ *
+ * @author Govind Yadav
+ * @version 1.1
+ * @date 2025-09-08
+ */
+
+#pragma once
+#include <cstdint>
+#include <memory_resource>
+#include <stdexcept>
+#include <vector>
+#include "open_loop_service.h"
+
+#if defined(__SSSE3__) || defined(__AVX__)
+#include <tmmintrin.h>
+#define OPEN_LOOP_BATCH_SSSE3 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define OPEN_LOOP_BATCH_NEON 1
+#endif
+
+namespace open_loop {
+
+    namespace detail {
+
+        //! Marks a shuffle-mask byte whose output lane byte must be zero.
+        constexpr uint8_t ZERO_LANE = 0x80;
+
+        /**
+         * @brief Gathers bytes from a 16-byte window into four little-endian 32-bit lanes.
+         * @details `mask[4 * lane + k]` selects the source byte that becomes byte `k` (least significant
+         *          first) of output lane `lane`; `ZERO_LANE` produces a zero byte. Listing the bytes of a
+         *          big-endian field in reverse order therefore decodes it in one step.
+         * @param src A pointer to 16 readable bytes.
+         * @param mask The 16-byte selection mask.
+         * @param out Receives the four decoded lanes.
+         */
+        inline void shuffle_u32x4(const uint8_t* src, const uint8_t* mask, uint32_t* out) noexcept {
+#if defined(OPEN_LOOP_BATCH_SSSE3)
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            const __m128i control = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_shuffle_epi8(bytes, control));
+#elif defined(OPEN_LOOP_BATCH_NEON)
+            // Out-of-range indices (>= 16) yield zero with `tbl`, matching the SSSE3 semantics of ZERO_LANE.
+            vst1q_u32(out, vreinterpretq_u32_u8(vqtbl1q_u8(vld1q_u8(src), vld1q_u8(mask))));
+#else
+            for (size_t lane = 0; lane < 4; ++lane) {
+                uint32_t value = 0;
+                for (size_t k = 0; k < 4; ++k) {
+                    const uint8_t index = mask[(lane * 4) + k];
+                    if (!(index & ZERO_LANE)) value |= static_cast<uint32_t>(src[index]) << (8 * k);
+                }
+                out[lane] = value;
+            }
+#endif
+        }
+
+        //! Reverses a big-endian field of `width` bytes starting at window byte `first` into a lane.
+        constexpr void set_lane(uint8_t* mask, const size_t lane, const uint8_t first, const uint8_t width) noexcept {
+            for (uint8_t k = 0; k < 4; ++k)
+                mask[(lane * 4) + k] = (k < width) ? static_cast<uint8_t>(first + width - 1 - k) : ZERO_LANE;
+        }
+
+        //! A 16-byte shuffle mask describing four big-endian fields (`first` byte and `width` per lane).
+        struct shuffle_mask {
+            alignas(16) uint8_t bytes[16]{};
+
+            constexpr shuffle_mask(const uint8_t first0, const uint8_t width0, const uint8_t first1, const uint8_t width1,
+                                   const uint8_t first2, const uint8_t width2, const uint8_t first3, const uint8_t width3) noexcept {
+                set_lane(bytes, 0, first0, width0);
+                set_lane(bytes, 1, first1, width1);
+                set_lane(bytes, 2, first2, width2);
+                set_lane(bytes, 3, first3, width3);
+            }
+        };
+
+    }
+
+    /**
+     * @brief Reports which byte-shuffle kernel the batch decoders were compiled with.
+     * @return "ssse3", "neon", or "scalar".
+     */
+    [[nodiscard]] constexpr const char* batch_kernel_name() noexcept {
+#if defined(OPEN_LOOP_BATCH_SSSE3)
+        return "ssse3";
+#elif defined(OPEN_LOOP_BATCH_NEON)
+        return "neon";
+#else
+        return "scalar";
+#endif
+    }
+
+    namespace csa {
+
+        /**
+         * @class batch
+         * @brief Decodes a run of contiguous 96-byte CSA images into one column per field.
+         *
+         * @details Image `i` occupies bytes `[i * 96, (i + 1) * 96)` of the input. Validation columns have one
+         *          entry per image; log columns have `history::LOG_COUNT` entries per image, indexed by
+         *          `log_index(image, slot)`, where slot 0 is the most recent entry. Empty log slots decode to
+         *          zeros and are excluded from `get_log_count()`, using the same rule as `history::parse`.
+         *
+         *          The object is meant to be reused: `decode()` keeps the capacity of every column, so a
+         *          nightly replay allocates only while the batch size grows.
+         *
+         * @usage
+         * @code
+         *     csa::batch cards;
+         *     cards.decode(upload.data(), upload.size());
+         *     uint64_t total_fares = 0;
+         *     for (size_t i = 0; i < cards.size(); ++i) total_fares += cards.get_validation_fare_amount()[i];
+         * @endcode
+         */
+        class batch {
+        public:
+
+            //! The stride of one image in the input buffer.
+            static constexpr size_t RECORD_SIZE = container::TOTAL_SIZE;
+
+            /**
+             * @brief Decodes every image in a buffer, replacing the previous contents of the batch.
+             * @param images A pointer to the first image. Images must be stored back to back.
+             * @param size The total number of bytes at `images`. What to send: A multiple of 96.
+             * @throws std::invalid_argument if `size` is not a multiple of 96 bytes.
+             */
+            void decode(const uint8_t* images, const size_t size) {
+                if (size % container::TOTAL_SIZE != 0)
+                    throw std::invalid_argument("Batch data must be a whole number of 96-byte CSA images.");
+                resize(size / container::TOTAL_SIZE);
+
+                alignas(16) uint32_t lanes[4];
+                for (size_t i = 0; i < count_; ++i) {
+                    const uint8_t* image = images + (i * container::TOTAL_SIZE);
+
+                    // Validation: terminal ID, time offset, fare and route from a single window.
+                    detail::shuffle_u32x4(image + VALIDATION_WINDOW, VALIDATION_MASK.bytes, lanes);
+                    validation_terminal_id_[i] = lanes[0];
+                    validation_date_and_time_offset_[i] = lanes[1];
+                    validation_fare_amount_[i] = static_cast<uint16_t>(lanes[2]);
+                    validation_route_number_[i] = static_cast<uint16_t>(lanes[3]);
+                    validation_txn_status_[i] = static_cast<txn_status>(image[view::VALIDATION_STATUS_OFFSET] >> 4);
+
+                    uint8_t populated = 0;
+                    for (size_t slot = 0; slot < history::LOG_COUNT; ++slot) {
+                        const uint8_t* log = image + container::HISTORY_OFFSET + (slot * history::LOG_SIZE_BYTES);
+                        const size_t at = log_index(i, slot);
+
+                        detail::shuffle_u32x4(log + LOG_WINDOW, LOG_MASK.bytes, lanes);
+                        log_date_and_time_offset_[at] = lanes[0];
+                        log_txn_amount_[at] = static_cast<uint16_t>(lanes[1]);
+                        log_txn_sq_no_[at] = static_cast<uint16_t>(lanes[2]);
+                        // The 20-bit balance sits in the top of a 24-bit window; the low nibble is RFU.
+                        log_card_balance_[at] = lanes[3] >> 4;
+                        log_txn_status_[at] = static_cast<txn_status>(log[view::LOG_STATUS_POS] >> 4);
+
+                        if (populated == slot && !detail::is_zero_filled(log, history::LOG_SIZE_BYTES)) ++populated;
+                    }
+                    log_count_[i] = populated;
+                }
+            }
+
+            //! Decodes every image in a vector. See `decode(const uint8_t*, size_t)`.
+            void decode(const std::vector<uint8_t>& images) { decode(images.data(), images.size()); }
+            //! Decodes every image in a vector drawn from a memory resource. See `decode(const uint8_t*, size_t)`.
+            void decode(const std::pmr::vector<uint8_t>& images) { decode(images.data(), images.size()); }
+
+            //! Returns the column position of a log slot. What to send: `slot` in [0, 3].
+            [[nodiscard]] static constexpr size_t log_index(const size_t image, const size_t slot) noexcept {
+                return (image * history::LOG_COUNT) + slot;
+            }
+
+            [[nodiscard]] size_t size() const noexcept { return count_; }
+            [[nodiscard]] bool empty() const noexcept { return count_ == 0; }
+
+            // --- Validation Columns (one entry per image) ---
+
+            [[nodiscard]] const std::vector<uint32_t>& get_validation_terminal_id() const noexcept { return validation_terminal_id_; }
+            [[nodiscard]] const std::vector<uint32_t>& get_validation_date_and_time_offset() const noexcept { return validation_date_and_time_offset_; }
+            [[nodiscard]] const std::vector<uint16_t>& get_validation_fare_amount() const noexcept { return validation_fare_amount_; }
+            [[nodiscard]] const std::vector<uint16_t>& get_validation_route_number() const noexcept { return validation_route_number_; }
+            [[nodiscard]] const std::vector<txn_status>& get_validation_txn_status() const noexcept { return validation_txn_status_; }
+
+            // --- Log Columns (history::LOG_COUNT entries per image) ---
+
+            [[nodiscard]] const std::vector<uint8_t>& get_log_count() const noexcept { return log_count_; }
+            [[nodiscard]] const std::vector<uint32_t>& get_log_date_and_time_offset() const noexcept { return log_date_and_time_offset_; }
+            [[nodiscard]] const std::vector<uint16_t>& get_log_txn_amount() const noexcept { return log_txn_amount_; }
+            [[nodiscard]] const std::vector<uint16_t>& get_log_txn_sq_no() const noexcept { return log_txn_sq_no_; }
+            [[nodiscard]] const std::vector<uint32_t>& get_log_card_balance() const noexcept { return log_card_balance_; }
+            [[nodiscard]] const std::vector<txn_status>& get_log_txn_status() const noexcept { return log_txn_status_; }
+
+        private:
+
+            //! The validation window starts at the 24-bit terminal ID and spans the time, fare and route fields.
+            static constexpr size_t VALIDATION_WINDOW = view::VALIDATION_TERMINAL_OFFSET + 3;
+            static constexpr detail::shuffle_mask VALIDATION_MASK{
+                0, 3,                                                   // terminal ID
+                view::VALIDATION_TIME_OFFSET - VALIDATION_WINDOW, 3,    // date and time offset
+                view::VALIDATION_FARE_OFFSET - VALIDATION_WINDOW, 2,    // fare amount
+                view::VALIDATION_ROUTE_OFFSET - VALIDATION_WINDOW, 2 }; // route number
+
+            //! The log window starts at the time offset and spans the amount, sequence number and balance.
+            static constexpr size_t LOG_WINDOW = view::LOG_TIME_POS;
+            static constexpr detail::shuffle_mask LOG_MASK{
+                0, 3,                                        // date and time offset
+                view::LOG_AMOUNT_POS - LOG_WINDOW, 2,        // transaction amount
+                view::LOG_SQ_NO_POS - LOG_WINDOW, 2,         // transaction sequence number
+                view::LOG_BALANCE_POS - LOG_WINDOW, 3 };     // card balance (upper 20 bits)
+
+            // Every 16-byte window must stay inside the 96-byte image.
+            static_assert(VALIDATION_WINDOW + 16 <= container::TOTAL_SIZE, "Validation window overruns the CSA image.");
+            static_assert(container::HISTORY_OFFSET + ((history::LOG_COUNT - 1) * history::LOG_SIZE_BYTES) + LOG_WINDOW + 16 <= container::TOTAL_SIZE,
+                          "Log window overruns the CSA image.");
+
+            void resize(const size_t count) {
+                count_ = count;
+                validation_terminal_id_.resize(count);
+                validation_date_and_time_offset_.resize(count);
+                validation_fare_amount_.resize(count);
+                validation_route_number_.resize(count);
+                validation_txn_status_.resize(count);
+                log_count_.resize(count);
+                log_date_and_time_offset_.resize(count * history::LOG_COUNT);
+                log_txn_amount_.resize(count * history::LOG_COUNT);
+                log_txn_sq_no_.resize(count * history::LOG_COUNT);
+                log_card_balance_.resize(count * history::LOG_COUNT);
+                log_txn_status_.resize(count * history::LOG_COUNT);
+            }
+
+            size_t count_{ 0 };
+            std::vector<uint32_t> validation_terminal_id_;
+            std::vector<uint32_t> validation_date_and_time_offset_;
+            std::vector<uint16_t> validation_fare_amount_;
+            std::vector<uint16_t> validation_route_number_;
+            std::vector<txn_status> validation_txn_status_;
+            std::vector<uint8_t> log_count_;
+            std::vector<uint32_t> log_date_and_time_offset_;
+            std::vector<uint16_t> log_txn_amount_;
+            std::vector<uint16_t> log_txn_sq_no_;
+            std::vector<uint32_t> log_card_balance_;
+            std::vector<txn_status> log_txn_status_;
+        };
+
+    }
+
+    namespace osa {
+
+        /**
+         * @class batch
+         * @brief Decodes a run of contiguous 96-byte OSA images into one column per field.
+         *
+         * @details Image `i` occupies bytes `[i * 96, (i + 1) * 96)` of the input. Validation columns have one
+         *          entry per image; trip pass columns have `container::NUM_TRIP_PASSES` entries per image,
+         *          indexed by `pass_index(image, slot)`. Expiry and start times are the raw 24-bit seconds
+         *          values stored on the card.
+         *
+         * @usage
+         * @code
+         *     osa::batch cards;
+         *     cards.decode(upload.data(), upload.size());
+         *     const auto& remaining = cards.get_trip_pass_remaining_trips();
+         * @endcode
+         */
+        class batch {
+        public:
+
+            //! The stride of one image in the input buffer.
+            static constexpr size_t RECORD_SIZE = container::BLOCK_SIZE;
+
+            /**
+             * @brief Decodes every image in a buffer, replacing the previous contents of the batch.
+             * @param images A pointer to the first image. Images must be stored back to back.
+             * @param size The total number of bytes at `images`. What to send: A multiple of 96.
+             * @throws std::invalid_argument if `size` is not a multiple of 96 bytes.
+             */
+            void decode(const uint8_t* images, const size_t size) {
+                if (size % container::BLOCK_SIZE != 0)
+                    throw std::invalid_argument("Batch data must be a whole number of 96-byte OSA images.");
+                resize(size / container::BLOCK_SIZE);
+
+                alignas(16) uint32_t lanes[4];
+                for (size_t i = 0; i < count_; ++i) {
+                    const uint8_t* image = images + (i * container::BLOCK_SIZE);
+
+                    // Validation: time offset, station, fare and terminal ID from a single window.
+                    detail::shuffle_u32x4(image + VALIDATION_WINDOW, VALIDATION_MASK.bytes, lanes);
+                    validation_date_and_time_offset_[i] = lanes[0];
+                    validation_station_id_[i] = static_cast<uint16_t>(lanes[1]);
+                    validation_fare_[i] = static_cast<uint16_t>(lanes[2]);
+                    validation_terminal_id_[i] = lanes[3];
+                    validation_txn_status_[i] = static_cast<txn_status>(image[view::VALIDATION_STATUS_OFFSET] >> 4);
+
+                    for (size_t slot = 0; slot < container::NUM_TRIP_PASSES; ++slot) {
+                        const uint8_t* pass = image + container::TRIP_PASS_START_OFFSET + (slot * trip_pass::DATA_SIZE);
+                        const size_t at = pass_index(i, slot);
+
+                        detail::shuffle_u32x4(pass + PASS_HEAD_WINDOW, PASS_HEAD_MASK.bytes, lanes);
+                        trip_pass_expiry_[at] = lanes[0];
+                        trip_pass_trips_allotted_[at] = static_cast<uint16_t>(lanes[1]);
+                        trip_pass_remaining_trips_[at] = static_cast<uint16_t>(lanes[2]);
+                        trip_pass_source_id_[at] = static_cast<uint16_t>(lanes[3]);
+
+                        detail::shuffle_u32x4(pass + PASS_TAIL_WINDOW, PASS_TAIL_MASK.bytes, lanes);
+                        trip_pass_destination_id_[at] = static_cast<uint16_t>(lanes[0]);
+                        trip_pass_daily_trip_indicator_[at] = static_cast<uint16_t>(lanes[1]);
+                        trip_pass_start_date_and_time_[at] = lanes[2];
+
+                        trip_pass_id_[at] = pass[0];
+                        trip_pass_priority_[at] = pass[view::PASS_PRIORITY_POS];
+                        trip_pass_daily_trip_counter_[at] = pass[view::PASS_DAILY_COUNTER_POS];
+                    }
+                }
+            }
+
+            //! Decodes every image in a vector. See `decode(const uint8_t*, size_t)`.
+            void decode(const std::vector<uint8_t>& images) { decode(images.data(), images.size()); }
+            //! Decodes every image in a vector drawn from a memory resource. See `decode(const uint8_t*, size_t)`.
+            void decode(const std::pmr::vector<uint8_t>& images) { decode(images.data(), images.size()); }
+
+            //! Returns the column position of a trip pass slot. What to send: `slot` in [0, NUM_TRIP_PASSES - 1].
+            [[nodiscard]] static constexpr size_t pass_index(const size_t image, const size_t slot) noexcept {
+                return (image * container::NUM_TRIP_PASSES) + slot;
+            }
+
+            [[nodiscard]] size_t size() const noexcept { return count_; }
+            [[nodiscard]] bool empty() const noexcept { return count_ == 0; }
+
+            // --- Validation Columns (one entry per image) ---
+
+            [[nodiscard]] const std::vector<uint32_t>& get_validation_date_and_time_offset() const noexcept { return validation_date_and_time_offset_; }
+            [[nodiscard]] const std::vector<uint16_t>& get_validation_station_id() const noexcept { return validation_station_id_; }
+            [[nodiscard]] const std::vector<uint16_t>& get_validation_fare() const noexcept { return validation_fare_; }
+            [[nodiscard]] const std::vector<uint32_t>& get_validation_terminal_id() const noexcept { return validation_terminal_id_; }
+            [[nodiscard]] const std::vector<txn_status>& get_validation_txn_status() const noexcept { return validation_txn_status_; }
+
+            // --- Trip Pass Columns (NUM_TRIP_PASSES entries per image) ---
+
+            [[nodiscard]] const std::vector<uint8_t>& get_trip_pass_id() const noexcept { return trip_pass_id_; }
+            [[nodiscard]] const std::vector<uint8_t>& get_trip_pass_priority() const noexcept { return trip_pass_priority_; }
+            [[nodiscard]] const std::vector<uint32_t>& get_trip_pass_expiry() const noexcept { return trip_pass_expiry_; }
+            [[nodiscard]] const std::vector<uint32_t>& get_trip_pass_start_date_and_time() const noexcept { return trip_pass_start_date_and_time_; }
+            [[nodiscard]] const std::vector<uint16_t>& get_trip_pass_trips_allotted() const noexcept { return trip_pass_trips_allotted_; }
+            [[nodiscard]] const std::vector<uint16_t>& get_trip_pass_remaining_trips() const noexcept { return trip_pass_remaining_trips_; }
+            [[nodiscard]] const std::vector<uint16_t>& get_trip_pass_source_id() const noexcept { return trip_pass_source_id_; }
+            [[nodiscard]] const std::vector<uint16_t>& get_trip_pass_destination_id() const noexcept { return trip_pass_destination_id_; }
+            [[nodiscard]] const std::vector<uint8_t>& get_trip_pass_daily_trip_counter() const noexcept { return trip_pass_daily_trip_counter_; }
+            [[nodiscard]] const std::vector<uint16_t>& get_trip_pass_daily_trip_indicator() const noexcept { return trip_pass_daily_trip_indicator_; }
+
+        private:
+
+            //! The validation window starts at the time offset and spans the station, fare and terminal fields.
+            static constexpr size_t VALIDATION_WINDOW = view::VALIDATION_TIME_OFFSET;
+            static constexpr detail::shuffle_mask VALIDATION_MASK{
+                0, 3,                                                       // date and time offset
+                view::VALIDATION_STATION_OFFSET - VALIDATION_WINDOW, 2,     // station ID
+                view::VALIDATION_FARE_OFFSET - VALIDATION_WINDOW, 2,        // fare
+                view::VALIDATION_TERMINAL_OFFSET - VALIDATION_WINDOW, 3 };  // terminal ID
+
+            //! Trip pass fields are split over two overlapping windows so the 24-bit start time is covered.
+            static constexpr size_t PASS_HEAD_WINDOW = view::PASS_EXPIRY_POS;
+            static constexpr detail::shuffle_mask PASS_HEAD_MASK{
+                0, 3,                                                   // expiry
+                view::PASS_ALLOTTED_POS - PASS_HEAD_WINDOW, 2,          // trips allotted
+                view::PASS_REMAINING_POS - PASS_HEAD_WINDOW, 2,         // remaining trips
+                view::PASS_SOURCE_POS - PASS_HEAD_WINDOW, 2 };          // source ID
+            static constexpr size_t PASS_TAIL_WINDOW = view::PASS_PRIORITY_POS;
+            static constexpr detail::shuffle_mask PASS_TAIL_MASK{
+                view::PASS_DESTINATION_POS - PASS_TAIL_WINDOW, 2,       // destination ID
+                view::PASS_DAILY_INDICATOR_POS - PASS_TAIL_WINDOW, 2,   // daily trip indicator
+                view::PASS_START_POS - PASS_TAIL_WINDOW, 3,             // start date and time
+                0, 0 };                                                 // unused
+
+            // Every 16-byte window must stay inside the 96-byte image.
+            static_assert(VALIDATION_WINDOW + 16 <= container::BLOCK_SIZE, "Validation window overruns the OSA image.");
+            static_assert(container::TRIP_PASS_START_OFFSET + ((container::NUM_TRIP_PASSES - 1) * trip_pass::DATA_SIZE) + PASS_TAIL_WINDOW + 16 <= container::BLOCK_SIZE,
+                          "Trip pass window overruns the OSA image.");
+
+            void resize(const size_t count) {
+                const size_t passes = count * container::NUM_TRIP_PASSES;
+                count_ = count;
+                validation_date_and_time_offset_.resize(count);
+                validation_station_id_.resize(count);
+                validation_fare_.resize(count);
+                validation_terminal_id_.resize(count);
+                validation_txn_status_.resize(count);
+                trip_pass_id_.resize(passes);
+                trip_pass_priority_.resize(passes);
+                trip_pass_expiry_.resize(passes);
+                trip_pass_start_date_and_time_.resize(passes);
+                trip_pass_trips_allotted_.resize(passes);
+                trip_pass_remaining_trips_.resize(passes);
+                trip_pass_source_id_.resize(passes);
+                trip_pass_destination_id_.resize(passes);
+                trip_pass_daily_trip_counter_.resize(passes);
+                trip_pass_daily_trip_indicator_.resize(passes);
+            }
+
+            size_t count_{ 0 };
+            std::vector<uint32_t> validation_date_and_time_offset_;
+            std::vector<uint16_t> validation_station_id_;
+            std::vector<uint16_t> validation_fare_;
+            std::vector<uint32_t> validation_terminal_id_;
+            std::vector<txn_status> validation_txn_status_;
+            std::vector<uint8_t> trip_pass_id_;
+            std::vector<uint8_t> trip_pass_priority_;
+            std::vector<uint32_t> trip_pass_expiry_;
+            std::vector<uint32_t> trip_pass_start_date_and_time_;
+            std::vector<uint16_t> trip_pass_trips_allotted_;
+            std::vector<uint16_t> trip_pass_remaining_trips_;
+            std::vector<uint16_t> trip_pass_source_id_;
+            std::vector<uint16_t> trip_pass_destination_id_;
+            std::vector<uint8_t> trip_pass_daily_trip_counter_;
+            std::vector<uint16_t> trip_pass_daily_trip_indicator_;
+        };
+
+    }
+
+}
@@ -0,0 +1,282 @@
+/**
+ * @file open_loop_card_cache.h
+ * @brief A concurrent last-known-state cache of CSAs, shared by the readers of one station controller.
+ * @details When a card is tapped on one gate and immediately on another, the second gate may read a card
+ *          whose write-back from the first gate was interrupted, or race the first gate's write entirely.
+ *          `csa::card_cache` keeps the last committed `csa::compact_card` per card token together with the
+ *          transaction sequence number of its newest log, and only accepts an update that was computed from
+ *          the state it replaces. Concurrent taps on the same card therefore cannot both succeed, and a
+ *          conflicting gate is told which sequence number won.
+ *
+ * @author Govind Yadav
+ * @version 1.1
+ * @date 2025-09-08
+ */
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include "open_loop_service.h"
+
+namespace open_loop {
+
+    namespace csa {
+
+        /**
+         * @struct cache_update
+         * @brief The outcome of `card_cache::compare_and_swap()`.
+         */
+        struct cache_update {
+            //! True if the desired state was stored.
+            bool swapped{ false };
+            //! True if the token had an entry before the call.
+            bool found{ false };
+            //! The sequence number stored for the token after the call: the new one on success, the
+            //! conflicting one on failure.
+            uint16_t txn_sq_no{ 0 };
+        };
+
+        /**
+         * @class card_cache
+         * @brief A fixed-capacity, set-associative cache of `compact_card`s keyed by card token.
+         *
+         * @details **Layout.** Tokens hash to one of a power-of-two number of buckets; each bucket holds
+         *          `WAYS` entries in its own cache lines. When a bucket is full, the least recently written
+         *          entry is evicted.
+         *
+         *          **Reads** never lock. Every entry is guarded by a sequence lock: a reader copies the entry and
+         *          retries only if a writer touched that same entry meanwhile. Readers on different cards never
+         *          contend with each other, and a reader never delays a writer.
+         *
+         *          **Writes** take a spin lock on the one bucket they touch, so updates of unrelated cards
+         *          proceed in parallel and there is no global mutex. `compare_and_swap()` stores the desired
+         *          state only if the cached sequence number still equals the one the caller started from.
+         *
+         *          The sequence number of a card is the `txn_sq_no` of its newest log (0 for an empty history),
+         *          see `sequence_of()`. Sequence numbers are compared for equality, so their 16-bit wrap-around
+         *          is harmless.
+         *
+         * @usage
+         * @code
+         *     csa::card_cache cache(65536);
+         *     // On tap: start from the cached state if it is newer than what the card returned.
+         *     csa::compact_card state = csa::compact_card::from_container(card);
+         *     cache.find(token, state);
+         *     const uint16_t expected = csa::card_cache::sequence_of(state);
+         *     csa::compact_card next = debit(state);
+         *     if (!cache.compare_and_swap(token, expected, next).swapped) retry_or_reject();
+         * @endcode
+         */
+        class card_cache {
+        public:
+
+            //! The number of entries per bucket.
+            static constexpr size_t WAYS = 8;
+
+            /**
+             * @brief Creates an empty cache.
+             * @param capacity The minimum number of cards to hold. Rounded up to a power-of-two number of buckets.
+             * @throws std::invalid_argument if `capacity` is 0.
+             */
+            explicit card_cache(const size_t capacity) {
+                if (capacity == 0) throw std::invalid_argument("Card cache capacity must be greater than zero.");
+                bucket_count_ = 1;
+                while (bucket_count_ * WAYS < capacity) bucket_count_ <<= 1;
+                buckets_ = std::make_unique<bucket[]>(bucket_count_);
+            }
+
+            card_cache(const card_cache&) = delete;
+            card_cache& operator=(const card_cache&) = delete;
+
+            /**
+             * @brief Reads the sequence number a card state is keyed on.
+             * @return The `txn_sq_no` of the newest log in the image, or 0 if the history is empty.
+             */
+            [[nodiscard]] static uint16_t sequence_of(const compact_card& card) noexcept {
+                const uint8_t* latest = card.image.data() + container::HISTORY_OFFSET;
+                if (detail::is_zero_filled(latest, history::LOG_SIZE_BYTES)) return 0;
+                return detail::read_u16_be(latest + view::LOG_SQ_NO_POS);
+            }
+
+            /**
+             * @brief Looks up the last stored state of a card, without locking.
+             * @param token The card token.
+             * @param out Receives the cached state. Unchanged if the token is not cached.
+             * @return True if the token was found.
+             */
+            bool find(const uint64_t token, compact_card& out) const noexcept {
+                const bucket& b = bucket_of(token);
+                for (const entry& e : b.entries) {
+                    uint64_t payload[PAYLOAD_WORDS];
+                    bool match = false;
+                    for (;;) {
+                        const uint64_t before = e.version.load(std::memory_order_acquire);
+                        if ((before & 1) != 0) { std::this_thread::yield(); continue; }
+                        match = (e.meta.load(std::memory_order_relaxed) & OCCUPIED) != 0 &&
+                                e.key.load(std::memory_order_relaxed) == token;
+                        if (match)
+                            for (size_t w = 0; w < PAYLOAD_WORDS; ++w) payload[w] = e.payload[w].load(std::memory_order_relaxed);
+                        std::atomic_thread_fence(std::memory_order_acquire);
+                        if (e.version.load(std::memory_order_relaxed) == before) break;
+                    }
+                    if (match) {
+                        std::memcpy(&out, payload, sizeof(compact_card));
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            /**
+             * @brief Stores `desired` if the cached state of `token` is still the one the caller started from.
+             * @param token The card token.
+             * @param expected_txn_sq_no The sequence number of the state `desired` was computed from. Ignored
+             *                           when the token is not cached yet, in which case `desired` is inserted.
+             * @param desired The new state.
+             * @return Whether the state was stored, and the sequence number that is now cached.
+             */
+            cache_update compare_and_swap(const uint64_t token, const uint16_t expected_txn_sq_no, const compact_card& desired) noexcept {
+                bucket& b = bucket_of(token);
+                const bucket_lock lock(b);
+                cache_update update;
+                entry* target = locate(b, token);
+                update.found = target != nullptr;
+                if (target != nullptr) {
+                    const uint16_t current = static_cast<uint16_t>(target->meta.load(std::memory_order_relaxed));
+                    if (current != expected_txn_sq_no) {
+                        update.txn_sq_no = current;
+                        return update;
+                    }
+                } else {
+                    target = victim(b);
+                }
+                update.txn_sq_no = sequence_of(desired);
+                write(*target, token, OCCUPIED | (++b.clock << STAMP_SHIFT) | update.txn_sq_no, &desired);
+                update.swapped = true;
+                return update;
+            }
+
+            /**
+             * @brief Stores `desired` unconditionally, e.g. when seeding the cache from the back office.
+             * @return The same as a successful `compare_and_swap()`.
+             */
+            cache_update assign(const uint64_t token, const compact_card& desired) noexcept {
+                bucket& b = bucket_of(token);
+                const bucket_lock lock(b);
+                entry* target = locate(b, token);
+                cache_update update;
+                update.found = target != nullptr;
+                if (target == nullptr) target = victim(b);
+                update.txn_sq_no = sequence_of(desired);
+                write(*target, token, OCCUPIED | (++b.clock << STAMP_SHIFT) | update.txn_sq_no, &desired);
+                update.swapped = true;
+                return update;
+            }
+
+            /**
+             * @brief Removes a card from the cache.
+             * @return True if the token was cached.
+             */
+            bool erase(const uint64_t token) noexcept {
+                bucket& b = bucket_of(token);
+                const bucket_lock lock(b);
+                entry* target = locate(b, token);
+                if (target == nullptr) return false;
+                write(*target, 0, 0, nullptr);
+                return true;
+            }
+
+            //! The number of entries the cache can hold.
+            [[nodiscard]] size_t capacity() const noexcept { return bucket_count_ * WAYS; }
+
+        private:
+
+            static constexpr size_t PAYLOAD_WORDS = (sizeof(compact_card) + 7) / 8;
+            //! `meta` layout: bit 63 = occupied, bits 16-62 = write stamp (for eviction), bits 0-15 = txn_sq_no.
+            static constexpr uint64_t OCCUPIED = uint64_t{ 1 } << 63;
+            static constexpr unsigned STAMP_SHIFT = 16;
+            static constexpr uint64_t STAMP_MASK = (OCCUPIED - 1) >> STAMP_SHIFT;
+
+            struct alignas(64) entry {
+                //! Odd while a writer is updating the entry.
+                std::atomic<uint64_t> version{ 0 };
+                std::atomic<uint64_t> key{ 0 };
+                std::atomic<uint64_t> meta{ 0 };
+                // Word-sized atomics so that a reader racing a writer is well defined; the seqlock discards such reads.
+                std::atomic<uint64_t> payload[PAYLOAD_WORDS]{};
+            };
+
+            struct alignas(64) bucket {
+                //! Serializes writers of this bucket.
+                std::atomic<bool> locked{ false };
+                //! Counts writes to this bucket; the newest entry has the highest stamp. Only changed under `locked`.
+                uint64_t clock{ 0 };
+                std::array<entry, WAYS> entries;
+            };
+
+            class bucket_lock {
+            public:
+                explicit bucket_lock(bucket& b) noexcept : bucket_(b) {
+                    while (bucket_.locked.exchange(true, std::memory_order_acquire))
+                        while (bucket_.locked.load(std::memory_order_relaxed)) std::this_thread::yield();
+                }
+                ~bucket_lock() { bucket_.locked.store(false, std::memory_order_release); }
+                bucket_lock(const bucket_lock&) = delete;
+                bucket_lock& operator=(const bucket_lock&) = delete;
+            private:
+                bucket& bucket_;
+            };
+
+            [[nodiscard]] bucket& bucket_of(const uint64_t token) const noexcept {
+                // Tokens are often sequential; mix them so neighbouring tokens land in different buckets.
+                uint64_t h = token * 0x9E3779B97F4A7C15ULL;
+                h ^= h >> 32;
+                return buckets_[static_cast<size_t>(h) & (bucket_count_ - 1)];
+            }
+
+            //! Finds the entry of `token`. Called with the bucket locked, so plain relaxed loads are stable.
+            [[nodiscard]] static entry* locate(bucket& b, const uint64_t token) noexcept {
+                for (entry& e : b.entries)
+                    if ((e.meta.load(std::memory_order_relaxed) & OCCUPIED) != 0 && e.key.load(std::memory_order_relaxed) == token)
+                        return &e;
+                return nullptr;
+            }
+
+            //! Picks a free entry, or the least recently written one.
+            [[nodiscard]] static entry* victim(bucket& b) noexcept {
+                entry* oldest = &b.entries[0];
+                uint64_t oldest_stamp = STAMP_MASK;
+                for (entry& e : b.entries) {
+                    const uint64_t meta = e.meta.load(std::memory_order_relaxed);
+                    if ((meta & OCCUPIED) == 0) return &e;
+                    const uint64_t stamp = (meta >> STAMP_SHIFT) & STAMP_MASK;
+                    if (stamp < oldest_stamp) { oldest_stamp = stamp; oldest = &e; }
+                }
+                return oldest;
+            }
+
+            //! Publishes one entry under its sequence lock. `card` may be null to clear the entry.
+            static void write(entry& e, const uint64_t token, const uint64_t meta, const compact_card* card) noexcept {
+                uint64_t payload[PAYLOAD_WORDS]{};
+                if (card != nullptr) std::memcpy(payload, card, sizeof(compact_card));
+                const uint64_t version = e.version.load(std::memory_order_relaxed);
+                e.version.store(version + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+                e.key.store(token, std::memory_order_relaxed);
+                e.meta.store(meta, std::memory_order_relaxed);
+                for (size_t w = 0; w < PAYLOAD_WORDS; ++w) e.payload[w].store(payload[w], std::memory_order_relaxed);
+                e.version.store(version + 2, std::memory_order_release);
+            }
+
+            std::unique_ptr<bucket[]> buckets_;
+            size_t bucket_count_{ 0 };
+        };
+
+    }
+
+}
@@ -0,0 +1,514 @@
+/**
+ * @file open_loop_deny_list.h
+ * @brief A read-optimized, memory-mappable hot-card and terminal deny list with lock-free snapshot swaps.
+ * @details Every tap is checked against the operator's deny lists: millions of blocked card tokens, and
+ *          blocked terminals keyed by the 16-bit operator ID and 24-bit terminal ID that `csa::terminal`
+ *          and the OSA records carry. The lists are compiled by `deny::builder` into one flat image:
+ *          - a split-block Bloom filter in front of the card tokens, so that the common "not denied" answer
+ *            costs one 64-byte cache line;
+ *          - the card tokens, terminal keys and operator IDs as sorted 64-bit arrays, searched with a
+ *            branch-free binary search to confirm a filter hit.
+ *
+ *          The image is position-independent and little-endian, so the nightly file can be memory-mapped
+ *          as-is by `deny::snapshot::map()`. `deny::list` publishes snapshots through a reader-counted
+ *          double buffer: gates keep checking against the previous snapshot while the next one loads,
+ *          and taking a snapshot is a few lock-free atomic operations, never a lock.
+ *
+ * @author Govind Yadav
+ * @version 1.1
+ * @date 2025-09-08
+ */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "open_loop_pipeline.h"
+#include "open_loop_service.h"
+
+namespace open_loop {
+
+    namespace detail {
+
+        //! The SplitMix64 finalizer: a cheap bijective mix that spreads every input bit over the output.
+        [[nodiscard]] constexpr uint64_t mix64(uint64_t x) noexcept {
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+            return x ^ (x >> 31);
+        }
+
+    }
+
+    /**
+     * @namespace deny
+     * @brief Deny-list (hot list) lookups for card tokens, terminals and operators.
+     */
+    namespace deny {
+
+        //! Why a tap was denied. `none` means the tap may proceed.
+        enum class reason : uint8_t {
+            none = 0,
+            //! The card token is on the hot-card list.
+            card_token,
+            //! A terminal recorded on the card is blocked.
+            terminal,
+            //! An operator whose terminal is recorded on the card is blocked as a whole.
+            operator_id
+        };
+
+        //! Packs an operator ID and a 24-bit terminal ID into the key stored in the terminal array.
+        [[nodiscard]] constexpr uint64_t terminal_key(const uint16_t operator_id, const uint32_t terminal_id) noexcept {
+            return (static_cast<uint64_t>(operator_id) << 24) | (terminal_id & 0xFFFFFF);
+        }
+
+        /**
+         * @struct image_format
+         * @brief The on-disk layout shared by `builder` and `snapshot`.
+         *
+         * @details All integers are little-endian. The image is:
+         *          | Offset | Size            | Content                                                   |
+         *          |--------|-----------------|-----------------------------------------------------------|
+         *          | 0      | 4               | Magic `"DENY"`                                            |
+         *          | 4      | 4               | Format version (1)                                        |
+         *          | 8      | 8               | Generation, chosen by the publisher                       |
+         *          | 16     | 8 × 3           | Card, terminal and operator counts                        |
+         *          | 40     | 8               | Filter block count (a power of two, 0 when no cards)      |
+         *          | 48     | 8               | Checksum of everything after the header                   |
+         *          | 56     | 8               | Reserved (0)                                              |
+         *          | 64     | 64 × blocks     | Split-block Bloom filter over the card tokens             |
+         *          | ...    | 8 × counts      | Sorted card tokens, terminal keys, operator IDs           |
+         */
+        struct image_format {
+            static constexpr uint32_t MAGIC = 0x594E4544; // "DENY"
+            static constexpr uint32_t VERSION = 1;
+            static constexpr size_t HEADER_SIZE = 64;
+            static constexpr size_t BLOCK_SIZE = 64;
+            static constexpr size_t WORDS_PER_BLOCK = BLOCK_SIZE / 8;
+            //! Filter bits per card token. 16 bits keeps false positives near 0.1%.
+            static constexpr size_t BITS_PER_TOKEN = 16;
+
+            //! The block that holds a token's filter bits.
+            [[nodiscard]] static constexpr size_t block_of(const uint64_t hash, const uint64_t block_count) noexcept {
+                return static_cast<size_t>(hash & (block_count - 1));
+            }
+
+            //! The bit set in word `word` of the block; one bit per word, taken from the upper hash bits.
+            [[nodiscard]] static constexpr uint64_t bit_of(const uint64_t hash, const size_t word) noexcept {
+                return uint64_t{ 1 } << ((hash >> (16 + 6 * word)) & 63);
+            }
+        };
+
+        class builder;
+
+        /**
+         * @class snapshot
+         * @brief An immutable, read-only deny-list image with allocation-free lookups.
+         *
+         * @details A snapshot either owns its bytes (`from_bytes()`) or keeps a memory mapping of the image
+         *          file alive (`map()`). All lookups are `const`, `noexcept` and safe to run concurrently.
+         *          A default-constructed snapshot is empty and denies nothing.
+         *
+         * @usage
+         * @code
+         *     const deny::snapshot hot = deny::snapshot::map("/var/lib/gate/deny-2025-09-08.bin");
+         *     if (hot.check(csa::view(rx_buffer, 96, effective_date), card_token) != deny::reason::none) reject();
+         * @endcode
+         */
+        class snapshot {
+        public:
+
+            snapshot() = default;
+
+            /**
+             * @brief Adopts a deny-list image held in memory.
+             * @param image The bytes produced by `builder::build()`.
+             * @throws std::invalid_argument if the image is truncated, has the wrong magic or version, or fails its checksum.
+             */
+            [[nodiscard]] static snapshot from_bytes(std::vector<uint8_t> image) {
+                auto owned = std::make_shared<const std::vector<uint8_t>>(std::move(image));
+                const uint8_t* data = owned->data();
+                const size_t size = owned->size();
+                return snapshot(data, size, std::move(owned));
+            }
+
+            /**
+             * @brief Memory-maps a deny-list image file written by `builder::write()`.
+             * @param path The file to map. The mapping is advised for random access.
+             * @throws std::system_error if the file cannot be mapped; std::invalid_argument if its contents are malformed.
+             */
+            [[nodiscard]] static snapshot map(const std::string& path) {
+                auto file = std::make_shared<const pipeline::mapped_file>(path, pipeline::access_pattern::random);
+                const uint8_t* data = file->data();
+                const size_t size = file->size();
+                return snapshot(data, size, std::move(file));
+            }
+
+            //! True if `token` is on the hot-card list.
+            [[nodiscard]] bool contains_card(const uint64_t token) const noexcept {
+                if (card_count_ == 0) return false;
+                const uint64_t hash = detail::mix64(token);
+                const uint8_t* block = filter_ + image_format::block_of(hash, block_count_) * image_format::BLOCK_SIZE;
+                uint64_t missing = 0;
+                for (size_t w = 0; w < image_format::WORDS_PER_BLOCK; ++w) {
+                    const uint64_t bit = image_format::bit_of(hash, w);
+                    missing |= ~detail::read_u64_le(block + w * 8) & bit;
+                }
+                return missing == 0 && sorted_contains(cards_, card_count_, token);
+            }
+
+            //! True if the terminal `terminal_id` of operator `operator_id` is blocked.
+            [[nodiscard]] bool contains_terminal(const uint16_t operator_id, const uint32_t terminal_id) const noexcept {
+                return sorted_contains(terminals_, terminal_count_, terminal_key(operator_id, terminal_id));
+            }
+
+            //! True if every terminal of `operator_id` is blocked.
+            [[nodiscard]] bool contains_operator(const uint16_t operator_id) const noexcept {
+                return sorted_contains(operators_, operator_count_, operator_id);
+            }
+
+            /**
+             * @brief Checks one terminal against the terminal and operator lists.
+             * @return `reason::terminal`, `reason::operator_id`, or `reason::none`.
+             */
+            [[nodiscard]] reason check_terminal(const uint16_t operator_id, const uint32_t terminal_id) const noexcept {
+                if (contains_terminal(operator_id, terminal_id)) return reason::terminal;
+                if (contains_operator(operator_id)) return reason::operator_id;
+                return reason::none;
+            }
+
+            /**
+             * @brief Checks a CSA tap: the card token, then every terminal recorded on the card.
+             * @details The terminals of the validation block and of every populated log are read directly from
+             *          the viewed bytes; nothing is decoded or allocated.
+             * @param card The CSA being tapped.
+             * @param card_token The token of the payment card, as issued by the acquirer.
+             */
+            [[nodiscard]] reason check(const csa::view& card, const uint64_t card_token) const noexcept {
+                if (contains_card(card_token)) return reason::card_token;
+                const uint8_t* data = card.data();
+                const uint8_t* validation_terminal = data + csa::view::VALIDATION_TERMINAL_OFFSET;
+                if (!detail::is_zero_filled(data + csa::container::VALIDATION_OFFSET, csa::validation::DATA_SIZE))
+                    if (const reason r = check_raw_terminal(validation_terminal); r != reason::none) return r;
+                const size_t logs = card.get_log_count();
+                for (size_t i = 0; i < logs; ++i)
+                    if (const reason r = check_raw_terminal(data + csa::container::HISTORY_OFFSET + i * csa::history::LOG_SIZE_BYTES);
+                        r != reason::none) return r;
+                return reason::none;
+            }
+
+            /**
+             * @brief Checks an OSA tap: the card token, then the terminals recorded on the card.
+             * @details OSA records carry only the 24-bit terminal ID, so the operator is the gate's own.
+             * @param card The OSA being tapped.
+             * @param operator_id The operator that owns the OSA.
+             * @param card_token The token of the payment card, as issued by the acquirer.
+             */
+            [[nodiscard]] reason check(const osa::view& card, const uint16_t operator_id, const uint64_t card_token) const noexcept {
+                if (contains_card(card_token)) return reason::card_token;
+                if (contains_operator(operator_id)) return reason::operator_id;
+                const uint8_t* data = card.data();
+                constexpr size_t TERMINAL_POS = osa::view::VALIDATION_TERMINAL_OFFSET - osa::container::VALIDATION_OFFSET;
+                for (size_t i = 0; i <= osa::container::history_type::LOG_COUNT; ++i) {
+                    // Record 0 is the validation block; the history records follow it contiguously.
+                    const uint8_t* record = data + osa::container::VALIDATION_OFFSET + i * osa::transaction_record::DATA_SIZE;
+                    if (detail::is_zero_filled(record, osa::transaction_record::DATA_SIZE)) continue;
+                    if (contains_terminal(operator_id, detail::read_u24_be(record + TERMINAL_POS))) return reason::terminal;
+                }
+                return reason::none;
+            }
+
+            [[nodiscard]] uint64_t generation() const noexcept { return generation_; }
+            [[nodiscard]] size_t card_count() const noexcept { return card_count_; }
+            [[nodiscard]] size_t terminal_count() const noexcept { return terminal_count_; }
+            [[nodiscard]] size_t operator_count() const noexcept { return operator_count_; }
+
+        private:
+            friend class builder;
+
+            snapshot(const uint8_t* data, const size_t size, std::shared_ptr<const void> owner) : owner_(std::move(owner)) {
+                if (data == nullptr || size < image_format::HEADER_SIZE ||
+                    detail::read_u32_le(data) != image_format::MAGIC || detail::read_u32_le(data + 4) != image_format::VERSION)
+                    throw std::invalid_argument("Deny list image has an invalid header.");
+
+                generation_ = detail::read_u64_le(data + 8);
+                const uint64_t cards = detail::read_u64_le(data + 16);
+                const uint64_t terminals = detail::read_u64_le(data + 24);
+                const uint64_t operators = detail::read_u64_le(data + 32);
+                const uint64_t blocks = detail::read_u64_le(data + 40);
+                const uint64_t body = size - image_format::HEADER_SIZE;
+                // Bound every count by the body size first, so the size arithmetic below cannot overflow.
+                if (cards > body / 8 || terminals > body / 8 || operators > body / 8 || blocks > body / image_format::BLOCK_SIZE ||
+                    (blocks & (blocks - 1)) != 0 || ((cards == 0) != (blocks == 0)) ||
+                    blocks * image_format::BLOCK_SIZE + (cards + terminals + operators) * 8 != body)
+                    throw std::invalid_argument("Deny list image size does not match its header.");
+                if (detail::hash_card(data + image_format::HEADER_SIZE, static_cast<size_t>(body), static_cast<int64_t>(generation_)) !=
+                    detail::read_u64_le(data + 48))
+                    throw std::invalid_argument("Deny list image failed its checksum.");
+
+                card_count_ = static_cast<size_t>(cards);
+                terminal_count_ = static_cast<size_t>(terminals);
+                operator_count_ = static_cast<size_t>(operators);
+                block_count_ = blocks;
+                filter_ = data + image_format::HEADER_SIZE;
+                cards_ = filter_ + blocks * image_format::BLOCK_SIZE;
+                terminals_ = cards_ + card_count_ * 8;
+                operators_ = terminals_ + terminal_count_ * 8;
+            }
+
+            [[nodiscard]] reason check_raw_terminal(const uint8_t* terminal_bytes) const noexcept {
+                return check_terminal(detail::read_u16_be(terminal_bytes + 1), detail::read_u24_be(terminal_bytes + 3));
+            }
+
+            /**
+             * @brief Branch-free binary search over `count` sorted little-endian 64-bit values.
+             * @details The loop runs exactly ceil(log2(count)) times whatever the key, and the conditional
+             *          compiles to a select rather than a jump.
+             */
+            [[nodiscard]] static bool sorted_contains(const uint8_t* values, const size_t count, const uint64_t key) noexcept {
+                if (count == 0) return false;
+                size_t base = 0;
+                for (size_t n = count; n > 1; n -= n / 2) {
+                    const size_t half = n / 2;
+                    base = detail::read_u64_le(values + (base + half) * 8) <= key ? base + half : base;
+                }
+                return detail::read_u64_le(values + base * 8) == key;
+            }
+
+            [[nodiscard]] static std::vector<uint64_t> read_array(const uint8_t* values, const size_t count) {
+                std::vector<uint64_t> out(count);
+                for (size_t i = 0; i < count; ++i) out[i] = detail::read_u64_le(values + i * 8);
+                return out;
+            }
+
+            //! Keeps the bytes alive: either an owned vector or a memory mapping.
+            std::shared_ptr<const void> owner_;
+            uint64_t generation_{ 0 };
+            size_t card_count_{ 0 };
+            size_t terminal_count_{ 0 };
+            size_t operator_count_{ 0 };
+            uint64_t block_count_{ 0 };
+            const uint8_t* filter_{ nullptr };
+            const uint8_t* cards_{ nullptr };
+            const uint8_t* terminals_{ nullptr };
+            const uint8_t* operators_{ nullptr };
+        };
+
+        /**
+         * @class builder
+         * @brief Compiles deny-list entries, or a delta on top of an existing snapshot, into an image.
+         *
+         * @details Entries may be added in any order and more than once. Removals are applied after every
+         *          addition, so a delta that both adds and removes an entry leaves it out.
+         *
+         * @usage
+         * @code
+         *     deny::builder delta(*list.current());   // Start from tonight's snapshot...
+         *     delta.add_card(new_token).remove_card(cleared_token);
+         *     list.publish(std::make_shared<const deny::snapshot>(deny::snapshot::from_bytes(delta.build(generation + 1))));
+         * @endcode
+         */
+        class builder {
+        public:
+
+            builder() = default;
+
+            //! Starts from the entries of an existing snapshot, for delta updates.
+            explicit builder(const snapshot& base)
+                : cards_(snapshot::read_array(base.cards_, base.card_count_)),
+                  terminals_(snapshot::read_array(base.terminals_, base.terminal_count_)),
+                  operators_(snapshot::read_array(base.operators_, base.operator_count_)) {}
+
+            builder& add_card(const uint64_t token) { cards_.push_back(token); return *this; }
+            builder& remove_card(const uint64_t token) { removed_cards_.push_back(token); return *this; }
+
+            /**
+             * @brief Blocks one terminal.
+             * @param operator_id The terminal's operator.
+             * @param terminal_id The terminal ID. What to send: a value that fits in 24 bits.
+             * @throws std::out_of_range if `terminal_id` does not fit in 24 bits.
+             */
+            builder& add_terminal(const uint16_t operator_id, const uint32_t terminal_id) {
+                terminals_.push_back(checked_terminal_key(operator_id, terminal_id));
+                return *this;
+            }
+
+            builder& remove_terminal(const uint16_t operator_id, const uint32_t terminal_id) {
+                removed_terminals_.push_back(checked_terminal_key(operator_id, terminal_id));
+                return *this;
+            }
+
+            builder& add_operator(const uint16_t operator_id) { operators_.push_back(operator_id); return *this; }
+            builder& remove_operator(const uint16_t operator_id) { removed_operators_.push_back(operator_id); return *this; }
+
+            /**
+             * @brief Produces the image.
+             * @param generation A publisher-chosen version number stored in the image, e.g. a date or a counter.
+             * @return The bytes accepted by `snapshot::from_bytes()`.
+             */
+            [[nodiscard]] std::vector<uint8_t> build(const uint64_t generation) const {
+                const std::vector<uint64_t> cards = normalized(cards_, removed_cards_);
+                const std::vector<uint64_t> terminals = normalized(terminals_, removed_terminals_);
+                const std::vector<uint64_t> operators = normalized(operators_, removed_operators_);
+
+                uint64_t blocks = 0;
+                if (!cards.empty()) {
+                    const uint64_t needed = (cards.size() * image_format::BITS_PER_TOKEN + image_format::BLOCK_SIZE * 8 - 1) /
+                                            (image_format::BLOCK_SIZE * 8);
+                    blocks = 1;
+                    while (blocks < needed) blocks <<= 1;
+                }
+
+                std::vector<uint8_t> image(image_format::HEADER_SIZE + blocks * image_format::BLOCK_SIZE +
+                                           (cards.size() + terminals.size() + operators.size()) * 8, 0);
+                uint8_t* filter = image.data() + image_format::HEADER_SIZE;
+                for (const uint64_t token : cards) {
+                    const uint64_t hash = detail::mix64(token);
+                    uint8_t* block = filter + image_format::block_of(hash, blocks) * image_format::BLOCK_SIZE;
+                    for (size_t w = 0; w < image_format::WORDS_PER_BLOCK; ++w)
+                        detail::write_u64_le(block + w * 8, detail::read_u64_le(block + w * 8) | image_format::bit_of(hash, w));
+                }
+                uint8_t* out = filter + blocks * image_format::BLOCK_SIZE;
+                for (const std::vector<uint64_t>* values : { &cards, &terminals, &operators })
+                    for (const uint64_t value : *values) { detail::write_u64_le(out, value); out += 8; }
+
+                detail::write_u32_le(image.data(), image_format::MAGIC);
+                detail::write_u32_le(image.data() + 4, image_format::VERSION);
+                detail::write_u64_le(image.data() + 8, generation);
+                detail::write_u64_le(image.data() + 16, cards.size());
+                detail::write_u64_le(image.data() + 24, terminals.size());
+                detail::write_u64_le(image.data() + 32, operators.size());
+                detail::write_u64_le(image.data() + 40, blocks);
+                detail::write_u64_le(image.data() + 48, detail::hash_card(filter, image.size() - image_format::HEADER_SIZE,
+                                                                          static_cast<int64_t>(generation)));
+                return image;
+            }
+
+            /**
+             * @brief Builds the image and writes it to a file that `snapshot::map()` can open.
+             * @throws std::runtime_error if the file cannot be written.
+             */
+            void write(const std::string& path, const uint64_t generation) const {
+                const std::vector<uint8_t> image = build(generation);
+                std::ofstream out(path, std::ios::binary | std::ios::trunc);
+                out.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+                if (!out) throw std::runtime_error("Unable to write deny list image: " + path);
+            }
+
+        private:
+
+            [[nodiscard]] static uint64_t checked_terminal_key(const uint16_t operator_id, const uint32_t terminal_id) {
+                if (terminal_id > 0xFFFFFF) throw std::out_of_range("Terminal ID must fit in 24 bits.");
+                return terminal_key(operator_id, terminal_id);
+            }
+
+            //! Sorts and de-duplicates `values`, then drops every value in `removed`.
+            [[nodiscard]] static std::vector<uint64_t> normalized(std::vector<uint64_t> values, std::vector<uint64_t> removed) {
+                std::sort(values.begin(), values.end());
+                values.erase(std::unique(values.begin(), values.end()), values.end());
+                std::sort(removed.begin(), removed.end());
+                std::vector<uint64_t> out;
+                out.reserve(values.size());
+                std::set_difference(values.begin(), values.end(), removed.begin(), removed.end(), std::back_inserter(out));
+                return out;
+            }
+
+            std::vector<uint64_t> cards_, removed_cards_;
+            std::vector<uint64_t> terminals_, removed_terminals_;
+            std::vector<uint64_t> operators_, removed_operators_;
+        };
+
+        /**
+         * @class list
+         * @brief The currently published deny-list snapshot, swapped atomically.
+         *
+         * @details Readers call `current()` and check against the returned snapshot; a publisher builds or
+         *          maps the next snapshot off the tap path and installs it with `publish()`. A snapshot (with
+         *          its mapping) is released when the last reader drops it.
+         *
+         *          `std::atomic_load` on a `shared_ptr` is not lock-free in the common standard libraries (it
+         *          goes through a global mutex pool), so the published pointer lives in one of two slots
+         *          instead, each with a count of readers currently copying it:
+         *          - a reader announces itself on the active slot, re-checks that the slot is still active,
+         *            copies the `shared_ptr` (one atomic reference-count increment) and leaves;
+         *          - the publisher fills the inactive slot once its stragglers have left, flips the active
+         *            index, then waits for the old slot's readers to leave before releasing its pointer.
+         *
+         *          Readers only ever run atomic operations on lock-free integers and the reference count,
+         *          and retry only if a publish lands between their first two steps. Publishers are
+         *          serialized by a mutex and wait at most for readers that are mid-copy.
+         */
+        class list {
+        public:
+
+            //! Starts with an empty snapshot that denies nothing.
+            list() { slots_[0] = std::make_shared<const snapshot>(); }
+
+            explicit list(std::shared_ptr<const snapshot> initial) {
+                if (!initial) throw std::invalid_argument("Deny list snapshot must not be null.");
+                slots_[0] = std::move(initial);
+            }
+
+            list(const list&) = delete;
+            list& operator=(const list&) = delete;
+
+            //! The snapshot readers should check against. Never null.
+            [[nodiscard]] std::shared_ptr<const snapshot> current() const noexcept {
+                for (;;) {
+                    const unsigned i = active_.load(std::memory_order_seq_cst);
+                    readers_[i].fetch_add(1, std::memory_order_seq_cst);
+                    // Pairs with the publisher's flip-then-count: either we see the flip and back off,
+                    // or the publisher sees us and keeps the slot alive until we leave.
+                    if (active_.load(std::memory_order_seq_cst) == i) {
+                        std::shared_ptr<const snapshot> out = slots_[i];
+                        readers_[i].fetch_sub(1, std::memory_order_release);
+                        return out;
+                    }
+                    readers_[i].fetch_sub(1, std::memory_order_release);
+                }
+            }
+
+            /**
+             * @brief Atomically replaces the published snapshot.
+             * @param next What to send: a non-null snapshot, normally with a higher generation.
+             * @throws std::invalid_argument if `next` is null.
+             */
+            void publish(std::shared_ptr<const snapshot> next) {
+                if (!next) throw std::invalid_argument("Deny list snapshot must not be null.");
+                const std::lock_guard<std::mutex> lock(publish_mutex_);
+                const unsigned old = active_.load(std::memory_order_relaxed);
+                const unsigned fresh = old ^ 1u;
+                // Readers that backed off the previous flip may still be touching the inactive slot's count.
+                wait_for_readers(fresh);
+                slots_[fresh] = std::move(next);
+                active_.store(fresh, std::memory_order_seq_cst);
+                wait_for_readers(old);
+                // No reader can reach the old slot any more; holders of the old snapshot keep their own reference.
+                slots_[old].reset();
+            }
+
+        private:
+
+            void wait_for_readers(const unsigned slot) const noexcept {
+                while (readers_[slot].load(std::memory_order_seq_cst) != 0) std::this_thread::yield();
+            }
+
+            static_assert(std::atomic<unsigned>::is_always_lock_free, "The deny list slot counters must be lock-free.");
+
+            std::shared_ptr<const snapshot> slots_[2];
+            std::atomic<unsigned> active_{ 0 };
+            mutable std::atomic<unsigned> readers_[2]{ { 0 }, { 0 } };
+            std::mutex publish_mutex_;
+        };
+
+    }
+
+}
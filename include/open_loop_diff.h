@@ -0,0 +1,241 @@
+/**
+ * @file open_loop_diff.h
+ * @brief Field-level comparison of two raw card images, for clone, replay and rollback detection.
+ * @details A back office that keeps the last-known copy of every card can compare each upload against it
+ *          without parsing either image. `csa::diff()` and `osa::diff()` XOR the two images a machine word at
+ *          a time over each logical region of the layout (the same regions `patch_into()` writes) and return:
+ *          - a bitmask of the regions that differ, and
+ *          - how the history moved: unchanged, advanced by N `add_log()` calls, rolled back by N entries,
+ *            or rewritten in a way no sequence of taps explains.
+ *
+ *          A legitimate upload is normally `history_change::advanced`; `rolled_back` means the card shows an
+ *          older state than the server has already seen, which is the signature of a restored clone.
+ *
+ * @author Govind Yadav
+ * @version 1.1
+ * @date 2025-09-08
+ */
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include "open_loop_service.h"
+
+namespace open_loop {
+
+    /**
+     * @enum history_change
+     * @brief How the history block of one image relates to that of another.
+     */
+    enum class history_change : uint8_t {
+        //! Every history slot is byte-identical.
+        unchanged,
+        //! The later image holds `shift` new entries on top of the earlier one's, as `add_log()` would produce.
+        advanced,
+        //! The later image is the earlier one with its `shift` newest entries removed.
+        rolled_back,
+        //! Neither image's history is a shift of the other's. Also reported when every slot was replaced.
+        rewritten
+    };
+
+    [[nodiscard]] constexpr const char* to_string(const history_change change) noexcept {
+        switch (change) {
+            case history_change::unchanged:   return "unchanged";
+            case history_change::advanced:    return "advanced";
+            case history_change::rolled_back: return "rolled_back";
+            case history_change::rewritten:   return "rewritten";
+        }
+        return "unknown";
+    }
+
+    /**
+     * @struct card_diff
+     * @brief The result of comparing two card images with `csa::diff()` or `osa::diff()`.
+     * @details Bit `i` of `fields` corresponds to region `i` of the layout's `PATCH_REGIONS`; use
+     *          `csa::diff_mask` or `osa::diff_mask` to name them.
+     */
+    struct card_diff {
+        //! One bit per logical region that differs.
+        uint32_t fields{ 0 };
+        //! How the history moved from the earlier image to the later one.
+        history_change history{ history_change::unchanged };
+        //! The number of entries added (`advanced`) or removed (`rolled_back`); 0 otherwise.
+        size_t shift{ 0 };
+
+        [[nodiscard]] bool identical() const noexcept { return fields == 0; }
+        //! Returns true if any region in `mask` differs.
+        [[nodiscard]] bool differs(const uint32_t mask) const noexcept { return (fields & mask) != 0; }
+    };
+
+    namespace detail {
+
+        template <typename Word>
+        [[nodiscard]] inline Word xor_word(const uint8_t* a, const uint8_t* b) noexcept {
+            Word x;
+            Word y;
+            std::memcpy(&x, a, sizeof(Word));
+            std::memcpy(&y, b, sizeof(Word));
+            return x ^ y;
+        }
+
+        /**
+         * @brief Returns true if the `length` bytes at `a` and `b` differ.
+         * @details ORs the XOR of 8-byte words; the last word is loaded so that it ends at `length` and may
+         *          overlap the previous one, which is harmless because only a non-zero result matters.
+         *          Regions shorter than a word use two overlapping 4-byte loads, or single bytes.
+         */
+        [[nodiscard]] inline bool bytes_differ(const uint8_t* a, const uint8_t* b, const size_t length) noexcept {
+            if (length >= 8) {
+                uint64_t acc = xor_word<uint64_t>(a + length - 8, b + length - 8);
+                for (size_t i = 0; i + 8 <= length; i += 8) acc |= xor_word<uint64_t>(a + i, b + i);
+                return acc != 0;
+            }
+            if (length >= 4) return (xor_word<uint32_t>(a, b) | xor_word<uint32_t>(a + length - 4, b + length - 4)) != 0;
+            uint8_t acc = 0;
+            for (size_t i = 0; i < length; ++i) acc |= static_cast<uint8_t>(a[i] ^ b[i]);
+            return acc != 0;
+        }
+
+        //! Sets bit `i` for every region `i` of `regions` that differs between the two images.
+        template <size_t N>
+        [[nodiscard]] inline uint32_t differing_regions(const std::array<byte_range, N>& regions, const uint8_t* a, const uint8_t* b) noexcept {
+            static_assert(N <= 32, "A card_diff field mask holds at most 32 regions.");
+            uint32_t fields = 0;
+            for (size_t i = 0; i < N; ++i) {
+                if (bytes_differ(a + regions[i].offset, b + regions[i].offset, regions[i].length)) fields |= 1u << i;
+            }
+            return fields;
+        }
+
+        /**
+         * @brief Classifies how a newest-first history of `Records` fixed-size entries moved between two images.
+         * @details `add_log()` pushes every entry one slot down, so `after` advanced by `k` exactly when its slots
+         *          `[k, Records)` equal `before`'s slots `[0, Records - k)`; each test is one contiguous comparison.
+         *          The smallest shift that matches wins, and advances are preferred over rollbacks.
+         */
+        template <size_t Records>
+        inline void classify_history(const uint8_t* before, const uint8_t* after, const size_t record_size, card_diff& out) noexcept {
+            if (!bytes_differ(before, after, Records * record_size)) return;
+            for (size_t k = 1; k < Records; ++k) {
+                const size_t kept = (Records - k) * record_size;
+                if (!bytes_differ(after + (k * record_size), before, kept)) {
+                    out.history = history_change::advanced;
+                    out.shift = k;
+                    return;
+                }
+            }
+            for (size_t k = 1; k < Records; ++k) {
+                const size_t kept = (Records - k) * record_size;
+                if (!bytes_differ(before + (k * record_size), after, kept)) {
+                    out.history = history_change::rolled_back;
+                    out.shift = k;
+                    return;
+                }
+            }
+            out.history = history_change::rewritten;
+        }
+
+    }
+
+    namespace csa {
+
+        /**
+         * @struct diff_mask
+         * @brief Names the bits of `card_diff::fields` for a CSA image.
+         */
+        struct diff_mask {
+            static constexpr uint32_t GENERAL = 1u << 0;
+            static constexpr uint32_t VALIDATION = 1u << 1;
+            //! Any of the four log slots.
+            static constexpr uint32_t HISTORY = 0xFu << 2;
+            static constexpr uint32_t RFU = 1u << 6;
+
+            //! The bit of one log slot. What to send: `slot` in [0, 3], where 0 is the newest.
+            [[nodiscard]] static constexpr uint32_t log(const size_t slot) noexcept { return 1u << (2 + slot); }
+        };
+
+        /**
+         * @brief Compares two raw 96-byte CSA images region by region, without parsing either.
+         * @param before The earlier image, e.g. the server's last-known copy. What to send: 96 readable bytes.
+         * @param after The later image, e.g. the card as just uploaded. What to send: 96 readable bytes.
+         * @return The differing regions and the history movement from `before` to `after`.
+         *
+         * @usage
+         * @code
+         *     const card_diff d = csa::diff(server_copy.data(), upload.data());
+         *     if (d.history == history_change::rolled_back) flag_possible_clone(token, d.shift);
+         *     else if (d.differs(csa::diff_mask::RFU)) flag_tampering(token);
+         * @endcode
+         */
+        [[nodiscard]] inline card_diff diff(const uint8_t* before, const uint8_t* after) noexcept {
+            card_diff out;
+            out.fields = detail::differing_regions(container::PATCH_REGIONS, before, after);
+            if (out.differs(diff_mask::HISTORY)) {
+                detail::classify_history<history::LOG_COUNT>(before + container::HISTORY_OFFSET, after + container::HISTORY_OFFSET,
+                                                             history::LOG_SIZE_BYTES, out);
+            }
+            return out;
+        }
+
+        //! Compares the canonical images of two containers. See `diff(const uint8_t*, const uint8_t*)`.
+        [[nodiscard]] inline card_diff diff(const container& before, const container& after) noexcept {
+            return diff(before.to_array().data(), after.to_array().data());
+        }
+
+    }
+
+    namespace osa {
+
+        /**
+         * @struct basic_diff_mask
+         * @brief Names the bits of `card_diff::fields` for an OSA image of a given layout.
+         */
+        template <typename Layout>
+        struct basic_diff_mask {
+            static constexpr size_t RECORDS = Layout::HISTORY_RECORDS;
+            static constexpr size_t PASSES = Layout::NUM_TRIP_PASSES;
+
+            static constexpr uint32_t GENERAL = 1u << 0;
+            static constexpr uint32_t VALIDATION = 1u << 1;
+            //! Any history record.
+            static constexpr uint32_t HISTORY = ((1u << RECORDS) - 1) << 2;
+            //! Any trip pass.
+            static constexpr uint32_t TRIP_PASSES = ((1u << PASSES) - 1) << (2 + RECORDS);
+            static constexpr uint32_t PADDING = 1u << (2 + RECORDS + PASSES);
+
+            //! The bit of one history record. What to send: `slot` below `RECORDS`, where 0 is the newest.
+            [[nodiscard]] static constexpr uint32_t record(const size_t slot) noexcept { return 1u << (2 + slot); }
+            //! The bit of one trip pass. What to send: `index` below `PASSES`.
+            [[nodiscard]] static constexpr uint32_t trip_pass(const size_t index) noexcept { return 1u << (2 + RECORDS + index); }
+        };
+
+        using diff_mask = basic_diff_mask<standard_layout>;
+
+        /**
+         * @brief Compares two raw 96-byte OSA images region by region, without parsing either.
+         * @tparam Layout The OSA layout of both images.
+         * @param before The earlier image. What to send: 96 readable bytes.
+         * @param after The later image. What to send: 96 readable bytes.
+         * @return The differing regions (see `basic_diff_mask<Layout>`) and the history movement.
+         */
+        template <typename Layout = standard_layout>
+        [[nodiscard]] card_diff diff(const uint8_t* before, const uint8_t* after) noexcept {
+            using card = basic_container<Layout>;
+            card_diff out;
+            out.fields = detail::differing_regions(card::PATCH_REGIONS, before, after);
+            if (out.differs(basic_diff_mask<Layout>::HISTORY)) {
+                detail::classify_history<Layout::HISTORY_RECORDS>(before + card::HISTORY_OFFSET, after + card::HISTORY_OFFSET,
+                                                                  card::history_type::LOG_SIZE_BYTES, out);
+            }
+            return out;
+        }
+
+        //! Compares the canonical images of two containers. See `diff(const uint8_t*, const uint8_t*)`.
+        template <typename Layout>
+        [[nodiscard]] card_diff diff(const basic_container<Layout>& before, const basic_container<Layout>& after) noexcept {
+            return diff<Layout>(before.to_array().data(), after.to_array().data());
+        }
+
+    }
+
+}
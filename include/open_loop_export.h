@@ -0,0 +1,371 @@
+/**
+ * @file open_loop_export.h
+ * @brief A de-duplicating, column-oriented export format for CSA history logs.
+ * @details A CSA carries its four newest logs, so every upload of a card repeats up to three logs the data
+ *          warehouse has already ingested. `csa::log_exporter` remembers the newest `txn_sq_no` exported per
+ *          card token and emits only logs after it. Exported logs are gathered into blocks and written
+ *          column by column:
+ *          - terminals through a per-block dictionary;
+ *          - card tokens, log times (in whole minutes, the on-card resolution), balances and sequence
+ *            numbers as zig-zag deltas from the previous row;
+ *          - amounts as plain varints, and statuses as packed nibbles.
+ *
+ *          Consecutive rows usually belong to the same card, so most deltas fit in a single byte.
+ *          `csa::log_block_reader` decodes a stream of blocks back into rows.
+ *
+ * @author Govind Yadav
+ * @version 1.1
+ * @date 2025-09-08
+ */
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+#include "open_loop_service.h"
+
+namespace open_loop {
+
+    namespace csa {
+
+        /**
+         * @struct log_row
+         * @brief One exported history log, with the card it was read from.
+         */
+        struct log_row {
+            uint64_t card_token{ 0 };
+            uint8_t acquirer_id{ 0 };
+            uint16_t operator_id{ 0 };
+            uint32_t terminal_id{ 0 };
+            //! The absolute log time in milliseconds since the Unix epoch (always a whole minute).
+            uint64_t time_in_milliseconds{ 0 };
+            uint16_t txn_amount{ 0 };
+            uint32_t card_balance{ 0 };
+            uint16_t txn_sq_no{ 0 };
+            txn_status status{ txn_status::EXIT };
+
+            friend bool operator==(const log_row& lhs, const log_row& rhs) noexcept {
+                return lhs.card_token == rhs.card_token && lhs.acquirer_id == rhs.acquirer_id &&
+                       lhs.operator_id == rhs.operator_id && lhs.terminal_id == rhs.terminal_id &&
+                       lhs.time_in_milliseconds == rhs.time_in_milliseconds && lhs.txn_amount == rhs.txn_amount &&
+                       lhs.card_balance == rhs.card_balance && lhs.txn_sq_no == rhs.txn_sq_no && lhs.status == rhs.status;
+            }
+            friend bool operator!=(const log_row& lhs, const log_row& rhs) noexcept { return !(lhs == rhs); }
+        };
+
+        /**
+         * @struct log_block_format
+         * @brief The block framing and integer encodings shared by `log_exporter` and `log_block_reader`.
+         *
+         * @details A stream is a sequence of blocks: a 12-byte frame (magic `"OLLX"`, payload size and payload
+         *          checksum, all little-endian `uint32_t`), then the payload:
+         *          row count, dictionary size, dictionary terminal keys, then the columns
+         *          `card_token`, `time`, `terminal`, `txn_amount`, `card_balance` and `txn_sq_no` of all rows, and
+         *          finally the statuses as packed nibbles. Every integer in the payload is a LEB128 varint.
+         */
+        struct log_block_format {
+            static constexpr uint32_t MAGIC = 0x584C4C4F; // "OLLX"
+            static constexpr size_t FRAME_SIZE = 12;
+
+            //! Packs a terminal into the 48-bit dictionary key: acquirer, operator, terminal ID.
+            [[nodiscard]] static constexpr uint64_t terminal_key(const uint8_t acquirer_id, const uint16_t operator_id, const uint32_t terminal_id) noexcept {
+                return (static_cast<uint64_t>(acquirer_id) << 40) | (static_cast<uint64_t>(operator_id) << 24) | (terminal_id & 0xFFFFFF);
+            }
+
+            [[nodiscard]] static constexpr uint64_t zigzag(const int64_t value) noexcept {
+                return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+            }
+
+            [[nodiscard]] static constexpr int64_t unzigzag(const uint64_t value) noexcept {
+                return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+            }
+
+            static void put_varint(std::vector<uint8_t>& out, uint64_t value) {
+                while (value >= 0x80) {
+                    out.push_back(static_cast<uint8_t>(value | 0x80));
+                    value >>= 7;
+                }
+                out.push_back(static_cast<uint8_t>(value));
+            }
+
+            //! Decodes one varint, advancing `p`. @throws std::invalid_argument if it runs past `end` or is too long.
+            [[nodiscard]] static uint64_t get_varint(const uint8_t*& p, const uint8_t* end) {
+                uint64_t value = 0;
+                for (unsigned shift = 0; shift < 64; shift += 7) {
+                    if (p == end) throw std::invalid_argument("Log export block is truncated.");
+                    const uint8_t byte = *p++;
+                    value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                    if ((byte & 0x80) == 0) return value;
+                }
+                throw std::invalid_argument("Log export block has an overlong varint.");
+            }
+
+            [[nodiscard]] static uint32_t checksum(const uint8_t* payload, const size_t size) noexcept {
+                const uint64_t h = detail::hash_card(payload, size, static_cast<int64_t>(MAGIC));
+                return static_cast<uint32_t>(h ^ (h >> 32));
+            }
+        };
+
+        /**
+         * @class log_exporter
+         * @brief Collects the logs of uploaded cards, skips the ones already exported, and writes column blocks.
+         *
+         * @details A log is new for a card when its `txn_sq_no` is after the card's watermark, comparing in
+         *          16-bit serial-number arithmetic so the counter may wrap. Watermarks live for the exporter's
+         *          lifetime; seed them with `set_watermark()` to continue from a previous export run.
+         *
+         *          Logs are exported oldest first, so each card's rows are chronological. The column buffers are
+         *          reused from block to block.
+         *
+         * @usage
+         * @code
+         *     std::ofstream out("logs-2025-09-08.ollx", std::ios::binary);
+         *     csa::log_exporter exporter(out);
+         *     for (const upload& u : uploads) exporter.add(u.card_token, csa::view(u.image, 96, u.effective_date));
+         *     exporter.finish();
+         * @endcode
+         */
+        class log_exporter {
+        public:
+
+            /**
+             * @brief Creates an exporter writing to `out`.
+             * @param out The destination stream. What to send: a stream opened in binary mode.
+             * @param block_rows The number of rows per block. Larger blocks share dictionaries better.
+             * @throws std::invalid_argument if `block_rows` is 0.
+             */
+            explicit log_exporter(std::ostream& out, const size_t block_rows = 4096) : out_(out), block_rows_(block_rows) {
+                if (block_rows == 0) throw std::invalid_argument("Log export block size must be greater than zero.");
+                rows_.reserve(block_rows);
+            }
+
+            ~log_exporter() {
+                try { finish(); } catch (...) {}
+            }
+
+            log_exporter(const log_exporter&) = delete;
+            log_exporter& operator=(const log_exporter&) = delete;
+
+            /**
+             * @brief Exports the new logs of one uploaded card.
+             * @param card_token The token identifying the card.
+             * @param card The uploaded CSA.
+             * @return The number of logs exported; the rest were already seen.
+             */
+            size_t add(const uint64_t card_token, const view& card) {
+                const size_t logs = card.get_log_count();
+                if (logs == 0) return 0;
+                const auto known = watermarks_.find(card_token);
+                size_t exported = 0;
+                for (size_t i = logs; i-- > 0;) {
+                    const uint8_t* slot = card.data() + container::HISTORY_OFFSET + i * history::LOG_SIZE_BYTES;
+                    const uint16_t sq_no = card.get_log_txn_sq_no(i);
+                    if (known != watermarks_.end() && !is_after(sq_no, known->second)) {
+                        ++skipped_;
+                        continue;
+                    }
+                    log_row row;
+                    row.card_token = card_token;
+                    row.acquirer_id = slot[0];
+                    row.operator_id = detail::read_u16_be(slot + 1);
+                    row.terminal_id = detail::read_u24_be(slot + 3);
+                    row.time_in_milliseconds = card.get_log_date_and_time(i);
+                    row.txn_amount = card.get_log_txn_amount(i);
+                    row.card_balance = card.get_log_card_balance(i);
+                    row.txn_sq_no = sq_no;
+                    row.status = card.get_log_txn_status(i);
+                    push(row);
+                    ++exported;
+                }
+                // The newest log (slot 0) carries the card's current sequence number. A stale upload of an
+                // older card image must not move the watermark back.
+                const uint16_t newest = card.get_log_txn_sq_no(0);
+                if (known == watermarks_.end()) watermarks_.emplace(card_token, newest);
+                else if (is_after(newest, known->second)) known->second = newest;
+                return exported;
+            }
+
+            //! Exports the new logs of a decoded card. @throws std::logic_error if its effective date is not set.
+            size_t add(const uint64_t card_token, const container& card) {
+                const std::array<uint8_t, container::TOTAL_SIZE> image = card.to_array();
+                return add(card_token, view(image.data(), image.size(), card.get_card_effective_date()));
+            }
+
+            //! Treats every log of `card_token` up to and including `txn_sq_no` as already exported.
+            void set_watermark(const uint64_t card_token, const uint16_t txn_sq_no) { watermarks_[card_token] = txn_sq_no; }
+
+            //! Writes the rows gathered so far as a (possibly short) block. @throws std::runtime_error on a write failure.
+            void finish() {
+                if (!rows_.empty()) write_block();
+                out_.flush();
+                if (!out_) throw std::runtime_error("Unable to write log export.");
+            }
+
+            [[nodiscard]] size_t rows_exported() const noexcept { return exported_; }
+            [[nodiscard]] size_t rows_skipped() const noexcept { return skipped_; }
+            [[nodiscard]] size_t bytes_written() const noexcept { return bytes_written_; }
+
+        private:
+
+            //! True if `sq_no` comes after `watermark` in 16-bit serial-number order.
+            [[nodiscard]] static bool is_after(const uint16_t sq_no, const uint16_t watermark) noexcept {
+                return static_cast<int16_t>(static_cast<uint16_t>(sq_no - watermark)) > 0;
+            }
+
+            void push(const log_row& row) {
+                rows_.push_back(row);
+                ++exported_;
+                if (rows_.size() == block_rows_) write_block();
+            }
+
+            void write_block() {
+                using fmt = log_block_format;
+                dictionary_.clear();
+                dictionary_index_.clear();
+                terminals_.clear();
+                for (const log_row& row : rows_) {
+                    const uint64_t key = fmt::terminal_key(row.acquirer_id, row.operator_id, row.terminal_id);
+                    const auto inserted = dictionary_index_.emplace(key, dictionary_.size());
+                    if (inserted.second) dictionary_.push_back(key);
+                    terminals_.push_back(inserted.first->second);
+                }
+
+                payload_.clear();
+                fmt::put_varint(payload_, rows_.size());
+                fmt::put_varint(payload_, dictionary_.size());
+                for (const uint64_t key : dictionary_) fmt::put_varint(payload_, key);
+
+                uint64_t previous = 0;
+                for (const log_row& row : rows_) {
+                    fmt::put_varint(payload_, fmt::zigzag(static_cast<int64_t>(row.card_token - previous)));
+                    previous = row.card_token;
+                }
+                previous = 0;
+                for (const log_row& row : rows_) {
+                    const uint64_t minutes = row.time_in_milliseconds / effective_epoch::MILLISECONDS_PER_MINUTE;
+                    fmt::put_varint(payload_, fmt::zigzag(static_cast<int64_t>(minutes - previous)));
+                    previous = minutes;
+                }
+                for (const uint64_t terminal : terminals_) fmt::put_varint(payload_, terminal);
+                for (const log_row& row : rows_) fmt::put_varint(payload_, row.txn_amount);
+                previous = 0;
+                for (const log_row& row : rows_) {
+                    fmt::put_varint(payload_, fmt::zigzag(static_cast<int64_t>(row.card_balance) - static_cast<int64_t>(previous)));
+                    previous = row.card_balance;
+                }
+                uint16_t previous_sq = 0;
+                for (const log_row& row : rows_) {
+                    fmt::put_varint(payload_, fmt::zigzag(static_cast<int16_t>(static_cast<uint16_t>(row.txn_sq_no - previous_sq))));
+                    previous_sq = row.txn_sq_no;
+                }
+                for (size_t i = 0; i < rows_.size(); i += 2) {
+                    const uint8_t low = static_cast<uint8_t>(rows_[i].status) & 0x0F;
+                    const uint8_t high = i + 1 < rows_.size() ? static_cast<uint8_t>(static_cast<uint8_t>(rows_[i + 1].status) << 4) : uint8_t{ 0 };
+                    payload_.push_back(static_cast<uint8_t>(low | high));
+                }
+
+                uint8_t frame[fmt::FRAME_SIZE];
+                detail::write_u32_le(frame, fmt::MAGIC);
+                detail::write_u32_le(frame + 4, static_cast<uint32_t>(payload_.size()));
+                detail::write_u32_le(frame + 8, fmt::checksum(payload_.data(), payload_.size()));
+                out_.write(reinterpret_cast<const char*>(frame), sizeof(frame));
+                out_.write(reinterpret_cast<const char*>(payload_.data()), static_cast<std::streamsize>(payload_.size()));
+                if (!out_) throw std::runtime_error("Unable to write log export.");
+                bytes_written_ += sizeof(frame) + payload_.size();
+                rows_.clear();
+            }
+
+            std::ostream& out_;
+            size_t block_rows_;
+            std::unordered_map<uint64_t, uint16_t> watermarks_;
+            std::vector<log_row> rows_;
+            std::vector<uint64_t> dictionary_;
+            std::unordered_map<uint64_t, uint64_t> dictionary_index_;
+            std::vector<uint64_t> terminals_;
+            std::vector<uint8_t> payload_;
+            size_t exported_{ 0 };
+            size_t skipped_{ 0 };
+            size_t bytes_written_{ 0 };
+        };
+
+        /**
+         * @class log_block_reader
+         * @brief Decodes a stream written by `log_exporter`.
+         */
+        class log_block_reader {
+        public:
+
+            /**
+             * @brief Decodes every block in `data`.
+             * @param data The exported bytes.
+             * @param size The number of bytes at `data`.
+             * @return All rows, in export order.
+             * @throws std::invalid_argument if a block is truncated, has a bad frame or fails its checksum.
+             */
+            [[nodiscard]] static std::vector<log_row> decode(const uint8_t* data, const size_t size) {
+                using fmt = log_block_format;
+                std::vector<log_row> rows;
+                const uint8_t* p = data;
+                const uint8_t* const end = data + size;
+                while (p != end) {
+                    if (static_cast<size_t>(end - p) < fmt::FRAME_SIZE || detail::read_u32_le(p) != fmt::MAGIC)
+                        throw std::invalid_argument("Log export block has an invalid frame.");
+                    const size_t payload_size = detail::read_u32_le(p + 4);
+                    const uint32_t expected = detail::read_u32_le(p + 8);
+                    p += fmt::FRAME_SIZE;
+                    if (static_cast<size_t>(end - p) < payload_size) throw std::invalid_argument("Log export block is truncated.");
+                    if (fmt::checksum(p, payload_size) != expected) throw std::invalid_argument("Log export block failed its checksum.");
+                    decode_block(p, p + payload_size, rows);
+                    p += payload_size;
+                }
+                return rows;
+            }
+
+        private:
+
+            static void decode_block(const uint8_t* p, const uint8_t* end, std::vector<log_row>& rows) {
+                using fmt = log_block_format;
+                const uint64_t count = fmt::get_varint(p, end);
+                const uint64_t dictionary_size = fmt::get_varint(p, end);
+                // Every row and dictionary entry takes at least one byte, which bounds both counts.
+                if (count > static_cast<uint64_t>(end - p) || dictionary_size > static_cast<uint64_t>(end - p))
+                    throw std::invalid_argument("Log export block is truncated.");
+                std::vector<uint64_t> dictionary(static_cast<size_t>(dictionary_size));
+                for (uint64_t& key : dictionary) key = fmt::get_varint(p, end);
+
+                const size_t first = rows.size();
+                rows.resize(first + static_cast<size_t>(count));
+                log_row* block = rows.data() + first;
+
+                uint64_t previous = 0;
+                for (size_t i = 0; i < count; ++i) block[i].card_token = previous += static_cast<uint64_t>(fmt::unzigzag(fmt::get_varint(p, end)));
+                previous = 0;
+                for (size_t i = 0; i < count; ++i) {
+                    previous += static_cast<uint64_t>(fmt::unzigzag(fmt::get_varint(p, end)));
+                    block[i].time_in_milliseconds = previous * effective_epoch::MILLISECONDS_PER_MINUTE;
+                }
+                for (size_t i = 0; i < count; ++i) {
+                    const uint64_t terminal = fmt::get_varint(p, end);
+                    if (terminal >= dictionary.size()) throw std::invalid_argument("Log export block references an unknown terminal.");
+                    const uint64_t key = dictionary[static_cast<size_t>(terminal)];
+                    block[i].acquirer_id = static_cast<uint8_t>(key >> 40);
+                    block[i].operator_id = static_cast<uint16_t>(key >> 24);
+                    block[i].terminal_id = static_cast<uint32_t>(key & 0xFFFFFF);
+                }
+                for (size_t i = 0; i < count; ++i) block[i].txn_amount = static_cast<uint16_t>(fmt::get_varint(p, end));
+                int64_t balance = 0;
+                for (size_t i = 0; i < count; ++i) block[i].card_balance = static_cast<uint32_t>(balance += fmt::unzigzag(fmt::get_varint(p, end)));
+                uint16_t sq_no = 0;
+                for (size_t i = 0; i < count; ++i) block[i].txn_sq_no = sq_no = static_cast<uint16_t>(sq_no + fmt::unzigzag(fmt::get_varint(p, end)));
+                if (static_cast<uint64_t>(end - p) != (count + 1) / 2) throw std::invalid_argument("Log export block has a malformed status column.");
+                for (size_t i = 0; i < count; ++i) block[i].status = static_cast<txn_status>((p[i / 2] >> ((i & 1) * 4)) & 0x0F);
+            }
+        };
+
+    }
+
+}
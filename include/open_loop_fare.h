@@ -0,0 +1,307 @@
+/**
+ * @file open_loop_fare.h
+ * @brief Flat, precompiled fare and transfer rule tables evaluated directly against a CSA.
+ * @details Fare computation needs the route and operator of the tap, the previous leg recorded in the CSA
+ *          validation block and the timestamps of the logs (for transfer windows). `csa::fare_table` compiles
+ *          the operator's rules once into a minimal-space perfect hash table keyed by
+ *          `(operator_id, route_number)`, so every lookup is two hashes and one probe. The
+ *          evaluator reads the fixed number of card fields it needs from a `csa::view` or a `csa::container`
+ *          and prices the tap in constant time.
+ *
+ * @author Govind Yadav
+ * @version 1.1
+ * @date 2025-09-08
+ */
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "open_loop_service.h"
+
+namespace open_loop {
+
+    namespace csa {
+
+        /**
+         * @struct fare_rule
+         * @brief The price of riding one route of one operator, and how it combines with earlier legs.
+         */
+        struct fare_rule {
+            uint16_t operator_id{ 0 };
+            uint16_t route_number{ 0 };
+            //! The fare of a leg that is not a transfer.
+            uint16_t base_fare{ 0 };
+            //! The fare charged instead of `base_fare` when the leg is a transfer.
+            uint16_t transfer_fare{ 0 };
+            //! How long after the previous leg a transfer is allowed, in minutes. 0 disables transfers onto this route.
+            uint16_t transfer_window_minutes{ 0 };
+            //! The maximum number of transfers within one window (legs after the first).
+            uint8_t max_transfers{ 0 };
+            //! Routes sharing a non-zero group transfer to each other. 0 means "no transfers".
+            uint8_t transfer_group{ 0 };
+        };
+
+        /**
+         * @struct fare_quote
+         * @brief The result of pricing one tap with `fare_table::evaluate()`.
+         */
+        struct fare_quote {
+            //! `status_code::ok`, `no_fare_rule`, or a time encoding error for the tap time.
+            status_code status{ status_code::ok };
+            //! The fare to charge. 0 on failure.
+            uint16_t fare{ 0 };
+            //! True if `fare` is the rule's transfer fare.
+            bool transfer{ false };
+            //! The number of logged legs that fall inside the transfer window (before this tap).
+            uint8_t legs_in_window{ 0 };
+
+            [[nodiscard]] bool ok() const noexcept { return status == status_code::ok; }
+        };
+
+        /**
+         * @class fare_table
+         * @brief An immutable, cache-friendly table of `fare_rule`s with constant-time evaluation.
+         *
+         * @details **Lookup.** Keys `(operator_id << 16) | route_number` are placed by hash-and-displace
+         *          (CHD): a first hash splits the keys into buckets of about four, and each bucket stores
+         *          a displacement that sends all of its keys to free slots of a flat power-of-two array.
+         *          Buckets are placed largest first, which is what keeps the array at a fixed load factor
+         *          (at most 0.8) for any key set. A lookup hashes the key, reads its bucket's displacement
+         *          and probes exactly one slot.
+         *
+         *          **Transfers.** A tap on route R is a transfer when:
+         *          - R's rule has a non-zero `transfer_group` and `transfer_window_minutes`;
+         *          - the card's validation block records a previous leg on a *different* route whose rule has
+         *            the same group, no more than the window before the tap;
+         *          - no more than `max_transfers` logged legs fall inside the window before the tap.
+         *
+         *          Only the validation block and the (at most four) log timestamps are read, so evaluation
+         *          cost does not depend on the table size or the card contents.
+         *
+         * @usage
+         * @code
+         *     const csa::fare_table fares({
+         *         { 1000, 12, 2500, 500, 90, 2, 1 },   // Operator 1000, route 12: 25.00, transfers for 5.00
+         *         { 1000, 40, 3000, 500, 90, 2, 1 },
+         *     });
+         *     const csa::fare_quote q = fares.evaluate(csa::view(rx_buffer, 96, effective_date), 1000, 40, now_ms);
+         * @endcode
+         */
+        class fare_table {
+        public:
+
+            /**
+             * @brief Compiles a set of rules into the lookup table.
+             * @param rules The rules. What to send: at most one rule per `(operator_id, route_number)`.
+             * @throws std::invalid_argument if two rules share the same operator and route.
+             */
+            explicit fare_table(const std::vector<fare_rule>& rules) : size_(rules.size()) {
+                std::vector<uint32_t> keys(rules.size());
+                std::transform(rules.begin(), rules.end(), keys.begin(), key_of);
+                std::sort(keys.begin(), keys.end());
+                if (std::adjacent_find(keys.begin(), keys.end()) != keys.end())
+                    throw std::invalid_argument("Fare rules must have unique (operator, route) pairs.");
+
+                // About four keys per bucket, and a slot array at a load factor of at most 0.8.
+                unsigned bucket_bits = 1;
+                while ((size_t{ 1 } << bucket_bits) * KEYS_PER_BUCKET < rules.size()) ++bucket_bits;
+                bucket_shift_ = 64 - bucket_bits;
+                unsigned slot_bits = 0;
+                while ((size_t{ 1 } << slot_bits) < rules.size() + (rules.size() + 3) / 4) ++slot_bits;
+                // Placement at this load practically never exhausts the displacements; grow if it does.
+                while (!try_place(rules, size_t{ 1 } << bucket_bits, size_t{ 1 } << slot_bits)) ++slot_bits;
+            }
+
+            /**
+             * @brief Looks up the rule of one route.
+             * @return A pointer into the table, or `nullptr` if no rule exists. Valid for the table's lifetime.
+             */
+            [[nodiscard]] const fare_rule* find(const uint16_t operator_id, const uint16_t route_number) const noexcept {
+                const uint32_t key = (static_cast<uint32_t>(operator_id) << 16) | route_number;
+                const slot& s = slots_[slot_of(key, displacements_[bucket_of(key)])];
+                return (s.used && key_of(s.rule) == key) ? &s.rule : nullptr;
+            }
+
+            /**
+             * @brief Prices a tap against a zero-copy view of the card.
+             * @param card The CSA before the tap.
+             * @param operator_id The operator of the tapping terminal.
+             * @param route_number The route being boarded.
+             * @param time_in_milliseconds The tap time in milliseconds since the Unix epoch.
+             */
+            [[nodiscard]] fare_quote evaluate(const view& card, const uint16_t operator_id, const uint16_t route_number,
+                                              const uint64_t time_in_milliseconds) const noexcept {
+                card_legs legs;
+                legs.epoch = effective_epoch(card.get_card_effective_date());
+                legs.has_previous = !detail::is_zero_filled(card.data() + container::VALIDATION_OFFSET, validation::DATA_SIZE);
+                legs.previous_operator = card.get_validation_operator_id();
+                legs.previous_route = card.get_validation_route_number();
+                legs.previous_time = card.get_validation_date_and_time();
+                legs.log_count = card.get_log_count();
+                for (size_t i = 0; i < legs.log_count; ++i) legs.log_times[i] = card.get_log_date_and_time(i);
+                return evaluate(legs, operator_id, route_number, time_in_milliseconds);
+            }
+
+            /**
+             * @brief Prices a tap against a decoded card.
+             * @param card The CSA before the tap. What to send: a container whose effective date is set.
+             * @param operator_id The operator of the tapping terminal.
+             * @param route_number The route being boarded.
+             * @param time_in_milliseconds The tap time in milliseconds since the Unix epoch.
+             */
+            [[nodiscard]] fare_quote evaluate(const container& card, const uint16_t operator_id, const uint16_t route_number,
+                                              const uint64_t time_in_milliseconds) const noexcept {
+                card_legs legs;
+                legs.epoch = card.get_card_epoch();
+                if (!legs.epoch.has_value()) {
+                    fare_quote quote;
+                    quote.status = status_code::effective_date_not_set;
+                    return quote;
+                }
+                const validation& previous = card.get_validation();
+                std::array<uint8_t, validation::DATA_SIZE> raw;
+                previous.serialize_into(raw.data());
+                legs.has_previous = !detail::is_zero_filled(raw.data(), raw.size());
+                legs.previous_operator = previous.get_terminal_info().get_operator_id();
+                legs.previous_route = previous.get_route_number();
+                legs.previous_time = previous.get_date_and_time_unchecked();
+                legs.log_count = card.get_history().get_valid_log_count();
+                legs.log_times = card.get_history().get_dates_and_times();
+                return evaluate(legs, operator_id, route_number, time_in_milliseconds);
+            }
+
+            //! The number of rules in the table.
+            [[nodiscard]] size_t size() const noexcept { return size_; }
+            //! The number of hash slots: the smallest power of two of at least 1.25 × `size()`.
+            [[nodiscard]] size_t capacity() const noexcept { return slots_.size(); }
+
+        private:
+
+            struct slot {
+                fare_rule rule;
+                bool used{ false };
+            };
+
+            //! The card fields evaluation depends on, gathered from either representation.
+            struct card_legs {
+                effective_epoch epoch;
+                bool has_previous{ false };
+                uint16_t previous_operator{ 0 };
+                uint16_t previous_route{ 0 };
+                uint64_t previous_time{ 0 };
+                size_t log_count{ 0 };
+                std::array<uint64_t, history::LOG_COUNT> log_times{};
+            };
+
+            [[nodiscard]] fare_quote evaluate(const card_legs& legs, const uint16_t operator_id, const uint16_t route_number,
+                                              const uint64_t time_in_milliseconds) const noexcept {
+                fare_quote quote;
+                const fare_rule* rule = find(operator_id, route_number);
+                if (rule == nullptr) {
+                    quote.status = status_code::no_fare_rule;
+                    return quote;
+                }
+                // The tap time must be representable on the card, exactly as when it is written.
+                uint32_t offset = 0;
+                quote.status = detail::encode_time_offset(legs.epoch, time_in_milliseconds, offset);
+                if (!quote.ok()) return quote;
+                const uint64_t now = legs.epoch.to_milliseconds(offset);
+                const uint64_t window = static_cast<uint64_t>(rule->transfer_window_minutes) * effective_epoch::MILLISECONDS_PER_MINUTE;
+                const uint64_t window_start = now > window ? now - window : 0;
+
+                // Count the logged legs inside the window with the same arithmetic for every slot.
+                uint8_t legs_in_window = 0;
+                for (size_t i = 0; i < history::LOG_COUNT; ++i)
+                    legs_in_window += static_cast<uint8_t>((i < legs.log_count) & (legs.log_times[i] >= window_start) & (legs.log_times[i] <= now));
+                quote.legs_in_window = legs_in_window;
+
+                const fare_rule* previous = legs.has_previous ? find(legs.previous_operator, legs.previous_route) : nullptr;
+                quote.transfer = previous != nullptr &&
+                                 rule->transfer_group != 0 && window != 0 &&
+                                 previous->transfer_group == rule->transfer_group &&
+                                 legs.previous_route != route_number &&
+                                 legs.previous_time >= window_start && legs.previous_time <= now &&
+                                 legs_in_window <= rule->max_transfers;
+                quote.fare = quote.transfer ? rule->transfer_fare : rule->base_fare;
+                return quote;
+            }
+
+            [[nodiscard]] static constexpr uint32_t key_of(const fare_rule& rule) noexcept {
+                return (static_cast<uint32_t>(rule.operator_id) << 16) | rule.route_number;
+            }
+
+            //! The MurmurHash3 64-bit finalizer.
+            [[nodiscard]] static constexpr uint64_t mix(uint64_t x) noexcept {
+                x = (x ^ (x >> 33)) * 0xFF51AFD7ED558CCDULL;
+                x = (x ^ (x >> 33)) * 0xC4CEB9FE1A85EC53ULL;
+                return x ^ (x >> 33);
+            }
+
+            //! The top bits of the key's hash select its bucket.
+            [[nodiscard]] size_t bucket_of(const uint32_t key) const noexcept {
+                return static_cast<size_t>(mix(key) >> bucket_shift_);
+            }
+
+            //! The slot of a key under its bucket's displacement.
+            [[nodiscard]] size_t slot_of(const uint32_t key, const uint32_t displacement) const noexcept {
+                const uint64_t seeded = key ^ ((static_cast<uint64_t>(displacement) + 1) * 0x9E3779B97F4A7C15ULL);
+                return static_cast<size_t>(mix(seeded)) & (slots_.size() - 1);
+            }
+
+            /**
+             * @brief Finds a displacement for every bucket, largest bucket first.
+             * @return False if some bucket found no free slots within `MAX_DISPLACEMENT` tries.
+             */
+            bool try_place(const std::vector<fare_rule>& rules, const size_t bucket_count, const size_t slot_count) {
+                slots_.assign(slot_count, slot{});
+                displacements_.assign(bucket_count, 0);
+                std::vector<std::vector<size_t>> buckets(bucket_count);
+                for (size_t i = 0; i < rules.size(); ++i) buckets[bucket_of(key_of(rules[i]))].push_back(i);
+                std::vector<size_t> order(bucket_count);
+                for (size_t b = 0; b < bucket_count; ++b) order[b] = b;
+                std::stable_sort(order.begin(), order.end(), [&](const size_t a, const size_t b) { return buckets[a].size() > buckets[b].size(); });
+
+                std::vector<size_t> targets;
+                for (const size_t b : order) {
+                    const std::vector<size_t>& members = buckets[b];
+                    if (members.empty()) break;
+                    bool placed = false;
+                    for (uint32_t d = 0; d < MAX_DISPLACEMENT && !placed; ++d) {
+                        targets.clear();
+                        placed = true;
+                        for (const size_t i : members) {
+                            const size_t at = slot_of(key_of(rules[i]), d);
+                            if (slots_[at].used || std::find(targets.begin(), targets.end(), at) != targets.end()) {
+                                placed = false;
+                                break;
+                            }
+                            targets.push_back(at);
+                        }
+                        if (!placed) continue;
+                        displacements_[b] = d;
+                        for (size_t m = 0; m < members.size(); ++m) {
+                            slots_[targets[m]].rule = rules[members[m]];
+                            slots_[targets[m]].used = true;
+                        }
+                    }
+                    if (!placed) return false;
+                }
+                return true;
+            }
+
+            static constexpr size_t KEYS_PER_BUCKET = 4;
+            static constexpr uint32_t MAX_DISPLACEMENT = 1u << 16;
+
+            std::vector<slot> slots_;
+            //! One displacement per bucket; a power-of-two count, selected by the top bits of the hash.
+            std::vector<uint32_t> displacements_;
+            unsigned bucket_shift_{ 63 };
+            size_t size_;
+        };
+
+    }
+
+}
@@ -0,0 +1,765 @@
+/**
+ * @file open_loop_format.h
+ * @brief Allocation-free, single-line text and JSON formatters for every CSA and OSA block.
+ * @details The `operator<<` overloads are multi-line debug dumps that go through `std::ostream`, the
+ *          stream manipulators and `std::gmtime`/`std::strftime`. Audit logging formats every tap, so the
+ *          functions here write straight into a caller-supplied `char` buffer instead:
+ *          - integers through a two-digits-at-a-time lookup table;
+ *          - hexadecimal fields through `codec::HEX_DIGITS`;
+ *          - timestamps through a `date_formatter` that converts a day to its civil date once and reuses
+ *            it for every later timestamp of the same day (taps of one shift nearly always share it).
+ *
+ *          No function here allocates, throws or touches a stream or locale. Each block type has a
+ *          compile-time bound on its output (`max_text_size` / `max_json_size`), so a stack buffer of that
+ *          size is always large enough. Timestamps are ISO-8601 UTC (`2024-01-01T08:30:00Z`); a time whose
+ *          card effective date has not been set is written as `unset` (text) or `null` (JSON).
+ *
+ * @author Govind Yadav
+ * @version 1.1
+ * @date 2025-09-08
+ */
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include "open_loop_service.h"
+
+namespace open_loop {
+
+    namespace detail {
+
+        //! "00" to "99", so that integers are written two digits per lookup.
+        constexpr char DIGIT_PAIRS[] =
+            "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+            "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899";
+
+        //! The number of decimal digits of `value`.
+        [[nodiscard]] constexpr size_t decimal_digits(uint64_t value) noexcept {
+            size_t digits = 1;
+            while (value >= 10) { value /= 10; ++digits; }
+            return digits;
+        }
+
+        //! Copies a string literal (without its terminator) and returns the end of the output.
+        template <size_t N>
+        inline char* put(char* out, const char (&literal)[N]) noexcept {
+            std::memcpy(out, literal, N - 1);
+            return out + N - 1;
+        }
+
+        //! Copies a null-terminated string and returns the end of the output.
+        inline char* put_cstr(char* out, const char* text) noexcept {
+            const size_t size = std::strlen(text);
+            std::memcpy(out, text, size);
+            return out + size;
+        }
+
+        //! Writes exactly two decimal digits. What to send: a value below 100.
+        inline char* put_2_digits(char* out, const uint32_t value) noexcept {
+            std::memcpy(out, DIGIT_PAIRS + value * 2, 2);
+            return out + 2;
+        }
+
+        //! Writes an unsigned integer in decimal without leading zeros.
+        inline char* put_uint(char* out, uint64_t value) noexcept {
+            char digits[20];
+            char* p = digits + sizeof(digits);
+            while (value >= 100) {
+                p -= 2;
+                std::memcpy(p, DIGIT_PAIRS + (value % 100) * 2, 2);
+                value /= 100;
+            }
+            if (value >= 10) {
+                p -= 2;
+                std::memcpy(p, DIGIT_PAIRS + value * 2, 2);
+            } else {
+                *--p = static_cast<char>('0' + value);
+            }
+            const size_t size = static_cast<size_t>(digits + sizeof(digits) - p);
+            std::memcpy(out, p, size);
+            return out + size;
+        }
+
+        //! Writes a signed integer in decimal.
+        inline char* put_int(char* out, const int64_t value) noexcept {
+            if (value >= 0) return put_uint(out, static_cast<uint64_t>(value));
+            *out++ = '-';
+            return put_uint(out, ~static_cast<uint64_t>(value) + 1);
+        }
+
+        //! Writes the low `digits` nibbles of `value` as upper-case hexadecimal, most significant first.
+        inline char* put_hex(char* out, const uint64_t value, const size_t digits) noexcept {
+            for (size_t i = 0; i < digits; ++i) out[i] = codec::HEX_DIGITS[(value >> ((digits - 1 - i) * 4)) & 0x0F];
+            return out + digits;
+        }
+
+        //! Writes a byte array as upper-case hexadecimal.
+        inline char* put_hex_bytes(char* out, const uint8_t* data, const size_t size) noexcept {
+            for (size_t i = 0; i < size; ++i) {
+                *out++ = codec::HEX_DIGITS[data[i] >> 4];
+                *out++ = codec::HEX_DIGITS[data[i] & 0x0F];
+            }
+            return out;
+        }
+
+    }
+
+    /**
+     * @namespace format
+     * @brief Single-line text and JSON formatters that write into caller buffers.
+     *
+     * @usage
+     * @code
+     *     char line[format::max_text_size<csa::log>];
+     *     char* end = format::format_to(line, card.get_history().get_log(0));
+     *     audit.write(line, end - line);
+     *
+     *     // Or, when an inline string is more convenient:
+     *     const auto json = format::to_json(card);
+     *     send(json.data(), json.size());
+     * @endcode
+     */
+    namespace format {
+
+        /**
+         * @class date_formatter
+         * @brief Formats millisecond timestamps as ISO-8601 UTC, caching the civil date of the last day seen.
+         * @details Converting a day number to a year, month and day is the only non-trivial step of date
+         *          formatting; it is done without `gmtime` (which takes a global lock on some platforms) and
+         *          only when the day changes. The formatting functions use `thread_date_formatter()` unless
+         *          given another instance. A formatter must not be shared between threads.
+         */
+        class date_formatter {
+        public:
+
+            //! The longest output of `write()`: a nine-digit year followed by "-MM-DDTHH:MM:SSZ".
+            static constexpr size_t MAX_SIZE = 25;
+
+            /**
+             * @brief Writes a timestamp such as `2024-01-01T08:30:00Z`.
+             * @param out The destination. What to send: at least `MAX_SIZE` writable characters.
+             * @param time_in_milliseconds Milliseconds since the Unix epoch. Sub-second digits are dropped.
+             * @return The end of the written characters. No terminator is written.
+             */
+            char* write(char* out, const uint64_t time_in_milliseconds) noexcept {
+                const uint64_t day = time_in_milliseconds / MILLISECONDS_PER_DAY;
+                if (!cached_ || day != day_) cache(day);
+                std::memcpy(out, date_, date_size_);
+                out += date_size_;
+                const uint32_t seconds = static_cast<uint32_t>((time_in_milliseconds % MILLISECONDS_PER_DAY) / 1000);
+                *out++ = 'T';
+                out = detail::put_2_digits(out, seconds / 3600);
+                *out++ = ':';
+                out = detail::put_2_digits(out, seconds / 60 % 60);
+                *out++ = ':';
+                out = detail::put_2_digits(out, seconds % 60);
+                *out++ = 'Z';
+                return out;
+            }
+
+        private:
+
+            static constexpr uint64_t MILLISECONDS_PER_DAY = 86400000;
+
+            //! Formats "YYYY-MM-DD" for a day number (days since 1970-01-01), using the proleptic Gregorian calendar.
+            void cache(const uint64_t day) noexcept {
+                // Shift the epoch to 0000-03-01 so that leap days fall at the end of each 400-year era.
+                const uint64_t z = day + 719468;
+                const uint64_t era = z / 146097;
+                const uint32_t day_of_era = static_cast<uint32_t>(z - era * 146097);
+                const uint32_t year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+                const uint32_t day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+                const uint32_t month_index = (5 * day_of_year + 2) / 153;
+                const uint32_t day_of_month = day_of_year - (153 * month_index + 2) / 5 + 1;
+                const uint32_t month = month_index < 10 ? month_index + 3 : month_index - 9;
+                const uint64_t year = era * 400 + year_of_era + (month <= 2 ? 1 : 0);
+
+                char* out = date_;
+                if (year < 10000) {
+                    out = detail::put_2_digits(out, static_cast<uint32_t>(year / 100));
+                    out = detail::put_2_digits(out, static_cast<uint32_t>(year % 100));
+                } else {
+                    out = detail::put_uint(out, year);
+                }
+                *out++ = '-';
+                out = detail::put_2_digits(out, month);
+                *out++ = '-';
+                out = detail::put_2_digits(out, day_of_month);
+                date_size_ = static_cast<size_t>(out - date_);
+                day_ = day;
+                cached_ = true;
+            }
+
+            uint64_t day_{ 0 };
+            bool cached_{ false };
+            size_t date_size_{ 0 };
+            char date_[MAX_SIZE]{};
+        };
+
+        /**
+         * @brief The date formatter used by default on the calling thread.
+         * @return A per-thread instance, so concurrent audit writers never share a cache.
+         */
+        [[nodiscard]] inline date_formatter& thread_date_formatter() noexcept {
+            thread_local date_formatter formatter;
+            return formatter;
+        }
+
+        // ---------------------------------------------------- OUTPUT BOUNDS ----------------------------------------------------
+
+        //! Characters needed for a timestamp, an unset timestamp or a signed 64-bit effective date.
+        constexpr size_t DATE_SIZE = date_formatter::MAX_SIZE;
+        constexpr size_t EPOCH_SIZE = 20;
+        //! Characters needed for the decimal form of an 8-, 16-, 20- and 24-bit field.
+        constexpr size_t U8_SIZE = 3;
+        constexpr size_t U16_SIZE = 5;
+        constexpr size_t U20_SIZE = 7;
+        //! Characters needed for the longest `to_string()` of a status ("PENALTY") and language ("Malayalam").
+        constexpr size_t STATUS_SIZE = 7;
+        constexpr size_t LANGUAGE_SIZE = 9;
+
+        /**
+         * @brief The maximum number of characters `format_to()` writes for a block of type `T`.
+         * @details Each bound is the fixed skeleton of the line plus the widest value of every field.
+         */
+        template <typename T>
+        inline constexpr size_t max_text_size = 0;
+        /**
+         * @brief The maximum number of characters `format_json_to()` writes for a block of type `T`.
+         */
+        template <typename T>
+        inline constexpr size_t max_json_size = 0;
+
+        template <>
+        inline constexpr size_t max_text_size<csa::terminal> =
+            sizeof("acquirer= operator= terminal=") - 1 + U8_SIZE + U16_SIZE + 6;
+        template <>
+        inline constexpr size_t max_json_size<csa::terminal> =
+            sizeof(R"({"acquirer_id":,"operator_id":,"terminal_id":""})") - 1 + U8_SIZE + U16_SIZE + 6;
+
+        template <>
+        inline constexpr size_t max_text_size<csa::general> =
+            sizeof("version=.. language= rfu=") - 1 + 3 + LANGUAGE_SIZE + 1;
+        template <>
+        inline constexpr size_t max_json_size<csa::general> =
+            sizeof(R"({"version":"..","language":"","language_code":,"rfu":})") - 1 + 3 + LANGUAGE_SIZE + 2 + 1;
+
+        template <>
+        inline constexpr size_t max_text_size<csa::validation> =
+            sizeof("error= product=  time= fare= route= service_provider_data= status= rfu=") - 1 +
+            2 * U8_SIZE + max_text_size<csa::terminal> + DATE_SIZE + 2 * U16_SIZE + 6 + STATUS_SIZE + 2;
+        template <>
+        inline constexpr size_t max_json_size<csa::validation> =
+            sizeof(R"({"error_code":,"product_type":,"terminal":,"date_and_time":"","fare_amount":,"route_number":,)"
+                   R"("service_provider_data":"","txn_status":"","rfu":})") - 1 +
+            2 * U8_SIZE + max_json_size<csa::terminal> + DATE_SIZE + 2 * U16_SIZE + 6 + STATUS_SIZE + 2;
+
+        template <>
+        inline constexpr size_t max_text_size<csa::log> =
+            sizeof(" time= sq= amount= balance= status= rfu=") - 1 +
+            max_text_size<csa::terminal> + DATE_SIZE + 2 * U16_SIZE + U20_SIZE + STATUS_SIZE + 2;
+        template <>
+        inline constexpr size_t max_json_size<csa::log> =
+            sizeof(R"({"terminal":,"date_and_time":"","txn_amount":,"txn_sq_no":,"card_balance":,"txn_status":"","rfu":})") - 1 +
+            max_json_size<csa::terminal> + DATE_SIZE + 2 * U16_SIZE + U20_SIZE + STATUS_SIZE + 2;
+
+        template <>
+        inline constexpr size_t max_text_size<csa::history> =
+            sizeof("effective_date= logs=") - 1 + EPOCH_SIZE + detail::decimal_digits(csa::history::LOG_COUNT) +
+            csa::history::LOG_COUNT * (sizeof(" log[]={}") - 1 + detail::decimal_digits(csa::history::LOG_COUNT) + max_text_size<csa::log>);
+        template <>
+        inline constexpr size_t max_json_size<csa::history> =
+            sizeof(R"({"card_effective_date":,"logs":[]})") - 1 + EPOCH_SIZE +
+            csa::history::LOG_COUNT * (1 + max_json_size<csa::log>);
+
+        template <>
+        inline constexpr size_t max_text_size<csa::container> =
+            sizeof("general={} validation={} history={} rfu=") - 1 + max_text_size<csa::general> +
+            max_text_size<csa::validation> + max_text_size<csa::history> + 2 * csa::container::RFU_SIZE;
+        template <>
+        inline constexpr size_t max_json_size<csa::container> =
+            sizeof(R"({"general":,"validation":,"history":,"rfu":""})") - 1 + max_json_size<csa::general> +
+            max_json_size<csa::validation> + max_json_size<csa::history> + 2 * csa::container::RFU_SIZE;
+
+        template <>
+        inline constexpr size_t max_text_size<osa::general> =
+            sizeof("version=.. phone= language= service_status= rfu=") - 1 +
+            3 + osa::general::PHONE_NUMBER_DIGITS + LANGUAGE_SIZE + sizeof("inactive") - 1 + 1;
+        template <>
+        inline constexpr size_t max_json_size<osa::general> =
+            sizeof(R"({"version":"..","phone_number":"","language":"","language_code":,"service_status":"","rfu":})") - 1 +
+            3 + osa::general::PHONE_NUMBER_DIGITS + LANGUAGE_SIZE + 2 + sizeof("inactive") - 1 + 1;
+
+        template <>
+        inline constexpr size_t max_text_size<osa::transaction_record> =
+            sizeof("error= product= time= station= fare= terminal= status= rfu=") - 1 +
+            2 * U8_SIZE + DATE_SIZE + 2 * U16_SIZE + 6 + STATUS_SIZE + 2;
+        template <>
+        inline constexpr size_t max_json_size<osa::transaction_record> =
+            sizeof(R"({"error_code":,"product_type":,"date_and_time":"","station_id":,"fare":,"terminal_id":"","txn_status":"","rfu":})") - 1 +
+            2 * U8_SIZE + DATE_SIZE + 2 * U16_SIZE + 6 + STATUS_SIZE + 2;
+
+        template <size_t LogCount>
+        inline constexpr size_t max_text_size<osa::basic_history<LogCount>> =
+            sizeof("effective_date= logs=") - 1 + EPOCH_SIZE + detail::decimal_digits(LogCount) +
+            LogCount * (sizeof(" log[]={}") - 1 + detail::decimal_digits(LogCount) + max_text_size<osa::transaction_record>);
+        template <size_t LogCount>
+        inline constexpr size_t max_json_size<osa::basic_history<LogCount>> =
+            sizeof(R"({"card_effective_date":,"logs":[]})") - 1 + EPOCH_SIZE +
+            LogCount * (1 + max_json_size<osa::transaction_record>);
+
+        template <>
+        inline constexpr size_t max_text_size<osa::trip_pass> =
+            sizeof("pass_id= expiry= priority= allotted= remaining= source= destination= flags= daily_counter= daily_indicator= start=") - 1 +
+            3 * U8_SIZE + 2 + 2 * DATE_SIZE + 5 * U16_SIZE;
+        template <>
+        inline constexpr size_t max_json_size<osa::trip_pass> =
+            sizeof(R"({"pass_id":,"pass_expiry":"","priority":,"trips_allotted":,"remaining_trips":,"source_id":,)"
+                   R"("destination_id":,"flags":,"daily_trip_counter":,"daily_trip_indicator":,"start_date_and_time":""})") - 1 +
+            4 * U8_SIZE + 2 * DATE_SIZE + 5 * U16_SIZE;
+
+        template <typename Layout>
+        inline constexpr size_t max_text_size<osa::basic_container<Layout>> =
+            sizeof("general={} validation={} history={}") - 1 + max_text_size<osa::general> +
+            max_text_size<osa::transaction_record> + max_text_size<typename osa::basic_container<Layout>::history_type> +
+            Layout::NUM_TRIP_PASSES * (sizeof(" pass[]={}") - 1 + detail::decimal_digits(Layout::NUM_TRIP_PASSES) + max_text_size<osa::trip_pass>);
+        template <typename Layout>
+        inline constexpr size_t max_json_size<osa::basic_container<Layout>> =
+            sizeof(R"({"general":,"validation":,"history":,"trip_passes":[]})") - 1 + max_json_size<osa::general> +
+            max_json_size<osa::transaction_record> + max_json_size<typename osa::basic_container<Layout>::history_type> +
+            Layout::NUM_TRIP_PASSES * (1 + max_json_size<osa::trip_pass>);
+
+        // ------------------------------------------------------ CSA TEXT -------------------------------------------------------
+
+        /**
+         * @brief Writes a block as one line of `key=value` pairs, e.g. `acquirer=15 operator=1025 terminal=A1B2C3`.
+         * @param out The destination. What to send: at least `max_text_size<T>` writable characters.
+         * @param obj The block to format.
+         * @param dates The date cache to use. Defaults to the calling thread's.
+         * @return The end of the written characters. No terminator is written.
+         */
+        inline char* format_to(char* out, const csa::terminal& obj, date_formatter& = thread_date_formatter()) noexcept {
+            out = detail::put(out, "acquirer=");
+            out = detail::put_uint(out, obj.get_acquirer_id());
+            out = detail::put(out, " operator=");
+            out = detail::put_uint(out, obj.get_operator_id());
+            out = detail::put(out, " terminal=");
+            return detail::put_cstr(out, obj.get_terminal_id_chars().data());
+        }
+
+        inline char* format_to(char* out, const csa::general& obj, date_formatter& = thread_date_formatter()) noexcept {
+            out = detail::put(out, "version=");
+            out = detail::put_uint(out, obj.get_major_version());
+            *out++ = '.';
+            out = detail::put_uint(out, obj.get_minor_version());
+            *out++ = '.';
+            out = detail::put_uint(out, obj.get_patch_version());
+            out = detail::put(out, " language=");
+            out = detail::put_cstr(out, to_string(obj.get_language()));
+            out = detail::put(out, " rfu=");
+            return detail::put_uint(out, obj.get_rfu());
+        }
+
+        inline char* format_to(char* out, const csa::validation& obj, date_formatter& dates = thread_date_formatter()) noexcept {
+            out = detail::put(out, "error=");
+            out = detail::put_uint(out, obj.get_error_code());
+            out = detail::put(out, " product=");
+            out = detail::put_uint(out, obj.get_product_type());
+            *out++ = ' ';
+            out = format_to(out, obj.get_terminal_info(), dates);
+            out = detail::put(out, " time=");
+            out = obj.get_card_epoch().has_value() ? dates.write(out, obj.get_date_and_time_unchecked()) : detail::put(out, "unset");
+            out = detail::put(out, " fare=");
+            out = detail::put_uint(out, obj.get_fare_amount());
+            out = detail::put(out, " route=");
+            out = detail::put_uint(out, obj.get_route_number());
+            out = detail::put(out, " service_provider_data=");
+            out = detail::put_hex(out, obj.get_service_provider_data_value(), 6);
+            out = detail::put(out, " status=");
+            out = detail::put_cstr(out, to_string(obj.get_txn_status()));
+            out = detail::put(out, " rfu=");
+            return detail::put_uint(out, obj.get_rfu_bits());
+        }
+
+        inline char* format_to(char* out, const csa::log& obj, date_formatter& dates = thread_date_formatter()) noexcept {
+            out = format_to(out, obj.get_terminal_info(), dates);
+            out = detail::put(out, " time=");
+            out = obj.get_card_epoch().has_value() ? dates.write(out, obj.get_date_and_time_unchecked()) : detail::put(out, "unset");
+            out = detail::put(out, " sq=");
+            out = detail::put_uint(out, obj.get_txn_sq_no());
+            out = detail::put(out, " amount=");
+            out = detail::put_uint(out, obj.get_txn_amount());
+            out = detail::put(out, " balance=");
+            out = detail::put_uint(out, obj.get_card_balance());
+            out = detail::put(out, " status=");
+            out = detail::put_cstr(out, to_string(obj.get_txn_status()));
+            out = detail::put(out, " rfu=");
+            return detail::put_uint(out, obj.get_rfu_bits());
+        }
+
+        inline char* format_to(char* out, const csa::history& obj, date_formatter& dates = thread_date_formatter()) noexcept {
+            out = detail::put(out, "effective_date=");
+            out = obj.get_card_epoch().has_value() ? detail::put_int(out, *obj.get_card_epoch()) : detail::put(out, "unset");
+            out = detail::put(out, " logs=");
+            out = detail::put_uint(out, obj.get_valid_log_count());
+            for (size_t i = 0; i < obj.get_valid_log_count(); ++i) {
+                out = detail::put(out, " log[");
+                out = detail::put_uint(out, i);
+                out = detail::put(out, "]={");
+                out = format_to(out, obj.get_log_unchecked(i), dates);
+                *out++ = '}';
+            }
+            return out;
+        }
+
+        inline char* format_to(char* out, const csa::container& obj, date_formatter& dates = thread_date_formatter()) noexcept {
+            out = detail::put(out, "general={");
+            out = format_to(out, obj.get_general(), dates);
+            out = detail::put(out, "} validation={");
+            out = format_to(out, obj.get_validation(), dates);
+            out = detail::put(out, "} history={");
+            out = format_to(out, obj.get_history(), dates);
+            out = detail::put(out, "} rfu=");
+            return detail::put_hex_bytes(out, obj.get_rfu().data(), obj.get_rfu().size());
+        }
+
+        // ------------------------------------------------------ OSA TEXT -------------------------------------------------------
+
+        inline char* format_to(char* out, const osa::general& obj, date_formatter& = thread_date_formatter()) noexcept {
+            out = detail::put(out, "version=");
+            out = detail::put_uint(out, obj.get_major_version());
+            *out++ = '.';
+            out = detail::put_uint(out, obj.get_minor_version());
+            *out++ = '.';
+            out = detail::put_uint(out, obj.get_patch_version());
+            out = detail::put(out, " phone=");
+            const auto phone = obj.get_phone_number_chars();
+            out = phone.empty() ? detail::put(out, "unset") : detail::put_cstr(out, phone.data());
+            out = detail::put(out, " language=");
+            out = detail::put_cstr(out, to_string(obj.get_language()));
+            out = detail::put(out, " service_status=");
+            out = obj.get_service_status() == osa::general::service_status::active ? detail::put(out, "active") : detail::put(out, "inactive");
+            out = detail::put(out, " rfu=");
+            return detail::put_uint(out, obj.get_rfu());
+        }
+
+        inline char* format_to(char* out, const osa::transaction_record& obj, date_formatter& dates = thread_date_formatter()) noexcept {
+            out = detail::put(out, "error=");
+            out = detail::put_uint(out, obj.get_error_code());
+            out = detail::put(out, " product=");
+            out = detail::put_uint(out, obj.get_product_type());
+            out = detail::put(out, " time=");
+            out = obj.get_card_epoch().has_value() ? dates.write(out, obj.get_date_and_time_unchecked()) : detail::put(out, "unset");
+            out = detail::put(out, " station=");
+            out = detail::put_uint(out, obj.get_station_id());
+            out = detail::put(out, " fare=");
+            out = detail::put_uint(out, obj.get_fare());
+            out = detail::put(out, " terminal=");
+            out = detail::put_hex(out, obj.get_terminal_id(), 6);
+            out = detail::put(out, " status=");
+            out = detail::put_cstr(out, to_string(obj.get_txn_status()));
+            out = detail::put(out, " rfu=");
+            return detail::put_uint(out, obj.get_rfu());
+        }
+
+        template <size_t LogCount>
+        char* format_to(char* out, const osa::basic_history<LogCount>& obj, date_formatter& dates = thread_date_formatter()) noexcept {
+            out = detail::put(out, "effective_date=");
+            out = obj.get_card_epoch().has_value() ? detail::put_int(out, *obj.get_card_epoch()) : detail::put(out, "unset");
+            out = detail::put(out, " logs=");
+            out = detail::put_uint(out, obj.get_valid_log_count());
+            for (size_t i = 0; i < obj.get_valid_log_count(); ++i) {
+                out = detail::put(out, " log[");
+                out = detail::put_uint(out, i);
+                out = detail::put(out, "]={");
+                out = format_to(out, obj.get_log_unchecked(i), dates);
+                *out++ = '}';
+            }
+            return out;
+        }
+
+        inline char* format_to(char* out, const osa::trip_pass& obj, date_formatter& dates = thread_date_formatter()) noexcept {
+            out = detail::put(out, "pass_id=");
+            out = detail::put_uint(out, obj.get_pass_id());
+            out = detail::put(out, " expiry=");
+            out = dates.write(out, obj.get_pass_expiry());
+            out = detail::put(out, " priority=");
+            out = detail::put_uint(out, obj.get_priority());
+            out = detail::put(out, " allotted=");
+            out = detail::put_uint(out, obj.get_trips_allotted());
+            out = detail::put(out, " remaining=");
+            out = detail::put_uint(out, obj.get_remaining_trips());
+            out = detail::put(out, " source=");
+            out = detail::put_uint(out, obj.get_source_id());
+            out = detail::put(out, " destination=");
+            out = detail::put_uint(out, obj.get_destination_id());
+            out = detail::put(out, " flags=");
+            out = detail::put_hex(out, obj.get_flags(), 2);
+            out = detail::put(out, " daily_counter=");
+            out = detail::put_uint(out, obj.get_daily_trip_counter());
+            out = detail::put(out, " daily_indicator=");
+            out = detail::put_uint(out, obj.get_daily_trip_indicator());
+            out = detail::put(out, " start=");
+            return dates.write(out, obj.get_start_date_and_time());
+        }
+
+        template <typename Layout>
+        char* format_to(char* out, const osa::basic_container<Layout>& obj, date_formatter& dates = thread_date_formatter()) noexcept {
+            out = detail::put(out, "general={");
+            out = format_to(out, obj.get_general(), dates);
+            out = detail::put(out, "} validation={");
+            out = format_to(out, obj.get_validation(), dates);
+            out = detail::put(out, "} history={");
+            out = format_to(out, obj.get_history(), dates);
+            *out++ = '}';
+            for (size_t i = 0; i < Layout::NUM_TRIP_PASSES; ++i) {
+                out = detail::put(out, " pass[");
+                out = detail::put_uint(out, i);
+                out = detail::put(out, "]={");
+                out = format_to(out, obj.get_trip_pass(i), dates);
+                *out++ = '}';
+            }
+            return out;
+        }
+
+        // ------------------------------------------------------ CSA JSON -------------------------------------------------------
+
+        /**
+         * @brief Writes a block as one compact JSON object, with keys named after the block's getters.
+         * @details Every string value comes from a fixed alphabet (digits, hexadecimal, enum names), so no
+         *          escaping is ever needed.
+         * @param out The destination. What to send: at least `max_json_size<T>` writable characters.
+         * @param obj The block to format.
+         * @param dates The date cache to use. Defaults to the calling thread's.
+         * @return The end of the written characters. No terminator is written.
+         */
+        inline char* format_json_to(char* out, const csa::terminal& obj, date_formatter& = thread_date_formatter()) noexcept {
+            out = detail::put(out, R"({"acquirer_id":)");
+            out = detail::put_uint(out, obj.get_acquirer_id());
+            out = detail::put(out, R"(,"operator_id":)");
+            out = detail::put_uint(out, obj.get_operator_id());
+            out = detail::put(out, R"(,"terminal_id":")");
+            out = detail::put_cstr(out, obj.get_terminal_id_chars().data());
+            return detail::put(out, R"("})");
+        }
+
+        inline char* format_json_to(char* out, const csa::general& obj, date_formatter& = thread_date_formatter()) noexcept {
+            out = detail::put(out, R"({"version":")");
+            out = detail::put_uint(out, obj.get_major_version());
+            *out++ = '.';
+            out = detail::put_uint(out, obj.get_minor_version());
+            *out++ = '.';
+            out = detail::put_uint(out, obj.get_patch_version());
+            out = detail::put(out, R"(","language":")");
+            out = detail::put_cstr(out, to_string(obj.get_language()));
+            out = detail::put(out, R"(","language_code":)");
+            out = detail::put_uint(out, static_cast<uint8_t>(obj.get_language()));
+            out = detail::put(out, R"(,"rfu":)");
+            out = detail::put_uint(out, obj.get_rfu());
+            *out++ = '}';
+            return out;
+        }
+
+        //! Writes a quoted timestamp, or `null` if the effective date it depends on is unset.
+        inline char* put_json_time(char* out, const bool set, const uint64_t time_in_milliseconds, date_formatter& dates) noexcept {
+            if (!set) return detail::put(out, "null");
+            *out++ = '"';
+            out = dates.write(out, time_in_milliseconds);
+            *out++ = '"';
+            return out;
+        }
+
+        inline char* format_json_to(char* out, const csa::validation& obj, date_formatter& dates = thread_date_formatter()) noexcept {
+            out = detail::put(out, R"({"error_code":)");
+            out = detail::put_uint(out, obj.get_error_code());
+            out = detail::put(out, R"(,"product_type":)");
+            out = detail::put_uint(out, obj.get_product_type());
+            out = detail::put(out, R"(,"terminal":)");
+            out = format_json_to(out, obj.get_terminal_info(), dates);
+            out = detail::put(out, R"(,"date_and_time":)");
+            out = put_json_time(out, obj.get_card_epoch().has_value(), obj.get_date_and_time_unchecked(), dates);
+            out = detail::put(out, R"(,"fare_amount":)");
+            out = detail::put_uint(out, obj.get_fare_amount());
+            out = detail::put(out, R"(,"route_number":)");
+            out = detail::put_uint(out, obj.get_route_number());
+            out = detail::put(out, R"(,"service_provider_data":")");
+            out = detail::put_hex(out, obj.get_service_provider_data_value(), 6);
+            out = detail::put(out, R"(","txn_status":")");
+            out = detail::put_cstr(out, to_string(obj.get_txn_status()));
+            out = detail::put(out, R"(","rfu":)");
+            out = detail::put_uint(out, obj.get_rfu_bits());
+            *out++ = '}';
+            return out;
+        }
+
+        inline char* format_json_to(char* out, const csa::log& obj, date_formatter& dates = thread_date_formatter()) noexcept {
+            out = detail::put(out, R"({"terminal":)");
+            out = format_json_to(out, obj.get_terminal_info(), dates);
+            out = detail::put(out, R"(,"date_and_time":)");
+            out = put_json_time(out, obj.get_card_epoch().has_value(), obj.get_date_and_time_unchecked(), dates);
+            out = detail::put(out, R"(,"txn_amount":)");
+            out = detail::put_uint(out, obj.get_txn_amount());
+            out = detail::put(out, R"(,"txn_sq_no":)");
+            out = detail::put_uint(out, obj.get_txn_sq_no());
+            out = detail::put(out, R"(,"card_balance":)");
+            out = detail::put_uint(out, obj.get_card_balance());
+            out = detail::put(out, R"(,"txn_status":")");
+            out = detail::put_cstr(out, to_string(obj.get_txn_status()));
+            out = detail::put(out, R"(","rfu":)");
+            out = detail::put_uint(out, obj.get_rfu_bits());
+            *out++ = '}';
+            return out;
+        }
+
+        inline char* format_json_to(char* out, const csa::history& obj, date_formatter& dates = thread_date_formatter()) noexcept {
+            out = detail::put(out, R"({"card_effective_date":)");
+            out = obj.get_card_epoch().has_value() ? detail::put_int(out, *obj.get_card_epoch()) : detail::put(out, "null");
+            out = detail::put(out, R"(,"logs":[)");
+            for (size_t i = 0; i < obj.get_valid_log_count(); ++i) {
+                if (i != 0) *out++ = ',';
+                out = format_json_to(out, obj.get_log_unchecked(i), dates);
+            }
+            return detail::put(out, "]}");
+        }
+
+        inline char* format_json_to(char* out, const csa::container& obj, date_formatter& dates = thread_date_formatter()) noexcept {
+            out = detail::put(out, R"({"general":)");
+            out = format_json_to(out, obj.get_general(), dates);
+            out = detail::put(out, R"(,"validation":)");
+            out = format_json_to(out, obj.get_validation(), dates);
+            out = detail::put(out, R"(,"history":)");
+            out = format_json_to(out, obj.get_history(), dates);
+            out = detail::put(out, R"(,"rfu":")");
+            out = detail::put_hex_bytes(out, obj.get_rfu().data(), obj.get_rfu().size());
+            return detail::put(out, R"("})");
+        }
+
+        // ------------------------------------------------------ OSA JSON -------------------------------------------------------
+
+        inline char* format_json_to(char* out, const osa::general& obj, date_formatter& = thread_date_formatter()) noexcept {
+            out = detail::put(out, R"({"version":")");
+            out = detail::put_uint(out, obj.get_major_version());
+            *out++ = '.';
+            out = detail::put_uint(out, obj.get_minor_version());
+            *out++ = '.';
+            out = detail::put_uint(out, obj.get_patch_version());
+            out = detail::put(out, R"(","phone_number":")");
+            out = detail::put_cstr(out, obj.get_phone_number_chars().data());
+            out = detail::put(out, R"(","language":")");
+            out = detail::put_cstr(out, to_string(obj.get_language()));
+            out = detail::put(out, R"(","language_code":)");
+            out = detail::put_uint(out, static_cast<uint8_t>(obj.get_language()));
+            out = detail::put(out, R"(,"service_status":")");
+            out = obj.get_service_status() == osa::general::service_status::active ? detail::put(out, "active") : detail::put(out, "inactive");
+            out = detail::put(out, R"(","rfu":)");
+            out = detail::put_uint(out, obj.get_rfu());
+            *out++ = '}';
+            return out;
+        }
+
+        inline char* format_json_to(char* out, const osa::transaction_record& obj, date_formatter& dates = thread_date_formatter()) noexcept {
+            out = detail::put(out, R"({"error_code":)");
+            out = detail::put_uint(out, obj.get_error_code());
+            out = detail::put(out, R"(,"product_type":)");
+            out = detail::put_uint(out, obj.get_product_type());
+            out = detail::put(out, R"(,"date_and_time":)");
+            out = put_json_time(out, obj.get_card_epoch().has_value(), obj.get_date_and_time_unchecked(), dates);
+            out = detail::put(out, R"(,"station_id":)");
+            out = detail::put_uint(out, obj.get_station_id());
+            out = detail::put(out, R"(,"fare":)");
+            out = detail::put_uint(out, obj.get_fare());
+            out = detail::put(out, R"(,"terminal_id":")");
+            out = detail::put_hex(out, obj.get_terminal_id(), 6);
+            out = detail::put(out, R"(","txn_status":")");
+            out = detail::put_cstr(out, to_string(obj.get_txn_status()));
+            out = detail::put(out, R"(","rfu":)");
+            out = detail::put_uint(out, obj.get_rfu());
+            *out++ = '}';
+            return out;
+        }
+
+        template <size_t LogCount>
+        char* format_json_to(char* out, const osa::basic_history<LogCount>& obj, date_formatter& dates = thread_date_formatter()) noexcept {
+            out = detail::put(out, R"({"card_effective_date":)");
+            out = obj.get_card_epoch().has_value() ? detail::put_int(out, *obj.get_card_epoch()) : detail::put(out, "null");
+            out = detail::put(out, R"(,"logs":[)");
+            for (size_t i = 0; i < obj.get_valid_log_count(); ++i) {
+                if (i != 0) *out++ = ',';
+                out = format_json_to(out, obj.get_log_unchecked(i), dates);
+            }
+            return detail::put(out, "]}");
+        }
+
+        inline char* format_json_to(char* out, const osa::trip_pass& obj, date_formatter& dates = thread_date_formatter()) noexcept {
+            out = detail::put(out, R"({"pass_id":)");
+            out = detail::put_uint(out, obj.get_pass_id());
+            out = detail::put(out, R"(,"pass_expiry":)");
+            out = put_json_time(out, true, obj.get_pass_expiry(), dates);
+            out = detail::put(out, R"(,"priority":)");
+            out = detail::put_uint(out, obj.get_priority());
+            out = detail::put(out, R"(,"trips_allotted":)");
+            out = detail::put_uint(out, obj.get_trips_allotted());
+            out = detail::put(out, R"(,"remaining_trips":)");
+            out = detail::put_uint(out, obj.get_remaining_trips());
+            out = detail::put(out, R"(,"source_id":)");
+            out = detail::put_uint(out, obj.get_source_id());
+            out = detail::put(out, R"(,"destination_id":)");
+            out = detail::put_uint(out, obj.get_destination_id());
+            out = detail::put(out, R"(,"flags":)");
+            out = detail::put_uint(out, obj.get_flags());
+            out = detail::put(out, R"(,"daily_trip_counter":)");
+            out = detail::put_uint(out, obj.get_daily_trip_counter());
+            out = detail::put(out, R"(,"daily_trip_indicator":)");
+            out = detail::put_uint(out, obj.get_daily_trip_indicator());
+            out = detail::put(out, R"(,"start_date_and_time":)");
+            out = put_json_time(out, true, obj.get_start_date_and_time(), dates);
+            *out++ = '}';
+            return out;
+        }
+
+        template <typename Layout>
+        char* format_json_to(char* out, const osa::basic_container<Layout>& obj, date_formatter& dates = thread_date_formatter()) noexcept {
+            out = detail::put(out, R"({"general":)");
+            out = format_json_to(out, obj.get_general(), dates);
+            out = detail::put(out, R"(,"validation":)");
+            out = format_json_to(out, obj.get_validation(), dates);
+            out = detail::put(out, R"(,"history":)");
+            out = format_json_to(out, obj.get_history(), dates);
+            out = detail::put(out, R"(,"trip_passes":[)");
+            for (size_t i = 0; i < Layout::NUM_TRIP_PASSES; ++i) {
+                if (i != 0) *out++ = ',';
+                out = format_json_to(out, obj.get_trip_pass(i), dates);
+            }
+            return detail::put(out, "]}");
+        }
+
+        // ---------------------------------------------------- INLINE STRINGS ---------------------------------------------------
+
+        /**
+         * @brief Formats a block with `format_to()` into an inline string.
+         * @return A `fixed_string` sized for the longest possible line of `T`. Never allocates.
+         */
+        template <typename T>
+        [[nodiscard]] fixed_string<max_text_size<T>> to_text(const T& obj, date_formatter& dates = thread_date_formatter()) noexcept {
+            static_assert(max_text_size<T> != 0, "to_text() supports the CSA and OSA block types only.");
+            char buffer[max_text_size<T>];
+            const char* end = format_to(buffer, obj, dates);
+            return { buffer, static_cast<size_t>(end - buffer) };
+        }
+
+        /**
+         * @brief Formats a block with `format_json_to()` into an inline string.
+         * @return A `fixed_string` sized for the longest possible JSON object of `T`. Never allocates.
+         */
+        template <typename T>
+        [[nodiscard]] fixed_string<max_json_size<T>> to_json(const T& obj, date_formatter& dates = thread_date_formatter()) noexcept {
+            static_assert(max_json_size<T> != 0, "to_json() supports the CSA and OSA block types only.");
+            char buffer[max_json_size<T>];
+            const char* end = format_json_to(buffer, obj, dates);
+            return { buffer, static_cast<size_t>(end - buffer) };
+        }
+
+    }
+
+}
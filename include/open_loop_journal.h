@@ -0,0 +1,486 @@
+/**
+ * @file open_loop_journal.h
+ * @brief An append-only, crash-safe binary journal of tap records with a zero-copy memory-mapped reader.
+ * @details Gates buffer their taps while offline and upload them in bulk. `journal::writer` appends one
+ *          fixed-stride record per tap (the 96-byte card image, its effective date, the tap time and the
+ *          terminal) into a buffer allocated once, and hands whole groups of records to the OS in a single
+ *          write, optionally followed by a data sync. `journal::reader` memory-maps a journal and exposes
+ *          every record as a `csa::view` or `osa::view` over the mapped bytes.
+ *
+ *          Every record carries its own index and checksum. After a power cut the file may end in a
+ *          partially written record or in stale bytes; both fail validation, so the reader stops at the last
+ *          intact record and a writer reopening the file truncates the torn tail before appending.
+ *
+ * @author Govind Yadav
+ * @version 1.1
+ * @date 2025-09-08
+ */
+
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+#include "open_loop_pipeline.h"
+#include "open_loop_service.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace open_loop {
+
+    /**
+     * @namespace journal
+     * @brief Offline tap journals: an append-only writer and a memory-mapped reader.
+     */
+    namespace journal {
+
+        //! The card area a record holds.
+        enum class area : uint8_t {
+            csa = 0,
+            osa = 1
+        };
+
+        /**
+         * @struct format
+         * @brief The on-disk layout shared by `writer` and `reader`.
+         *
+         * @details All integers are little-endian. The file is a 64-byte header followed by 128-byte records:
+         *          | Offset | Size | Content                                                            |
+         *          |--------|------|--------------------------------------------------------------------|
+         *          | 0      | 96   | The card image, as `serialize_into()` writes it                    |
+         *          | 96     | 8    | The card effective date in minutes since the Unix epoch            |
+         *          | 104    | 8    | The tap time in milliseconds since the Unix epoch                  |
+         *          | 112    | 6    | The terminal, as `csa::terminal::serialize_into()` writes it        |
+         *          | 118    | 1    | The `area`                                                         |
+         *          | 119    | 1    | Reserved (0)                                                       |
+         *          | 120    | 4    | The record index within the journal                                |
+         *          | 124    | 4    | Checksum of bytes 0-123                                            |
+         */
+        struct format {
+            static constexpr uint32_t MAGIC = 0x524A4C4F; // "OLJR"
+            static constexpr uint32_t VERSION = 1;
+            static constexpr size_t HEADER_SIZE = 64;
+            static constexpr size_t RECORD_SIZE = 128;
+            static constexpr size_t IMAGE_SIZE = 96;
+
+            static constexpr size_t EFFECTIVE_DATE_POS = 96;
+            static constexpr size_t TIMESTAMP_POS = 104;
+            static constexpr size_t TERMINAL_POS = 112;
+            static constexpr size_t AREA_POS = 118;
+            static constexpr size_t INDEX_POS = 120;
+            static constexpr size_t CHECKSUM_POS = 124;
+
+            //! The checksum of one record: the card hash of its first 124 bytes, folded to 32 bits.
+            [[nodiscard]] static uint32_t checksum(const uint8_t* record) noexcept {
+                const uint64_t h = detail::hash_card(record, CHECKSUM_POS, static_cast<int64_t>(MAGIC));
+                return static_cast<uint32_t>(h ^ (h >> 32));
+            }
+
+            //! Writes the journal header into 64 bytes at `out`.
+            static void write_header(uint8_t* out) noexcept {
+                std::fill(out, out + HEADER_SIZE, uint8_t{ 0 });
+                detail::write_u32_le(out, MAGIC);
+                detail::write_u32_le(out + 4, VERSION);
+                detail::write_u32_le(out + 8, static_cast<uint32_t>(RECORD_SIZE));
+            }
+
+            //! True if `data` starts with a journal header this version understands.
+            [[nodiscard]] static bool valid_header(const uint8_t* data, const size_t size) noexcept {
+                return data != nullptr && size >= HEADER_SIZE && detail::read_u32_le(data) == MAGIC &&
+                       detail::read_u32_le(data + 4) == VERSION && detail::read_u32_le(data + 8) == RECORD_SIZE;
+            }
+
+            /**
+             * @brief True if `data` is what a crash while the header was being written leaves behind.
+             * @details The file holds no complete record and every byte is either zero or the byte of a
+             *          fresh header at that position, so a writer may safely start the journal over.
+             */
+            [[nodiscard]] static bool unfinished_header(const uint8_t* data, const size_t size) noexcept {
+                if (data == nullptr || size >= HEADER_SIZE + RECORD_SIZE || valid_header(data, size)) return false;
+                uint8_t header[HEADER_SIZE];
+                write_header(header);
+                for (size_t i = 0; i < size; ++i)
+                    if (data[i] != 0 && (i >= HEADER_SIZE || data[i] != header[i])) return false;
+                return true;
+            }
+
+            /**
+             * @brief Counts the intact records at the start of a journal.
+             * @details A record is intact when it is complete, its checksum matches and its index equals its
+             *          position. Counting stops at the first record that is not.
+             */
+            [[nodiscard]] static size_t intact_records(const uint8_t* data, const size_t size) noexcept {
+                if (!valid_header(data, size)) return 0;
+                const size_t available = (size - HEADER_SIZE) / RECORD_SIZE;
+                size_t count = 0;
+                for (const uint8_t* record = data + HEADER_SIZE; count < available; ++count, record += RECORD_SIZE)
+                    if (detail::read_u32_le(record + INDEX_POS) != static_cast<uint32_t>(count) ||
+                        detail::read_u32_le(record + CHECKSUM_POS) != checksum(record))
+                        break;
+                return count;
+            }
+        };
+
+        /**
+         * @class record
+         * @brief A zero-copy view of one journal record.
+         * @warning Valid only while the `reader` it came from is alive.
+         */
+        class record {
+        public:
+            explicit record(const uint8_t* data) noexcept : data_(data) {}
+
+            [[nodiscard]] const uint8_t* image() const noexcept { return data_; }
+            [[nodiscard]] area get_area() const noexcept { return static_cast<area>(data_[format::AREA_POS]); }
+            [[nodiscard]] std::time_t get_card_effective_date() const noexcept {
+                return static_cast<std::time_t>(detail::read_u64_le(data_ + format::EFFECTIVE_DATE_POS));
+            }
+            [[nodiscard]] uint64_t get_timestamp() const noexcept { return detail::read_u64_le(data_ + format::TIMESTAMP_POS); }
+            [[nodiscard]] uint32_t get_index() const noexcept { return detail::read_u32_le(data_ + format::INDEX_POS); }
+
+            //! Decodes the recorded terminal.
+            [[nodiscard]] csa::terminal get_terminal() const { return csa::terminal::try_parse(data_ + format::TERMINAL_POS, csa::terminal::DATA_SIZE).value(); }
+
+            /**
+             * @brief Views the recorded image as a CSA.
+             * @throws std::logic_error if the record holds an OSA.
+             */
+            [[nodiscard]] csa::view get_csa_view() const {
+                if (get_area() != area::csa) throw std::logic_error("Journal record does not hold a CSA.");
+                return { data_, format::IMAGE_SIZE, get_card_effective_date() };
+            }
+
+            /**
+             * @brief Views the recorded image as an OSA.
+             * @throws std::logic_error if the record holds a CSA.
+             */
+            [[nodiscard]] osa::view get_osa_view() const {
+                if (get_area() != area::osa) throw std::logic_error("Journal record does not hold an OSA.");
+                return { data_, format::IMAGE_SIZE, get_card_effective_date() };
+            }
+
+        private:
+            const uint8_t* data_;
+        };
+
+        /**
+         * @class writer
+         * @brief Appends tap records to a journal file in durable groups.
+         *
+         * @details Records are staged in a buffer of `group_size` records allocated at construction; `append()`
+         *          serializes the card straight into the next slot and never allocates. When the group is full
+         *          it is written with one system call and, if `sync_each_group` is set, synced to storage before
+         *          the next record is accepted. `flush()` and `sync()` force the same for a partial group, e.g.
+         *          before powering down the reader. The destructor syncs whatever is still staged.
+         *
+         *          Opening an existing journal keeps its intact records, truncates anything after them (a torn
+         *          tail from a power cut) and continues the record numbering.
+         *
+         *          If a write fails part-way through a group (e.g. the disk is full), the file is cut back to
+         *          the last fully written group and the group stays staged, so a later `flush()` writes it
+         *          again in the right place instead of after the partial bytes.
+         *
+         * @usage
+         * @code
+         *     journal::writer out("/var/spool/gate/2025-09-08.olj");
+         *     out.append(card, now_ms, gate_terminal);   // After each successful tap.
+         *     out.sync();                                // Before the bulk upload.
+         * @endcode
+         */
+        class writer {
+        public:
+
+            /**
+             * @brief Opens or creates a journal for appending.
+             * @param path The journal file.
+             * @param group_size The number of records written per system call. What to send: 1 for one write per tap.
+             * @param sync_each_group Whether every group is synced to storage before the next record is accepted.
+             * @details A file left with a partial or zeroed header and no records, as a crash right after
+             *          creating it does, is started over with a fresh header.
+             * @throws std::invalid_argument if `group_size` is 0 or the file is not a journal;
+             *         std::system_error if the file cannot be opened, repaired or written.
+             */
+            explicit writer(const std::string& path, const size_t group_size = 64, const bool sync_each_group = true)
+                : group_size_(group_size), sync_each_group_(sync_each_group) {
+                if (group_size == 0) throw std::invalid_argument("Journal group size must be greater than zero.");
+                buffer_.resize(group_size * format::RECORD_SIZE);
+                size_t intact = 0;
+                bool fresh = true;
+                {
+                    std::error_code ignored;
+                    if (std::filesystem::exists(path, ignored) && std::filesystem::file_size(path, ignored) > 0) {
+                        const pipeline::mapped_file existing(path);
+                        if (!format::unfinished_header(existing.data(), existing.size())) {
+                            if (!format::valid_header(existing.data(), existing.size()))
+                                throw std::invalid_argument("Existing file is not a tap journal: " + path);
+                            intact = format::intact_records(existing.data(), existing.size());
+                            fresh = false;
+                        }
+                    }
+                }
+                open(path, format::HEADER_SIZE + intact * format::RECORD_SIZE, fresh);
+                next_index_ = static_cast<uint32_t>(intact);
+            }
+
+            ~writer() {
+                try { sync(); } catch (...) {}
+                close();
+            }
+
+            writer(const writer&) = delete;
+            writer& operator=(const writer&) = delete;
+
+            //! Appends a CSA tap. @throws std::logic_error if the card's effective date is not set.
+            void append(const csa::container& card, const uint64_t timestamp_in_milliseconds, const csa::terminal& terminal_info) {
+                uint8_t* slot = next_slot();
+                card.serialize_into(slot);
+                finish(slot, area::csa, static_cast<int64_t>(card.get_card_effective_date()), timestamp_in_milliseconds, terminal_info);
+            }
+
+            //! Appends an OSA tap. @throws std::logic_error if the card's effective date is not set.
+            void append(const osa::container& card, const uint64_t timestamp_in_milliseconds, const csa::terminal& terminal_info) {
+                uint8_t* slot = next_slot();
+                card.serialize_into(slot);
+                finish(slot, area::osa, static_cast<int64_t>(card.get_card_effective_date()), timestamp_in_milliseconds, terminal_info);
+            }
+
+            /**
+             * @brief Appends a tap from a raw card image, e.g. the reader's receive buffer after write-back.
+             * @param image What to send: the 96 card bytes.
+             */
+            void append(const area card_area, const uint8_t* image, const std::time_t card_effective_date_in_minutes,
+                        const uint64_t timestamp_in_milliseconds, const csa::terminal& terminal_info) {
+                uint8_t* slot = next_slot();
+                std::copy(image, image + format::IMAGE_SIZE, slot);
+                finish(slot, card_area, static_cast<int64_t>(card_effective_date_in_minutes), timestamp_in_milliseconds, terminal_info);
+            }
+
+            /**
+             * @brief Writes the staged records to the file (no sync).
+             * @throws std::system_error on a write failure. The staged records are kept and the file holds
+             *         only the records written before this call, so calling `flush()` again retries the group.
+             */
+            void flush() {
+                if (staged_ == 0) return;
+                // A previous failure could not cut the partial group off; do it before writing past it.
+                if (torn_) truncate_to(committed_size_);
+                try {
+                    write_all(buffer_.data(), staged_ * format::RECORD_SIZE);
+                } catch (...) {
+                    torn_ = true;
+                    try { truncate_to(committed_size_); } catch (...) {}
+                    throw;
+                }
+                committed_size_ += staged_ * format::RECORD_SIZE;
+                staged_ = 0;
+            }
+
+            //! Writes the staged records and syncs the file to storage. @throws std::system_error on failure.
+            void sync() {
+                flush();
+                sync_file();
+            }
+
+            //! The number of records in the journal, including staged ones.
+            [[nodiscard]] size_t size() const noexcept { return next_index_; }
+            //! The number of records appended but not yet written.
+            [[nodiscard]] size_t staged() const noexcept { return staged_; }
+
+        private:
+
+            [[nodiscard]] uint8_t* next_slot() {
+                if (staged_ == group_size_) {
+                    flush();
+                    if (sync_each_group_) sync_file();
+                }
+                return buffer_.data() + staged_ * format::RECORD_SIZE;
+            }
+
+            void finish(uint8_t* slot, const area card_area, const int64_t effective_date, const uint64_t timestamp,
+                        const csa::terminal& terminal_info) noexcept {
+                detail::write_u64_le(slot + format::EFFECTIVE_DATE_POS, static_cast<uint64_t>(effective_date));
+                detail::write_u64_le(slot + format::TIMESTAMP_POS, timestamp);
+                terminal_info.serialize_into(slot + format::TERMINAL_POS);
+                slot[format::AREA_POS] = static_cast<uint8_t>(card_area);
+                slot[format::AREA_POS + 1] = 0;
+                detail::write_u32_le(slot + format::INDEX_POS, next_index_);
+                detail::write_u32_le(slot + format::CHECKSUM_POS, format::checksum(slot));
+                ++next_index_;
+                ++staged_;
+            }
+
+            [[noreturn]] static void throw_last_error(const std::string& message) {
+#ifdef _WIN32
+                throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), message);
+#else
+                throw std::system_error(errno, std::generic_category(), message);
+#endif
+            }
+
+            //! Opens the file, cuts it to `valid_size` bytes and, for a new journal, writes the header.
+            void open(const std::string& path, const uint64_t valid_size, const bool fresh) {
+#ifdef _WIN32
+                file_ = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+                if (file_ == INVALID_HANDLE_VALUE) throw_last_error("Unable to open journal: " + path);
+                LARGE_INTEGER end;
+                end.QuadPart = static_cast<LONGLONG>(fresh ? 0 : valid_size);
+                if (!SetFilePointerEx(file_, end, nullptr, FILE_BEGIN) || !SetEndOfFile(file_)) {
+                    close();
+                    throw_last_error("Unable to repair journal: " + path);
+                }
+#else
+                fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+                if (fd_ < 0) throw_last_error("Unable to open journal: " + path);
+                if (::ftruncate(fd_, static_cast<off_t>(fresh ? 0 : valid_size)) != 0) {
+                    close();
+                    throw_last_error("Unable to repair journal: " + path);
+                }
+#endif
+                if (fresh) {
+                    uint8_t header[format::HEADER_SIZE];
+                    format::write_header(header);
+                    write_all(header, sizeof(header));
+                }
+                committed_size_ = fresh ? format::HEADER_SIZE : valid_size;
+                sync_file();
+            }
+
+            //! Cuts the file to `size` bytes; appends continue from there. Clears `torn_` on success.
+            void truncate_to(const uint64_t size) {
+#ifdef _WIN32
+                LARGE_INTEGER end;
+                end.QuadPart = static_cast<LONGLONG>(size);
+                if (!SetFilePointerEx(file_, end, nullptr, FILE_BEGIN) || !SetEndOfFile(file_))
+                    throw_last_error("Unable to roll back journal.");
+#else
+                // The descriptor is O_APPEND, so the next write lands at the new end.
+                if (::ftruncate(fd_, static_cast<off_t>(size)) != 0) throw_last_error("Unable to roll back journal.");
+#endif
+                torn_ = false;
+            }
+
+            void write_all(const uint8_t* data, size_t size) {
+                while (size > 0) {
+#ifdef _WIN32
+                    DWORD written = 0;
+                    const DWORD chunk = static_cast<DWORD>(std::min<size_t>(size, 1u << 30));
+                    if (!WriteFile(file_, data, chunk, &written, nullptr)) throw_last_error("Unable to write journal.");
+#else
+                    const ssize_t written = ::write(fd_, data, size);
+                    if (written < 0) {
+                        if (errno == EINTR) continue;
+                        throw_last_error("Unable to write journal.");
+                    }
+#endif
+                    data += written;
+                    size -= static_cast<size_t>(written);
+                }
+            }
+
+            void sync_file() {
+#ifdef _WIN32
+                if (!FlushFileBuffers(file_)) throw_last_error("Unable to sync journal.");
+#else
+#ifdef __APPLE__
+                if (::fsync(fd_) != 0) throw_last_error("Unable to sync journal.");
+#else
+                if (::fdatasync(fd_) != 0) throw_last_error("Unable to sync journal.");
+#endif
+#endif
+            }
+
+            void close() noexcept {
+#ifdef _WIN32
+                if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+                file_ = INVALID_HANDLE_VALUE;
+#else
+                if (fd_ >= 0) ::close(fd_);
+                fd_ = -1;
+#endif
+            }
+
+            std::vector<uint8_t> buffer_;
+            size_t group_size_;
+            size_t staged_{ 0 };
+            bool sync_each_group_;
+            //! The file size up to the last fully written group.
+            uint64_t committed_size_{ 0 };
+            //! True if a failed write left bytes after `committed_size_` that could not be cut off.
+            bool torn_{ false };
+            uint32_t next_index_{ 0 };
+#ifdef _WIN32
+            HANDLE file_{ INVALID_HANDLE_VALUE };
+#else
+            int fd_{ -1 };
+#endif
+        };
+
+        /**
+         * @class reader
+         * @brief Memory-maps a journal and exposes its intact records without copying.
+         *
+         * @details The journal is validated once when it is opened. Records past the first torn or stale one
+         *          are ignored and reported through `discarded_bytes()`.
+         *
+         * @usage
+         * @code
+         *     const journal::reader in("/var/spool/gate/2025-09-08.olj");
+         *     for (size_t i = 0; i < in.size(); ++i)
+         *         if (in[i].get_area() == journal::area::csa) upload(in[i].get_csa_view(), in[i].get_timestamp());
+         * @endcode
+         */
+        class reader {
+        public:
+
+            /**
+             * @brief Opens a journal.
+             * @throws std::system_error if the file cannot be mapped; std::invalid_argument if it is not a journal.
+             */
+            explicit reader(const std::string& path) : file_(std::make_unique<pipeline::mapped_file>(path)) {
+                if (!format::valid_header(file_->data(), file_->size()))
+                    throw std::invalid_argument("File is not a tap journal: " + path);
+                size_ = format::intact_records(file_->data(), file_->size());
+            }
+
+            //! The number of intact records.
+            [[nodiscard]] size_t size() const noexcept { return size_; }
+            [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+            //! Views record `index`. What to send: an index below `size()`; not bounds-checked.
+            [[nodiscard]] record operator[](const size_t index) const noexcept {
+                return record(file_->data() + format::HEADER_SIZE + index * format::RECORD_SIZE);
+            }
+
+            //! Views record `index`. @throws std::out_of_range if `index` is not below `size()`.
+            [[nodiscard]] record at(const size_t index) const {
+                if (index >= size_) throw std::out_of_range("Journal record index is out of bounds.");
+                return (*this)[index];
+            }
+
+            //! The number of trailing bytes after the last intact record (a torn tail), ignored by the reader.
+            [[nodiscard]] size_t discarded_bytes() const noexcept {
+                return file_->size() - format::HEADER_SIZE - size_ * format::RECORD_SIZE;
+            }
+
+        private:
+            std::unique_ptr<pipeline::mapped_file> file_;
+            size_t size_{ 0 };
+        };
+
+    }
+
+}
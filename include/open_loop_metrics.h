@@ -0,0 +1,353 @@
+/**
+ * @file open_loop_metrics.h
+ * @brief Opt-in counters and latency histograms for the container parse/serialize paths and the failure paths.
+ * @details Build with `OPEN_LOOP_METRICS` defined (CMake: `-DOPEN_LOOP_ENABLE_METRICS=ON`) to record:
+ *          - the number of calls and the elapsed CPU ticks of every `metrics::operation`, with a log2
+ *            histogram of the per-call ticks;
+ *          - every exception thrown by the classic API, split by exception type;
+ *          - every non-`ok` `status_code` returned by the containers' `try_parse()`.
+ *
+ *          Each thread accumulates into its own cache-aligned slot. The owner is the only writer, so an
+ *          update is a relaxed load and store with no locked instruction. `metrics::collect()` sums every
+ *          slot and may be called at any time from any thread, e.g. by a metrics agent. Slots are recycled
+ *          when threads exit, and their counts are kept, so totals only ever grow. Report rates by
+ *          differencing two snapshots.
+ *
+ *          Without `OPEN_LOOP_METRICS`, the hooks are empty inline functions and types that compile to
+ *          nothing. `collect()` then returns an all-zero snapshot, so agent code builds either way.
+ *
+ * @author Govind Yadav
+ * @version 1.1
+ * @date 2025-09-08
+ */
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#ifdef OPEN_LOOP_METRICS
+#include <atomic>
+#include <chrono>
+#include <new>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace open_loop {
+
+    /**
+     * @namespace metrics
+     * @brief Per-thread, lock-free instrumentation of the library's hot and failure paths.
+     *
+     * @usage
+     * @code
+     *     // On the metrics agent's scrape interval:
+     *     const metrics::snapshot now = metrics::collect();
+     *     const metrics::operation_stats& parses = now[metrics::operation::csa_parse];
+     *     publish("csa_parse_calls", parses.calls - previous[metrics::operation::csa_parse].calls);
+     *     publish("csa_invalid_size", now.statuses[static_cast<size_t>(status_code::invalid_size)]);
+     *     previous = now;
+     * @endcode
+     */
+    namespace metrics {
+
+        //! True if the library was compiled with `OPEN_LOOP_METRICS`.
+#ifdef OPEN_LOOP_METRICS
+        constexpr bool ENABLED = true;
+#else
+        constexpr bool ENABLED = false;
+#endif
+
+        /**
+         * @enum operation
+         * @brief The instrumented library calls.
+         */
+        enum class operation : uint8_t {
+            //! `csa::container::parse()` / `try_parse()`.
+            csa_parse,
+            //! `csa::container::serialize_into()`, and therefore `to_bytes()`, `to_array()` and `patch_into()`.
+            csa_serialize,
+            //! `csa::history::add_log()`.
+            csa_add_log,
+            //! `osa::basic_container::parse()` / `try_parse()`.
+            osa_parse,
+            //! `osa::basic_container::serialize_into()`, and therefore `to_bytes()`, `to_array()` and `patch_into()`.
+            osa_serialize,
+            //! `osa::basic_history::add_record()`.
+            osa_add_record
+        };
+
+        /**
+         * @enum exception_kind
+         * @brief The exception types thrown by the classic API.
+         */
+        enum class exception_kind : uint8_t {
+            logic_error,
+            invalid_argument,
+            out_of_range
+        };
+
+        //! The number of `operation` values.
+        constexpr size_t OPERATION_COUNT = 6;
+        //! The number of `exception_kind` values.
+        constexpr size_t EXCEPTION_KIND_COUNT = 3;
+        //! The number of status counters; `status_code` values index them directly.
+        constexpr size_t STATUS_CODE_COUNT = 32;
+        //! Histogram bucket `i > 0` counts calls of `[2^(i-1), 2^i)` ticks; bucket 0 counts calls of 0 ticks and
+        //! the last bucket everything longer.
+        constexpr size_t HISTOGRAM_BUCKETS = 40;
+
+        [[nodiscard]] constexpr const char* to_string(const operation op) noexcept {
+            switch (op) {
+                case operation::csa_parse:      return "csa_parse";
+                case operation::csa_serialize:  return "csa_serialize";
+                case operation::csa_add_log:    return "csa_add_log";
+                case operation::osa_parse:      return "osa_parse";
+                case operation::osa_serialize:  return "osa_serialize";
+                case operation::osa_add_record: return "osa_add_record";
+                default:                        return "unknown";
+            }
+        }
+
+        [[nodiscard]] constexpr const char* to_string(const exception_kind kind) noexcept {
+            switch (kind) {
+                case exception_kind::logic_error:      return "logic_error";
+                case exception_kind::invalid_argument: return "invalid_argument";
+                case exception_kind::out_of_range:     return "out_of_range";
+                default:                               return "unknown";
+            }
+        }
+
+        /**
+         * @struct operation_stats
+         * @brief The accumulated calls and latency of one `operation`.
+         */
+        struct operation_stats {
+            uint64_t calls{ 0 };
+            //! The total elapsed ticks (TSC cycles on x86, the virtual counter on AArch64, nanoseconds elsewhere).
+            uint64_t ticks{ 0 };
+            std::array<uint64_t, HISTOGRAM_BUCKETS> histogram{};
+        };
+
+        /**
+         * @struct snapshot
+         * @brief The process-wide totals returned by `collect()`.
+         * @details Counters of threads that are running during `collect()` are read without stopping them,
+         *          so `calls`, `ticks` and `histogram` of one operation may differ by the calls in flight.
+         */
+        struct snapshot {
+            std::array<operation_stats, OPERATION_COUNT> operations{};
+            //! Thrown exceptions, indexed by `exception_kind`.
+            std::array<uint64_t, EXCEPTION_KIND_COUNT> exceptions{};
+            //! Failed `try_parse()` calls, indexed by `status_code`.
+            std::array<uint64_t, STATUS_CODE_COUNT> statuses{};
+
+            [[nodiscard]] const operation_stats& operator[](const operation op) const noexcept { return operations[static_cast<size_t>(op)]; }
+            [[nodiscard]] uint64_t exception_count(const exception_kind kind) const noexcept { return exceptions[static_cast<size_t>(kind)]; }
+        };
+
+    }
+
+#ifdef OPEN_LOOP_METRICS
+
+    namespace detail {
+
+        //! The counters of one thread. Only the owning thread writes; `metrics::collect()` reads concurrently.
+        struct alignas(64) metrics_slot {
+            std::atomic<uint64_t> calls[metrics::OPERATION_COUNT]{};
+            std::atomic<uint64_t> ticks[metrics::OPERATION_COUNT]{};
+            std::atomic<uint64_t> histogram[metrics::OPERATION_COUNT][metrics::HISTOGRAM_BUCKETS]{};
+            std::atomic<uint64_t> exceptions[metrics::EXCEPTION_KIND_COUNT]{};
+            std::atomic<uint64_t> statuses[metrics::STATUS_CODE_COUNT]{};
+            std::atomic<bool> in_use{ true };
+            metrics_slot* next{ nullptr };
+        };
+
+        //! Single-writer increment: no read-modify-write instruction is needed.
+        inline void bump(std::atomic<uint64_t>& counter, const uint64_t amount) noexcept {
+            counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief The list of every slot ever created. Slots are never freed, so `collect()` can walk the list
+         *        while threads start and exit; an exiting thread only marks its slot free for reuse.
+         */
+        class metrics_registry {
+        public:
+            [[nodiscard]] static metrics_registry& instance() noexcept {
+                static metrics_registry registry;
+                return registry;
+            }
+
+            //! Claims a free slot or appends a new one. Falls back to a shared slot if allocation fails.
+            [[nodiscard]] metrics_slot* acquire() noexcept {
+                for (metrics_slot* s = head_.load(std::memory_order_acquire); s != nullptr; s = s->next) {
+                    bool expected = false;
+                    if (s->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) return s;
+                }
+                auto* slot = new (std::nothrow) metrics_slot();
+                if (slot == nullptr) return &shared_;
+                slot->next = head_.load(std::memory_order_relaxed);
+                while (!head_.compare_exchange_weak(slot->next, slot, std::memory_order_release, std::memory_order_relaxed)) {}
+                return slot;
+            }
+
+            //! Marks `slot` free for reuse. The shared slot is never released: other threads may still be using it.
+            void release(metrics_slot* slot) noexcept {
+                if (slot != &shared_) slot->in_use.store(false, std::memory_order_release);
+            }
+
+            [[nodiscard]] metrics_slot* head() const noexcept { return head_.load(std::memory_order_acquire); }
+
+        private:
+            //! Permanently in use; threads share it only when no slot could be allocated, and may then lose counts.
+            metrics_slot shared_;
+            std::atomic<metrics_slot*> head_{ &shared_ };
+        };
+
+        //! Owns the calling thread's slot and hands it back when the thread exits.
+        class metrics_lease {
+        public:
+            metrics_lease() noexcept : slot_(metrics_registry::instance().acquire()) {}
+            ~metrics_lease() { metrics_registry::instance().release(slot_); }
+            metrics_lease(const metrics_lease&) = delete;
+            metrics_lease& operator=(const metrics_lease&) = delete;
+            [[nodiscard]] metrics_slot& slot() const noexcept { return *slot_; }
+        private:
+            metrics_slot* slot_;
+        };
+
+        [[nodiscard]] inline metrics_slot& local_metrics() noexcept {
+            thread_local metrics_lease lease;
+            return lease.slot();
+        }
+
+        //! Reads the cheapest monotonic tick counter of the platform.
+        [[nodiscard]] inline uint64_t read_ticks() noexcept {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+            return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#elif defined(__aarch64__)
+            uint64_t value;
+            asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+            return value;
+#else
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+        }
+
+        //! The histogram bucket of a duration: its bit width, capped at the last bucket.
+        [[nodiscard]] inline size_t histogram_bucket(uint64_t ticks) noexcept {
+            size_t width = 0;
+#if defined(__GNUC__) || defined(__clang__)
+            width = ticks == 0 ? 0 : static_cast<size_t>(64 - __builtin_clzll(ticks));
+#else
+            while (ticks != 0) { ticks >>= 1; ++width; }
+#endif
+            return width < metrics::HISTOGRAM_BUCKETS ? width : metrics::HISTOGRAM_BUCKETS - 1;
+        }
+
+    }
+
+#endif
+
+    namespace metrics {
+
+        /**
+         * @class scoped_timer
+         * @brief Records one call of an `operation` and the ticks until the timer goes out of scope.
+         * @details The library places one at the top of every instrumented function. Without
+         *          `OPEN_LOOP_METRICS` it is an empty object whose constructor does nothing.
+         */
+        class scoped_timer {
+        public:
+#ifdef OPEN_LOOP_METRICS
+            explicit scoped_timer(const operation op) noexcept : op_(op), start_(detail::read_ticks()) {}
+            ~scoped_timer() {
+                const uint64_t elapsed = detail::read_ticks() - start_;
+                const size_t index = static_cast<size_t>(op_);
+                detail::metrics_slot& slot = detail::local_metrics();
+                detail::bump(slot.calls[index], 1);
+                detail::bump(slot.ticks[index], elapsed);
+                detail::bump(slot.histogram[index][detail::histogram_bucket(elapsed)], 1);
+            }
+#else
+            explicit constexpr scoped_timer(const operation) noexcept {}
+#endif
+            scoped_timer(const scoped_timer&) = delete;
+            scoped_timer& operator=(const scoped_timer&) = delete;
+
+#ifdef OPEN_LOOP_METRICS
+        private:
+            operation op_;
+            uint64_t start_;
+#endif
+        };
+
+        //! Counts an exception of the given kind. Does nothing without `OPEN_LOOP_METRICS`.
+        inline void record_exception([[maybe_unused]] const exception_kind kind) noexcept {
+#ifdef OPEN_LOOP_METRICS
+            detail::bump(detail::local_metrics().exceptions[static_cast<size_t>(kind)], 1);
+#endif
+        }
+
+        /**
+         * @brief Counts an exception and returns it, so that a throw site reads `throw metrics::counted(std::logic_error(...))`.
+         * @details Overloaded on the exact type so that each standard exception lands in its own counter.
+         */
+        inline std::logic_error counted(std::logic_error e) noexcept {
+            record_exception(exception_kind::logic_error);
+            return e;
+        }
+        inline std::invalid_argument counted(std::invalid_argument e) noexcept {
+            record_exception(exception_kind::invalid_argument);
+            return e;
+        }
+        inline std::out_of_range counted(std::out_of_range e) noexcept {
+            record_exception(exception_kind::out_of_range);
+            return e;
+        }
+
+        /**
+         * @brief Counts a failed `try_parse()` and returns its status code unchanged.
+         * @tparam Code `status_code`. A template so that this header does not depend on the service header.
+         */
+        template <typename Code>
+        inline Code rejected(const Code code) noexcept {
+#ifdef OPEN_LOOP_METRICS
+            const size_t index = static_cast<size_t>(code);
+            if (index < STATUS_CODE_COUNT) detail::bump(detail::local_metrics().statuses[index], 1);
+#endif
+            return code;
+        }
+
+        /**
+         * @brief Sums the counters of every thread that has used the library.
+         * @return The process-wide totals; all zero without `OPEN_LOOP_METRICS`. Never blocks a recording thread.
+         */
+        [[nodiscard]] inline snapshot collect() noexcept {
+            snapshot totals;
+#ifdef OPEN_LOOP_METRICS
+            for (const detail::metrics_slot* s = detail::metrics_registry::instance().head(); s != nullptr; s = s->next) {
+                for (size_t op = 0; op < OPERATION_COUNT; ++op) {
+                    totals.operations[op].calls += s->calls[op].load(std::memory_order_relaxed);
+                    totals.operations[op].ticks += s->ticks[op].load(std::memory_order_relaxed);
+                    for (size_t b = 0; b < HISTOGRAM_BUCKETS; ++b)
+                        totals.operations[op].histogram[b] += s->histogram[op][b].load(std::memory_order_relaxed);
+                }
+                for (size_t k = 0; k < EXCEPTION_KIND_COUNT; ++k) totals.exceptions[k] += s->exceptions[k].load(std::memory_order_relaxed);
+                for (size_t c = 0; c < STATUS_CODE_COUNT; ++c) totals.statuses[c] += s->statuses[c].load(std::memory_order_relaxed);
+            }
+#endif
+            return totals;
+        }
+
+    }
+
+}
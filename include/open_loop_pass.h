@@ -0,0 +1,209 @@
+/**
+ * @file open_loop_pass.h
+ * @brief Selection and consumption of OSA trip passes directly on the raw card image.
+ * @details At an OSA gate the validator has to find the pass that pays for the journey among the trip pass
+ *          slots, apply the daily usage rules and decrement its remaining trips. Doing that through
+ *          `osa::container` decodes every pass and goes through the bounds-checked `get_trip_pass()` for
+ *          each lookup. `osa::pass_selector` instead reads the handful of fields it needs from the raw
+ *          20-byte slots, scores every slot with the same branch-free arithmetic, and patches only the
+ *          consumed slot's counters in place.
+ *
+ * @author Govind Yadav
+ * @version 1.1
+ * @date 2025-09-08
+ */
+
+#pragma once
+#include <cstdint>
+#include <limits>
+#include "open_loop_service.h"
+
+namespace open_loop {
+
+    namespace osa {
+
+        /**
+         * @struct journey
+         * @brief The gate-side facts a trip pass is checked against.
+         */
+        struct journey {
+            //! The station where the journey starts.
+            uint16_t source_id{ 0 };
+            //! The station where the journey ends (or the gate's own station for single-tap products).
+            uint16_t destination_id{ 0 };
+            //! The time of the tap in milliseconds since the Unix epoch.
+            uint64_t time_in_milliseconds{ 0 };
+            //! The operating day of the tap, in the same units as the pass's daily trip indicator
+            //! (see `basic_pass_selector::day_indicator()`).
+            uint16_t day_indicator{ 0 };
+        };
+
+        /**
+         * @struct pass_result
+         * @brief The outcome of `basic_pass_selector::consume()`.
+         */
+        struct pass_result {
+            //! `status_code::ok`, or the reason no trip was consumed. The buffer is unchanged on failure.
+            status_code status{ status_code::ok };
+            //! The index of the consumed pass slot. Only meaningful on success.
+            size_t slot{ 0 };
+            //! The remaining trips on the consumed pass after this journey.
+            uint16_t remaining_trips{ 0 };
+            //! The trips made on the consumed pass today, including this one.
+            uint8_t daily_trip_counter{ 0 };
+            //! The bytes of the card that changed, in card offsets.
+            dirty_ranges dirty;
+
+            [[nodiscard]] bool ok() const noexcept { return status == status_code::ok; }
+        };
+
+        /**
+         * @class basic_pass_selector
+         * @brief Picks and consumes the applicable trip pass of an OSA laid out as `Layout`.
+         *
+         * @details A slot is **applicable** to a journey when all of the following hold:
+         *          - it has at least one remaining trip;
+         *          - the tap time lies within `[start, expiry]` (a start of 0 means "valid immediately");
+         *          - its route matches: `source_id` and `destination_id` equal the journey's stations in either
+         *            direction, where 0 on the pass matches any station;
+         *          - its daily limit is not exhausted: if the pass's daily trip indicator is today, its counter
+         *            must be below the selector's daily limit (0 = unlimited). A pass last used on another
+         *            day counts as unused today.
+         *
+         *          Among the applicable slots the one with the **lowest** `priority` value wins, then the one
+         *          that expires first, then the lower slot index. Every slot is evaluated with the same
+         *          arithmetic and reduced to one 64-bit ranking key, so the selection has no data-dependent
+         *          branches.
+         *
+         *          Consuming a pass decrements its remaining trips, and either increments its daily counter or,
+         *          when the pass was last used on another day, resets the counter to 1 and stores today's
+         *          indicator.
+         *
+         * @usage
+         * @code
+         *     const osa::pass_selector selector(4); // At most 4 trips per day on any pass.
+         *     const osa::pass_result r = selector.consume(rx_buffer, 96, { entry_station, gate_station, now_ms,
+         *                                                                  osa::pass_selector::day_indicator(now_ms) });
+         *     if (r.ok()) write_blocks(rx_buffer, r.dirty.block_mask(16));
+         * @endcode
+         */
+        template <typename Layout>
+        class basic_pass_selector {
+        public:
+            using container_type = basic_container<Layout>;
+
+            //! The number of pass slots on the card.
+            static constexpr size_t NUM_TRIP_PASSES = container_type::NUM_TRIP_PASSES;
+            //! The offset of the first pass slot within the card.
+            static constexpr size_t REGION_OFFSET = container_type::TRIP_PASS_START_OFFSET;
+            //! The size of the pass region (40 bytes for the standard layout).
+            static constexpr size_t REGION_SIZE = NUM_TRIP_PASSES * trip_pass::DATA_SIZE;
+            //! Returned by `select()` when no slot is applicable.
+            static constexpr size_t NO_PASS = std::numeric_limits<size_t>::max();
+
+            /**
+             * @brief Creates a selector.
+             * @param daily_trip_limit The maximum trips per pass per day. What to send: 0 for no daily limit.
+             */
+            explicit basic_pass_selector(const uint8_t daily_trip_limit = 0) noexcept : daily_trip_limit_(daily_trip_limit) {}
+
+            /**
+             * @brief Computes the day indicator of a timestamp: whole days since the Unix epoch, truncated to 16 bits.
+             * @param time_in_milliseconds The tap time in milliseconds since the Unix epoch.
+             * @param utc_offset_minutes The operator's local offset from UTC, so that the day rolls over at local midnight.
+             */
+            [[nodiscard]] static constexpr uint16_t day_indicator(const uint64_t time_in_milliseconds, const int32_t utc_offset_minutes = 0) noexcept {
+                const int64_t local_ms = static_cast<int64_t>(time_in_milliseconds) + static_cast<int64_t>(utc_offset_minutes) * 60000;
+                return static_cast<uint16_t>(local_ms / 86400000);
+            }
+
+            /**
+             * @brief Finds the applicable pass for a journey without modifying anything.
+             * @param passes A pointer to the first byte of the raw pass region (`card + REGION_OFFSET`).
+             *               What to send: `REGION_SIZE` readable bytes.
+             * @param trip The journey to validate.
+             * @return The slot index of the selected pass, or `NO_PASS`.
+             */
+            [[nodiscard]] size_t select(const uint8_t* passes, const journey& trip) const noexcept {
+                uint64_t best = std::numeric_limits<uint64_t>::max();
+                for (size_t slot = 0; slot < NUM_TRIP_PASSES; ++slot)
+                    best = std::min(best, rank(passes + slot * trip_pass::DATA_SIZE, slot, trip));
+                return (best >> 63) != 0 ? NO_PASS : static_cast<size_t>(best & 0xFF);
+            }
+
+            /**
+             * @brief Selects and consumes one trip from the applicable pass of an OSA, in place.
+             * @param card A pointer to the first byte of the OSA. Modified only on success.
+             * @param size The number of bytes at `card`. What to send: Exactly `container_type::BLOCK_SIZE` (96).
+             * @param trip The journey being validated.
+             * @return The consumed slot, its updated counters, and the changed byte ranges; or
+             *         `status_code::invalid_size` / `status_code::no_applicable_pass`.
+             */
+            [[nodiscard]] pass_result consume(uint8_t* card, const size_t size, const journey& trip) const noexcept {
+                pass_result result;
+                if (size != container_type::BLOCK_SIZE) {
+                    result.status = status_code::invalid_size;
+                    return result;
+                }
+                const size_t slot = select(card + REGION_OFFSET, trip);
+                if (slot == NO_PASS) {
+                    result.status = status_code::no_applicable_pass;
+                    return result;
+                }
+
+                uint8_t* pass = card + REGION_OFFSET + slot * trip_pass::DATA_SIZE;
+                const bool same_day = detail::read_u16_be(pass + view::PASS_DAILY_INDICATOR_POS) == trip.day_indicator;
+                result.slot = slot;
+                result.remaining_trips = static_cast<uint16_t>(detail::read_u16_be(pass + view::PASS_REMAINING_POS) - 1);
+                const uint8_t counter = pass[view::PASS_DAILY_COUNTER_POS];
+                result.daily_trip_counter = same_day ? static_cast<uint8_t>(counter + (counter != 0xFF)) : uint8_t{ 1 };
+
+                // Remaining trips (bytes 7-8) and the daily counter and indicator (bytes 14-16) are rewritten;
+                // the span between them is reported as one dirty range.
+                detail::write_u16_be(pass + view::PASS_REMAINING_POS, result.remaining_trips);
+                pass[view::PASS_DAILY_COUNTER_POS] = result.daily_trip_counter;
+                detail::write_u16_be(pass + view::PASS_DAILY_INDICATOR_POS, trip.day_indicator);
+                const size_t first = REGION_OFFSET + slot * trip_pass::DATA_SIZE + view::PASS_REMAINING_POS;
+                result.dirty.add(first, view::PASS_DAILY_INDICATOR_POS + 2 - view::PASS_REMAINING_POS);
+                return result;
+            }
+
+            [[nodiscard]] uint8_t get_daily_trip_limit() const noexcept { return daily_trip_limit_; }
+
+        private:
+
+            /**
+             * @brief Reduces one slot to a ranking key; the smallest key wins.
+             * @details Layout: bit 63 = not applicable, bits 40-47 = priority, bits 16-39 = expiry, bits 0-7 = slot.
+             */
+            [[nodiscard]] uint64_t rank(const uint8_t* pass, const size_t slot, const journey& trip) const noexcept {
+                const uint64_t now = trip.time_in_milliseconds / 1000;
+                const uint32_t expiry = detail::read_u24_be(pass + view::PASS_EXPIRY_POS);
+                const uint32_t start = detail::read_u24_be(pass + view::PASS_START_POS);
+                const uint16_t remaining = detail::read_u16_be(pass + view::PASS_REMAINING_POS);
+                const uint16_t source = detail::read_u16_be(pass + view::PASS_SOURCE_POS);
+                const uint16_t destination = detail::read_u16_be(pass + view::PASS_DESTINATION_POS);
+                const bool same_day = detail::read_u16_be(pass + view::PASS_DAILY_INDICATOR_POS) == trip.day_indicator;
+                const uint8_t used_today = same_day ? pass[view::PASS_DAILY_COUNTER_POS] : uint8_t{ 0 };
+
+                const bool source_any = source == 0, destination_any = destination == 0;
+                const bool forward = (source_any | (source == trip.source_id)) & (destination_any | (destination == trip.destination_id));
+                const bool reverse = (source_any | (source == trip.destination_id)) & (destination_any | (destination == trip.source_id));
+                const bool applicable = (remaining != 0) & (now >= start) & (now <= expiry) & (forward | reverse) &
+                                        ((daily_trip_limit_ == 0) | (used_today < daily_trip_limit_));
+
+                return (static_cast<uint64_t>(!applicable) << 63) |
+                       (static_cast<uint64_t>(pass[view::PASS_PRIORITY_POS]) << 40) |
+                       (static_cast<uint64_t>(expiry) << 16) |
+                       static_cast<uint64_t>(slot);
+            }
+
+            uint8_t daily_trip_limit_;
+        };
+
+        //! The selector for the standard two-pass OSA.
+        using pass_selector = basic_pass_selector<standard_layout>;
+
+    }
+
+}
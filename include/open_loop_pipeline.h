@@ -0,0 +1,348 @@
+/**
+ * @file open_loop_pipeline.h
+ * @brief A multi-threaded reconciliation pipeline over files of fixed-stride 96-byte card images.
+ * @details The pipeline memory-maps an upload file, cuts it into chunks of whole records, and lets a set of
+ *          worker threads decode the chunks with `csa::batch` or `osa::batch` and hand each one to a
+ *          user-supplied visitor. Every worker owns its batch, so the only shared state is the read-only
+ *          mapping and the atomic chunk cursors; visitors that accumulate results should write into a
+ *          per-worker slot selected by `chunk::worker`.
+ *
+ *          Images do not carry their card effective date, so the caller supplies it through
+ *          `effective_dates`, either as one date for the whole file or as one date per record. The
+ *          visited chunk resolves on-card time offsets against those dates.
+ *
+ * @author Govind Yadav
+ * @version 1.1
+ * @date 2025-09-08
+ */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <ctime>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "open_loop_batch.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace open_loop {
+
+    /**
+     * @namespace pipeline
+     * @brief Bulk, multi-threaded processing of card image files.
+     */
+    namespace pipeline {
+
+        //! How a `mapped_file` will be read, passed on to the OS as a paging hint.
+        enum class access_pattern : uint8_t {
+            //! Front-to-back scans, such as the pipeline's chunked decode.
+            sequential,
+            //! Point lookups, such as deny-list searches.
+            random
+        };
+
+        /**
+         * @class mapped_file
+         * @brief A read-only memory mapping of a whole file, released on destruction.
+         *
+         * @details The mapping is advised for sequential access unless another `access_pattern` is given. An
+         *          empty file produces a valid object whose `data()` is `nullptr` and whose `size()` is 0.
+         */
+        class mapped_file {
+        public:
+
+            /**
+             * @brief Maps the file at `path` into memory.
+             * @param path The file to map.
+             * @param pattern How the mapping will be read. What to send: `random` for lookup tables.
+             * @throws std::system_error if the file cannot be opened, inspected or mapped.
+             */
+            explicit mapped_file(const std::string& path, const access_pattern pattern = access_pattern::sequential) {
+#ifdef _WIN32
+                file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                    pattern == access_pattern::random ? FILE_FLAG_RANDOM_ACCESS : FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+                if (file_ == INVALID_HANDLE_VALUE) throw_last_error("Unable to open file: " + path);
+                LARGE_INTEGER length;
+                if (!GetFileSizeEx(file_, &length)) { close(); throw_last_error("Unable to size file: " + path); }
+                size_ = static_cast<size_t>(length.QuadPart);
+                if (size_ == 0) return;
+                mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (mapping_ == nullptr) { close(); throw_last_error("Unable to map file: " + path); }
+                data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+                if (data_ == nullptr) { close(); throw_last_error("Unable to map file: " + path); }
+#else
+                const int fd = ::open(path.c_str(), O_RDONLY);
+                if (fd < 0) throw_last_error("Unable to open file: " + path);
+                struct stat info {};
+                if (::fstat(fd, &info) != 0) { ::close(fd); throw_last_error("Unable to size file: " + path); }
+                size_ = static_cast<size_t>(info.st_size);
+                if (size_ != 0) {
+                    void* address = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (address == MAP_FAILED) { ::close(fd); throw_last_error("Unable to map file: " + path); }
+                    ::madvise(address, size_, pattern == access_pattern::random ? MADV_RANDOM : MADV_SEQUENTIAL);
+                    data_ = static_cast<const uint8_t*>(address);
+                }
+                // The mapping stays valid after the descriptor is closed.
+                ::close(fd);
+#endif
+            }
+
+            ~mapped_file() { close(); }
+
+            mapped_file(const mapped_file&) = delete;
+            mapped_file& operator=(const mapped_file&) = delete;
+
+            [[nodiscard]] const uint8_t* data() const noexcept { return data_; }
+            [[nodiscard]] size_t size() const noexcept { return size_; }
+
+        private:
+
+            [[noreturn]] static void throw_last_error(const std::string& message) {
+#ifdef _WIN32
+                throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), message);
+#else
+                throw std::system_error(errno, std::generic_category(), message);
+#endif
+            }
+
+            void close() noexcept {
+#ifdef _WIN32
+                if (data_ != nullptr) UnmapViewOfFile(data_);
+                if (mapping_ != nullptr) CloseHandle(mapping_);
+                if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+                mapping_ = nullptr;
+                file_ = INVALID_HANDLE_VALUE;
+#else
+                if (data_ != nullptr) ::munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+                data_ = nullptr;
+            }
+
+            const uint8_t* data_{ nullptr };
+            size_t size_{ 0 };
+#ifdef _WIN32
+            HANDLE file_{ INVALID_HANDLE_VALUE };
+            HANDLE mapping_{ nullptr };
+#endif
+        };
+
+        /**
+         * @class effective_dates
+         * @brief Supplies the card effective date (in minutes since the Unix epoch) for each record of a file.
+         *
+         * @details Either every record shares one date, or the caller provides a parallel array holding one
+         *          date per record. The array is not copied and must outlive the pipeline run.
+         */
+        class effective_dates {
+        public:
+
+            //! Every record uses `date_in_minutes`.
+            explicit effective_dates(const std::time_t date_in_minutes) noexcept : uniform_(date_in_minutes) {}
+
+            /**
+             * @brief Record `i` uses `per_record[i]`.
+             * @param per_record The dates, one per record. Not copied.
+             * @param count The number of entries at `per_record`. What to send: The number of records in the file.
+             */
+            effective_dates(const std::time_t* per_record, const size_t count) noexcept
+                : per_record_(per_record), count_(count) {}
+
+            [[nodiscard]] std::time_t operator[](const size_t record) const noexcept {
+                return (per_record_ != nullptr) ? per_record_[record] : uniform_;
+            }
+
+            [[nodiscard]] bool is_uniform() const noexcept { return per_record_ == nullptr; }
+            [[nodiscard]] size_t size() const noexcept { return count_; }
+
+        private:
+            std::time_t uniform_{ 0 };
+            const std::time_t* per_record_{ nullptr };
+            size_t count_{ 0 };
+        };
+
+        /**
+         * @struct chunk
+         * @brief One decoded slice of the input, as handed to the visitor.
+         * @details Record `i` of the chunk (with `i < records.size()`) is record `first_record + i` of the file.
+         *          `records` is owned by the worker and is overwritten by its next chunk, so the visitor must
+         *          copy anything it wants to keep.
+         */
+        template <typename Batch>
+        struct chunk {
+            //! The index of the worker thread running the visitor, in [0, worker_count).
+            unsigned worker;
+            //! The file-wide index of the chunk's first record.
+            size_t first_record;
+            //! The decoded records of this chunk.
+            const Batch& records;
+            //! The effective dates for the whole file, indexed by file-wide record number.
+            const effective_dates& dates;
+
+            //! Returns the effective date of chunk record `i`, in minutes since the Unix epoch.
+            [[nodiscard]] std::time_t card_effective_date(const size_t i) const noexcept { return dates[first_record + i]; }
+
+            /**
+             * @brief Resolves an on-card minute offset of chunk record `i` to an absolute time.
+             * @return The time in milliseconds since the Unix epoch, as `log::get_date_and_time()` computes it.
+             */
+            [[nodiscard]] uint64_t to_milliseconds(const size_t i, const uint32_t offset_in_minutes) const noexcept {
+                return (static_cast<uint64_t>(card_effective_date(i)) + offset_in_minutes) * 60000;
+            }
+        };
+
+        /**
+         * @class runner
+         * @brief Splits a buffer of fixed-stride records into chunks and processes them on worker threads.
+         *
+         * @details Chunk indices are dealt out to the workers as contiguous ranges. A worker claims chunks
+         *          from the front of its own range and, once that is exhausted, steals the remaining chunks
+         *          of the other ranges, so a slow visitor on one thread does not leave the others idle. Each
+         *          claim is a single atomic increment; no locks are taken while records are processed.
+         *
+         *          If a visitor throws, the remaining chunks are abandoned and the first exception is
+         *          rethrown from `run()` once every worker has stopped.
+         *
+         * @tparam Batch `csa::batch` or `osa::batch`.
+         *
+         * @usage
+         * @code
+         *     pipeline::mapped_file file("uploads/2025-09-08.csa");
+         *     pipeline::csa_runner runner;
+         *     std::vector<uint64_t> fares(runner.worker_count());
+         *     runner.run(file, pipeline::effective_dates(effective_date), [&](const auto& c) {
+         *         for (size_t i = 0; i < c.records.size(); ++i) fares[c.worker] += c.records.get_validation_fare_amount()[i];
+         *     });
+         * @endcode
+         */
+        template <typename Batch>
+        class runner {
+        public:
+
+            //! The default number of records decoded per chunk.
+            static constexpr size_t DEFAULT_CHUNK_RECORDS = 4096;
+
+            /**
+             * @brief Configures the runner.
+             * @param worker_count The number of threads. What to send: 0 to use every hardware thread.
+             * @param chunk_records The number of records per chunk. What to send: A value > 0.
+             * @throws std::invalid_argument if `chunk_records` is 0.
+             */
+            explicit runner(const unsigned worker_count = 0, const size_t chunk_records = DEFAULT_CHUNK_RECORDS)
+                : worker_count_(worker_count != 0 ? worker_count : std::max(1u, std::thread::hardware_concurrency())),
+                  chunk_records_(chunk_records) {
+                if (chunk_records_ == 0) throw std::invalid_argument("Chunk size must be at least one record.");
+            }
+
+            [[nodiscard]] unsigned worker_count() const noexcept { return worker_count_; }
+            [[nodiscard]] size_t chunk_records() const noexcept { return chunk_records_; }
+
+            /**
+             * @brief Decodes every record in a buffer and passes each chunk to `visitor`.
+             * @param data A pointer to the first record.
+             * @param size The number of bytes at `data`. What to send: A multiple of 96.
+             * @param dates The effective date of each record.
+             * @param visitor Called as `visitor(const chunk<Batch>&)`, concurrently from several threads.
+             * @throws std::invalid_argument if `size` is not a multiple of 96, or if a per-record `dates`
+             *         array does not cover every record.
+             */
+            template <typename Visitor>
+            void run(const uint8_t* data, const size_t size, const effective_dates& dates, Visitor&& visitor) const {
+                if (size % Batch::RECORD_SIZE != 0)
+                    throw std::invalid_argument("Card image data must be a whole number of 96-byte records.");
+                const size_t records = size / Batch::RECORD_SIZE;
+                if (!dates.is_uniform() && dates.size() < records)
+                    throw std::invalid_argument("An effective date must be supplied for every record.");
+
+                const size_t chunks = (records + chunk_records_ - 1) / chunk_records_;
+                const unsigned workers = static_cast<unsigned>(std::min<size_t>(worker_count_, chunks));
+                if (workers == 0) return;
+
+                // Deal the chunk indices out as one contiguous range per worker.
+                std::unique_ptr<work_range[]> ranges(new work_range[workers]);
+                for (unsigned w = 0; w < workers; ++w) {
+                    ranges[w].next.store((chunks * w) / workers, std::memory_order_relaxed);
+                    ranges[w].end = (chunks * (w + 1)) / workers;
+                }
+
+                std::atomic<bool> failed{ false };
+                std::exception_ptr error;
+                std::mutex error_mutex;
+
+                auto work = [&](const unsigned self) {
+                    Batch batch;
+                    try {
+                        // Start with our own range, then visit the others in turn and steal what is left.
+                        for (unsigned step = 0; step < workers; ++step) {
+                            work_range& range = ranges[(self + step) % workers];
+                            for (;;) {
+                                if (failed.load(std::memory_order_relaxed)) return;
+                                const size_t index = range.next.fetch_add(1, std::memory_order_relaxed);
+                                if (index >= range.end) break;
+
+                                const size_t first = index * chunk_records_;
+                                const size_t count = std::min(chunk_records_, records - first);
+                                batch.decode(data + (first * Batch::RECORD_SIZE), count * Batch::RECORD_SIZE);
+                                visitor(chunk<Batch>{ self, first, batch, dates });
+                            }
+                        }
+                    } catch (...) {
+                        const std::lock_guard<std::mutex> lock(error_mutex);
+                        if (!error) error = std::current_exception();
+                        failed.store(true, std::memory_order_relaxed);
+                    }
+                };
+
+                // The calling thread acts as worker 0.
+                std::vector<std::thread> threads;
+                threads.reserve(workers - 1);
+                for (unsigned w = 1; w < workers; ++w) threads.emplace_back(work, w);
+                work(0);
+                for (std::thread& t : threads) t.join();
+
+                if (error) std::rethrow_exception(error);
+            }
+
+            //! Runs over a memory-mapped file. See `run(const uint8_t*, size_t, const effective_dates&, Visitor&&)`.
+            template <typename Visitor>
+            void run(const mapped_file& file, const effective_dates& dates, Visitor&& visitor) const {
+                run(file.data(), file.size(), dates, std::forward<Visitor>(visitor));
+            }
+
+        private:
+
+            //! A worker's share of the chunk indices. Padded so that neighbouring cursors do not share a cache line.
+            struct alignas(64) work_range {
+                std::atomic<size_t> next{ 0 };
+                size_t end{ 0 };
+            };
+
+            unsigned worker_count_;
+            size_t chunk_records_;
+        };
+
+        using csa_runner = runner<csa::batch>;
+        using osa_runner = runner<osa::batch>;
+
+    }
+
+}
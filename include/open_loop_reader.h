@@ -0,0 +1,307 @@
+/**
+ * @file open_loop_reader.h
+ * @brief A pipelined reader loop that overlaps card decoding and business logic with the RF I/O of the next card.
+ * @details A sequential gate loop spends most of every tap waiting on the radio: read 96 bytes, parse, price
+ *          the journey, serialize, write. `reader::station_loop` splits the loop into two stages connected by
+ *          a ring of pre-allocated tap slots:
+ *          - the **I/O stage** (the thread calling `run()`) reads cards into free slots and writes finished
+ *            slots back through a pluggable `transport`;
+ *          - the **decode stage** (one worker thread) parses each slot into its container, runs the
+ *            user's handler (fare evaluation, deny-list checks, …) and patches the image in place.
+ *
+ *          While the handler works on one card, the transport is already reading the next, and write-backs
+ *          happen strictly in tap order. Every slot owns its image buffer, its container and its dirty-range
+ *          list, so after the constructor no tap allocates.
+ *
+ * @author Govind Yadav
+ * @version 1.1
+ * @date 2025-09-08
+ */
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include "open_loop_service.h"
+
+namespace open_loop {
+
+    /**
+     * @namespace reader
+     * @brief Integration of the card containers with a contactless reader driver.
+     */
+    namespace reader {
+
+        /**
+         * @struct tap_slot
+         * @brief One tap in flight: the raw card image, the decoded container and the outcome.
+         * @details The transport fills the "in" fields, the loop decodes the image into `card`, the handler
+         *          edits `card`, and the loop patches the changes back into `image` and lists them in `dirty`
+         *          for the transport to write. Slots are reused, so nothing here outlives the tap.
+         *
+         * @tparam Container `csa::container` or an `osa::basic_container`.
+         */
+        template <typename Container>
+        struct tap_slot {
+            //! The size of the card area handled by `Container`.
+            static constexpr size_t IMAGE_SIZE = std::tuple_size<decltype(std::declval<const Container&>().to_array())>::value;
+
+            // --- In: filled by `transport::read()` ---
+
+            //! The card area as read from the card; patched in place before `transport::write()`.
+            std::array<uint8_t, IMAGE_SIZE> image{};
+            //! The number of bytes actually read. Reset to `IMAGE_SIZE` before each read; a torn read reports fewer.
+            size_t image_length{ IMAGE_SIZE };
+            //! An identifier of the card, e.g. its PAN token, for the handler's lookups.
+            uint64_t card_token{ 0 };
+            //! The card effective date in minutes since the Unix epoch.
+            std::time_t card_effective_date{ 0 };
+            //! The time of the tap in milliseconds since the Unix epoch.
+            uint64_t time_in_milliseconds{ 0 };
+
+            // --- Set by the loop ---
+
+            //! The tap's position in this run, starting at 0.
+            uint64_t sequence{ 0 };
+            //! The result of decoding `image`. The handler runs either way, so that it can reject bad cards.
+            status_code status{ status_code::ok };
+            //! The decoded card. Meaningful only if `status` is `ok`.
+            Container card;
+
+            // --- Out ---
+
+            //! Set by the handler to false to leave the card untouched. Initialized to `status == ok`.
+            bool write_back{ true };
+            //! The byte ranges of `image` the transport must write. Empty if nothing changed or `write_back` is false.
+            dirty_ranges dirty;
+        };
+
+        /**
+         * @class transport
+         * @brief The interface a reader driver implements to plug into `station_loop`.
+         * @details `station_loop::run()` accepts any type with these two members, so a driver may also
+         *          implement them without virtual dispatch. Both are only ever called from the thread
+         *          that called `run()`.
+         */
+        template <typename Container>
+        class transport {
+        public:
+            virtual ~transport() = default;
+
+            /**
+             * @brief Waits for the next card and reads it into `slot`.
+             * @details Must fill `image`, `card_token`, `card_effective_date` and `time_in_milliseconds`, and lower
+             *          `image_length` if the card left the field mid-read. Should return within one poll
+             *          interval when no card is presented, because finished taps are written back between reads.
+             * @return True if a card was read, false if none was presented in time.
+             */
+            virtual bool read(tap_slot<Container>& slot) = 0;
+
+            /**
+             * @brief Writes the `dirty` ranges of `slot.image` back to the card the slot was read from.
+             * @details Only called for slots with a non-empty `dirty` list, in tap order.
+             */
+            virtual void write(const tap_slot<Container>& slot) = 0;
+        };
+
+        /**
+         * @class station_loop
+         * @brief A two-stage, fixed-depth pipeline of taps between a `transport` and a handler.
+         *
+         * @details Up to `depth()` taps are in flight at once: read but not yet decoded, being handled, or
+         *          handled but not yet written. When every slot is busy, the I/O stage stops reading until
+         *          the oldest tap has been written back. Handoffs between the stages take one short mutex
+         *          section each; the handler and the transport always run outside it.
+         *
+         *          If the handler throws, no further cards are read, the taps it already finished are
+         *          written, and the exception is rethrown from `run()`. An exception from the transport is
+         *          rethrown once the decode stage has stopped.
+         *
+         * @tparam Container `csa::container` or an `osa::basic_container`.
+         *
+         * @usage
+         * @code
+         *     reader::station_loop<csa::container> loop(4);
+         *     std::atomic<bool> open{ true };
+         *     loop.run(driver, [&](reader::tap_slot<csa::container>& tap) {
+         *         if (!tap.write_back) return;  // Unreadable card; the driver will beep.
+         *         const csa::fare_quote q = fares.evaluate(tap.card, operator_id, route, tap.time_in_milliseconds);
+         *         tap.write_back = q.ok() && debit(tap.card, q.fare);
+         *     }, open);
+         * @endcode
+         */
+        template <typename Container>
+        class station_loop {
+        public:
+
+            using slot_type = tap_slot<Container>;
+
+            /**
+             * @brief Pre-allocates the tap slots.
+             * @param depth The number of taps in flight. What to send: 2 for one read overlapping one decode;
+             *              more to absorb handler latency spikes.
+             * @throws std::invalid_argument if `depth` is 0.
+             */
+            explicit station_loop(const size_t depth = 4) : depth_(depth) {
+                if (depth_ == 0) throw std::invalid_argument("Station loop depth must be at least one slot.");
+                slots_ = std::make_unique<slot_type[]>(depth_);
+            }
+
+            station_loop(const station_loop&) = delete;
+            station_loop& operator=(const station_loop&) = delete;
+
+            [[nodiscard]] size_t depth() const noexcept { return depth_; }
+
+            /**
+             * @brief Runs the loop until `keep_running` is cleared, then finishes every tap in flight.
+             * @param transport The reader driver, e.g. a `transport<Container>` implementation.
+             * @param handler Called as `handler(slot_type&)` on the decode thread, once per tap, in tap order.
+             * @param keep_running Checked before each read. Clear it from any thread to stop.
+             * @return The number of taps read during this run.
+             * @throws Whatever `transport` or `handler` threw first.
+             * @warning Not reentrant: one `run()` per loop at a time.
+             */
+            template <typename Transport, typename Handler>
+            uint64_t run(Transport& transport, Handler&& handler, const std::atomic<bool>& keep_running) {
+                read_ = decoded_ = written_ = 0;
+                stopping_ = failed_ = handler_failed_ = false;
+                error_ = nullptr;
+
+                std::thread decoder([&] { decode(handler); });
+                try {
+                    for (;;) {
+                        write_finished(transport);
+
+                        std::unique_lock<std::mutex> lock(mutex_);
+                        if (failed_) {
+                            // The decode stage may have finished more taps since `write_finished()` looked;
+                            // they were approved and must reach the card. It has stopped, so this is final.
+                            const bool drain = handler_failed_;
+                            lock.unlock();
+                            if (drain) write_finished(transport);
+                            break;
+                        }
+                        if (!keep_running.load(std::memory_order_relaxed)) {
+                            if (decoded_ == read_ && written_ == decoded_) break;
+                            // Let the decode stage catch up before writing the last taps.
+                            ready_.wait(lock, [&] { return decoded_ != written_ || failed_; });
+                            continue;
+                        }
+                        if (read_ - written_ == depth_) {
+                            ready_.wait(lock, [&] { return decoded_ != written_ || failed_; });
+                            continue;
+                        }
+                        // Only this thread advances `read_`, so the slot is ours until it is published.
+                        slot_type& slot = slots_[read_ % depth_];
+                        lock.unlock();
+
+                        slot.image_length = slot_type::IMAGE_SIZE;
+                        if (!transport.read(slot)) continue;
+
+                        lock.lock();
+                        slot.sequence = read_++;
+                        lock.unlock();
+                        ready_.notify_all();
+                    }
+                } catch (...) {
+                    fail(std::current_exception());
+                }
+
+                {
+                    const std::lock_guard<std::mutex> lock(mutex_);
+                    stopping_ = true;
+                }
+                ready_.notify_all();
+                decoder.join();
+                if (error_) std::rethrow_exception(error_);
+                return read_;
+            }
+
+        private:
+
+            //! Writes every decoded tap, oldest first. Runs on the I/O thread.
+            template <typename Transport>
+            void write_finished(Transport& transport) {
+                for (;;) {
+                    {
+                        const std::lock_guard<std::mutex> lock(mutex_);
+                        if (written_ == decoded_) return;
+                    }
+                    const slot_type& slot = slots_[written_ % depth_];
+                    if (!slot.dirty.empty()) transport.write(slot);
+                    const std::lock_guard<std::mutex> lock(mutex_);
+                    ++written_;
+                }
+            }
+
+            //! Decodes, handles and patches taps in order until the I/O stage stops. Runs on the worker thread.
+            template <typename Handler>
+            void decode(Handler& handler) {
+                for (;;) {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    ready_.wait(lock, [&] { return decoded_ != read_ || stopping_ || failed_; });
+                    if (failed_ || decoded_ == read_) return;
+                    slot_type& slot = slots_[decoded_ % depth_];
+                    lock.unlock();
+
+                    try {
+                        slot.card.set_card_effective_date(slot.card_effective_date);
+                        slot.status = slot.card.try_parse(slot.image.data(), slot.image_length);
+                        slot.write_back = slot.status == status_code::ok;
+                        slot.dirty = dirty_ranges{};
+                        handler(slot);
+                        if (slot.write_back && slot.status == status_code::ok) slot.dirty = slot.card.patch_into(slot.image.data());
+                    } catch (...) {
+                        fail(std::current_exception(), true);
+                        return;
+                    }
+
+                    lock.lock();
+                    ++decoded_;
+                    lock.unlock();
+                    ready_.notify_all();
+                }
+            }
+
+            void fail(std::exception_ptr error, const bool from_decoder = false) {
+                {
+                    const std::lock_guard<std::mutex> lock(mutex_);
+                    if (!error_) error_ = std::move(error);
+                    failed_ = true;
+                    handler_failed_ = handler_failed_ || from_decoder;
+                }
+                ready_.notify_all();
+            }
+
+            size_t depth_;
+            std::unique_ptr<slot_type[]> slots_;
+
+            std::mutex mutex_;
+            //! Signalled whenever a cursor advances or the loop fails or stops.
+            std::condition_variable ready_;
+            //! Taps read, decoded and written in this run. `written_ <= decoded_ <= read_ <= written_ + depth_`.
+            uint64_t read_{ 0 };
+            uint64_t decoded_{ 0 };
+            uint64_t written_{ 0 };
+            bool stopping_{ false };
+            bool failed_{ false };
+            //! True if the decode stage failed, so the taps it finished are still written back.
+            bool handler_failed_{ false };
+            std::exception_ptr error_;
+        };
+
+        using csa_station_loop = station_loop<csa::container>;
+        using osa_station_loop = station_loop<osa::container>;
+
+    }
+
+}
@@ -19,14 +19,20 @@
 #pragma once
 #include <algorithm>
 #include <array>
-#include <bitset>
 #include <cstdint>
-#include <iomanip>
-#include <optional>
-#include <ostream>
-#include <sstream>
+#include <ctime>
+#include <functional>
+#include <iosfwd>
+#include <limits>
+#include <memory_resource>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
+#include "open_loop_metrics.h"
 
 /**
  * @namespace open_loop
@@ -82,6 +88,904 @@ namespace open_loop {
         ONETAP = 0x3
     };
 
+    /**
+     * @enum status_code
+     * @brief Outcome codes reported by the non-throwing (`try_*`) API.
+     * @details Each failure code corresponds to exactly one exception thrown by the classic API, so the
+     *          throwing functions are thin wrappers that translate a non-`ok` code into that exception.
+     */
+    enum class status_code : uint8_t {
+        ok = 0,
+        //! The input buffer does not have the exact size of the block being parsed.
+        invalid_size,
+        //! A time-sensitive operation was attempted before the card effective date was set.
+        effective_date_not_set,
+        //! The transaction time lies before the card effective date.
+        time_before_effective_date,
+        //! The transaction time is more than 2^24 - 1 minutes after the card effective date.
+        time_offset_overflow,
+        //! An absolute timestamp does not fit in its 24-bit seconds field.
+        timestamp_overflow,
+        //! A terminal ID hex string is not exactly 6 characters long.
+        invalid_terminal_id_length,
+        //! A terminal ID hex string contains a non-hexadecimal character.
+        invalid_terminal_id,
+        //! The card balance exceeds the 20-bit storage limit.
+        card_balance_overflow,
+        //! The remaining trips exceed the trips allotted to the pass.
+        remaining_trips_exceed_allotted,
+        //! A phone number string is not exactly 10 characters long.
+        invalid_phone_number_length,
+        //! A phone number string contains a non-digit character.
+        invalid_phone_number_digit,
+        //! No OSA layout is registered for the major version found in the card's general data.
+        unsupported_layout,
+        //! The card balance is lower than the amount a tap would debit.
+        insufficient_balance,
+        //! No trip pass on the card is valid for the journey being validated.
+        no_applicable_pass,
+        //! The fare table has no rule for the operator and route of the tap.
+        no_fare_rule
+    };
+
+    static_assert(static_cast<size_t>(status_code::no_fare_rule) < metrics::STATUS_CODE_COUNT,
+                  "Every status code needs a counter in metrics::snapshot::statuses.");
+
+    /**
+     * @brief Retrieves a human-readable description of a status code.
+     * @return A static, null-terminated string. Never allocates.
+     */
+    [[nodiscard]] constexpr const char* to_string(const status_code code) noexcept {
+        switch (code) {
+            case status_code::ok:                              return "OK";
+            case status_code::invalid_size:                    return "Input data has an invalid size.";
+            case status_code::effective_date_not_set:          return "Card effective date must be set before setting transaction time.";
+            case status_code::time_before_effective_date:      return "Transaction time cannot be before the card effective date.";
+            case status_code::time_offset_overflow:            return "Transaction time is out of the valid 24-bit range from effective date.";
+            case status_code::timestamp_overflow:              return "Timestamp exceeds 24-bit storage limit.";
+            case status_code::invalid_terminal_id_length:      return "Terminal ID hex string must be exactly 6 characters.";
+            case status_code::invalid_terminal_id:             return "Terminal ID string is invalid or its value is out of the 24-bit range.";
+            case status_code::card_balance_overflow:           return "Card balance exceeds 20-bit limit.";
+            case status_code::remaining_trips_exceed_allotted: return "Remaining trips cannot be greater than allotted trips.";
+            case status_code::invalid_phone_number_length:     return "Phone number must be exactly 10 digits.";
+            case status_code::invalid_phone_number_digit:      return "Phone number must contain only digits.";
+            case status_code::unsupported_layout:              return "No OSA layout is registered for this major version.";
+            case status_code::insufficient_balance:            return "Card balance is lower than the fare.";
+            case status_code::no_applicable_pass:              return "No trip pass is valid for this journey.";
+            case status_code::no_fare_rule:                    return "No fare rule matches this operator and route.";
+            default:                                           return "Unknown status code.";
+        }
+    }
+
+    /**
+     * @brief Retrieves the name of a transaction status.
+     * @return A static string such as "ENTRY", or "UNKNOWN" for values outside the enum. Never allocates.
+     */
+    [[nodiscard]] constexpr const char* to_string(const txn_status status) noexcept {
+        switch (status) {
+            case txn_status::ENTRY:   return "ENTRY";
+            case txn_status::EXIT:    return "EXIT";
+            case txn_status::ONETAP:  return "ONETAP";
+            case txn_status::PENALTY: return "PENALTY";
+            default:                  return "UNKNOWN";
+        }
+    }
+
+    /**
+     * @brief Retrieves the name of a language code.
+     * @return A static string such as "Hindi", or "RFU" for the reserved codes. Never allocates.
+     */
+    [[nodiscard]] constexpr const char* to_string(const language_code code) noexcept {
+        switch (code) {
+            case language_code::English:   return "English";
+            case language_code::Hindi:     return "Hindi";
+            case language_code::Bengali:   return "Bengali";
+            case language_code::Marathi:   return "Marathi";
+            case language_code::Telugu:    return "Telugu";
+            case language_code::Tamil:     return "Tamil";
+            case language_code::Gujarati:  return "Gujarati";
+            case language_code::Urdu:      return "Urdu";
+            case language_code::Kannada:   return "Kannada";
+            case language_code::Odia:      return "Odia";
+            case language_code::Malayalam: return "Malayalam";
+            case language_code::Punjabi:   return "Punjabi";
+            case language_code::Sanskrit:  return "Sanskrit";
+            case language_code::Assamese:  return "Assamese";
+            case language_code::Maithili:  return "Maithili";
+            case language_code::Santali:   return "Santali";
+            case language_code::Kashmiri:  return "Kashmiri";
+            case language_code::Nepali:    return "Nepali";
+            case language_code::Sindhi:    return "Sindhi";
+            case language_code::Dogri:     return "Dogri";
+            case language_code::Konkani:   return "Konkani";
+            case language_code::Manipuri:  return "Manipuri";
+            case language_code::Bodo:      return "Bodo";
+            default:                       return "RFU";
+        }
+    }
+
+    /**
+     * @class result
+     * @brief A minimal expected-style holder returned by the non-throwing `try_parse()` functions.
+     *
+     * @details Holds either a successfully parsed value or the `status_code` describing why parsing failed.
+     *          All block types are cheap to default-construct, so the value is stored inline and no
+     *          allocation or exception is ever involved.
+     *
+     * @usage
+     * @code
+     *     if (auto term = csa::terminal::try_parse(buf, 6)) {
+     *         use(term.value());
+     *     } else {
+     *         count_corrupt_card(term.status());
+     *     }
+     * @endcode
+     */
+    template <typename T>
+    class result {
+    public:
+        //! Constructs a successful result holding `value`.
+        result(T value) noexcept : value_(std::move(value)) {}
+        //! Constructs a failed result. What to send: Any code other than `status_code::ok`.
+        result(const status_code status) noexcept : status_(status) {}
+
+        [[nodiscard]] bool has_value() const noexcept { return status_ == status_code::ok; }
+        explicit operator bool() const noexcept { return has_value(); }
+        [[nodiscard]] status_code status() const noexcept { return status_; }
+
+        /**
+         * @brief Accesses the held value.
+         * @warning Only meaningful if `has_value()` is true; otherwise a default-constructed object is returned.
+         */
+        [[nodiscard]] T& value() & noexcept { return value_; }
+        [[nodiscard]] const T& value() const & noexcept { return value_; }
+        [[nodiscard]] T&& value() && noexcept { return std::move(value_); }
+        [[nodiscard]] const T& operator*() const & noexcept { return value_; }
+        [[nodiscard]] const T* operator->() const noexcept { return &value_; }
+
+    private:
+        T value_{};
+        status_code status_{ status_code::ok };
+    };
+
+    /**
+     * @class fixed_string
+     * @brief A null-terminated string of at most `Capacity` characters stored inline.
+     * @details Returned by the allocation-free formatting getters (`get_terminal_id_chars()`,
+     *          `get_phone_number_chars()`) so that hot formatting paths never touch the heap. Converts
+     *          implicitly to `std::string_view` and compares equal to string literals and `std::string`.
+     */
+    template <size_t Capacity>
+    class fixed_string {
+    public:
+        static constexpr size_t CAPACITY = Capacity;
+
+        constexpr fixed_string() noexcept = default;
+
+        /**
+         * @brief Copies `size` characters from `chars`.
+         * @param chars The characters to copy. What to send: at least `size` readable characters.
+         * @param size The number of characters. Values above `Capacity` are truncated.
+         */
+        constexpr fixed_string(const char* chars, const size_t size) noexcept : size_(size < Capacity ? size : Capacity) {
+            for (size_t i = 0; i < size_; ++i) data_[i] = chars[i];
+            data_[size_] = '\0';
+        }
+
+        [[nodiscard]] constexpr const char* data() const noexcept { return data_; }
+        [[nodiscard]] constexpr const char* c_str() const noexcept { return data_; }
+        [[nodiscard]] constexpr size_t size() const noexcept { return size_; }
+        [[nodiscard]] constexpr bool empty() const noexcept { return size_ == 0; }
+        [[nodiscard]] constexpr std::string_view view() const noexcept { return { data_, size_ }; }
+        [[nodiscard]] std::string str() const { return { data_, size_ }; }
+
+        constexpr operator std::string_view() const noexcept { return view(); }
+
+        friend constexpr bool operator==(const fixed_string& lhs, const std::string_view rhs) noexcept { return lhs.view() == rhs; }
+        friend constexpr bool operator==(const std::string_view lhs, const fixed_string& rhs) noexcept { return lhs == rhs.view(); }
+        friend constexpr bool operator!=(const fixed_string& lhs, const std::string_view rhs) noexcept { return !(lhs == rhs); }
+        friend constexpr bool operator!=(const std::string_view lhs, const fixed_string& rhs) noexcept { return !(lhs == rhs); }
+        friend constexpr bool operator==(const fixed_string& lhs, const fixed_string& rhs) noexcept { return lhs.view() == rhs.view(); }
+        friend constexpr bool operator!=(const fixed_string& lhs, const fixed_string& rhs) noexcept { return !(lhs == rhs); }
+
+        friend std::ostream& operator<<(std::ostream& os, const fixed_string& s) { return os << s.view(); }
+
+    private:
+        char data_[Capacity + 1]{};
+        size_t size_{ 0 };
+    };
+
+    /**
+     * @class effective_epoch
+     * @brief A card effective date, precomputed once in both minutes and milliseconds.
+     * @details Every on-card timestamp is a 24-bit minute offset from the card effective date. Containers build
+     *          one `effective_epoch` in `set_card_effective_date()` and hand it to their children, so decoding
+     *          a timestamp is a single multiply-add with no per-call conversion of the base date. A
+     *          default-constructed epoch is "not set", mirroring the `std::optional` it replaces: `has_value()`
+     *          and `operator*` behave the same way.
+     *
+     *          Every block of every container holds a copy, so the epoch is kept the size of the
+     *          `std::optional<std::time_t>` it replaces: the smallest `std::time_t` marks "not set" instead of
+     *          a separate flag.
+     */
+    class effective_epoch {
+    public:
+        //! The number of milliseconds in one on-card time unit.
+        static constexpr uint64_t MILLISECONDS_PER_MINUTE = 60000;
+        //! The date reserved for "not set". An epoch built from it reports `has_value() == false`.
+        static constexpr std::time_t UNSET = std::numeric_limits<std::time_t>::min();
+
+        constexpr effective_epoch() noexcept = default;
+
+        /**
+         * @brief Creates a set epoch.
+         * @param date_in_minutes The card effective date. What to send: minutes since the Unix epoch.
+         */
+        constexpr effective_epoch(const std::time_t date_in_minutes) noexcept
+            : minutes_(date_in_minutes),
+              milliseconds_(date_in_minutes == UNSET ? 0 : static_cast<uint64_t>(date_in_minutes) * MILLISECONDS_PER_MINUTE) {}
+
+        [[nodiscard]] constexpr bool has_value() const noexcept { return minutes_ != UNSET; }
+        constexpr explicit operator bool() const noexcept { return has_value(); }
+
+        //! The effective date in minutes. Only meaningful if `has_value()`.
+        [[nodiscard]] constexpr std::time_t operator*() const noexcept { return minutes_; }
+        [[nodiscard]] constexpr std::time_t minutes() const noexcept { return minutes_; }
+        //! The effective date in milliseconds since the Unix epoch. Only meaningful if `has_value()`.
+        [[nodiscard]] constexpr uint64_t milliseconds() const noexcept { return milliseconds_; }
+
+        /**
+         * @brief Converts an on-card minute offset into an absolute timestamp.
+         * @pre `has_value()`.
+         * @return Milliseconds since the Unix epoch.
+         */
+        [[nodiscard]] constexpr uint64_t to_milliseconds(const uint32_t offset_in_minutes) const noexcept {
+            return milliseconds_ + static_cast<uint64_t>(offset_in_minutes) * MILLISECONDS_PER_MINUTE;
+        }
+
+        friend constexpr bool operator==(const effective_epoch& lhs, const effective_epoch& rhs) noexcept {
+            return lhs.minutes_ == rhs.minutes_;
+        }
+        friend constexpr bool operator!=(const effective_epoch& lhs, const effective_epoch& rhs) noexcept { return !(lhs == rhs); }
+
+    private:
+        std::time_t minutes_{ UNSET };
+        uint64_t milliseconds_{ 0 };
+    };
+
+    static_assert(sizeof(effective_epoch) <= 2 * sizeof(uint64_t),
+                  "effective_epoch is copied into every block; keep it the 16 bytes of std::optional<std::time_t>.");
+
+    /**
+     * @namespace codec
+     * @brief Table-driven hexadecimal and packed-BCD codecs shared by the terminal ID and phone number accessors.
+     * @details None of these functions use streams, locales or the heap. Decoding validates every character
+     *          without branching per digit: each lookup yields either a nibble or an "invalid" marker bit, and
+     *          the markers are OR-ed together and checked once at the end. The batch variants run the same
+     *          code over contiguous arrays so that loaders and exporters can convert whole columns at once.
+     */
+    namespace codec {
+
+        //! Marker bit set in `HEX_DECODE` / `DECIMAL_DECODE` for characters that are not valid digits.
+        constexpr uint8_t INVALID_DIGIT = 0x80;
+
+        //! Upper-case hexadecimal digits, indexed by nibble.
+        constexpr char HEX_DIGITS[] = "0123456789ABCDEF";
+
+        //! Maps every byte to its hexadecimal nibble value, or `INVALID_DIGIT`. Accepts upper and lower case.
+        constexpr std::array<uint8_t, 256> HEX_DECODE = [] {
+            std::array<uint8_t, 256> table{};
+            for (size_t c = 0; c < table.size(); ++c) {
+                if (c >= '0' && c <= '9') table[c] = static_cast<uint8_t>(c - '0');
+                else if (c >= 'A' && c <= 'F') table[c] = static_cast<uint8_t>(c - 'A' + 10);
+                else if (c >= 'a' && c <= 'f') table[c] = static_cast<uint8_t>(c - 'a' + 10);
+                else table[c] = INVALID_DIGIT;
+            }
+            return table;
+        }();
+
+        //! Maps every byte to its decimal digit value, or `INVALID_DIGIT`.
+        constexpr std::array<uint8_t, 256> DECIMAL_DECODE = [] {
+            std::array<uint8_t, 256> table{};
+            for (size_t c = 0; c < table.size(); ++c)
+                table[c] = (c >= '0' && c <= '9') ? static_cast<uint8_t>(c - '0') : INVALID_DIGIT;
+            return table;
+        }();
+
+        //! Maps every byte value to its two upper-case hexadecimal characters.
+        constexpr std::array<char, 512> HEX_PAIRS = [] {
+            std::array<char, 512> table{};
+            for (size_t b = 0; b < 256; ++b) {
+                table[b * 2] = HEX_DIGITS[b >> 4];
+                table[b * 2 + 1] = HEX_DIGITS[b & 0x0F];
+            }
+            return table;
+        }();
+
+        /**
+         * @brief Decodes `size` hexadecimal characters into an unsigned value.
+         * @param chars The characters to decode. What to send: 1 to 8 hex digits (`size <= 8`).
+         * @param size The number of characters.
+         * @param value_out Receives the decoded value. Left unchanged on failure.
+         * @return `true` if every character was a hexadecimal digit.
+         */
+        [[nodiscard]] constexpr bool hex_decode(const char* chars, const size_t size, uint32_t& value_out) noexcept {
+            uint32_t value = 0;
+            uint8_t invalid = 0;
+            for (size_t i = 0; i < size; ++i) {
+                const uint8_t nibble = HEX_DECODE[static_cast<uint8_t>(chars[i])];
+                invalid |= nibble;
+                value = (value << 4) | (nibble & 0x0F);
+            }
+            if ((invalid & INVALID_DIGIT) != 0) return false;
+            value_out = value;
+            return true;
+        }
+
+        /**
+         * @brief Writes the low 24 bits of `value` as six upper-case, zero-padded hexadecimal characters.
+         * @param value The value to format (e.g., a terminal ID).
+         * @param out The destination. What to send: a buffer of at least 6 writable characters. No terminator is written.
+         */
+        constexpr void hex_encode_u24(const uint32_t value, char* out) noexcept {
+            const size_t high = ((value >> 16) & 0xFF) * 2, mid = ((value >> 8) & 0xFF) * 2, low = (value & 0xFF) * 2;
+            out[0] = HEX_PAIRS[high]; out[1] = HEX_PAIRS[high + 1];
+            out[2] = HEX_PAIRS[mid];  out[3] = HEX_PAIRS[mid + 1];
+            out[4] = HEX_PAIRS[low];  out[5] = HEX_PAIRS[low + 1];
+        }
+
+        /**
+         * @brief Formats the low 24 bits of `value` as a six-character upper-case hexadecimal string.
+         * @return A `fixed_string<6>` such as "A1B2C3".
+         */
+        [[nodiscard]] constexpr fixed_string<6> hex_u24(const uint32_t value) noexcept {
+            char chars[6]{};
+            hex_encode_u24(value, chars);
+            return { chars, 6 };
+        }
+
+        /**
+         * @brief Packs `digit_count` decimal characters into BCD, two digits per byte, high nibble first.
+         * @param digits The digit characters. What to send: an even number of '0'-'9' characters.
+         * @param digit_count The number of characters.
+         * @param out The destination. What to send: a buffer of at least `digit_count / 2` bytes. Left
+         *            unchanged on failure.
+         * @return `true` if every character was a decimal digit.
+         */
+        [[nodiscard]] constexpr bool bcd_encode(const char* digits, const size_t digit_count, uint8_t* out) noexcept {
+            uint8_t invalid = 0;
+            for (size_t i = 0; i < digit_count; ++i) invalid |= DECIMAL_DECODE[static_cast<uint8_t>(digits[i])];
+            if ((invalid & INVALID_DIGIT) != 0) return false;
+            for (size_t i = 0; i < digit_count / 2; ++i)
+                out[i] = static_cast<uint8_t>((DECIMAL_DECODE[static_cast<uint8_t>(digits[i * 2])] << 4) |
+                                              DECIMAL_DECODE[static_cast<uint8_t>(digits[i * 2 + 1])]);
+            return true;
+        }
+
+        /**
+         * @brief Unpacks `byte_count` BCD bytes into `2 * byte_count` digit characters.
+         * @details Every nibble is written as `'0' + nibble`, matching how the card stores digits; nibbles
+         *          above 9 are not validated.
+         * @param bcd The packed bytes.
+         * @param byte_count The number of bytes.
+         * @param out The destination. What to send: a buffer of at least `2 * byte_count` characters.
+         */
+        constexpr void bcd_decode(const uint8_t* bcd, const size_t byte_count, char* out) noexcept {
+            for (size_t i = 0; i < byte_count; ++i) {
+                out[i * 2] = static_cast<char>('0' + (bcd[i] >> 4));
+                out[i * 2 + 1] = static_cast<char>('0' + (bcd[i] & 0x0F));
+            }
+        }
+
+        // --- Batch Variants ---
+
+        /**
+         * @brief Formats `count` 24-bit values as consecutive six-character hexadecimal fields.
+         * @param values The values to format.
+         * @param count The number of values.
+         * @param out The destination. What to send: a buffer of at least `6 * count` characters.
+         */
+        inline void hex_encode_u24_batch(const uint32_t* values, const size_t count, char* out) noexcept {
+            for (size_t i = 0; i < count; ++i) hex_encode_u24(values[i], out + i * 6);
+        }
+
+        /**
+         * @brief Decodes `count` consecutive six-character hexadecimal fields into 24-bit values.
+         * @param chars The packed input, `6 * count` characters with no separators.
+         * @param count The number of fields.
+         * @param values_out Receives the decoded values.
+         * @return The index of the first field that is not valid hexadecimal, or `count` if every field decoded.
+         *         Fields before that index have been written.
+         */
+        [[nodiscard]] inline size_t hex_decode_u24_batch(const char* chars, const size_t count, uint32_t* values_out) noexcept {
+            for (size_t i = 0; i < count; ++i)
+                if (!hex_decode(chars + i * 6, 6, values_out[i])) return i;
+            return count;
+        }
+
+        /**
+         * @brief Unpacks `count` BCD fields of `field_bytes` bytes each into `2 * field_bytes` characters per field.
+         * @param bcd The packed input, `count * field_bytes` bytes.
+         * @param count The number of fields.
+         * @param field_bytes The size of each packed field (5 for an OSA phone number).
+         * @param out The destination. What to send: a buffer of at least `2 * field_bytes * count` characters.
+         */
+        inline void bcd_decode_batch(const uint8_t* bcd, const size_t count, const size_t field_bytes, char* out) noexcept {
+            for (size_t i = 0; i < count; ++i) bcd_decode(bcd + i * field_bytes, field_bytes, out + i * field_bytes * 2);
+        }
+    }
+
+    /**
+     * @namespace detail
+     * @brief Internal byte-level helpers shared by the zero-copy accessors. Not part of the public API.
+     */
+    namespace detail {
+
+        //! Reads a 16-bit big-endian value starting at `p`.
+        [[nodiscard]] constexpr uint16_t read_u16_be(const uint8_t* p) noexcept {
+            return static_cast<uint16_t>((static_cast<uint16_t>(p[0]) << 8) | p[1]);
+        }
+
+        //! Reads a 24-bit big-endian value starting at `p`.
+        [[nodiscard]] constexpr uint32_t read_u24_be(const uint8_t* p) noexcept {
+            return (static_cast<uint32_t>(p[0]) << 16) | (static_cast<uint32_t>(p[1]) << 8) | p[2];
+        }
+
+        //! Writes the low 16 bits of `value` big-endian starting at `p`.
+        constexpr void write_u16_be(uint8_t* p, const uint32_t value) noexcept {
+            p[0] = static_cast<uint8_t>(value >> 8);
+            p[1] = static_cast<uint8_t>(value);
+        }
+
+        //! Writes the low 24 bits of `value` big-endian starting at `p`.
+        constexpr void write_u24_be(uint8_t* p, const uint32_t value) noexcept {
+            p[0] = static_cast<uint8_t>(value >> 16);
+            p[1] = static_cast<uint8_t>(value >> 8);
+            p[2] = static_cast<uint8_t>(value);
+        }
+
+        //! Reads a 64-bit little-endian value starting at `p`. Compiles to a single load on little-endian targets.
+        [[nodiscard]] constexpr uint64_t read_u64_le(const uint8_t* p) noexcept {
+            uint64_t value = 0;
+            for (size_t i = 0; i < 8; ++i) value |= static_cast<uint64_t>(p[i]) << (8 * i);
+            return value;
+        }
+
+        //! Reads a 32-bit little-endian value starting at `p`.
+        [[nodiscard]] constexpr uint32_t read_u32_le(const uint8_t* p) noexcept {
+            return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+                   (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+        }
+
+        //! Writes a 32-bit value little-endian starting at `p`.
+        constexpr void write_u32_le(uint8_t* p, const uint32_t value) noexcept {
+            for (size_t i = 0; i < 4; ++i) p[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+
+        //! Writes a 64-bit value little-endian starting at `p`.
+        constexpr void write_u64_le(uint8_t* p, const uint64_t value) noexcept {
+            for (size_t i = 0; i < 8; ++i) p[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+
+        /**
+         * @brief A fast, non-cryptographic 64-bit hash of a card image and its effective date.
+         * @details Consumes the image eight bytes at a time (12 multiply-xorshift rounds for a 96-byte card)
+         *          and finishes with the SplitMix64 finalizer, so every input bit affects every output bit.
+         *          Words are read little-endian, so the value is the same on every platform and can be stored
+         *          or compared across machines. Not suitable where an adversary chooses the input.
+         * @param data The canonical serialized bytes.
+         * @param size The number of bytes at `data`.
+         * @param card_effective_date_in_minutes Mixed into the seed, since equal bytes under different
+         *                                       effective dates describe different cards.
+         */
+        [[nodiscard]] constexpr uint64_t hash_card(const uint8_t* data, const size_t size, const int64_t card_effective_date_in_minutes) noexcept {
+            constexpr uint64_t K0 = 0x9E3779B97F4A7C15ULL;
+            constexpr uint64_t K1 = 0xBF58476D1CE4E5B9ULL;
+            constexpr uint64_t K2 = 0x94D049BB133111EBULL;
+            const auto round = [](uint64_t h, uint64_t word) {
+                word *= K1;
+                word ^= word >> 31;
+                h = (h ^ word) * K2;
+                return h ^ (h >> 29);
+            };
+
+            uint64_t h = (static_cast<uint64_t>(card_effective_date_in_minutes) * K0) ^ (size * K2);
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8) h = round(h, read_u64_le(data + i));
+            if (i < size) {
+                uint64_t tail = 0;
+                for (size_t j = 0; i + j < size; ++j) tail |= static_cast<uint64_t>(data[i + j]) << (8 * j);
+                h = round(h, tail);
+            }
+
+            // SplitMix64 finalizer.
+            h = (h ^ (h >> 30)) * K1;
+            h = (h ^ (h >> 27)) * K2;
+            return h ^ (h >> 31);
+        }
+
+        //! Returns true if all `size` bytes starting at `p` are zero (the "empty slot" heuristic used by `history::parse`).
+        [[nodiscard]] inline bool is_zero_filled(const uint8_t* p, const size_t size) noexcept {
+            return std::all_of(p, p + size, [](const uint8_t byte) { return byte == 0; });
+        }
+
+        /**
+         * @brief Maps logical history index `index` (0 = newest) to its physical ring slot.
+         * @param head The physical slot holding the newest entry.
+         * @param index The logical index. What to send: a value below `capacity`.
+         * @param capacity The number of slots in the ring.
+         */
+        [[nodiscard]] constexpr size_t ring_slot(const size_t head, const size_t index, const size_t capacity) noexcept {
+            const size_t slot = head + index;
+            return slot >= capacity ? slot - capacity : slot;
+        }
+
+        /**
+         * @brief Rotates a raw newest-first history block down by one slot and writes `entry` into slot 0.
+         * @details This is the on-card equivalent of `add_log()`: the oldest slot is overwritten and every
+         *          other slot moves one position towards the end, using a single overlapping copy.
+         * @param block The first byte of the history block (`slot_count * slot_size` bytes).
+         * @param entry The `slot_size` bytes of the new entry. Must not overlap `block`.
+         */
+        inline void push_front_slot(uint8_t* block, const size_t slot_count, const size_t slot_size, const uint8_t* entry) noexcept {
+            std::copy_backward(block, block + (slot_count - 1) * slot_size, block + slot_count * slot_size);
+            std::copy(entry, entry + slot_size, block);
+        }
+
+        /**
+         * @brief Throws the exception that the classic API documents for a failing `status_code`.
+         * @details Precondition violations (`effective_date_not_set`) map to `std::logic_error`, malformed
+         *          input (`invalid_size`, bad string lengths or digits, trip counts) to `std::invalid_argument`,
+         *          and numeric overflow (including invalid hex values) to `std::out_of_range`.
+         */
+        [[noreturn]] inline void throw_status(const status_code code) {
+            switch (code) {
+                case status_code::effective_date_not_set:
+                    throw metrics::counted(std::logic_error(to_string(code)));
+                case status_code::invalid_size:
+                case status_code::invalid_terminal_id_length:
+                case status_code::remaining_trips_exceed_allotted:
+                case status_code::invalid_phone_number_length:
+                case status_code::invalid_phone_number_digit:
+                case status_code::unsupported_layout:
+                    throw metrics::counted(std::invalid_argument(to_string(code)));
+                default:
+                    throw metrics::counted(std::out_of_range(to_string(code)));
+            }
+        }
+
+        /**
+         * @brief Converts an absolute millisecond timestamp into the 24-bit minute offset stored on the card.
+         * @param card_effective_date The base date of the record, which may not have been set.
+         * @param absolute_time_in_milliseconds The absolute time of the transaction.
+         * @param offset_out Receives the offset in minutes. Left unchanged on failure.
+         * @return `status_code::ok`, or the reason the time cannot be represented.
+         */
+        [[nodiscard]] inline status_code encode_time_offset(const effective_epoch& card_effective_date,
+                                                            const uint64_t absolute_time_in_milliseconds,
+                                                            uint32_t& offset_out) noexcept {
+            // First, ensure the base date for the calculation has been set.
+            if (!card_effective_date.has_value())
+                return status_code::effective_date_not_set;
+
+            // The epoch is a whole number of minutes, so comparing in milliseconds is equivalent to comparing
+            // the truncated minute values. The transaction time must be on or after the effective date.
+            if (absolute_time_in_milliseconds < card_effective_date.milliseconds())
+                return status_code::time_before_effective_date;
+
+            // Ensure the calculated offset fits within the 24 bits allocated for it.
+            const uint64_t time_diff = (absolute_time_in_milliseconds - card_effective_date.milliseconds()) / effective_epoch::MILLISECONDS_PER_MINUTE;
+            if (time_diff > 0xFFFFFF)
+                return status_code::time_offset_overflow;
+
+            offset_out = static_cast<uint32_t>(time_diff);
+            return status_code::ok;
+        }
+
+        /**
+         * @brief Decodes a 6-character hexadecimal string into a 24-bit terminal ID.
+         * @param hex_id The string to decode. Upper- and lower-case digits are accepted.
+         * @param value_out Receives the decoded value. Left unchanged on failure.
+         * @return `status_code::ok`, `invalid_terminal_id_length`, or `invalid_terminal_id`.
+         */
+        [[nodiscard]] inline status_code decode_terminal_id(const std::string_view hex_id, uint32_t& value_out) noexcept {
+            if (hex_id.size() != 6)
+                return status_code::invalid_terminal_id_length;
+            if (!codec::hex_decode(hex_id.data(), hex_id.size(), value_out))
+                return status_code::invalid_terminal_id;
+            return status_code::ok;
+        }
+
+        // --- Block Layout Descriptors ---
+        //
+        // Each block declares its on-card layout as a `detail::layout` of field descriptors. The descriptors
+        // carry the offset, width and shift of a field as template arguments, so `decode`, `encode` and
+        // `equal` expand into straight-line byte loads, shifts and stores with no tables read at run time.
+
+        //! Extracts the owning class and the value type from a pointer to data member.
+        template <typename>
+        struct member_traits;
+
+        template <typename Owner, typename Value>
+        struct member_traits<Value Owner::*> {
+            using owner = Owner;
+            using value = Value;
+        };
+
+        /**
+         * @struct bit_span
+         * @brief `Bits` bits located `Shift` bits above the least significant bit of the big-endian integer
+         *        formed by the bytes starting at block offset `Offset`.
+         * @details For example, `bit_span<13, 20, 4>` is the upper 20 bits of bytes 13-15.
+         */
+        template <size_t Offset, size_t Bits, size_t Shift>
+        struct bit_span {
+            static constexpr size_t OFFSET = Offset;
+            static constexpr size_t BYTES = (Bits + Shift + 7) / 8;
+            //! One past the last block byte touched by the span.
+            static constexpr size_t END = Offset + BYTES;
+            static constexpr uint64_t MASK = (uint64_t{ 1 } << Bits) - 1;
+            static_assert(Bits > 0 && BYTES <= 4, "A bit span must cover between 1 and 4 bytes.");
+
+            //! Reads the span from a block starting at `block`.
+            [[nodiscard]] static uint64_t read(const uint8_t* block) noexcept {
+                return (load(block + Offset, std::make_index_sequence<BYTES>{}) >> Shift) & MASK;
+            }
+
+            //! ORs `value` into the span of a zero-initialised block starting at `block`.
+            static void write(uint8_t* block, const uint64_t value) noexcept {
+                store(block + Offset, (value & MASK) << Shift, std::make_index_sequence<BYTES>{});
+            }
+
+        private:
+            template <size_t... I>
+            [[nodiscard]] static uint64_t load(const uint8_t* p, std::index_sequence<I...>) noexcept {
+                return ((static_cast<uint64_t>(p[I]) << (8 * (BYTES - 1 - I))) | ...);
+            }
+
+            template <size_t... I>
+            static void store(uint8_t* p, const uint64_t bits, std::index_sequence<I...>) noexcept {
+                ((p[I] |= static_cast<uint8_t>(bits >> (8 * (BYTES - 1 - I)))), ...);
+            }
+        };
+
+        //! An integer or enum data member stored in a `bit_span`. `Bits` defaults to whole bytes with no shift.
+        template <auto Member, size_t Offset, size_t Bits, size_t Shift = 0>
+        struct field : bit_span<Offset, Bits, Shift> {
+            using owner = typename member_traits<decltype(Member)>::owner;
+            using value_type = typename member_traits<decltype(Member)>::value;
+
+            static void decode(const uint8_t* block, owner& obj) noexcept {
+                obj.*Member = static_cast<value_type>(field::read(block));
+            }
+            static void encode(const owner& obj, uint8_t* block) noexcept {
+                field::write(block, static_cast<uint64_t>(obj.*Member));
+            }
+            [[nodiscard]] static bool equal(const owner& lhs, const owner& rhs) noexcept {
+                return lhs.*Member == rhs.*Member;
+            }
+        };
+
+        //! Filler bits that are always written as `Value` and ignored when decoding and comparing.
+        template <size_t Offset, size_t Bits, size_t Shift, uint64_t Value>
+        struct constant : bit_span<Offset, Bits, Shift> {
+            template <typename Owner>
+            static void decode(const uint8_t*, Owner&) noexcept {}
+            template <typename Owner>
+            static void encode(const Owner&, uint8_t* block) noexcept { constant::write(block, Value); }
+            template <typename Owner>
+            [[nodiscard]] static bool equal(const Owner&, const Owner&) noexcept { return true; }
+        };
+
+        //! A `std::array<uint8_t, N>` data member copied verbatim to and from block offset `Offset`.
+        template <auto Member, size_t Offset>
+        struct byte_array {
+            using owner = typename member_traits<decltype(Member)>::owner;
+            using value_type = typename member_traits<decltype(Member)>::value;
+            static constexpr size_t OFFSET = Offset;
+            static constexpr size_t END = Offset + std::tuple_size<value_type>::value;
+
+            static void decode(const uint8_t* block, owner& obj) noexcept {
+                std::copy_n(block + Offset, std::tuple_size<value_type>::value, (obj.*Member).begin());
+            }
+            static void encode(const owner& obj, uint8_t* block) noexcept {
+                std::copy((obj.*Member).begin(), (obj.*Member).end(), block + Offset);
+            }
+            [[nodiscard]] static bool equal(const owner& lhs, const owner& rhs) noexcept {
+                return lhs.*Member == rhs.*Member;
+            }
+        };
+
+        //! A data member that is itself a block with a `layout`, embedded at block offset `Offset`.
+        template <auto Member, size_t Offset>
+        struct nested {
+            using owner = typename member_traits<decltype(Member)>::owner;
+            using value_type = typename member_traits<decltype(Member)>::value;
+            static constexpr size_t OFFSET = Offset;
+            static constexpr size_t END = Offset + value_type::layout::SIZE;
+
+            static void decode(const uint8_t* block, owner& obj) noexcept {
+                value_type::layout::decode(block + Offset, obj.*Member);
+            }
+            static void encode(const owner& obj, uint8_t* block) noexcept {
+                value_type::layout::encode_fields(obj.*Member, block + Offset);
+            }
+            [[nodiscard]] static bool equal(const owner& lhs, const owner& rhs) noexcept {
+                return value_type::layout::equal(lhs.*Member, rhs.*Member);
+            }
+        };
+
+        /**
+         * @struct layout
+         * @brief The complete field table of a `Size`-byte block, from which the block's codec is generated.
+         * @tparam Fields `field`, `constant`, `byte_array` and `nested` descriptors, in any order.
+         */
+        template <size_t Size, typename... Fields>
+        struct layout {
+            static constexpr size_t SIZE = Size;
+            static constexpr size_t FIELD_COUNT = sizeof...(Fields);
+            static_assert(((Fields::END <= Size) && ...), "A field lies outside its block.");
+
+            //! Decodes every field of the block starting at `block` into `obj`.
+            template <typename Owner>
+            static void decode(const uint8_t* block, Owner& obj) noexcept { (Fields::decode(block, obj), ...); }
+
+            //! Writes all `Size` bytes of the block starting at `block` from `obj`.
+            template <typename Owner>
+            static void encode(const Owner& obj, uint8_t* block) noexcept {
+                std::fill_n(block, Size, uint8_t{ 0 });
+                encode_fields(obj, block);
+            }
+
+            //! ORs every field into an already zero-initialised block. Used for nested blocks.
+            template <typename Owner>
+            static void encode_fields(const Owner& obj, uint8_t* block) noexcept { (Fields::encode(obj, block), ...); }
+
+            //! Compares every decoded field of two objects.
+            template <typename Owner>
+            [[nodiscard]] static bool equal(const Owner& lhs, const Owner& rhs) noexcept { return (Fields::equal(lhs, rhs) && ...); }
+        };
+
+    }
+
+    /**
+     * @struct byte_range
+     * @brief A contiguous range of bytes within a 96-byte card area, described by its offset and length.
+     */
+    struct byte_range {
+        size_t offset{ 0 };
+        size_t length{ 0 };
+
+        friend bool operator==(const byte_range& lhs, const byte_range& rhs) {
+            return lhs.offset == rhs.offset && lhs.length == rhs.length;
+        }
+    };
+
+    /**
+     * @class dirty_ranges
+     * @brief A fixed-capacity, allocation-free list of the byte ranges changed by a patch write-back.
+     *
+     * @details Produced by `csa::container::patch_into()` and `osa::container::patch_into()`. Ranges are
+     *          kept in ascending offset order and adjacent ranges are merged, so a reader driver can map
+     *          them directly onto the card's physical blocks via `block_mask()` and write only those.
+     */
+    class dirty_ranges {
+    public:
+
+        //! The maximum number of disjoint ranges that can be recorded (one per logical region of a card area).
+        static constexpr size_t MAX_RANGES = 8;
+
+        /**
+         * @brief Records a changed range, merging it with the previous one when they touch.
+         * @param offset The offset of the first changed byte. What to send: A value not below the end of the last range.
+         * @param length The number of changed bytes. Zero-length ranges are ignored.
+         */
+        void add(const size_t offset, const size_t length) noexcept {
+            if (length == 0) return;
+            if (count_ > 0 && ranges_[count_ - 1].offset + ranges_[count_ - 1].length == offset) {
+                ranges_[count_ - 1].length += length;
+                return;
+            }
+            if (count_ < MAX_RANGES) {
+                ranges_[count_++] = { offset, length };
+            } else {
+                // Out of slots: widen the last range so that it still covers everything that changed.
+                ranges_[count_ - 1].length = offset + length - ranges_[count_ - 1].offset;
+            }
+        }
+
+        /**
+         * @brief Computes which fixed-size physical card blocks overlap the dirty ranges.
+         * @param block_size The size of one physical card block in bytes (e.g., 16). What to send: A non-zero value.
+         * @return A bitmask where bit `n` is set if block `n` (bytes `[n * block_size, (n + 1) * block_size)`) must be written.
+         */
+        [[nodiscard]] uint32_t block_mask(const size_t block_size) const noexcept {
+            uint32_t mask = 0;
+            for (size_t i = 0; i < count_; ++i) {
+                const size_t first = ranges_[i].offset / block_size;
+                const size_t last = (ranges_[i].offset + ranges_[i].length - 1) / block_size;
+                for (size_t block = first; block <= last && block < 32; ++block)
+                    mask |= (1u << block);
+            }
+            return mask;
+        }
+
+        //! Returns the total number of dirty bytes across all ranges.
+        [[nodiscard]] size_t total_bytes() const noexcept {
+            size_t total = 0;
+            for (size_t i = 0; i < count_; ++i) total += ranges_[i].length;
+            return total;
+        }
+
+        [[nodiscard]] size_t size() const noexcept { return count_; }
+        [[nodiscard]] bool empty() const noexcept { return count_ == 0; }
+        [[nodiscard]] const byte_range& operator[](const size_t index) const noexcept { return ranges_[index]; }
+        [[nodiscard]] const byte_range* begin() const noexcept { return ranges_.data(); }
+        [[nodiscard]] const byte_range* end() const noexcept { return ranges_.data() + count_; }
+
+    private:
+        std::array<byte_range, MAX_RANGES> ranges_{};
+        size_t count_{ 0 };
+    };
+
+    namespace osa {
+        class general;
+        class transaction_record;
+        class trip_pass;
+    }
+
+    namespace detail {
+
+        /**
+         * @brief Writes the report behind `osa::basic_history::operator<<` for any history depth.
+         * @param logs The valid records, newest first. What to send: `count` non-null pointers.
+         */
+        std::ostream& write_osa_history(std::ostream& os, const effective_epoch& card_effective_date,
+                                        const osa::transaction_record* const* logs, size_t count);
+
+        //! Writes the part of `osa::basic_container::operator<<` that precedes the history report.
+        std::ostream& write_osa_container_head(std::ostream& os, const osa::general& general, const osa::transaction_record& validation);
+
+        //! Writes the part of `osa::basic_container::operator<<` that follows the history report.
+        std::ostream& write_osa_container_tail(std::ostream& os, const osa::trip_pass* trip_passes, size_t count, size_t padding_size);
+
+        /**
+         * @brief Copies the bytes of `region` that differ between `fresh` and `target` into `target`.
+         * @details Only the span from the first to the last differing byte of the region is copied and recorded.
+         */
+        inline void patch_region(const uint8_t* fresh, uint8_t* target, const byte_range& region, dirty_ranges& dirty) noexcept {
+            size_t first = region.offset;
+            const size_t end = region.offset + region.length;
+            while (first < end && fresh[first] == target[first]) ++first;
+            if (first == end) return;
+            size_t last = end - 1;
+            while (fresh[last] == target[last]) --last;
+            std::copy(fresh + first, fresh + last + 1, target + first);
+            dirty.add(first, last + 1 - first);
+        }
+
+        /**
+         * @brief Builds the `patch_into()` regions of an OSA layout: general, validation, each history
+         *        record, each trip pass, and the trailing padding.
+         */
+        template <size_t HistoryRecords, size_t TripPasses>
+        constexpr std::array<byte_range, 3 + HistoryRecords + TripPasses> make_osa_patch_regions(
+            const size_t general_size, const size_t record_size, const size_t pass_size, const size_t block_size) noexcept {
+            std::array<byte_range, 3 + HistoryRecords + TripPasses> regions{};
+            size_t offset = 0;
+            size_t n = 0;
+            regions[n++] = { offset, general_size };
+            offset += general_size;
+            for (size_t i = 0; i < 1 + HistoryRecords; ++i, offset += record_size)
+                regions[n++] = { offset, record_size }; // The validation record, then each history record.
+            for (size_t i = 0; i < TripPasses; ++i, offset += pass_size)
+                regions[n++] = { offset, pass_size };
+            regions[n] = { offset, block_size - offset };
+            return regions;
+        }
+
+    }
+
     /**
      * @namespace csa
      * @brief Contains all classes and structures related to the Common Service Area.
@@ -153,18 +1057,7 @@ namespace open_loop {
              * @param patch The patch version. What to send: A value in the range [0, 3].
              * @throws std::out_of_range if any version component is outside its valid bit-field range.
              */
-            void set_version(const uint8_t major, const uint8_t minor, const uint8_t patch) {
-                // Validate that the major version fits within its allocated 3 bits.
-                if (major > MAJOR_VERSION_MAX) throw std::out_of_range("Major version must be in the range [0, 7].");
-                // Validate that the minor version fits within its allocated 3 bits.
-                if (minor > MINOR_VERSION_MAX) throw std::out_of_range("Minor version must be in the range [0, 7].");
-                // Validate that the patch version fits within its allocated 2 bits.
-                if (patch > PATCH_VERSION_MAX) throw std::out_of_range("Patch version must be in the range [0, 3].");
-                // If all checks pass, assign the values to the member variables.
-                major_version_ = major;
-                minor_version_ = minor;
-                patch_version_ = patch;
-            }
+            void set_version(const uint8_t major, const uint8_t minor, const uint8_t patch);
 
             /**
              * @brief Sets the card's preferred language.
@@ -180,11 +1073,7 @@ namespace open_loop {
              * @param value The RFU value. What to send: A value in the range [0, 7].
              * @throws std::out_of_range if the value is outside the valid 3-bit range.
              */
-            void set_rfu(const uint8_t value) {
-                // Validate that the RFU value fits within its allocated 3 bits.
-                if (value > RFU_MAX) throw std::out_of_range("RFU value must be in the range [0, 7].");
-                rfu_ = value;
-            }
+            void set_rfu(const uint8_t value);
 
             /**
              * @brief Parses a 2-byte data vector into a `general` object.
@@ -192,33 +1081,30 @@ namespace open_loop {
              * @return A `general` object populated with the parsed data.
              * @throws std::invalid_argument if the data vector is not exactly 2 bytes.
              */
-            static general parse(const std::vector<uint8_t>& data) {
-                // Ensure the input data is the correct size before attempting to parse.
-                if (data.size() != DATA_SIZE) {
-                    throw std::invalid_argument("General data must be exactly 2 bytes.");
-                }
+            static general parse(const std::vector<uint8_t>& data);
 
-                // Create a new object to hold the parsed data.
-                general g;
+            /**
+             * @brief Parses 2 bytes read directly from a raw buffer into a `general` object.
+             * @details This overload performs no heap allocation and is the one used by `csa::container::parse`.
+             * @param data A pointer to the first byte of the general data block.
+             * @param size The number of bytes available at `data`. What to send: Exactly 2.
+             * @return A `general` object populated with the parsed data.
+             * @throws std::invalid_argument if `size` is not exactly 2 bytes.
+             */
+            static general parse(const uint8_t* data, const size_t size);
 
-                // --- Byte 0: Version ---
-                // Example Byte 0: 001 010 11 (Binary)
-                // To get Major Version (first 3 bits): Right-shift by 5 bits, then mask with 0x07 (0b111).
-                // (00101011 >> 5) -> 00000001. 00000001 & 0b111 -> 1.
-                g.major_version_ = (data[0] >> 5) & 0x07;
-                // To get Minor Version (middle 3 bits): Right-shift by 2 bits, then mask with 0x07.
-                // (00101011 >> 2) -> 00001010. 00001010 & 0b111 -> 2.
-                g.minor_version_ = (data[0] >> 2) & 0x07;
-                // To get Patch Version (last 2 bits): Mask with 0x03 (0b11).
-                // 00101011 & 0b11 -> 3.
-                g.patch_version_ = data[0] & 0x03;
-
-                // --- Byte 1: Language and RFU ---
-                // To get Language Code (first 5 bits): Right-shift by 3 bits. Masking is implicit due to the limited range of the enum.
-                g.language_ = static_cast<language_code>(data[1] >> 3);
-                // To get RFU (last 3 bits): Mask with 0x07 (0b111).
-                g.rfu_ = data[1] & 0x07;
+            /**
+             * @brief Non-throwing variant of `parse()` that decodes 2 bytes read directly from a raw buffer.
+             * @param data A pointer to the first byte of the general data block.
+             * @param size The number of bytes available at `data`. What to send: Exactly 2.
+             * @return A `result` holding the parsed `general`, or `status_code::invalid_size` on a size mismatch.
+             */
+            [[nodiscard]] static result<general> try_parse(const uint8_t* data, const size_t size) noexcept {
+                if (size != DATA_SIZE) return status_code::invalid_size;
 
+                general g;
+                // Every field is decoded from the descriptor table in `layout`.
+                layout::decode(data, g);
                 return g;
             }
 
@@ -226,27 +1112,15 @@ namespace open_loop {
              * @brief Serializes the `general` object into a 2-byte vector.
              * @return A `std::vector<uint8_t>` containing the 2 bytes of serialized data.
              */
-            [[nodiscard]] std::vector<uint8_t> to_bytes() const noexcept {
-                // --- Assemble Byte 0 (Version) ---
-                // Left-shift the major version by 5 to place it in the most significant 3 bits.
-                // Left-shift the minor version by 2 to place it in the middle 3 bits.
-                // The patch version already occupies the least significant 2 bits.
-                // Combine all parts using bitwise OR.
-                const auto first_byte = static_cast<uint8_t>(
-                    (major_version_ << 5) | (minor_version_ << 2) | patch_version_
-                );
+            [[nodiscard]] std::vector<uint8_t> to_bytes() const noexcept;
 
-                // --- Assemble Byte 1 (Language and RFU) ---
-                // Cast the language enum to its underlying uint8_t type.
-                // Left-shift the language code by 3 to place it in the most significant 5 bits.
-                // The RFU value already occupies the least significant 3 bits.
-                // Combine both parts using bitwise OR.
-                const auto second_byte = static_cast<uint8_t>(
-                    (static_cast<uint8_t>(language_) << 3) | rfu_
-                );
-
-                // Return the assembled bytes in a vector.
-                return { first_byte, second_byte };
+            /**
+             * @brief Serializes the `general` object directly into a caller-supplied buffer.
+             * @param out A pointer to at least 2 writable bytes. Exactly 2 bytes are written.
+             */
+            void serialize_into(uint8_t* out) const noexcept {
+                // Every field is encoded from the descriptor table in `layout`.
+                layout::encode(*this, out);
             }
 
 
@@ -260,32 +1134,19 @@ namespace open_loop {
              * @brief Retrieves the full version number as a formatted string.
              * @return The version string in "major.minor.patch" format (e.g., "1.2.3").
              */
-            [[nodiscard]] std::string get_version() const {
-                return std::to_string(major_version_) + "." + std::to_string(minor_version_) + "." + std::to_string(patch_version_);
-            }
+            [[nodiscard]] std::string get_version() const;
 
             /**
              * @brief Retrieves the language as a human-readable string.
              * @return The name of the language (e.g., "English"). Returns "Unknown" for undefined or RFU codes.
              */
-            [[nodiscard]] std::string get_language_string() const {
-                switch (language_) {
-                    case language_code::English: return "English";
-                    case language_code::Hindi:   return "Hindi";
-                    case language_code::Marathi: return "Marathi";
-                    // Note: This is not an exhaustive list of all languages in the enum.
-                    // The default case is crucial for handling all other defined and RFU language codes gracefully.
-                    default: return "Unknown";
-                }
-            }
+            [[nodiscard]] std::string get_language_string() const;
 
             /**
              * @brief Retrieves the full version number as a formatted string.
              * @return The version string in "major.minor.patch" format (e.g., "1.2.3").
              */
-            [[nodiscard]] std::string get_version_string() const {
-                return std::to_string(major_version_) + "." + std::to_string(minor_version_) + "." + std::to_string(patch_version_);
-            }
+            [[nodiscard]] std::string get_version_string() const;
 
             /**
              * @brief Stream insertion operator for easy printing of `general` objects.
@@ -293,27 +1154,14 @@ namespace open_loop {
              * @param obj The `general` object to print.
              * @return A reference to the output stream.
              */
-            friend std::ostream& operator<<(std::ostream& os, const general& obj) {
-                return os << "------------------------ GENERAL DATA ------------------------" << std::endl
-                          << "  VERSION                  : " << obj.get_version() << std::endl
-                          // Also print the binary representation of the language code for debugging purposes.
-                          << "  LANGUAGE                 : " << obj.get_language_string() << " (0b"
-                          << std::bitset<5>(static_cast<uint8_t>(obj.get_language())) << ")" << std::endl
-                          << "  RFU                      : " << static_cast<int>(obj.get_rfu()) << std::endl
-                          << "------------------------------------------------------------";
-            }
+            friend std::ostream& operator<<(std::ostream& os, const general& obj);
 
             /**
              * @brief Compares two `general` objects for equality.
              * @return True if all corresponding members are identical, false otherwise.
              */
             friend bool operator==(const general& lhs, const general& rhs) {
-                // This performs a deep comparison of all data members.
-                return lhs.major_version_ == rhs.major_version_ &&
-                       lhs.minor_version_ == rhs.minor_version_ &&
-                       lhs.patch_version_ == rhs.patch_version_ &&
-                       lhs.language_ == rhs.language_ &&
-                       lhs.rfu_ == rhs.rfu_;
+                return layout::equal(lhs, rhs);
             }
 
         private:
@@ -329,6 +1177,16 @@ namespace open_loop {
             //! Reserved for Future Use field, stored in the 3 least significant bits of the second byte.
             uint8_t rfu_{ 0 };
 
+
+        public:
+
+            //! The on-card layout of this block. `try_parse()`, `serialize_into()` and `operator==` are generated from it.
+            using layout = detail::layout<DATA_SIZE,
+                detail::field<&general::major_version_, 0, 3, 5>,  // Byte 0, bits 7-5
+                detail::field<&general::minor_version_, 0, 3, 2>,  // Byte 0, bits 4-2
+                detail::field<&general::patch_version_, 0, 2>,     // Byte 0, bits 1-0
+                detail::field<&general::language_, 1, 5, 3>,       // Byte 1, bits 7-3
+                detail::field<&general::rfu_, 1, 3>>;              // Byte 1, bits 2-0
         };
 
         // ------------------------------------------------------ TERMINAL DATA -------------------------------------------------------
@@ -409,25 +1267,19 @@ namespace open_loop {
              * @throws std::invalid_argument if `hex_id` is not exactly 6 characters long.
              * @throws std::out_of_range if `hex_id` contains invalid characters or represents a value > 0xFFFFFF.
              */
-            void set_terminal_id(const std::string& hex_id) {
-                // First, perform a quick and inexpensive check on the string length.
-                if (hex_id.size() != TERMINAL_ID_HEX_LENGTH)
-                    throw std::invalid_argument("Terminal ID hex string must be exactly 6 characters.");
-
-                // Use a stringstream for a robust conversion from hex string to an integer.
-                unsigned long long value = 0;
-                std::stringstream ss;
-                ss << std::hex << hex_id; // Tell the stream to interpret the input as hexadecimal.
+            void set_terminal_id(const std::string_view hex_id) {
+                if (const status_code code = try_set_terminal_id(hex_id); code != status_code::ok)
+                    detail::throw_status(code);
+            }
 
-                // Try to extract the value and perform comprehensive validation.
-                // 1. `!(ss >> value)`: Fails if the string contains non-hex characters (e.g., "A1B2G3").
-                // 2. `ss.rdbuf()->in_avail() != 0`: Fails if there are leftover characters after a valid parse,
-                //    which handles cases where the stream stops parsing early.
-                // 3. `value > TERMINAL_ID_MAX`: Fails if the parsed number exceeds the 24-bit limit.
-                if (!(ss >> value) || ss.rdbuf()->in_avail() != 0 || value > TERMINAL_ID_MAX)
-                    throw std::out_of_range("Terminal ID string is invalid or its value is out of the 24-bit range.");
-                // If all checks pass, safely cast and assign the value.
-                terminal_id_ = static_cast<uint32_t>(value);
+            /**
+             * @brief Non-throwing variant of `set_terminal_id()`.
+             * @param hex_id The terminal's unique identifier as a 6-character hex string.
+             * @return `status_code::ok`, `invalid_terminal_id_length`, or `invalid_terminal_id`. The ID is unchanged on failure.
+             */
+            [[nodiscard]] status_code try_set_terminal_id(const std::string_view hex_id) noexcept {
+                // Every 6-digit hex value fits in 24 bits, so only the length and the characters need checking.
+                return detail::decode_terminal_id(hex_id, terminal_id_);
             }
 
             /**
@@ -436,28 +1288,29 @@ namespace open_loop {
              * @return A `terminal` object populated with the parsed data.
              * @throws std::invalid_argument if the data vector is not exactly 6 bytes.
              */
-            static terminal parse(const std::vector<uint8_t>& data) {
-                if (data.size() != DATA_SIZE) {
-                    throw std::invalid_argument("Terminal data must be 6 bytes.");
-                }
-
-                terminal t;
-
-                // Byte 0: Acquirer ID is a single byte, so a direct copy is enough.
-                t.acquirer_id_ = data[0];
+            static terminal parse(const std::vector<uint8_t>& data);
 
-                // Bytes 1-2: Operator ID (Big-Endian)
-                // Shift the first byte (MSB) left by 8 bits to make room for the second byte.
-                // Then, bitwise OR it with the second byte (LSB) to combine them into a uint16_t.
-                // Example: {0x04, 0x01} -> (0x04 << 8) | 0x01 -> 0x0400 | 0x01 -> 0x0401 (1025).
-                t.operator_id_ = (static_cast<uint16_t>(data[1]) << 8) | data[2];
+            /**
+             * @brief Parses 6 bytes read directly from a raw buffer into a `terminal` object.
+             * @param data A pointer to the first byte of the terminal data block.
+             * @param size The number of bytes available at `data`. What to send: Exactly 6.
+             * @return A `terminal` object populated with the parsed data.
+             * @throws std::invalid_argument if `size` is not exactly 6 bytes.
+             */
+            static terminal parse(const uint8_t* data, const size_t size);
 
-                // Bytes 3-5: Terminal ID (Big-Endian)
-                // Similar logic, but with three bytes. Shift the first byte by 16, the second by 8,
-                // and combine all three with the last byte using bitwise OR.
-                // Example: {0xA1, 0xB2, 0xC3} -> (0xA1 << 16) | (0xB2 << 8) | 0xC3 -> 0xA1B2C3.
-                t.terminal_id_ = (static_cast<uint32_t>(data[3]) << 16) | (static_cast<uint32_t>(data[4]) << 8) | data[5];
+            /**
+             * @brief Non-throwing variant of `parse()` that decodes 6 bytes read directly from a raw buffer.
+             * @param data A pointer to the first byte of the terminal data block.
+             * @param size The number of bytes available at `data`. What to send: Exactly 6.
+             * @return A `result` holding the parsed `terminal`, or `status_code::invalid_size` on a size mismatch.
+             */
+            [[nodiscard]] static result<terminal> try_parse(const uint8_t* data, const size_t size) noexcept {
+                if (size != DATA_SIZE) return status_code::invalid_size;
 
+                terminal t;
+                // Every field is decoded from the descriptor table in `layout`.
+                layout::decode(data, t);
                 return t;
             }
 
@@ -465,25 +1318,15 @@ namespace open_loop {
              * @brief Serializes the `terminal` object into a 6-byte vector.
              * @return A `std::vector<uint8_t>` containing the 6 bytes of serialized data.
              */
-            [[nodiscard]] std::vector<uint8_t> to_bytes() const noexcept {
-                return {
-                    // Byte 0: Acquirer ID is already a single byte.
-                    acquirer_id_,
+            [[nodiscard]] std::vector<uint8_t> to_bytes() const noexcept;
 
-                    // Bytes 1-2: Operator ID (Big-Endian)
-                    // Get the MSB by shifting right by 8 bits.
-                    // Get the LSB by casting to uint8_t (which implicitly truncates the upper bits).
-                    static_cast<uint8_t>(operator_id_ >> 8),
-                    static_cast<uint8_t>(operator_id_),
-
-                    // Bytes 3-5: Terminal ID (Big-Endian)
-                    // Get the MSB by shifting right by 16.
-                    // Get the middle byte by shifting right by 8.
-                    // Get the LSB by casting.
-                    static_cast<uint8_t>(terminal_id_ >> 16),
-                    static_cast<uint8_t>(terminal_id_ >> 8),
-                    static_cast<uint8_t>(terminal_id_)
-                };
+            /**
+             * @brief Serializes the `terminal` object directly into a caller-supplied buffer.
+             * @param out A pointer to at least 6 writable bytes. Exactly 6 bytes are written.
+             */
+            void serialize_into(uint8_t* out) const noexcept {
+                // Every field is encoded from the descriptor table in `layout`.
+                layout::encode(*this, out);
             }
 
             [[nodiscard]] uint8_t get_acquirer_id() const noexcept { return acquirer_id_; }
@@ -493,16 +1336,13 @@ namespace open_loop {
              * @brief Retrieves the Terminal ID as a zero-padded, uppercase hexadecimal string.
              * @return A 6-character string representing the terminal ID (e.g., "A1B2C3").
              */
-            [[nodiscard]] std::string get_terminal_id() const {
-                std::stringstream ss;
-                // Configure the stream for hex output:
-                // - std::uppercase: Use "A-F" instead of "a-f".
-                // - std::hex: Use base 16.
-                // - std::setw(6): Set the total width to 6 characters.
-                // - std::setfill('0'): Pad with leading zeros if the number is smaller than 6 hex digits.
-                ss << std::uppercase << std::hex << std::setw(TERMINAL_ID_HEX_LENGTH) << std::setfill('0') << terminal_id_;
-                return ss.str();
-            }
+            [[nodiscard]] std::string get_terminal_id() const { return get_terminal_id_chars().str(); }
+
+            /**
+             * @brief Allocation-free variant of `get_terminal_id()`.
+             * @return The same 6 upper-case hex characters, stored inline.
+             */
+            [[nodiscard]] fixed_string<TERMINAL_ID_HEX_LENGTH> get_terminal_id_chars() const noexcept { return codec::hex_u24(terminal_id_); }
 
             /**
              * @brief Stream insertion operator for easy printing of `terminal` objects.
@@ -510,20 +1350,14 @@ namespace open_loop {
              * @param obj The `terminal` object to print.
              * @return A reference to the output stream.
              */
-            friend std::ostream& operator<<(std::ostream& os, const terminal& obj) {
-                return os << "  [TN] ACQUIRER ID       : " << +obj.get_acquirer_id() << std::endl // Unary `+` promotes uint8_t to int for printing as a number.
-                          << "  [TN] OPERATOR ID       : " << obj.get_operator_id() << std::endl
-                          << "  [TN] TERMINAL ID       : " << obj.get_terminal_id();
-            }
+            friend std::ostream& operator<<(std::ostream& os, const terminal& obj);
 
             /**
              * @brief Compares two `terminal` objects for equality.
              * @return True if all corresponding members are identical, false otherwise.
              */
             friend bool operator==(const terminal& lhs, const terminal& rhs) {
-                return lhs.acquirer_id_ == rhs.acquirer_id_ &&
-                       lhs.operator_id_ == rhs.operator_id_ &&
-                       lhs.terminal_id_ == rhs.terminal_id_;
+                return layout::equal(lhs, rhs);
             }
 
         private:
@@ -536,6 +1370,14 @@ namespace open_loop {
             //! A uint32_t is used for convenience, but the value is always constrained to 0xFFFFFF.
             uint32_t terminal_id_{ 0 };
 
+
+        public:
+
+            //! The on-card layout of this block. `try_parse()`, `serialize_into()` and `operator==` are generated from it.
+            using layout = detail::layout<DATA_SIZE,
+                detail::field<&terminal::acquirer_id_, 0, 8>,   // Byte 0
+                detail::field<&terminal::operator_id_, 1, 16>,  // Bytes 1-2 (Big-Endian)
+                detail::field<&terminal::terminal_id_, 3, 24>>; // Bytes 3-5 (Big-Endian)
         };
         // ------------------------------------------------------ VALIDATION DATA -------------------------------------------------------
 
@@ -598,7 +1440,7 @@ namespace open_loop {
              * @param date_in_minutes The card's effective date. What to send: A `std::time_t` value representing
              *                        the number of **minutes** since the Unix epoch.
              */
-            void set_card_effective_date(std::time_t date_in_minutes) noexcept {
+            void set_card_effective_date(const effective_epoch date_in_minutes) noexcept {
                 card_effective_date_in_minutes_ = date_in_minutes;
             }
 
@@ -609,32 +1451,17 @@ namespace open_loop {
              * @throws std::logic_error if `set_card_effective_date()` has not been called first.
              * @throws std::out_of_range if the calculated time difference is negative or exceeds the 24-bit storage limit.
              */
-            void set_date_and_time(const uint64_t absolute_time_in_milliseconds) {
-                // This function's primary job is to convert an absolute timestamp into a relative
-                // offset in minutes, which is how the data is stored on the card.
-
-                // First, ensure the base date for the calculation has been set.
-                if (!card_effective_date_in_minutes_.has_value())
-                    throw std::logic_error("Card effective date must be set before setting transaction time.");
-
-                // Convert the absolute time from milliseconds to minutes. Use uint64_t for the intermediate
-                // value to prevent overflow and maintain precision.
-                const uint64_t absolute_time_in_minutes = absolute_time_in_milliseconds / 60000;
-                const uint64_t effective_date_minutes = *card_effective_date_in_minutes_;
-
-                // The transaction time must be on or after the effective date.
-                if (absolute_time_in_minutes < effective_date_minutes)
-                    throw std::out_of_range("Transaction time cannot be before the card effective date.");
-
-                // Calculate the difference in minutes. This difference will be stored.
-                const uint64_t time_diff = absolute_time_in_minutes - effective_date_minutes;
+            void set_date_and_time(const uint64_t absolute_time_in_milliseconds);
 
-                // Ensure the calculated offset fits within the 24 bits allocated for it.
-                if (time_diff > TIME_OFFSET_MAX)
-                    throw std::out_of_range("Transaction time is out of the valid 24-bit range from effective date.");
-
-                // Safely store the valid offset.
-                date_and_time_offset_ = static_cast<uint32_t>(time_diff);
+            /**
+             * @brief Non-throwing variant of `set_date_and_time()`.
+             * @param absolute_time_in_milliseconds The absolute time of the transaction in milliseconds since the Unix epoch.
+             * @return `status_code::ok`, `effective_date_not_set`, `time_before_effective_date`, or `time_offset_overflow`.
+             *         The stored time is unchanged on failure.
+             */
+            [[nodiscard]] status_code try_set_date_and_time(const uint64_t absolute_time_in_milliseconds) noexcept {
+                // Convert the absolute timestamp into the relative offset in minutes stored on the card.
+                return detail::encode_time_offset(card_effective_date_in_minutes_, absolute_time_in_milliseconds, date_and_time_offset_);
             }
 
             /**
@@ -642,20 +1469,14 @@ namespace open_loop {
              * @param data A numeric value for use by the service provider. What to send: A value in the range [0, 0xFFFFFF].
              * @throws std::out_of_range if the data value exceeds the 24-bit limit.
              */
-            void set_service_provider_data(const uint32_t data) {
-                if (data > SERVICE_DATA_MAX) throw std::out_of_range("Service provider data exceeds 24-bit limit.");
-                service_provider_data_ = data;
-            }
+            void set_service_provider_data(const uint32_t data);
 
             /**
              * @brief Sets the value for the Reserved for Future Use (RFU) field.
              * @param value The RFU value. What to send: A value in the range [0, 15].
              * @throws std::out_of_range if the value is outside the valid 4-bit range.
              */
-            void set_rfu(const uint8_t value) {
-                if (value > RFU_MAX) throw std::out_of_range("RFU value must be in the range [0, 15].");
-                rfu_ = value;
-            }
+            void set_rfu(const uint8_t value);
 
             void set_error_code(const uint8_t code) noexcept { error_code_ = code; }
             void set_product_type(const uint8_t type) noexcept { product_type_ = type; }
@@ -672,84 +1493,49 @@ namespace open_loop {
              * @return A `validation` object populated with parsed data.
              * @throws std::invalid_argument if the data vector is not 19 bytes.
              */
-            static validation parse(const std::vector<uint8_t>& data, std::time_t card_effective_date_in_minutes) {
-                if (data.size() != DATA_SIZE) throw std::invalid_argument("Validation data must be exactly 19 bytes.");
+            static validation parse(const std::vector<uint8_t>& data, std::time_t card_effective_date_in_minutes);
+
+            /**
+             * @brief Parses 19 bytes read directly from a raw buffer into a `validation` object.
+             * @param data A pointer to the first byte of the validation data block.
+             * @param size The number of bytes available at `data`. What to send: Exactly 19.
+             * @param card_effective_date_in_minutes The card's effective date in minutes since epoch.
+             * @return A `validation` object populated with parsed data.
+             * @throws std::invalid_argument if `size` is not 19 bytes.
+             */
+            static validation parse(const uint8_t* data, const size_t size, std::time_t card_effective_date_in_minutes);
+
+            /**
+             * @brief Non-throwing variant of `parse()` that decodes 19 bytes read directly from a raw buffer.
+             * @param data A pointer to the first byte of the validation data block.
+             * @param size The number of bytes available at `data`. What to send: Exactly 19.
+             * @param card_effective_date_in_minutes The card's effective date in minutes since epoch.
+             * @return A `result` holding the parsed `validation`, or `status_code::invalid_size` on a size mismatch.
+             */
+            [[nodiscard]] static result<validation> try_parse(const uint8_t* data, const size_t size, const effective_epoch card_effective_date_in_minutes) noexcept {
+                if (size != DATA_SIZE) return status_code::invalid_size;
 
                 validation v;
                 // Store the provided effective date, as it's necessary to calculate the absolute time later.
                 v.card_effective_date_in_minutes_ = card_effective_date_in_minutes;
+                // Every field is decoded from the descriptor table in `layout`.
+                layout::decode(data, v);
+                return v;
+            }
 
-                // Bytes 0-1: Single-byte fields, direct copy.
-                v.error_code_ = data[0];
-                v.product_type_ = data[1];
-
-                // Bytes 2-7: Terminal Info (6 bytes).
-                // Delegate parsing to the `terminal` class by passing it the relevant slice of the data vector.
-                v.terminal_info_ = terminal::parse({data.begin() + 2, data.begin() + 8});
-
-                // Bytes 8-10: Date and Time Offset (24-bit, Big-Endian).
-                // Reconstruct the 24-bit integer from three bytes using bitwise shifts and ORs.
-                v.date_and_time_offset_ = (static_cast<uint32_t>(data[8]) << 16) | (static_cast<uint32_t>(data[9]) << 8) | data[10];
-
-                // Bytes 11-12: Fare Amount (16-bit, Big-Endian).
-                v.fare_amount_ = (static_cast<uint16_t>(data[11]) << 8) | data[12];
-
-                // Bytes 13-14: Route Number (16-bit, Big-Endian).
-                v.route_number_ = (static_cast<uint16_t>(data[13]) << 8) | data[14];
-
-                // Bytes 15-17: Service Provider Data (24-bit, Big-Endian).
-                v.service_provider_data_ = (static_cast<uint32_t>(data[15]) << 16) | (static_cast<uint32_t>(data[16]) << 8) | data[17];
-
-                // Byte 18: Transaction Status (upper 4 bits) and RFU (lower 4 bits).
-                // Get status by shifting right by 4 bits.
-                v.status_ = static_cast<txn_status>(data[18] >> 4);
-                // Get RFU by masking with 0x0F (binary 00001111).
-                v.rfu_ = data[18] & RFU_MAX;
-
-                return v;
-            }
+            /**
+             * @brief Serializes the `validation` object into a 19-byte vector.
+             * @return A `std::vector<uint8_t>` containing the serialized data.
+             */
+            [[nodiscard]] std::vector<uint8_t> to_bytes() const;
 
             /**
-             * @brief Serializes the `validation` object into a 19-byte vector.
-             * @return A `std::vector<uint8_t>` containing the serialized data.
+             * @brief Serializes the `validation` object directly into a caller-supplied buffer.
+             * @param out A pointer to at least 19 writable bytes. Exactly 19 bytes are written.
              */
-            [[nodiscard]] std::vector<uint8_t> to_bytes() const {
-                std::vector<uint8_t> data;
-                data.reserve(DATA_SIZE); // Pre-allocate memory to avoid reallocations.
-
-                // Bytes 0-1: Single-byte fields.
-                data.push_back(error_code_);
-                data.push_back(product_type_);
-
-                // Bytes 2-7: Terminal Info.
-                // Delegate serialization to the `terminal` class and insert its bytes.
-                auto terminal_bytes = terminal_info_.to_bytes();
-                data.insert(data.end(), terminal_bytes.begin(), terminal_bytes.end());
-
-                // Bytes 8-10: Date and Time Offset (24-bit, Big-Endian).
-                // Deconstruct the 24-bit integer into three separate bytes.
-                data.push_back((date_and_time_offset_ >> 16) & 0xFF); // Most significant byte
-                data.push_back((date_and_time_offset_ >> 8) & 0xFF);  // Middle byte
-                data.push_back(date_and_time_offset_ & 0xFF);         // Least significant byte
-
-                // Bytes 11-12: Fare Amount (16-bit, Big-Endian).
-                data.push_back((fare_amount_ >> 8) & 0xFF);
-                data.push_back(fare_amount_ & 0xFF);
-
-                // Bytes 13-14: Route Number (16-bit, Big-Endian).
-                data.push_back((route_number_ >> 8) & 0xFF);
-                data.push_back(route_number_ & 0xFF);
-
-                // Bytes 15-17: Service Provider Data (24-bit, Big-Endian).
-                data.push_back((service_provider_data_ >> 16) & 0xFF);
-                data.push_back((service_provider_data_ >> 8) & 0xFF);
-                data.push_back(service_provider_data_ & 0xFF);
-
-                // Byte 18: Transaction Status and RFU.
-                // Shift status into the upper 4 bits and combine with the 4-bit RFU value.
-                data.push_back((static_cast<uint8_t>(status_) << 4) | rfu_);
-
-                return data;
+            void serialize_into(uint8_t* out) const noexcept {
+                // Every field is encoded from the descriptor table in `layout`.
+                layout::encode(*this, out);
             }
 
             /**
@@ -759,11 +1545,18 @@ namespace open_loop {
              */
             [[nodiscard]] uint64_t get_date_and_time() const {
                 if (!card_effective_date_in_minutes_.has_value())
-                    throw std::logic_error("Card effective date is not set; cannot calculate absolute time.");
-                // Reconstruct the absolute time by adding the stored offset to the base effective date.
-                const uint64_t total_minutes = static_cast<uint64_t>(*card_effective_date_in_minutes_) + date_and_time_offset_;
-                // Convert the total minutes back to milliseconds for the absolute timestamp.
-                return total_minutes * 60000;
+                    throw metrics::counted(std::logic_error("Card effective date is not set; cannot calculate absolute time."));
+                return get_date_and_time_unchecked();
+            }
+
+            /**
+             * @brief Non-checking variant of `get_date_and_time()` for callers that already hold a set epoch.
+             * @pre The effective date has been set, e.g. by the owning container's `set_card_effective_date()`.
+             * @return The transaction time in milliseconds since the Unix epoch.
+             */
+            [[nodiscard]] uint64_t get_date_and_time_unchecked() const noexcept {
+                // Reconstruct the absolute time by adding the stored offset to the precomputed base date.
+                return card_effective_date_in_minutes_.to_milliseconds(date_and_time_offset_);
             }
 
             /**
@@ -771,11 +1564,7 @@ namespace open_loop {
              * @return The effective date in minutes since the Unix epoch.
              * @throws std::logic_error if the effective date has not been set.
              */
-            [[nodiscard]] std::time_t get_card_effective_date() const {
-                if (!card_effective_date_in_minutes_.has_value())
-                    throw std::logic_error("Card effective date has not been set for this record.");
-                return *card_effective_date_in_minutes_;
-            }
+            [[nodiscard]] std::time_t get_card_effective_date() const;
 
             [[nodiscard]] uint8_t get_error_code() const noexcept { return error_code_; }
             [[nodiscard]] uint8_t get_product_type() const noexcept { return product_type_; }
@@ -788,33 +1577,26 @@ namespace open_loop {
              * @brief Retrieves the service provider data as a zero-padded, uppercase hex string.
              * @return A 6-character string representing the data (e.g., "1A2B3C").
              */
-            [[nodiscard]] std::string get_service_provider_data() const {
-                std::stringstream ss;
-                ss << std::uppercase << std::hex << std::setw(6) << std::setfill('0') << service_provider_data_;
-                return ss.str();
-            }
+            [[nodiscard]] std::string get_service_provider_data() const;
+
+            //! The raw 24-bit service provider data, as formatted by `get_service_provider_data()`.
+            [[nodiscard]] uint32_t get_service_provider_data_value() const noexcept { return service_provider_data_; }
+            //! The raw 4-bit RFU value, as formatted by `get_rfu()`.
+            [[nodiscard]] uint8_t get_rfu_bits() const noexcept { return rfu_; }
+            //! The epoch the time offset is relative to. Unset until `set_card_effective_date()` has been called.
+            [[nodiscard]] const effective_epoch& get_card_epoch() const noexcept { return card_effective_date_in_minutes_; }
 
             /**
              * @brief Retrieves the transaction status as a human-readable string.
              * @return A `std::string` like "ENTRY", "EXIT", etc., or "UNKNOWN" for invalid values.
              */
-            [[nodiscard]] std::string get_txn_status_string() const {
-                switch (status_) {
-                    case txn_status::ENTRY:   return "ENTRY";
-                    case txn_status::EXIT:    return "EXIT";
-                    case txn_status::ONETAP:  return "ONETAP";
-                    case txn_status::PENALTY: return "PENALTY";
-                    default:                  return "UNKNOWN";
-                }
-            }
+            [[nodiscard]] std::string get_txn_status_string() const;
 
             /**
              * @brief Retrieves the RFU value as a 4-character binary string.
              * @return A `std::string` like "1101". Useful for debugging.
              */
-            [[nodiscard]] std::string get_rfu() const {
-                return std::bitset<4>(rfu_).to_string();
-            }
+            [[nodiscard]] std::string get_rfu() const;
 
             /**
              * @brief Stream insertion operator for easy printing of `validation` objects.
@@ -822,46 +1604,15 @@ namespace open_loop {
              * @param obj The `validation` object to print.
              * @return A reference to the output stream.
              */
-            friend std::ostream& operator<<(std::ostream& os, const validation& obj) {
-                os << "-------------------------- VALIDATION DATA -------------------------" << std::endl;
-                os << obj.get_terminal_info() << std::endl;
-                os << "  ERROR CODE             : " << static_cast<int>(obj.get_error_code()) << std::endl;
-                os << "  PRODUCT TYPE           : " << static_cast<int>(obj.get_product_type()) << std::endl;
-                try {
-                    // Convert the millisecond timestamp from get_date_and_time() to seconds
-                    // before passing it to std::gmtime, which expects seconds.
-                    const std::time_t t_sec = obj.get_date_and_time() / 1000;
-                    char time_str[100];
-                    // Format the time as a human-readable UTC string.
-                    if (std::strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", std::gmtime(&t_sec))) {
-                        os << "  DATE AND TIME          : " << time_str << " (UTC)" << std::endl;
-                    }
-                } catch (const std::logic_error& e) {
-                    os << "  DATE AND TIME          : " << "[Not available: " << e.what() << "]" << std::endl;
-                }
-                os << "  FARE AMOUNT            : " << obj.get_fare_amount() << std::endl;
-                os << "  ROUTE NUMBER           : " << obj.get_route_number() << std::endl;
-                os << "  SERVICE PROVIDER DATA  : 0x" << obj.get_service_provider_data() << std::endl;
-                os << "  TRANSACTION STATUS     : " << obj.get_txn_status_string() << std::endl;
-                os << "  RFU (BINARY)           : " << obj.get_rfu() << std::endl;
-                os << "--------------------------------------------------------------------";
-                return os;
-            }
+            friend std::ostream& operator<<(std::ostream& os, const validation& obj);
 
             /**
              * @brief Compares two `validation` objects for equality.
              * @return True if all corresponding members are identical, false otherwise.
              */
             friend bool operator==(const validation& lhs, const validation& rhs) {
-                return lhs.error_code_ == rhs.error_code_ &&
-                       lhs.product_type_ == rhs.product_type_ &&
-                       lhs.terminal_info_ == rhs.terminal_info_ &&
-                       lhs.date_and_time_offset_ == rhs.date_and_time_offset_ &&
-                       lhs.fare_amount_ == rhs.fare_amount_ &&
-                       lhs.route_number_ == rhs.route_number_ &&
-                       lhs.service_provider_data_ == rhs.service_provider_data_ &&
-                       lhs.status_ == rhs.status_ &&
-                       lhs.rfu_ == rhs.rfu_ &&
+                // The effective date is not part of the on-card layout, so it is compared separately.
+                return layout::equal(lhs, rhs) &&
                        lhs.card_effective_date_in_minutes_ == rhs.card_effective_date_in_minutes_;
             }
 
@@ -883,8 +1634,22 @@ namespace open_loop {
             uint8_t rfu_{ 0 };
             //! The base date for time calculations, stored in minutes since epoch. This is not part of the
             //! serialized data but is essential for interpreting the `date_and_time_offset_`.
-            std::optional<std::time_t> card_effective_date_in_minutes_;
+            effective_epoch card_effective_date_in_minutes_;
+
+
+        public:
 
+            //! The on-card layout of this block. `try_parse()`, `serialize_into()` and `operator==` are generated from it.
+            using layout = detail::layout<DATA_SIZE,
+                detail::field<&validation::error_code_, 0, 8>,               // Byte 0
+                detail::field<&validation::product_type_, 1, 8>,             // Byte 1
+                detail::nested<&validation::terminal_info_, 2>,              // Bytes 2-7
+                detail::field<&validation::date_and_time_offset_, 8, 24>,    // Bytes 8-10 (Big-Endian)
+                detail::field<&validation::fare_amount_, 11, 16>,            // Bytes 11-12 (Big-Endian)
+                detail::field<&validation::route_number_, 13, 16>,           // Bytes 13-14 (Big-Endian)
+                detail::field<&validation::service_provider_data_, 15, 24>,  // Bytes 15-17 (Big-Endian)
+                detail::field<&validation::status_, 18, 4, 4>,               // Byte 18, upper nibble
+                detail::field<&validation::rfu_, 18, 4>>;                    // Byte 18, lower nibble
         };
 
         // ------------------------------------------------------ LOG DATA -------------------------------------------------------
@@ -933,7 +1698,7 @@ namespace open_loop {
              * @param date_in_minutes The card's effective date. What to send: A `std::time_t` value representing
              *                        the number of **minutes** since the Unix epoch.
              */
-            void set_card_effective_date(std::time_t date_in_minutes) noexcept {
+            void set_card_effective_date(const effective_epoch date_in_minutes) noexcept {
                 card_effective_date_in_minutes_ = date_in_minutes;
             }
 
@@ -944,17 +1709,17 @@ namespace open_loop {
              * @throws std::logic_error if `set_card_effective_date()` has not been called first.
              * @throws std::out_of_range if the calculated time difference is negative or exceeds the 24-bit storage limit.
              */
-            void set_date_and_time(const uint64_t absolute_time_in_milliseconds) {
-                if (!card_effective_date_in_minutes_.has_value())
-                    throw std::logic_error("Card effective date must be set before setting transaction time.");
-                const uint64_t absolute_time_in_minutes = absolute_time_in_milliseconds / 60000;
-                const uint64_t effective_date_minutes = *card_effective_date_in_minutes_;
-                if (absolute_time_in_minutes < effective_date_minutes)
-                    throw std::out_of_range("Transaction time cannot be before the card effective date.");
-                const uint64_t time_diff = absolute_time_in_minutes - effective_date_minutes;
-                if (time_diff > TIME_OFFSET_MAX)
-                    throw std::out_of_range("Transaction time is out of the valid 24-bit range from effective date.");
-                date_and_time_offset_ = static_cast<uint32_t>(time_diff);
+            void set_date_and_time(const uint64_t absolute_time_in_milliseconds);
+
+            /**
+             * @brief Non-throwing variant of `set_date_and_time()`.
+             * @param absolute_time_in_milliseconds The absolute time of the transaction in milliseconds since the Unix epoch.
+             * @return `status_code::ok`, `effective_date_not_set`, `time_before_effective_date`, or `time_offset_overflow`.
+             *         The stored time is unchanged on failure.
+             */
+            [[nodiscard]] status_code try_set_date_and_time(const uint64_t absolute_time_in_milliseconds) noexcept {
+                // Convert the absolute timestamp into the relative offset in minutes stored on the card.
+                return detail::encode_time_offset(card_effective_date_in_minutes_, absolute_time_in_milliseconds, date_and_time_offset_);
             }
 
             /**
@@ -962,9 +1727,16 @@ namespace open_loop {
              * @param balance The card balance. What to send: A value in the range [0, 1048575] (0xFFFFF).
              * @throws std::out_of_range if the balance exceeds the 20-bit limit.
              */
-            void set_card_balance(const uint32_t balance) {
-                if (balance > CARD_BALANCE_MAX) throw std::out_of_range("Card balance exceeds 20-bit limit.");
+            void set_card_balance(const uint32_t balance);
+
+            /**
+             * @brief Non-throwing variant of `set_card_balance()`.
+             * @return `status_code::ok`, or `card_balance_overflow` (balance unchanged) if it exceeds 0xFFFFF.
+             */
+            [[nodiscard]] status_code try_set_card_balance(const uint32_t balance) noexcept {
+                if (balance > CARD_BALANCE_MAX) return status_code::card_balance_overflow;
                 card_balance_ = balance;
+                return status_code::ok;
             }
 
             /**
@@ -972,10 +1744,7 @@ namespace open_loop {
              * @param value The RFU value. What to send: A value in the range [0, 15].
              * @throws std::out_of_range if the value is outside the valid 4-bit range.
              */
-            void set_rfu(const uint8_t value) {
-                if (value > RFU_MAX) throw std::out_of_range("RFU value must be in the range [0, 15].");
-                rfu_ = value;
-            }
+            void set_rfu(const uint8_t value);
 
             void set_terminal_info(const terminal& info) noexcept { terminal_info_ = info; }
             void set_txn_amount(const uint16_t amount) noexcept { txn_amount_ = amount; }
@@ -991,17 +1760,33 @@ namespace open_loop {
              * @return A `log` object populated with parsed data.
              * @throws std::invalid_argument if the data vector is not 17 bytes.
              */
-            static log parse(const std::vector<uint8_t>& data, std::time_t card_effective_date_in_minutes) {
-                if (data.size() != DATA_SIZE) throw std::invalid_argument("Log data must be exactly 17 bytes.");
+            static log parse(const std::vector<uint8_t>& data, std::time_t card_effective_date_in_minutes);
+
+            /**
+             * @brief Parses 17 bytes read directly from a raw buffer into a `log` object.
+             * @param data A pointer to the first byte of the log entry.
+             * @param size The number of bytes available at `data`. What to send: Exactly 17.
+             * @param card_effective_date_in_minutes The card's effective date in minutes since epoch.
+             * @return A `log` object populated with parsed data.
+             * @throws std::invalid_argument if `size` is not 17 bytes.
+             */
+            static log parse(const uint8_t* data, const size_t size, std::time_t card_effective_date_in_minutes);
+
+            /**
+             * @brief Non-throwing variant of `parse()` that decodes 17 bytes read directly from a raw buffer.
+             * @param data A pointer to the first byte of the log entry.
+             * @param size The number of bytes available at `data`. What to send: Exactly 17.
+             * @param card_effective_date_in_minutes The card's effective date in minutes since epoch.
+             * @return A `result` holding the parsed `log`, or `status_code::invalid_size` on a size mismatch.
+             */
+            [[nodiscard]] static result<log> try_parse(const uint8_t* data, const size_t size, const effective_epoch card_effective_date_in_minutes) noexcept {
+                if (size != DATA_SIZE) return status_code::invalid_size;
+
                 log l;
+                // Store the provided effective date, as it's necessary to calculate the absolute time later.
                 l.card_effective_date_in_minutes_ = card_effective_date_in_minutes;
-                l.terminal_info_ = terminal::parse({data.begin(), data.begin() + 6});
-                l.date_and_time_offset_ = (static_cast<uint32_t>(data[6]) << 16) | (static_cast<uint32_t>(data[7]) << 8) | data[8];
-                l.txn_amount_ = (static_cast<uint16_t>(data[9]) << 8) | data[10];
-                l.txn_sq_no_ = (static_cast<uint16_t>(data[11]) << 8) | data[12];
-                l.card_balance_ = (static_cast<uint32_t>(data[13]) << 12) | (static_cast<uint32_t>(data[14]) << 4) | (data[15] >> 4);
-                l.status_ = static_cast<txn_status>((data[16] >> 4) & 0x0F);
-                l.rfu_ = data[16] & 0x0F;
+                // Every field is decoded from the descriptor table in `layout`.
+                layout::decode(data, l);
                 return l;
             }
 
@@ -1009,107 +1794,55 @@ namespace open_loop {
              * @brief Serializes the `log` object into a 17-byte vector.
              * @return A `std::vector<uint8_t>` containing the serialized data.
              */
-            [[nodiscard]] std::vector<uint8_t> to_bytes() const {
-                std::vector<uint8_t> data;
-                data.reserve(DATA_SIZE);
-
-                // Bytes 0-5: Terminal Info.
-                auto terminal_bytes = terminal_info_.to_bytes();
-                data.insert(data.end(), terminal_bytes.begin(), terminal_bytes.end());
-
-                // Bytes 6-8: Date and Time Offset (24-bit).
-                data.push_back((date_and_time_offset_ >> 16) & 0xFF);
-                data.push_back((date_and_time_offset_ >> 8) & 0xFF);
-                data.push_back(date_and_time_offset_ & 0xFF);
-
-                // Bytes 9-10: Transaction Amount (16-bit).
-                data.push_back((txn_amount_ >> 8) & 0xFF);
-                data.push_back(txn_amount_ & 0xFF);
-
-                // Bytes 11-12: Transaction Sequence Number (16-bit).
-                data.push_back((txn_sq_no_ >> 8) & 0xFF);
-                data.push_back(txn_sq_no_ & 0xFF);
-
-                // Bytes 13-15: Card Balance (20-bit).
-                // Byte 13: The most significant 8 bits of the 20-bit balance.
-                data.push_back((card_balance_ >> 12) & 0xFF);
-                // Byte 14: The middle 8 bits of the 20-bit balance.
-                data.push_back((card_balance_ >> 4) & 0xFF);
-                // Byte 15: The least significant 4 bits of the balance, placed into the upper
-                //          4 bits of this byte. The lower 4 unused bits are set to 1s (0x0F)
-                //          to match the data specification.
-                data.push_back(((card_balance_ & 0x0F) << 4) | 0x0F);
-
-                // Byte 16: Transaction Status and RFU.
-                data.push_back((static_cast<uint8_t>(status_) << 4) | rfu_);
+            [[nodiscard]] std::vector<uint8_t> to_bytes() const;
 
-                return data;
+            /**
+             * @brief Serializes the `log` object directly into a caller-supplied buffer.
+             * @param out A pointer to at least 17 writable bytes. Exactly 17 bytes are written.
+             */
+            void serialize_into(uint8_t* out) const noexcept {
+                // Every field is encoded from the descriptor table in `layout`.
+                layout::encode(*this, out);
             }
 
             // --- Getters ---
 
             [[nodiscard]] uint64_t get_date_and_time() const {
                 if (!card_effective_date_in_minutes_.has_value())
-                    throw std::logic_error("Card effective date is not set; cannot calculate absolute time.");
-                const uint64_t total_minutes = static_cast<uint64_t>(*card_effective_date_in_minutes_) + date_and_time_offset_;
-                return total_minutes * 60000;
+                    throw metrics::counted(std::logic_error("Card effective date is not set; cannot calculate absolute time."));
+                return get_date_and_time_unchecked();
             }
 
-            [[nodiscard]] std::time_t get_card_effective_date() const {
-                if (!card_effective_date_in_minutes_.has_value())
-                    throw std::logic_error("Card effective date has not been set for this log.");
-                return *card_effective_date_in_minutes_;
+            /**
+             * @brief Non-checking variant of `get_date_and_time()` for callers that already hold a set epoch.
+             * @pre The effective date has been set, e.g. by the owning container's `set_card_effective_date()`.
+             * @return The transaction time in milliseconds since the Unix epoch.
+             */
+            [[nodiscard]] uint64_t get_date_and_time_unchecked() const noexcept {
+                // Reconstruct the absolute time by adding the stored offset to the precomputed base date.
+                return card_effective_date_in_minutes_.to_milliseconds(date_and_time_offset_);
             }
 
+            [[nodiscard]] std::time_t get_card_effective_date() const;
+
             [[nodiscard]] const terminal& get_terminal_info() const noexcept { return terminal_info_; }
             [[nodiscard]] uint16_t get_txn_amount() const noexcept { return txn_amount_; }
             [[nodiscard]] uint16_t get_txn_sq_no() const noexcept { return txn_sq_no_; }
             [[nodiscard]] uint32_t get_card_balance() const noexcept { return card_balance_; }
             [[nodiscard]] txn_status get_txn_status() const noexcept { return status_; }
-            [[nodiscard]] std::string get_rfu() const noexcept { return std::bitset<4>(rfu_).to_string(); }
-
-            [[nodiscard]] std::string get_txn_status_string() const {
-                switch (status_) {
-                    case txn_status::ENTRY:   return "ENTRY";
-                    case txn_status::EXIT:    return "EXIT";
-                    case txn_status::ONETAP:  return "ONETAP";
-                    case txn_status::PENALTY: return "PENALTY";
-                    default:                  return "UNKNOWN";
-                }
-            }
+            [[nodiscard]] std::string get_rfu() const noexcept;
+            [[nodiscard]] uint8_t get_rfu_bits() const noexcept { return rfu_; }
+            [[nodiscard]] const effective_epoch& get_card_epoch() const noexcept { return card_effective_date_in_minutes_; }
+
+            [[nodiscard]] std::string get_txn_status_string() const;
 
             // --- Operator Overloads ---
 
-            friend std::ostream& operator<<(std::ostream& os, const log& obj) {
-                os << "--------------------------- LOG ENTRY ----------------------------" << std::endl;
-                os << obj.get_terminal_info() << std::endl;
-                try {
-                    const uint64_t time_ms = obj.get_date_and_time();
-                    const std::time_t time_sec = time_ms / 1000;
-                    char time_str[100];
-                    if (std::strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", std::gmtime(&time_sec))) {
-                        os << "  DATE AND TIME          : " << time_str << " (UTC)" << std::endl;
-                    }
-                } catch (const std::logic_error& e) {
-                    os << "  DATE AND TIME          : " << "[Not available: " << e.what() << "]" << std::endl;
-                }
-                os << "  TRANSACTION SQ NO      : " << obj.get_txn_sq_no() << std::endl;
-                os << "  TRANSACTION AMOUNT     : " << obj.get_txn_amount() << std::endl;
-                os << "  CARD BALANCE           : " << obj.get_card_balance() << std::endl;
-                os << "  TRANSACTION STATUS     : " << obj.get_txn_status_string() << std::endl;
-                os << "  RFU (BINARY)           : " << obj.get_rfu() << std::endl;
-                os << "--------------------------------------------------------------------";
-                return os;
-            }
+            friend std::ostream& operator<<(std::ostream& os, const log& obj);
 
             friend bool operator==(const log& lhs, const log& rhs) {
-                return lhs.terminal_info_ == rhs.terminal_info_ &&
-                       lhs.date_and_time_offset_ == rhs.date_and_time_offset_ &&
-                       lhs.txn_amount_ == rhs.txn_amount_ &&
-                       lhs.txn_sq_no_ == rhs.txn_sq_no_ &&
-                       lhs.card_balance_ == rhs.card_balance_ &&
-                       lhs.status_ == rhs.status_ &&
-                       lhs.rfu_ == rhs.rfu_ &&
+                // The effective date is not part of the on-card layout, so it is compared separately.
+                return layout::equal(lhs, rhs) &&
                        lhs.card_effective_date_in_minutes_ == rhs.card_effective_date_in_minutes_;
             }
 
@@ -1121,7 +1854,20 @@ namespace open_loop {
             uint32_t card_balance_{ 0 };
             txn_status status_{ txn_status::ENTRY };
             uint8_t rfu_{ 0 };
-            std::optional<std::time_t> card_effective_date_in_minutes_;
+            effective_epoch card_effective_date_in_minutes_;
+
+        public:
+
+            //! The on-card layout of this block. `try_parse()`, `serialize_into()` and `operator==` are generated from it.
+            using layout = detail::layout<DATA_SIZE,
+                detail::nested<&log::terminal_info_, 0>,            // Bytes 0-5
+                detail::field<&log::date_and_time_offset_, 6, 24>,  // Bytes 6-8 (Big-Endian)
+                detail::field<&log::txn_amount_, 9, 16>,            // Bytes 9-10 (Big-Endian)
+                detail::field<&log::txn_sq_no_, 11, 16>,            // Bytes 11-12 (Big-Endian)
+                detail::field<&log::card_balance_, 13, 20, 4>,      // Bytes 13-15, upper 20 bits
+                detail::constant<15, 4, 0, 0x0F>,                   // Byte 15, lower nibble: always 1s per the specification
+                detail::field<&log::status_, 16, 4, 4>,             // Byte 16, upper nibble
+                detail::field<&log::rfu_, 16, 4>>;                  // Byte 16, lower nibble
         };
 
         // ------------------------------------------------------ HISTORY DATA -------------------------------------------------------
@@ -1185,43 +1931,36 @@ namespace open_loop {
              * @param date_in_minutes The card's effective date. What to send: A `std::time_t` value representing
              *                        the number of **minutes** since the Unix epoch.
              */
-            void set_card_effective_date(std::time_t date_in_minutes) noexcept {
+            void set_card_effective_date(const effective_epoch date_in_minutes) noexcept {
                 card_effective_date_in_minutes_ = date_in_minutes;
             }
 
             /**
              * @brief Adds a new transaction log to the history using circular buffer logic.
-             * @details This method implements "push-down" functionality. The new log is inserted
-             *          at index 0. All existing logs are shifted one position to the right (e.g., the log at
-             *          index 0 moves to index 1, etc.). If the history was already full (4 logs), the last
-             *          log (at index 3) is discarded before the shift.
+             * @details This method implements "push-down" semantics. The new log becomes index 0 and every
+             *          existing log moves one position towards the end (e.g., the log at index 0 becomes index 1).
+             *          If the history was already full (4 logs), the log at index 3 is discarded. The logs are
+             *          kept in a head-indexed ring, so only the new log is copied; nothing is shifted.
              * @param new_log The `log` object to add. What to send: A fully populated `log` object whose
              *                own effective date has been set and matches this history's effective date.
              * @throws std::logic_error if this history's effective date has not been set.
              * @throws std::invalid_argument if the `new_log`'s effective date does not match this history's.
              */
             void add_log(const log& new_log) {
+                const metrics::scoped_timer timer(metrics::operation::csa_add_log);
 
                 // Precondition: The history object must have its effective date set.
                 if (!card_effective_date_in_minutes_.has_value())
-                    throw std::logic_error("Cannot add a log until the history's effective date is set.");
+                    throw metrics::counted(std::logic_error("Cannot add a log until the history's effective date is set."));
 
                 // Precondition: The incoming log must be consistent with the history's effective date.
                 if (new_log.get_card_effective_date() != *card_effective_date_in_minutes_)
-                    throw std::invalid_argument("Log's effective date must match history's effective date.");
-
-                // Determine how many existing elements need to be shifted to make space at the front.
-                // If the array is not full, we shift `valid_log_count_` elements.
-                // If the array is full, we only shift the first `LOG_COUNT - 1` elements, discarding the last one.
-                const size_t elements_to_shift = std::min(valid_log_count_, LOG_COUNT - 1);
-
-                // Perform the shift. Loop backwards from the end to avoid overwriting data prematurely.
-                // e.g., for 3 elements: logs[3]=logs[2], logs[2]=logs[1], logs[1]=logs[0].
-                for (size_t i = elements_to_shift; i > 0; --i)
-                    logs_[i] = logs_[i - 1];
+                    throw metrics::counted(std::invalid_argument("Log's effective date must match history's effective date."));
 
-                // Insert the new log at the first position.
-                logs_[0] = new_log;
+                // Step the head back one slot. When the ring is full, that slot holds the oldest log,
+                // which is exactly the one push-down would discard.
+                head_ = (head_ == 0) ? LOG_COUNT - 1 : head_ - 1;
+                logs_[head_] = new_log;
 
                 // Increment the count of valid logs but cap it at the maximum size.
                 if (valid_log_count_ < LOG_COUNT)
@@ -1235,6 +1974,7 @@ namespace open_loop {
              */
             void clear() noexcept {
                 valid_log_count_ = 0;
+                head_ = 0;
             }
 
             /**
@@ -1246,18 +1986,37 @@ namespace open_loop {
              * @note This function assumes that log slots are contiguous from the start. It stops parsing
              *       if it encounters a log slot that is entirely filled with zeros.
              */
-            static history parse(const std::vector<uint8_t>& data, const std::time_t card_effective_date_in_minutes) {
+            static history parse(const std::vector<uint8_t>& data, const std::time_t card_effective_date_in_minutes);
 
-                if (data.size() != TOTAL_SIZE)
-                    throw std::invalid_argument("History data must be exactly 68 bytes.");
+            /**
+             * @brief Parses 68 bytes read directly from a raw buffer into a `history` object.
+             * @param data A pointer to the first byte of the history block.
+             * @param size The number of bytes available at `data`. What to send: Exactly 68.
+             * @param card_effective_date_in_minutes The card's effective date in minutes since epoch.
+             * @return A `history` object populated with up to 4 logs from the data.
+             * @throws std::invalid_argument if `size` is not exactly 68 bytes.
+             */
+            static history parse(const uint8_t* data, const size_t size, const std::time_t card_effective_date_in_minutes);
+
+            /**
+             * @brief Non-throwing variant of `parse()` that decodes 68 bytes read directly from a raw buffer.
+             * @param data A pointer to the first byte of the history block.
+             * @param size The number of bytes available at `data`. What to send: Exactly 68.
+             * @param card_effective_date_in_minutes The card's effective date in minutes since epoch.
+             * @return A `result` holding the parsed `history`, or `status_code::invalid_size` on a size mismatch.
+             */
+            [[nodiscard]] static result<history> try_parse(const uint8_t* data, const size_t size, const effective_epoch card_effective_date_in_minutes) noexcept {
+
+                if (size != TOTAL_SIZE)
+                    return status_code::invalid_size;
 
                 history h;
                 h.set_card_effective_date(card_effective_date_in_minutes);
 
                 // Iterate through the four possible log slots in the byte array.
                 for (size_t i = 0; i < LOG_COUNT; ++i) {
-                    // Get an iterator to the start of the current 17-byte log chunk.
-                    const auto begin = data.begin() + (i * LOG_SIZE_BYTES);
+                    // Get a pointer to the start of the current 17-byte log chunk.
+                    const uint8_t* begin = data + (i * LOG_SIZE_BYTES);
                     const auto end = begin + LOG_SIZE_BYTES;
 
                     // Heuristic check: If a 17-byte chunk is all zeros, assume it's an empty log slot
@@ -1266,7 +2025,7 @@ namespace open_loop {
                         break; // Stop parsing.
 
                     // If the slot is not empty, delegate parsing to the `log` class.
-                    h.logs_[i] = log::parse({begin, end}, card_effective_date_in_minutes);
+                    h.logs_[i] = log::try_parse(begin, LOG_SIZE_BYTES, card_effective_date_in_minutes).value();
                     h.valid_log_count_++;
                 }
                 return h;
@@ -1277,39 +2036,98 @@ namespace open_loop {
              * @details Any unused log slots will be padded with zeros to ensure the output is always 68 bytes.
              * @return A `std::vector<uint8_t>` of the serialized history data.
              */
-            [[nodiscard]] std::vector<uint8_t> to_bytes() const {
-                std::vector<uint8_t> data;
-                data.reserve(TOTAL_SIZE); // Pre-allocate memory for efficiency.
+            [[nodiscard]] std::vector<uint8_t> to_bytes() const;
 
-                // Serialize each valid log entry and append its bytes to the main vector.
+            /**
+             * @brief Serializes the `history` object directly into a caller-supplied buffer.
+             * @details Any unused log slots are zero-filled, so exactly 68 bytes are always written.
+             * @param out A pointer to at least 68 writable bytes.
+             */
+            void serialize_into(uint8_t* out) const noexcept {
+                // Serialize each valid log entry, newest first, straight into its 17-byte slot.
                 for (size_t i = 0; i < valid_log_count_; ++i) {
-                    auto log_bytes = logs_[i].to_bytes();
-                    data.insert(data.end(), log_bytes.begin(), log_bytes.end());
+                    get_log_unchecked(i).serialize_into(out + (i * LOG_SIZE_BYTES));
                 }
 
-                // If there are fewer than 4 logs, the remaining space must be padded with zeros
+                // If there are fewer than 4 logs, the remaining slots must be padded with zeros
                 // to ensure the final output is exactly 68 bytes.
-                if (const size_t padding_size = (LOG_COUNT - valid_log_count_) * LOG_SIZE_BYTES; padding_size > 0) {
-                    data.insert(data.end(), padding_size, 0x00);
-                }
-                return data;
+                std::fill(out + (valid_log_count_ * LOG_SIZE_BYTES), out + TOTAL_SIZE, 0x00);
             }
 
             // --- Getters ---
 
-            [[nodiscard]] const std::array<log, LOG_COUNT>& get_logs() const noexcept { return logs_; }
+            /**
+             * @brief Returns a copy of all four log slots in on-card order (index 0 is the newest).
+             * @details Prefer `get_log()` on hot paths; it returns a reference without copying.
+             */
+            [[nodiscard]] std::array<log, LOG_COUNT> get_logs() const noexcept {
+                std::array<log, LOG_COUNT> logs;
+                for (size_t i = 0; i < LOG_COUNT; ++i) logs[i] = get_log_unchecked(i);
+                return logs;
+            }
+
+            /**
+             * @brief Returns the log at logical position `index`, where 0 is the newest.
+             * @param index What to send: a value in [0, 3]. Slots at or beyond `get_valid_log_count()` hold
+             *              default-constructed or stale logs.
+             * @throws std::out_of_range if `index` is not below `LOG_COUNT`.
+             */
+            [[nodiscard]] const log& get_log(const size_t index) const {
+                if (index >= LOG_COUNT) throw metrics::counted(std::out_of_range("History log index must be in the range [0, 3]."));
+                return get_log_unchecked(index);
+            }
+
+            //! Non-checking variant of `get_log()`. `index` must be below `LOG_COUNT`.
+            [[nodiscard]] const log& get_log_unchecked(const size_t index) const noexcept {
+                return logs_[detail::ring_slot(head_, index, LOG_COUNT)];
+            }
+
             [[nodiscard]] size_t get_valid_log_count() const noexcept { return valid_log_count_; }
+            //! The epoch shared by the stored logs. Unset until `set_card_effective_date()` has been called.
+            [[nodiscard]] const effective_epoch& get_card_epoch() const noexcept { return card_effective_date_in_minutes_; }
+
+            /**
+             * @brief Pushes a serialized log onto a raw 68-byte history block without decoding it.
+             * @details Rotates the 17-byte slots down by one in place, dropping the oldest, and copies the new
+             *          log into slot 0. The result matches `add_log()` followed by `serialize_into()`.
+             * @param history_data The first byte of the history block, e.g. `csa + container::HISTORY_OFFSET`.
+             * @param log_data The 17 bytes of the new log. Must not overlap `history_data`.
+             */
+            static void push_log_into(uint8_t* history_data, const uint8_t* log_data) noexcept {
+                detail::push_front_slot(history_data, LOG_COUNT, LOG_SIZE_BYTES, log_data);
+            }
+
+            /**
+             * @brief Serializes `new_log` and pushes it onto a raw 68-byte history block.
+             * @param history_data The first byte of the history block.
+             * @param new_log The log to write into slot 0.
+             */
+            static void push_log_into(uint8_t* history_data, const log& new_log) noexcept {
+                std::array<uint8_t, LOG_SIZE_BYTES> bytes;
+                new_log.serialize_into(bytes.data());
+                push_log_into(history_data, bytes.data());
+            }
 
             /**
              * @brief Gets the card effective date associated with this history.
              * @return The effective date in minutes since the Unix epoch.
              * @throws std::logic_error if the effective date has not been set.
              */
-            [[nodiscard]] std::time_t get_card_effective_date() const {
-                if (!card_effective_date_in_minutes_.has_value()) {
-                    throw std::logic_error("Card effective date has not been set.");
-                }
-                return *card_effective_date_in_minutes_;
+            [[nodiscard]] std::time_t get_card_effective_date() const;
+
+            /**
+             * @brief Decodes the timestamps of every stored log in one pass.
+             * @details Fare rules read all timestamps repeatedly; this checks the effective date once and
+             *          then performs one multiply-add per log.
+             * @return The absolute times in milliseconds, newest first. Slots at or beyond `get_valid_log_count()` are 0.
+             * @throws std::logic_error if the effective date has not been set.
+             */
+            [[nodiscard]] std::array<uint64_t, LOG_COUNT> get_dates_and_times() const {
+                if (!card_effective_date_in_minutes_.has_value())
+                    throw metrics::counted(std::logic_error("Card effective date is not set; cannot calculate absolute time."));
+                std::array<uint64_t, LOG_COUNT> times{};
+                for (size_t i = 0; i < valid_log_count_; ++i) times[i] = get_log_unchecked(i).get_date_and_time_unchecked();
+                return times;
             }
 
             // --- Operator Overloads ---
@@ -1320,27 +2138,7 @@ namespace open_loop {
              * @param obj The `history` object to print.
              * @return A reference to the output stream.
              */
-            friend std::ostream& operator<<(std::ostream& os, const history& obj) {
-                os << "=========================== HISTORY DATA ===========================" << std::endl;
-                try {
-                    os << "  CARD EFFECTIVE DATE (MINS): " << obj.get_card_effective_date() << std::endl;
-                } catch ([[maybe_unused]] const std::logic_error& e) {
-                    // `[[maybe_unused]]` prevents a compiler warning if exceptions are turned off.
-                    os << "  CARD EFFECTIVE DATE (MINS): [Not Set]" << std::endl;
-                }
-                os << "  VALID LOG COUNT           : " << obj.get_valid_log_count() << std::endl;
-
-                if (obj.get_valid_log_count() > 0) {
-                    // Print each valid log entry. The log's own stream operator will be used.
-                    for (size_t i = 0; i < obj.get_valid_log_count(); ++i) {
-                        os << obj.get_logs()[i] << std::endl;
-                    }
-                } else {
-                    os << "  [No log entries]" << std::endl;
-                }
-                os << "==================================================================";
-                return os;
-            }
+            friend std::ostream& operator<<(std::ostream& os, const history& obj);
 
             /**
              * @brief Compares two `history` objects for equality.
@@ -1352,22 +2150,25 @@ namespace open_loop {
                     lhs.valid_log_count_ != rhs.valid_log_count_) {
                     return false;
                 }
-                // If those match, perform a more expensive comparison of the actual log data.
-                // `std::equal` compares the contents of the logs in the range [begin, end).
-                // We only compare the number of logs that are actually valid.
-                return std::equal(lhs.logs_.begin(), lhs.logs_.begin() + lhs.valid_log_count_, rhs.logs_.begin());
+                // If those match, perform a more expensive comparison of the actual log data,
+                // in logical order and only for the logs that are actually valid.
+                for (size_t i = 0; i < lhs.valid_log_count_; ++i)
+                    if (!(lhs.get_log_unchecked(i) == rhs.get_log_unchecked(i))) return false;
+                return true;
             }
 
         private:
             // --- Private Member Variables ---
 
-            //! A fixed-size array to hold up to four log entries.
+            //! A ring of up to four log entries. Logical index `i` lives in `logs_[(head_ + i) % LOG_COUNT]`.
             std::array<log, LOG_COUNT> logs_{};
+            //! The physical slot in `logs_` that holds the newest log.
+            size_t head_{ 0 };
             //! A counter for how many slots in the `logs_` array are currently filled with valid data.
             size_t valid_log_count_{ 0 };
             //! The base date for all logs within this history, stored in minutes since epoch. This is not
             //! serialized but is essential for consistency and time calculations.
-            std::optional<std::time_t> card_effective_date_in_minutes_;
+            effective_epoch card_effective_date_in_minutes_;
         };
 
         /**
@@ -1418,6 +2219,16 @@ namespace open_loop {
             static constexpr size_t VALIDATION_OFFSET = GENERAL_OFFSET + general::DATA_SIZE; // Offset 2
             static constexpr size_t HISTORY_OFFSET = VALIDATION_OFFSET + validation::DATA_SIZE; // Offset 21
             static constexpr size_t RFU_OFFSET = HISTORY_OFFSET + history::TOTAL_SIZE; // Offset 89
+            //! The logical regions compared independently by `patch_into()`.
+            static constexpr std::array<byte_range, 7> PATCH_REGIONS{{
+                { GENERAL_OFFSET, general::DATA_SIZE },
+                { VALIDATION_OFFSET, validation::DATA_SIZE },
+                { HISTORY_OFFSET + 0 * history::LOG_SIZE_BYTES, history::LOG_SIZE_BYTES },
+                { HISTORY_OFFSET + 1 * history::LOG_SIZE_BYTES, history::LOG_SIZE_BYTES },
+                { HISTORY_OFFSET + 2 * history::LOG_SIZE_BYTES, history::LOG_SIZE_BYTES },
+                { HISTORY_OFFSET + 3 * history::LOG_SIZE_BYTES, history::LOG_SIZE_BYTES },
+                { RFU_OFFSET, RFU_SIZE }
+            }};
 
             /**
              * @brief Default constructor. Creates a `csa::container` in an uninitialized state.
@@ -1433,22 +2244,23 @@ namespace open_loop {
              * @param card_effective_date_in_minutes The card's effective date in minutes since the Unix epoch.
              */
             void set_card_effective_date(const std::time_t card_effective_date_in_minutes) noexcept {
-                card_effective_date_ = card_effective_date_in_minutes;
-                validation_.set_card_effective_date(card_effective_date_in_minutes);
-                history_.set_card_effective_date(card_effective_date_in_minutes);
+                // Build the epoch once and share it, so no child converts the base date again.
+                card_effective_date_ = effective_epoch(card_effective_date_in_minutes);
+                validation_.set_card_effective_date(card_effective_date_);
+                history_.set_card_effective_date(card_effective_date_);
             }
 
             void set_general(const general& gen) noexcept { general_ = gen; }
 
             void set_validation(const validation& val) {
                 if (val.get_card_effective_date() != get_card_effective_date())
-                    throw std::logic_error("Validation object's effective date does not match CSA's.");
+                    throw metrics::counted(std::logic_error("Validation object's effective date does not match CSA's."));
                 validation_ = val;
             }
 
             void set_history(const history& hist) {
                 if (hist.get_card_effective_date() != get_card_effective_date())
-                    throw std::logic_error("History object's effective date does not match CSA's.");
+                    throw metrics::counted(std::logic_error("History object's effective date does not match CSA's."));
                 history_ = hist;
             }
 
@@ -1463,30 +2275,112 @@ namespace open_loop {
              * @throws std::invalid_argument if the data vector is not exactly 96 bytes.
              */
             void parse(const std::vector<uint8_t>& data) {
-                if (!card_effective_date_.has_value())
-                    throw std::logic_error("Card effective date must be set before parsing.");
-                if (data.size() != TOTAL_SIZE)
-                    throw std::invalid_argument("Input CSA data must be exactly 96 bytes.");
+                parse(data.data(), data.size());
+            }
+
+            //! Parses a 96-byte vector drawn from a memory resource, e.g. one returned by `to_bytes(resource)`.
+            void parse(const std::pmr::vector<uint8_t>& data) {
+                parse(data.data(), data.size());
+            }
+
+            /**
+             * @brief Parses 96 bytes read directly from a raw buffer (e.g., the NFC reader's receive buffer).
+             * @details Every child block is decoded in place from its offset within `data`, so a full
+             *          container parse performs no heap allocation.
+             * @param data A pointer to the first byte of the CSA.
+             * @param size The number of bytes available at `data`. What to send: Exactly 96.
+             * @throws std::logic_error if the card's effective date has not been set first via `set_card_effective_date`.
+             * @throws std::invalid_argument if `size` is not exactly 96 bytes.
+             */
+            void parse(const uint8_t* data, const size_t size) {
+                switch (try_parse(data, size)) {
+                    case status_code::ok: return;
+                    case status_code::effective_date_not_set: throw metrics::counted(std::logic_error("Card effective date must be set before parsing."));
+                    default: throw metrics::counted(std::invalid_argument("Input CSA data must be exactly 96 bytes."));
+                }
+            }
 
-                general_ = general::parse({data.begin() + GENERAL_OFFSET, data.begin() + VALIDATION_OFFSET});
-                validation_ = validation::parse({data.begin() + VALIDATION_OFFSET, data.begin() + HISTORY_OFFSET}, *card_effective_date_);
-                history_ = history::parse({data.begin() + HISTORY_OFFSET, data.begin() + RFU_OFFSET}, *card_effective_date_);
-                std::copy(data.begin() + RFU_OFFSET, data.end(), rfu_.begin());
+            /**
+             * @brief Non-throwing variant of `parse()` for use on corrupt-card storms and other hot error paths.
+             * @param data A pointer to the first byte of the CSA.
+             * @param size The number of bytes available at `data`. What to send: Exactly 96.
+             * @return `status_code::ok` on success; `status_code::effective_date_not_set` or `status_code::invalid_size`
+             *         on failure, in which case this container is left unchanged.
+             */
+            [[nodiscard]] status_code try_parse(const uint8_t* data, const size_t size) noexcept {
+                const metrics::scoped_timer timer(metrics::operation::csa_parse);
+                if (!card_effective_date_.has_value())
+                    return metrics::rejected(status_code::effective_date_not_set);
+                if (size != TOTAL_SIZE)
+                    return metrics::rejected(status_code::invalid_size);
+
+                general_ = general::try_parse(data + GENERAL_OFFSET, general::DATA_SIZE).value();
+                validation_ = validation::try_parse(data + VALIDATION_OFFSET, validation::DATA_SIZE, card_effective_date_).value();
+                history_ = history::try_parse(data + HISTORY_OFFSET, history::TOTAL_SIZE, card_effective_date_).value();
+                std::copy(data + RFU_OFFSET, data + TOTAL_SIZE, rfu_.begin());
+                return status_code::ok;
             }
 
             [[nodiscard]] std::vector<uint8_t> to_bytes() const {
-                std::vector<uint8_t> data;
-                data.reserve(TOTAL_SIZE);
-                auto general_data = general_.to_bytes();
-                data.insert(data.end(), general_data.begin(), general_data.end());
-                auto validation_data = validation_.to_bytes();
-                data.insert(data.end(), validation_data.begin(), validation_data.end());
-                auto history_data = history_.to_bytes();
-                data.insert(data.end(), history_data.begin(), history_data.end());
-                data.insert(data.end(), rfu_.begin(), rfu_.end());
+                std::vector<uint8_t> data(TOTAL_SIZE);
+                serialize_into(data.data());
+                return data;
+            }
+
+            /**
+             * @brief Serializes the whole CSA into a vector drawn from a caller-supplied memory resource.
+             * @details Lets a batch job keep every temporary image in one arena and release them all at once,
+             *          instead of returning millions of 96-byte blocks to the global heap one at a time.
+             * @param resource The arena, e.g. a `std::pmr::monotonic_buffer_resource` released after each batch.
+             *                 What to send: A resource that outlives the returned vector.
+             * @return A `std::pmr::vector` holding the 96 serialized bytes.
+             */
+            [[nodiscard]] std::pmr::vector<uint8_t> to_bytes(std::pmr::memory_resource* resource) const {
+                std::pmr::vector<uint8_t> data(TOTAL_SIZE, resource);
+                serialize_into(data.data());
+                return data;
+            }
+
+            /**
+             * @brief Serializes the whole CSA into a fixed-size array without any heap allocation.
+             * @return A `std::array` holding the 96 serialized bytes.
+             */
+            [[nodiscard]] std::array<uint8_t, TOTAL_SIZE> to_array() const noexcept {
+                std::array<uint8_t, TOTAL_SIZE> data{};
+                serialize_into(data.data());
                 return data;
             }
 
+            /**
+             * @brief Serializes the whole CSA directly into a caller-supplied buffer.
+             * @details Each child block writes itself at its fixed offset; no intermediate buffers are used.
+             * @param out A pointer to at least 96 writable bytes. Exactly 96 bytes are written.
+             */
+            void serialize_into(uint8_t* out) const noexcept {
+                const metrics::scoped_timer timer(metrics::operation::csa_serialize);
+                general_.serialize_into(out + GENERAL_OFFSET);
+                validation_.serialize_into(out + VALIDATION_OFFSET);
+                history_.serialize_into(out + HISTORY_OFFSET);
+                std::copy(rfu_.begin(), rfu_.end(), out + RFU_OFFSET);
+            }
+
+            /**
+             * @brief Writes back only the bytes that changed since the buffer was parsed.
+             * @details The container is serialized onto the stack and compared region by region (general,
+             *          validation, each of the 4 log slots, RFU) against `buffer`. Only the differing span of
+             *          each region is copied, and the touched ranges are reported so the reader driver can
+             *          limit the RF write to the affected card blocks.
+             * @param buffer The 96-byte buffer this container was parsed from. It is updated in place.
+             * @return The byte ranges that were modified, in ascending offset order.
+             */
+            dirty_ranges patch_into(uint8_t* buffer) const noexcept {
+                const std::array<uint8_t, TOTAL_SIZE> fresh = to_array();
+                dirty_ranges dirty;
+                for (const byte_range& region : PATCH_REGIONS)
+                    detail::patch_region(fresh.data(), buffer, region, dirty);
+                return dirty;
+            }
+
             [[nodiscard]] general& get_general() noexcept { return general_; }
             [[nodiscard]] const general& get_general() const noexcept { return general_; }
             [[nodiscard]] validation& get_validation() noexcept { return validation_; }
@@ -1502,23 +2396,46 @@ namespace open_loop {
              */
             [[nodiscard]] std::time_t get_card_effective_date() const {
                 if (!card_effective_date_.has_value()) {
-                    throw std::logic_error("Card effective date has not been set.");
+                    throw metrics::counted(std::logic_error("Card effective date has not been set."));
                 }
                 return *card_effective_date_;
             }
 
-            friend std::ostream& operator<<(std::ostream& os, const container& obj) {
-                os << "======================= COMMON SERVICE AREA (CSA) =======================" << std::endl;
-                os << obj.general_ << std::endl;
-                os << obj.validation_ << std::endl;
-                os << obj.history_ << std::endl;
-                os << "-------------------------- RFU (7 Bytes) --------------------------" << std::endl << "  ";
-                for (const auto& byte : obj.rfu_) {
-                    os << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte) << " ";
-                }
-                os << std::dec << std::endl;
-                os << "=======================================================================";
-                return os;
+            /**
+             * @brief Gets the precomputed effective date shared with the child blocks.
+             * @return The epoch, which is unset until `set_card_effective_date()` has been called.
+             */
+            [[nodiscard]] const effective_epoch& get_card_epoch() const noexcept { return card_effective_date_; }
+
+            friend std::ostream& operator<<(std::ostream& os, const container& obj);
+
+            /**
+             * @brief Compares the canonical serialized form of two containers.
+             * @details Serializes both containers into stack buffers and compares the 96 bytes directly,
+             *          together with the effective date. This is cheaper than `operator==`, which walks every
+             *          sub-object. It is the right check for "card unchanged, skip write" and for deduplicating taps.
+             */
+            [[nodiscard]] bool equals_canonical(const container& other) const noexcept {
+                return card_effective_date_ == other.card_effective_date_ && to_array() == other.to_array();
+            }
+
+            /**
+             * @brief Returns true if this container serializes to exactly the 96 bytes at `data`.
+             * @param data What to send: a pointer to at least 96 readable bytes, e.g. the card read before a tap.
+             */
+            [[nodiscard]] bool equals_bytes(const uint8_t* data) const noexcept {
+                const auto bytes = to_array();
+                return std::equal(bytes.begin(), bytes.end(), data);
+            }
+
+            /**
+             * @brief Computes a fast, non-cryptographic 64-bit hash of the canonical bytes and the effective date.
+             * @details Containers that are `equals_canonical()` hash equally, and the value matches
+             *          `compact_card::from_container(*this).hash()`. Also used by `std::hash`.
+             */
+            [[nodiscard]] uint64_t hash() const noexcept {
+                const auto bytes = to_array();
+                return detail::hash_card(bytes.data(), bytes.size(), static_cast<int64_t>(*card_effective_date_));
             }
 
             friend bool operator==(const container& lhs, const container& rhs) {
@@ -1534,166 +2451,394 @@ namespace open_loop {
             validation validation_{};
             history history_{};
             std::array<uint8_t, RFU_SIZE> rfu_{};
-            // The effective date is now optional, as it's not set at construction.
-            std::optional<std::time_t> card_effective_date_;
+            // The effective date is not set at construction; the epoch starts out unset.
+            effective_epoch card_effective_date_;
         };
 
-    }
-
-    /**
-     * @namespace osa
-     * @brief Placeholder for components related to the Operator Service Area (OSA).
-     * @details The Operator Service Area is a separate, proprietary data block on a transit card
-     *          reserved for use by a specific transit operator. Its structure is vendor-defined
-     *          and is not implemented in this library. This namespace is reserved for future
-     *          extensions where a specific operator's OSA layout might be implemented.
-     */
-    namespace osa {
         /**
-         * @class general
-         * @brief Represents the 7-byte General Data block of the Operator Service Area (OSA).
+         * @class view
+         * @brief A non-owning, zero-copy window onto a raw 96-byte CSA that decodes fields on access.
          *
-         * @details This class provides a structured interface for the OSA's general information. It has been
-         *          refactored to use the same major.minor.patch versioning system as the `csa::general` class.
-         *          The 10-digit phone number is stored efficiently in a 5-byte Binary-Coded Decimal (BCD) format.
+         * @details Most tap decisions only need a handful of fields (the validation status and time, or the
+         *          latest log's balance). A `view` wraps the raw buffer—typically the NFC reader's receive
+         *          buffer—and decodes each requested field directly from its fixed offset, so nothing is parsed
+         *          or copied up front. When the card needs to be modified, `to_container()` performs the full
+         *          parse into a mutable `csa::container`.
          *
-         *          The 7-byte data is structured as follows:
-         *          - **Byte 0**: [Major (3 bits)][Minor (3 bits)][Patch (2 bits)]
-         *          - **Bytes 1-5**: Phone Number (10 digits stored in 5 bytes as packed BCD)
-         *          - **Byte 6**: [Language (5 bits)][Service Status (1 bit)][RFU (2 bits)]
+         * @warning The view does not own the buffer. The caller must keep the 96 bytes alive and unchanged
+         *          for as long as the view is in use.
          *
          * @usage
          * @code
-         *     osa::general osa_gen;
-         *     osa_gen.set_version(1, 2, 3);
-         *     osa_gen.set_phone_number("9876543210"); // Must be 10 digits
-         *     osa_gen.set_language(language_code::English);
-         *     osa_gen.set_service_status(osa::general::service_status::active);
-         *
-         *     std::vector<uint8_t> bytes = osa_gen.to_bytes();
-         *     osa::general parsed_gen = osa::general::parse(bytes);
-         *
-         *     std::cout << parsed_gen << std::endl;
+         *     csa::view card(rx_buffer, 96, effective_date);
+         *     if (card.get_validation_txn_status() == txn_status::ENTRY && card.get_latest_card_balance() >= fare) {
+         *         csa::container full = card.to_container(); // Only parse fully when a write is needed.
+         *     }
          * @endcode
          */
-        class general {
+        class view {
         public:
 
-            //! Defines the service status as either active or inactive.
-            enum class service_status : bool {
-                inactive = false,
-                active = true
-            };
-
-            //! The fixed size of this data block in bytes.
-            static constexpr size_t DATA_SIZE = 7;
-            //! The fixed size of the BCD-encoded phone number in bytes.
-            static constexpr size_t PHONE_NUMBER_BYTES = 5;
-            //! The required number of digits for a valid phone number string.
-            static constexpr size_t PHONE_NUMBER_DIGITS = 10;
+            //! Absolute offsets of the individual validation fields within the 96-byte CSA.
+            static constexpr size_t VALIDATION_TERMINAL_OFFSET = container::VALIDATION_OFFSET + 2;
+            static constexpr size_t VALIDATION_TIME_OFFSET = container::VALIDATION_OFFSET + 8;
+            static constexpr size_t VALIDATION_FARE_OFFSET = container::VALIDATION_OFFSET + 11;
+            static constexpr size_t VALIDATION_ROUTE_OFFSET = container::VALIDATION_OFFSET + 13;
+            static constexpr size_t VALIDATION_STATUS_OFFSET = container::VALIDATION_OFFSET + 18;
 
-            // --- Versioning Constants (mirrors csa::general) ---
-            //! The maximum value for the major version (stored in 3 bits: 2^3 - 1).
-            static constexpr uint8_t MAJOR_VERSION_MAX = 7;
-            //! The maximum value for the minor version (stored in 3 bits: 2^3 - 1).
-            static constexpr uint8_t MINOR_VERSION_MAX = 7;
-            //! The maximum value for the patch version (stored in 2 bits: 2^2 - 1).
-            static constexpr uint8_t PATCH_VERSION_MAX = 3;
-            //! The maximum value for the RFU field (stored in 2 bits: 2^2 - 1).
-            static constexpr uint8_t RFU_MAX = 3;
+            //! Offsets of the individual log fields relative to the start of a 17-byte log slot.
+            static constexpr size_t LOG_TIME_POS = 6;
+            static constexpr size_t LOG_AMOUNT_POS = 9;
+            static constexpr size_t LOG_SQ_NO_POS = 11;
+            static constexpr size_t LOG_BALANCE_POS = 13;
+            static constexpr size_t LOG_STATUS_POS = 16;
 
             /**
-             * @brief Default constructor. Creates a `general` object with all fields initialized to their defaults.
+             * @brief Creates a view over a raw CSA buffer.
+             * @param data A pointer to the first byte of the CSA. The buffer is not copied.
+             * @param size The number of bytes available at `data`. What to send: Exactly 96.
+             * @param card_effective_date_in_minutes The card's effective date in minutes since the Unix epoch.
+             * @throws std::invalid_argument if `size` is not exactly 96 bytes.
              */
-            general() = default;
+            view(const uint8_t* data, const size_t size, const std::time_t card_effective_date_in_minutes)
+                : data_(data), card_effective_date_in_minutes_(card_effective_date_in_minutes) {
+                if (size != container::TOTAL_SIZE)
+                    throw metrics::counted(std::invalid_argument("Input CSA data must be exactly 96 bytes."));
+            }
+
+            // --- Validation Fields ---
+
+            [[nodiscard]] uint8_t get_validation_error_code() const noexcept { return data_[container::VALIDATION_OFFSET]; }
+            [[nodiscard]] uint8_t get_validation_product_type() const noexcept { return data_[container::VALIDATION_OFFSET + 1]; }
+            [[nodiscard]] uint16_t get_validation_fare_amount() const noexcept { return detail::read_u16_be(data_ + VALIDATION_FARE_OFFSET); }
+            [[nodiscard]] uint16_t get_validation_route_number() const noexcept { return detail::read_u16_be(data_ + VALIDATION_ROUTE_OFFSET); }
+            [[nodiscard]] txn_status get_validation_txn_status() const noexcept { return static_cast<txn_status>(data_[VALIDATION_STATUS_OFFSET] >> 4); }
+            [[nodiscard]] uint32_t get_validation_date_and_time_offset() const noexcept { return detail::read_u24_be(data_ + VALIDATION_TIME_OFFSET); }
 
             /**
-             * @brief Sets the version of the data format.
-             * @param major The major version. What to send: A value in the range [0, 7].
-             * @param minor The minor version. What to send: A value in the range [0, 7].
-             * @param patch The patch version. What to send: A value in the range [0, 3].
-             * @throws std::out_of_range if any version component is outside its valid bit-field range.
+             * @brief Decodes the absolute time of the last validation.
+             * @return The validation time in milliseconds since the Unix epoch.
              */
-            void set_version(const uint8_t major, const uint8_t minor, const uint8_t patch) {
-                if (major > MAJOR_VERSION_MAX) throw std::out_of_range("Major version must be in the range [0, 7].");
-                if (minor > MINOR_VERSION_MAX) throw std::out_of_range("Minor version must be in the range [0, 7].");
-                if (patch > PATCH_VERSION_MAX) throw std::out_of_range("Patch version must be in the range [0, 3].");
-                major_version_ = major;
-                minor_version_ = minor;
-                patch_version_ = patch;
+            [[nodiscard]] uint64_t get_validation_date_and_time() const noexcept {
+                return to_milliseconds(get_validation_date_and_time_offset());
             }
 
             /**
-             * @brief Sets the customer phone number from a 10-digit string using BCD encoding.
-             * @details Binary-Coded Decimal (BCD) stores each decimal digit in a 4-bit "nibble". This method
-             *          packs two digits into every byte of the `phone_number_` array.
-             * @param number_str The phone number as a string of digits.
-             *                   What to send: A string containing **exactly 10 digits** ('0'-'9').
-             * @throws std::invalid_argument if the number string is not 10 characters or contains non-digits.
+             * @brief Decodes the terminal that performed the last validation.
+             * @return A `terminal` object decoded from the 6 terminal bytes.
              */
-            void set_phone_number(const std::string& number_str) {
-                // Validate the input string format before processing.
-                if (number_str.length() != PHONE_NUMBER_DIGITS)
-                    throw std::invalid_argument("Phone number must be exactly 10 digits.");
-                if (number_str.find_first_not_of("0123456789") != std::string::npos)
-                    throw std::invalid_argument("Phone number must contain only digits.");
-
-                // Iterate 5 times, processing two digits for each byte.
-                for (size_t i = 0; i < PHONE_NUMBER_BYTES; ++i) {
-                    // Convert the ASCII character of the first digit (e.g., '9') to its integer value (9).
-                    const uint8_t high_nibble = number_str[i * 2] - '0';
-                    // Convert the second digit.
-                    const uint8_t low_nibble = number_str[i * 2 + 1] - '0';
-                    // Pack the two 4-bit values into a single byte.
-                    // e.g., for "98": high_nibble=9 (0b1001), low_nibble=8 (0b1000)
-                    // (9 << 4) | 8  ->  0b10010000 | 0b00001000  ->  0b10011000 (0x98)
-                    phone_number_[i] = (high_nibble << 4) | low_nibble;
-                }
+            [[nodiscard]] terminal get_validation_terminal() const {
+                return terminal::try_parse(data_ + VALIDATION_TERMINAL_OFFSET, terminal::DATA_SIZE).value();
             }
 
-            void set_language(const language_code code) noexcept { language_ = code; }
-            void set_service_status(const service_status status) noexcept { status_ = status; }
+            //! Reads only the operator ID of the validation terminal, without decoding the whole terminal.
+            [[nodiscard]] uint16_t get_validation_operator_id() const noexcept { return detail::read_u16_be(data_ + VALIDATION_TERMINAL_OFFSET + 1); }
+
+            // --- History Fields ---
 
             /**
-             * @brief Sets the value for the Reserved for Future Use (RFU) field.
-             * @param value The RFU value. What to send: A value in the range [0, 3].
-             * @throws std::out_of_range if the value is outside the valid 2-bit range.
+             * @brief Counts the populated log slots using the same rule as `history::parse`.
+             * @return The number of leading log slots that are not entirely zero (0 to 4).
              */
-            void set_rfu(const uint8_t value) {
-                if (value > RFU_MAX) throw std::out_of_range("RFU value must be in the range [0, 3].");
-                rfu_ = value;
+            [[nodiscard]] size_t get_log_count() const noexcept {
+                size_t count = 0;
+                while (count < history::LOG_COUNT && !detail::is_zero_filled(log_slot(count), history::LOG_SIZE_BYTES))
+                    ++count;
+                return count;
             }
 
             /**
-             * @brief Parses a 7-byte data vector into a `general` object.
-             * @param data A const reference to a `std::vector` containing exactly 7 bytes.
-             * @return A `general` object populated with the parsed data.
-             * @throws std::invalid_argument if the data vector is not exactly 7 bytes.
+             * @brief Decodes the 20-bit card balance recorded in a log slot.
+             * @param index The log slot, where 0 is the most recent entry. What to send: A value in [0, 3].
+             * @throws std::out_of_range if `index` is not a valid slot.
              */
-            static general parse(const std::vector<uint8_t>& data) {
-                if (data.size() != DATA_SIZE) throw std::invalid_argument("OSA General data must be exactly 7 bytes.");
+            [[nodiscard]] uint32_t get_log_card_balance(const size_t index) const {
+                const uint8_t* slot = checked_log_slot(index);
+                return (static_cast<uint32_t>(slot[LOG_BALANCE_POS]) << 12) |
+                       (static_cast<uint32_t>(slot[LOG_BALANCE_POS + 1]) << 4) |
+                       (slot[LOG_BALANCE_POS + 2] >> 4);
+            }
 
-                general g;
+            [[nodiscard]] uint16_t get_log_txn_amount(const size_t index) const { return detail::read_u16_be(checked_log_slot(index) + LOG_AMOUNT_POS); }
+            [[nodiscard]] uint16_t get_log_txn_sq_no(const size_t index) const { return detail::read_u16_be(checked_log_slot(index) + LOG_SQ_NO_POS); }
+            [[nodiscard]] txn_status get_log_txn_status(const size_t index) const { return static_cast<txn_status>(checked_log_slot(index)[LOG_STATUS_POS] >> 4); }
 
-                // Byte 0: Version (Major/Minor/Patch).
-                // Unpack the three version components from the first byte using bit shifts and masks.
-                g.major_version_ = (data[0] >> 5) & 0x07;
-                g.minor_version_ = (data[0] >> 2) & 0x07;
-                g.patch_version_ = data[0] & 0x03;
-
-                // Bytes 1-5: Phone Number (BCD).
-                // Directly copy the 5 bytes of BCD data into the internal array.
-                std::copy(data.begin() + 1, data.begin() + 1 + PHONE_NUMBER_BYTES, g.phone_number_.begin());
-
-                // Byte 6: Packed Language, Status, and RFU.
-                const uint8_t last_byte = data[6];
-                // Extract the 5-bit language code.
-                g.language_ = static_cast<open_loop::language_code>((last_byte >> 3) & 0x1F);
-                // Extract the 1-bit service status.
-                g.status_ = static_cast<service_status>((last_byte >> 2) & 0x01);
-                // Extract the 2-bit RFU value.
-                g.rfu_ = last_byte & 0x03;
+            /**
+             * @brief Decodes the absolute time of a log entry.
+             * @param index The log slot, where 0 is the most recent entry. What to send: A value in [0, 3].
+             * @return The transaction time in milliseconds since the Unix epoch.
+             * @throws std::out_of_range if `index` is not a valid slot.
+             */
+            [[nodiscard]] uint64_t get_log_date_and_time(const size_t index) const {
+                return to_milliseconds(detail::read_u24_be(checked_log_slot(index) + LOG_TIME_POS));
+            }
+
+            /**
+             * @brief Convenience accessor for the card balance recorded by the most recent log.
+             * @return The balance from log slot 0, or 0 if the history is empty.
+             */
+            [[nodiscard]] uint32_t get_latest_card_balance() const noexcept {
+                if (detail::is_zero_filled(log_slot(0), history::LOG_SIZE_BYTES)) return 0;
+                const uint8_t* slot = log_slot(0);
+                return (static_cast<uint32_t>(slot[LOG_BALANCE_POS]) << 12) |
+                       (static_cast<uint32_t>(slot[LOG_BALANCE_POS + 1]) << 4) |
+                       (slot[LOG_BALANCE_POS + 2] >> 4);
+            }
+
+            // --- Escape Hatch ---
+
+            /**
+             * @brief Fully parses the viewed bytes into a mutable `csa::container`.
+             * @return A container with its effective date set and all blocks decoded.
+             */
+            [[nodiscard]] container to_container() const {
+                container c;
+                c.set_card_effective_date(*card_effective_date_in_minutes_);
+                c.parse(data_, container::TOTAL_SIZE);
+                return c;
+            }
+
+            [[nodiscard]] const uint8_t* data() const noexcept { return data_; }
+            [[nodiscard]] std::time_t get_card_effective_date() const noexcept { return *card_effective_date_in_minutes_; }
+
+        private:
+
+            [[nodiscard]] const uint8_t* log_slot(const size_t index) const noexcept {
+                return data_ + container::HISTORY_OFFSET + (index * history::LOG_SIZE_BYTES);
+            }
+
+            [[nodiscard]] const uint8_t* checked_log_slot(const size_t index) const {
+                if (index >= history::LOG_COUNT) throw metrics::counted(std::out_of_range("Log index is out of bounds."));
+                return log_slot(index);
+            }
+
+            [[nodiscard]] uint64_t to_milliseconds(const uint32_t offset_in_minutes) const noexcept {
+                return card_effective_date_in_minutes_.to_milliseconds(offset_in_minutes);
+            }
+
+            //! The viewed buffer. Not owned.
+            const uint8_t* data_;
+            //! The base date for time calculations, in minutes since epoch.
+            effective_epoch card_effective_date_in_minutes_;
+        };
+
+        /**
+         * @struct compact_card
+         * @brief A trivially copyable, fixed-size snapshot of one CSA: the raw 96-byte image plus its effective date.
+         *
+         * @details `container` keeps each decoded block alongside its own copy of the effective date, which makes
+         *          it several times larger than the card it models. `compact_card` stores the on-card bytes
+         *          verbatim and the effective date exactly once, with no padding (104 bytes). It can be
+         *          `memcpy`-ed, kept in large arrays (deny lists, risk scoring caches) and placed in memory shared
+         *          between processes. Fields are read through `get_view()` without decoding the whole card, and
+         *          `to_container()` / `store()` convert to and from the mutable representation.
+         *
+         * @usage
+         * @code
+         *     std::vector<csa::compact_card> hot_cards;
+         *     hot_cards.push_back(csa::compact_card::from_container(card));
+         *     const csa::view fields = hot_cards.back().get_view();
+         * @endcode
+         */
+        struct compact_card {
+            //! The size of the stored card image in bytes.
+            static constexpr size_t IMAGE_SIZE = container::TOTAL_SIZE;
+
+            //! The on-card bytes, exactly as `container::serialize_into()` writes them.
+            std::array<uint8_t, IMAGE_SIZE> image;
+            //! The card effective date in minutes since the Unix epoch. A fixed-width integer so the
+            //! representation is identical across processes that share it.
+            int64_t card_effective_date_in_minutes;
+
+            /**
+             * @brief Captures a container.
+             * @param card The container to snapshot. What to send: a container whose effective date is set.
+             * @throws std::logic_error if the container's effective date has not been set.
+             */
+            [[nodiscard]] static compact_card from_container(const container& card) {
+                compact_card compact{};
+                compact.store(card);
+                return compact;
+            }
+
+            /**
+             * @brief Overwrites this snapshot with `card`, in place.
+             * @throws std::logic_error if the container's effective date has not been set.
+             */
+            void store(const container& card) {
+                card_effective_date_in_minutes = static_cast<int64_t>(card.get_card_effective_date());
+                card.serialize_into(image.data());
+            }
+
+            //! Fully decodes the snapshot into a mutable container.
+            [[nodiscard]] container to_container() const { return get_view().to_container(); }
+
+            //! Returns a zero-copy view of the stored image. The view is valid while this object is alive and unchanged.
+            [[nodiscard]] view get_view() const {
+                return { image.data(), IMAGE_SIZE, static_cast<std::time_t>(card_effective_date_in_minutes) };
+            }
+
+            //! The same hash as `container::hash()` for the container this snapshot was taken from.
+            [[nodiscard]] uint64_t hash() const noexcept {
+                return detail::hash_card(image.data(), IMAGE_SIZE, card_effective_date_in_minutes);
+            }
+
+            friend bool operator==(const compact_card& lhs, const compact_card& rhs) noexcept {
+                return lhs.card_effective_date_in_minutes == rhs.card_effective_date_in_minutes && lhs.image == rhs.image;
+            }
+            friend bool operator!=(const compact_card& lhs, const compact_card& rhs) noexcept { return !(lhs == rhs); }
+        };
+
+        static_assert(std::is_trivially_copyable_v<compact_card> && std::is_standard_layout_v<compact_card>,
+                      "compact_card must stay safe to memcpy and to place in shared memory.");
+        static_assert(sizeof(compact_card) == compact_card::IMAGE_SIZE + sizeof(int64_t), "compact_card must not contain padding.");
+
+    }
+
+    /**
+     * @namespace osa
+     * @brief Placeholder for components related to the Operator Service Area (OSA).
+     * @details The Operator Service Area is a separate, proprietary data block on a transit card
+     *          reserved for use by a specific transit operator. Its structure is vendor-defined
+     *          and is not implemented in this library. This namespace is reserved for future
+     *          extensions where a specific operator's OSA layout might be implemented.
+     */
+    namespace osa {
+        /**
+         * @class general
+         * @brief Represents the 7-byte General Data block of the Operator Service Area (OSA).
+         *
+         * @details This class provides a structured interface for the OSA's general information. It has been
+         *          refactored to use the same major.minor.patch versioning system as the `csa::general` class.
+         *          The 10-digit phone number is stored efficiently in a 5-byte Binary-Coded Decimal (BCD) format.
+         *
+         *          The 7-byte data is structured as follows:
+         *          - **Byte 0**: [Major (3 bits)][Minor (3 bits)][Patch (2 bits)]
+         *          - **Bytes 1-5**: Phone Number (10 digits stored in 5 bytes as packed BCD)
+         *          - **Byte 6**: [Language (5 bits)][Service Status (1 bit)][RFU (2 bits)]
+         *
+         * @usage
+         * @code
+         *     osa::general osa_gen;
+         *     osa_gen.set_version(1, 2, 3);
+         *     osa_gen.set_phone_number("9876543210"); // Must be 10 digits
+         *     osa_gen.set_language(language_code::English);
+         *     osa_gen.set_service_status(osa::general::service_status::active);
+         *
+         *     std::vector<uint8_t> bytes = osa_gen.to_bytes();
+         *     osa::general parsed_gen = osa::general::parse(bytes);
+         *
+         *     std::cout << parsed_gen << std::endl;
+         * @endcode
+         */
+        class general {
+        public:
+
+            //! Defines the service status as either active or inactive.
+            enum class service_status : bool {
+                inactive = false,
+                active = true
+            };
 
+            //! The fixed size of this data block in bytes.
+            static constexpr size_t DATA_SIZE = 7;
+            //! The fixed size of the BCD-encoded phone number in bytes.
+            static constexpr size_t PHONE_NUMBER_BYTES = 5;
+            //! The required number of digits for a valid phone number string.
+            static constexpr size_t PHONE_NUMBER_DIGITS = 10;
+
+            // --- Versioning Constants (mirrors csa::general) ---
+            //! The maximum value for the major version (stored in 3 bits: 2^3 - 1).
+            static constexpr uint8_t MAJOR_VERSION_MAX = 7;
+            //! The maximum value for the minor version (stored in 3 bits: 2^3 - 1).
+            static constexpr uint8_t MINOR_VERSION_MAX = 7;
+            //! The maximum value for the patch version (stored in 2 bits: 2^2 - 1).
+            static constexpr uint8_t PATCH_VERSION_MAX = 3;
+            //! The maximum value for the RFU field (stored in 2 bits: 2^2 - 1).
+            static constexpr uint8_t RFU_MAX = 3;
+
+            /**
+             * @brief Default constructor. Creates a `general` object with all fields initialized to their defaults.
+             */
+            general() = default;
+
+            /**
+             * @brief Sets the version of the data format.
+             * @param major The major version. What to send: A value in the range [0, 7].
+             * @param minor The minor version. What to send: A value in the range [0, 7].
+             * @param patch The patch version. What to send: A value in the range [0, 3].
+             * @throws std::out_of_range if any version component is outside its valid bit-field range.
+             */
+            void set_version(const uint8_t major, const uint8_t minor, const uint8_t patch);
+
+            /**
+             * @brief Sets the customer phone number from a 10-digit string using BCD encoding.
+             * @details Binary-Coded Decimal (BCD) stores each decimal digit in a 4-bit "nibble". This method
+             *          packs two digits into every byte of the `phone_number_` array.
+             * @param number_str The phone number as a string of digits.
+             *                   What to send: A string containing **exactly 10 digits** ('0'-'9').
+             * @throws std::invalid_argument if the number string is not 10 characters or contains non-digits.
+             */
+            void set_phone_number(const std::string_view number_str) {
+                if (const status_code code = try_set_phone_number(number_str); code != status_code::ok)
+                    detail::throw_status(code);
+            }
+
+            /**
+             * @brief Non-throwing variant of `set_phone_number()`.
+             * @param number_str The phone number as a string of exactly 10 digits.
+             * @return `status_code::ok`, `invalid_phone_number_length`, or `invalid_phone_number_digit`.
+             *         The stored number is unchanged on failure.
+             */
+            [[nodiscard]] status_code try_set_phone_number(const std::string_view number_str) noexcept {
+                // Validate the input string format before processing.
+                if (number_str.length() != PHONE_NUMBER_DIGITS)
+                    return status_code::invalid_phone_number_length;
+                // Pack two digits into each byte, e.g. "98" -> (9 << 4) | 8 -> 0x98.
+                if (!codec::bcd_encode(number_str.data(), PHONE_NUMBER_DIGITS, phone_number_.data()))
+                    return status_code::invalid_phone_number_digit;
+                return status_code::ok;
+            }
+
+            void set_language(const language_code code) noexcept { language_ = code; }
+            void set_service_status(const service_status status) noexcept { status_ = status; }
+
+            /**
+             * @brief Sets the value for the Reserved for Future Use (RFU) field.
+             * @param value The RFU value. What to send: A value in the range [0, 3].
+             * @throws std::out_of_range if the value is outside the valid 2-bit range.
+             */
+            void set_rfu(const uint8_t value);
+
+            /**
+             * @brief Parses a 7-byte data vector into a `general` object.
+             * @param data A const reference to a `std::vector` containing exactly 7 bytes.
+             * @return A `general` object populated with the parsed data.
+             * @throws std::invalid_argument if the data vector is not exactly 7 bytes.
+             */
+            static general parse(const std::vector<uint8_t>& data);
+
+            /**
+             * @brief Parses 7 bytes read directly from a raw buffer into a `general` object.
+             * @param data A pointer to the first byte of the general data block.
+             * @param size The number of bytes available at `data`. What to send: Exactly 7.
+             * @return A `general` object populated with the parsed data.
+             * @throws std::invalid_argument if `size` is not exactly 7 bytes.
+             */
+            static general parse(const uint8_t* data, const size_t size);
+
+            /**
+             * @brief Non-throwing variant of `parse()` that decodes 7 bytes read directly from a raw buffer.
+             * @param data A pointer to the first byte of the general data block.
+             * @param size The number of bytes available at `data`. What to send: Exactly 7.
+             * @return A `result` holding the parsed `general`, or `status_code::invalid_size` on a size mismatch.
+             */
+            [[nodiscard]] static result<general> try_parse(const uint8_t* data, const size_t size) noexcept {
+                if (size != DATA_SIZE) return status_code::invalid_size;
+
+                general g;
+                // Every field is decoded from the descriptor table in `layout`.
+                layout::decode(data, g);
                 return g;
             }
 
@@ -1701,28 +2846,15 @@ namespace open_loop {
              * @brief Serializes the `general` object into a 7-byte vector.
              * @return A `std::vector<uint8_t>` containing the serialized data.
              */
-            [[nodiscard]] std::vector<uint8_t> to_bytes() const {
-                std::vector<uint8_t> data;
-                data.reserve(DATA_SIZE);
-
-                // Byte 0: Version.
-                // Pack the three version components into a single byte.
-                data.push_back(
-                    (major_version_ << 5) | (minor_version_ << 2) | patch_version_
-                );
-
-                // Bytes 1-5: Phone Number.
-                // Insert the 5 bytes of raw BCD data.
-                data.insert(data.end(), phone_number_.begin(), phone_number_.end());
-
-                // Byte 6: Packed Language, Status, and RFU.
-                // Combine the three fields into the last byte using bitwise shifts and ORs.
-                const uint8_t last_byte = (static_cast<uint8_t>(language_) << 3) |
-                                          (static_cast<uint8_t>(status_) << 2) |
-                                          rfu_;
-                data.push_back(last_byte);
+            [[nodiscard]] std::vector<uint8_t> to_bytes() const;
 
-                return data;
+            /**
+             * @brief Serializes the `general` object directly into a caller-supplied buffer.
+             * @param out A pointer to at least 7 writable bytes. Exactly 7 bytes are written.
+             */
+            void serialize_into(uint8_t* out) const noexcept {
+                // Every field is encoded from the descriptor table in `layout`.
+                layout::encode(*this, out);
             }
 
             [[nodiscard]] uint8_t get_major_version() const noexcept { return major_version_; }
@@ -1737,73 +2869,45 @@ namespace open_loop {
              * @brief Retrieves the full version number as a formatted string.
              * @return The version string in "major.minor.patch" format (e.g., "1.2.3").
              */
-            [[nodiscard]] std::string get_version_string() const {
-                return std::to_string(major_version_) + "." + std::to_string(minor_version_) + "." + std::to_string(patch_version_);
-            }
+            [[nodiscard]] std::string get_version_string() const;
 
             /**
              * @brief Retrieves the customer phone number as a 10-digit string by decoding BCD.
              * @return A `std::string` containing the phone number, or an empty string if the number is all zeros.
              */
-            [[nodiscard]] std::string get_phone_number() const {
-                std::stringstream ss;
-                // Unpack each byte into two digit characters.
-                for (const auto& byte : phone_number_) {
-                    // Get the high nibble (first digit) by shifting right.
-                    ss << static_cast<char>('0' + ((byte >> 4) & 0x0F));
-                    // Get the low nibble (second digit) by masking.
-                    ss << static_cast<char>('0' + (byte & 0x0F));
-                }
-                std::string result = ss.str();
+            [[nodiscard]] std::string get_phone_number() const { return get_phone_number_chars().str(); }
+
+            /**
+             * @brief Allocation-free variant of `get_phone_number()`.
+             * @return The 10 decoded digits stored inline, or an empty `fixed_string` if the number is all zeros.
+             */
+            [[nodiscard]] fixed_string<PHONE_NUMBER_DIGITS> get_phone_number_chars() const noexcept {
                 // Treat an uninitialized (all-zeros) phone number as an empty string for convenience.
-                if (result == "0000000000")
-                    return "";
-                return result;
+                if (detail::is_zero_filled(phone_number_.data(), PHONE_NUMBER_BYTES))
+                    return {};
+                char digits[PHONE_NUMBER_DIGITS]{};
+                codec::bcd_decode(phone_number_.data(), PHONE_NUMBER_BYTES, digits);
+                return { digits, PHONE_NUMBER_DIGITS };
             }
 
-            [[nodiscard]] std::string get_service_status_string() const {
-                return (status_ == service_status::active) ? "Active" : "Inactive";
-            }
+            [[nodiscard]] std::string get_service_status_string() const;
 
             /**
              * @brief Retrieves the language as a human-readable string.
              * @return The name of the language (e.g., "English"). Returns "Unknown" for undefined codes.
              */
-            [[nodiscard]] std::string get_language_string() const {
-                // This helper provides a more user-friendly output than just the raw enum value.
-                switch (language_) {
-                    case language_code::English: return "English";
-                    case language_code::Hindi:   return "Hindi";
-                    case language_code::Marathi: return "Marathi";
-                    default: return "Unknown";
-                }
-            }
+            [[nodiscard]] std::string get_language_string() const;
 
             /**
             * @brief Stream insertion operator for easy printing of `osa::general` objects.
             */
-            friend std::ostream& operator<<(std::ostream& os, const general& obj) {
-                os << "-------------------- OSA: GENERAL DATA ---------------------" << std::endl;
-                os << "  VERSION                : " << obj.get_version_string() << std::endl;
-                os << "  PHONE NUMBER           : " << obj.get_phone_number() << std::endl;
-                os << "  LANGUAGE               : " << obj.get_language_string() << " (Code: " << static_cast<int>(obj.get_language()) << ")" << std::endl;
-                os << "  SERVICE STATUS         : " << obj.get_service_status_string() << std::endl;
-                os << "  RFU (BINARY)           : " << std::bitset<2>(obj.get_rfu()) << std::endl;
-                os << "------------------------------------------------------------";
-                return os;
-            }
+            friend std::ostream& operator<<(std::ostream& os, const general& obj);
 
             /**
              * @brief Compares two `osa::general` objects for equality.
              */
             friend bool operator==(const general& lhs, const general& rhs) {
-                return lhs.major_version_ == rhs.major_version_ &&
-                       lhs.minor_version_ == rhs.minor_version_ &&
-                       lhs.patch_version_ == rhs.patch_version_ &&
-                       lhs.phone_number_ == rhs.phone_number_ &&
-                       lhs.language_ == rhs.language_ &&
-                       lhs.status_ == rhs.status_ &&
-                       lhs.rfu_ == rhs.rfu_;
+                return layout::equal(lhs, rhs);
             }
 
         private:
@@ -1823,6 +2927,18 @@ namespace open_loop {
             service_status status_{ service_status::inactive };
             //! Reserved for Future Use field (2 bits).
             uint8_t rfu_{ 0 };
+
+        public:
+
+            //! The on-card layout of this block. `try_parse()`, `serialize_into()` and `operator==` are generated from it.
+            using layout = detail::layout<DATA_SIZE,
+                detail::field<&general::major_version_, 0, 3, 5>,  // Byte 0, bits 7-5
+                detail::field<&general::minor_version_, 0, 3, 2>,  // Byte 0, bits 4-2
+                detail::field<&general::patch_version_, 0, 2>,     // Byte 0, bits 1-0
+                detail::byte_array<&general::phone_number_, 1>,    // Bytes 1-5 (packed BCD)
+                detail::field<&general::language_, 6, 5, 3>,       // Byte 6, bits 7-3
+                detail::field<&general::status_, 6, 1, 2>,         // Byte 6, bit 2
+                detail::field<&general::rfu_, 6, 2>>;              // Byte 6, bits 1-0
         };
 
         /**
@@ -1887,7 +3003,7 @@ namespace open_loop {
              * @param date_in_minutes The card's effective date. What to send: A `std::time_t` value
              *                        representing the number of **minutes** since the Unix epoch.
              */
-            void set_card_effective_date(std::time_t date_in_minutes) noexcept {
+            void set_card_effective_date(const effective_epoch date_in_minutes) noexcept {
                 card_effective_date_in_minutes_ = date_in_minutes;
             }
 
@@ -1898,24 +3014,17 @@ namespace open_loop {
              * @throws std::logic_error if `set_card_effective_date()` has not been called first.
              * @throws std::out_of_range if the calculated time difference is negative or exceeds the 24-bit storage limit.
              */
-            void set_date_and_time(const uint64_t absolute_time_in_milliseconds) {
-                if (!card_effective_date_in_minutes_.has_value())
-                    throw std::logic_error("Card effective date must be set before setting transaction time.");
+            void set_date_and_time(const uint64_t absolute_time_in_milliseconds);
 
-                // Use uint64_t for all intermediate calculations to prevent
-                // signed/unsigned comparison issues and potential overflow.
-                const uint64_t absolute_time_in_minutes = absolute_time_in_milliseconds / 60000;
-                const uint64_t effective_date_minutes = *card_effective_date_in_minutes_;
-
-                if (absolute_time_in_minutes < effective_date_minutes)
-                    throw std::out_of_range("Transaction time cannot be before the card effective date.");
-
-                const uint64_t time_diff = absolute_time_in_minutes - effective_date_minutes;
-
-                if (time_diff > TIME_OFFSET_MAX)
-                    throw std::out_of_range("Transaction time is out of the valid 24-bit range from effective date.");
-
-                date_and_time_offset_ = static_cast<uint32_t>(time_diff);
+            /**
+             * @brief Non-throwing variant of `set_date_and_time()`.
+             * @param absolute_time_in_milliseconds The absolute time of the transaction in milliseconds since the Unix epoch.
+             * @return `status_code::ok`, `effective_date_not_set`, `time_before_effective_date`, or `time_offset_overflow`.
+             *         The stored time is unchanged on failure.
+             */
+            [[nodiscard]] status_code try_set_date_and_time(const uint64_t absolute_time_in_milliseconds) noexcept {
+                // Convert the absolute timestamp into the relative offset in minutes stored on the card.
+                return detail::encode_time_offset(card_effective_date_in_minutes_, absolute_time_in_milliseconds, date_and_time_offset_);
             }
 
             /**
@@ -1926,25 +3035,19 @@ namespace open_loop {
              * @throws std::invalid_argument if `hex_id` is not exactly 6 characters long.
              * @throws std::out_of_range if `hex_id` contains invalid characters or represents a value > 0xFFFFFF.
              */
-            void set_terminal_id(const std::string& hex_id) {
-                // First, perform a quick and inexpensive check on the string length.
-                if (hex_id.size() != TERMINAL_ID_HEX_LENGTH)
-                    throw std::invalid_argument("Terminal ID hex string must be exactly 6 characters.");
-
-                // Use a stringstream for a robust conversion from hex string to an integer.
-                unsigned long long value = 0;
-                std::stringstream ss;
-                ss << std::hex << hex_id; // Tell the stream to interpret the input as hexadecimal.
+            void set_terminal_id(const std::string_view hex_id) {
+                if (const status_code code = try_set_terminal_id(hex_id); code != status_code::ok)
+                    detail::throw_status(code);
+            }
 
-                // Try to extract the value and perform comprehensive validation.
-                // 1. `!(ss >> value)`: Fails if the string contains non-hex characters (e.g., "A1B2G3").
-                // 2. `ss.rdbuf()->in_avail() != 0`: Fails if there are leftover characters after a valid parse,
-                //    which handles cases where the stream stops parsing early.
-                // 3. `value > TERMINAL_ID_MAX`: Fails if the parsed number exceeds the 24-bit limit.
-                if (!(ss >> value) || ss.rdbuf()->in_avail() != 0 || value > TERMINAL_ID_MAX)
-                    throw std::out_of_range("Terminal ID string is invalid or its value is out of the 24-bit range.");
-                // If all checks pass, safely cast and assign the value.
-                terminal_id_ = static_cast<uint32_t>(value);
+            /**
+             * @brief Non-throwing variant of `set_terminal_id()`.
+             * @param hex_id The terminal's unique identifier as a 6-character hex string.
+             * @return `status_code::ok`, `invalid_terminal_id_length`, or `invalid_terminal_id`. The ID is unchanged on failure.
+             */
+            [[nodiscard]] status_code try_set_terminal_id(const std::string_view hex_id) noexcept {
+                // Every 6-digit hex value fits in 24 bits, so only the length and the characters need checking.
+                return detail::decode_terminal_id(hex_id, terminal_id_);
             }
 
             /**
@@ -1952,10 +3055,7 @@ namespace open_loop {
              * @param value The RFU value. What to send: A value in the range [0, 15].
              * @throws std::out_of_range if the value is outside the valid 4-bit range.
              */
-            void set_rfu(const uint8_t value) {
-                if (value > RFU_MAX) throw std::out_of_range("RFU value must be in the range [0, 15].");
-                rfu_ = value;
-            }
+            void set_rfu(const uint8_t value);
 
             void set_error_code(const uint8_t code) noexcept { error_code_ = code; }
             void set_product_type(const uint8_t type) noexcept { product_type_ = type; }
@@ -1971,32 +3071,33 @@ namespace open_loop {
              * @return A `transaction_record` object populated with the parsed data.
              * @throws std::invalid_argument if the data vector is not exactly 13 bytes.
              */
-            static transaction_record parse(const std::vector<uint8_t>& data, std::time_t card_effective_date_in_minutes) {
-                if (data.size() != DATA_SIZE) throw std::invalid_argument("OSA Transaction Record data must be 13 bytes.");
-
-                transaction_record rec;
-                rec.card_effective_date_in_minutes_ = card_effective_date_in_minutes;
-
-                // Bytes 0-1: Single-byte fields.
-                rec.error_code_ = data[0];
-                rec.product_type_ = data[1];
-
-                // Bytes 2-4: Date & Time Offset (24-bit, Big-Endian). Reconstruct from 3 bytes.
-                rec.date_and_time_offset_ = (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 8) | data[4];
+            static transaction_record parse(const std::vector<uint8_t>& data, std::time_t card_effective_date_in_minutes);
 
-                // Bytes 5-6: Station ID (16-bit, Big-Endian). Reconstruct from 2 bytes.
-                rec.station_id_ = (static_cast<uint16_t>(data[5]) << 8) | data[6];
-
-                // Bytes 7-8: Fare (16-bit, Big-Endian). Reconstruct from 2 bytes.
-                rec.fare_ = (static_cast<uint16_t>(data[7]) << 8) | data[8];
-
-                // Bytes 9-11: Terminal ID (24-bit, Big-Endian). Reconstruct from 3 bytes.
-                rec.terminal_id_ = (static_cast<uint32_t>(data[9]) << 16) | (static_cast<uint32_t>(data[10]) << 8) | data[11];
+            /**
+             * @brief Parses 13 bytes read directly from a raw buffer into a `transaction_record` object.
+             * @param data A pointer to the first byte of the record.
+             * @param size The number of bytes available at `data`. What to send: Exactly 13.
+             * @param card_effective_date_in_minutes The card's effective date in minutes since epoch.
+             * @return A `transaction_record` object populated with the parsed data.
+             * @throws std::invalid_argument if `size` is not exactly 13 bytes.
+             */
+            static transaction_record parse(const uint8_t* data, const size_t size, std::time_t card_effective_date_in_minutes);
 
-                // Byte 12: Packed Status (upper 4 bits) and RFU (lower 4 bits).
-                rec.status_ = static_cast<open_loop::txn_status>((data[12] >> 4) & 0x0F);
-                rec.rfu_ = data[12] & 0x0F;
+            /**
+             * @brief Non-throwing variant of `parse()` that decodes 13 bytes read directly from a raw buffer.
+             * @param data A pointer to the first byte of the record.
+             * @param size The number of bytes available at `data`. What to send: Exactly 13.
+             * @param card_effective_date_in_minutes The card's effective date in minutes since epoch.
+             * @return A `result` holding the parsed `transaction_record`, or `status_code::invalid_size` on a size mismatch.
+             */
+            [[nodiscard]] static result<transaction_record> try_parse(const uint8_t* data, const size_t size, const effective_epoch card_effective_date_in_minutes) noexcept {
+                if (size != DATA_SIZE) return status_code::invalid_size;
 
+                transaction_record rec;
+                // Store the provided effective date, as it's necessary to calculate the absolute time later.
+                rec.card_effective_date_in_minutes_ = card_effective_date_in_minutes;
+                // Every field is decoded from the descriptor table in `layout`.
+                layout::decode(data, rec);
                 return rec;
             }
 
@@ -2004,36 +3105,15 @@ namespace open_loop {
              * @brief Serializes the `transaction_record` object into a 13-byte vector.
              * @return A `std::vector<uint8_t>` containing the serialized data.
              */
-            [[nodiscard]] std::vector<uint8_t> to_bytes() const {
-                std::vector<uint8_t> data;
-                data.reserve(DATA_SIZE); // Pre-allocate memory for efficiency.
-
-                // Bytes 0-1.
-                data.push_back(error_code_);
-                data.push_back(product_type_);
-
-                // Bytes 2-4: Deconstruct 24-bit time offset into 3 bytes.
-                data.push_back((date_and_time_offset_ >> 16) & 0xFF);
-                data.push_back((date_and_time_offset_ >> 8) & 0xFF);
-                data.push_back(date_and_time_offset_ & 0xFF);
-
-                // Bytes 5-6: Deconstruct 16-bit station ID into 2 bytes.
-                data.push_back((station_id_ >> 8) & 0xFF);
-                data.push_back(station_id_ & 0xFF);
+            [[nodiscard]] std::vector<uint8_t> to_bytes() const;
 
-                // Bytes 7-8: Deconstruct 16-bit fare into 2 bytes.
-                data.push_back((fare_ >> 8) & 0xFF);
-                data.push_back(fare_ & 0xFF);
-
-                // Bytes 9-11: Deconstruct 24-bit terminal ID into 3 bytes.
-                data.push_back((terminal_id_ >> 16) & 0xFF);
-                data.push_back((terminal_id_ >> 8) & 0xFF);
-                data.push_back(terminal_id_ & 0xFF);
-
-                // Byte 12: Pack 4-bit status and 4-bit RFU into one byte.
-                data.push_back((static_cast<uint8_t>(status_) << 4) | rfu_);
-
-                return data;
+            /**
+             * @brief Serializes the `transaction_record` object directly into a caller-supplied buffer.
+             * @param out A pointer to at least 13 writable bytes. Exactly 13 bytes are written.
+             */
+            void serialize_into(uint8_t* out) const noexcept {
+                // Every field is encoded from the descriptor table in `layout`.
+                layout::encode(*this, out);
             }
 
             /**
@@ -2042,13 +3122,19 @@ namespace open_loop {
              * @throws std::logic_error if the card's effective date was not set.
              */
             [[nodiscard]] uint64_t get_date_and_time() const {
-                if (!card_effective_date_in_minutes_.has_value()) {
-                    throw std::logic_error("Card effective date is not set; cannot calculate absolute time.");
-                }
-                // Reconstruct the absolute time by adding the stored offset back to the base date.
-                const uint64_t total_minutes = static_cast<uint64_t>(*card_effective_date_in_minutes_) + date_and_time_offset_;
-                // Convert the total minutes to milliseconds for the final timestamp.
-                return total_minutes * 60000;
+                if (!card_effective_date_in_minutes_.has_value())
+                    throw metrics::counted(std::logic_error("Card effective date is not set; cannot calculate absolute time."));
+                return get_date_and_time_unchecked();
+            }
+
+            /**
+             * @brief Non-checking variant of `get_date_and_time()` for callers that already hold a set epoch.
+             * @pre The effective date has been set, e.g. by the owning container's `set_card_effective_date()`.
+             * @return The transaction time in milliseconds since the Unix epoch.
+             */
+            [[nodiscard]] uint64_t get_date_and_time_unchecked() const noexcept {
+                // Reconstruct the absolute time by adding the stored offset to the precomputed base date.
+                return card_effective_date_in_minutes_.to_milliseconds(date_and_time_offset_);
             }
 
             [[nodiscard]] uint8_t get_error_code() const noexcept { return error_code_; }
@@ -2058,60 +3144,20 @@ namespace open_loop {
             [[nodiscard]] uint32_t get_terminal_id() const noexcept { return terminal_id_; }
             [[nodiscard]] txn_status get_txn_status() const noexcept { return status_; }
             [[nodiscard]] uint8_t get_rfu() const noexcept { return rfu_; }
-            [[nodiscard]] std::time_t get_card_effective_date() const {
-                if (!card_effective_date_in_minutes_.has_value()) {
-                    throw std::logic_error("Card effective date has not been set for this record.");
-                }
-                return *card_effective_date_in_minutes_;
-            }
+            [[nodiscard]] const effective_epoch& get_card_epoch() const noexcept { return card_effective_date_in_minutes_; }
+            [[nodiscard]] std::time_t get_card_effective_date() const;
 
             /**
              * @brief Retrieves the transaction status as a human-readable string.
              * @return A `std::string` like "ENTRY", "EXIT", etc., or "UNKNOWN" for invalid values.
              */
-            [[nodiscard]] std::string get_txn_status_string() const {
-                switch (status_) {
-                    case txn_status::ENTRY:   return "ENTRY";
-                    case txn_status::EXIT:    return "EXIT";
-                    case txn_status::ONETAP:  return "ONETAP";
-                    case txn_status::PENALTY: return "PENALTY";
-                    default:                             return "UNKNOWN";
-                }
-            }
+            [[nodiscard]] std::string get_txn_status_string() const;
 
-            friend std::ostream& operator<<(std::ostream& os, const transaction_record& obj) {
-                os << "---------------- OSA: TRANSACTION RECORD -----------------" << std::endl;
-                os << "  ERROR CODE             : " << static_cast<int>(obj.error_code_) << std::endl;
-                os << "  PRODUCT TYPE           : " << static_cast<int>(obj.product_type_) << std::endl;
-                try {
-                    // **BUG FIX**: Convert milliseconds from get_date_and_time() to seconds for std::gmtime.
-                    const std::time_t t_sec = obj.get_date_and_time() / 1000;
-                    char time_str[100];
-                    if (std::strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", std::gmtime(&t_sec))) {
-                        os << "  DATE AND TIME          : " << time_str << " (UTC)" << std::endl;
-                    }
-                } catch (const std::logic_error& e) {
-                    os << "  DATE AND TIME          : " << "[Not available: " << e.what() << "]" << std::endl;
-                }
-                os << "  STATION ID             : " << obj.station_id_ << std::endl;
-                os << "  FARE                   : " << obj.fare_ << std::endl;
-                os << "  TERMINAL ID            : 0x" << std::hex << std::uppercase << std::setw(6) << std::setfill('0') << obj.terminal_id_ << std::dec << std::endl;
-                // **IMPROVEMENT**: Use the helper method for a more readable status.
-                os << "  TRANSACTION STATUS     : " << obj.get_txn_status_string() << std::endl;
-                os << "  RFU (BINARY)           : " << std::bitset<4>(obj.rfu_) << std::endl;
-                os << "------------------------------------------------------------";
-                return os;
-            }
+            friend std::ostream& operator<<(std::ostream& os, const transaction_record& obj);
 
             friend bool operator==(const transaction_record& lhs, const transaction_record& rhs) {
-                return lhs.error_code_ == rhs.error_code_ &&
-                       lhs.product_type_ == rhs.product_type_ &&
-                       lhs.date_and_time_offset_ == rhs.date_and_time_offset_ &&
-                       lhs.station_id_ == rhs.station_id_ &&
-                       lhs.fare_ == rhs.fare_ &&
-                       lhs.terminal_id_ == rhs.terminal_id_ &&
-                       lhs.status_ == rhs.status_ &&
-                       lhs.rfu_ == rhs.rfu_ &&
+                // The effective date is not part of the on-card layout, so it is compared separately.
+                return layout::equal(lhs, rhs) &&
                        lhs.card_effective_date_in_minutes_ == rhs.card_effective_date_in_minutes_;
             }
 
@@ -2130,18 +3176,34 @@ namespace open_loop {
             //! A 4-bit field Reserved for Future Use.
             uint8_t rfu_{ 0 };
             //! The base date for time calculations, essential for interpreting the time offset. Not serialized.
-            std::optional<std::time_t> card_effective_date_in_minutes_;
+            effective_epoch card_effective_date_in_minutes_;
+
+        public:
+
+            //! The on-card layout of this block. `try_parse()`, `serialize_into()` and `operator==` are generated from it.
+            using layout = detail::layout<DATA_SIZE,
+                detail::field<&transaction_record::error_code_, 0, 8>,             // Byte 0
+                detail::field<&transaction_record::product_type_, 1, 8>,           // Byte 1
+                detail::field<&transaction_record::date_and_time_offset_, 2, 24>,  // Bytes 2-4 (Big-Endian)
+                detail::field<&transaction_record::station_id_, 5, 16>,            // Bytes 5-6 (Big-Endian)
+                detail::field<&transaction_record::fare_, 7, 16>,                  // Bytes 7-8 (Big-Endian)
+                detail::field<&transaction_record::terminal_id_, 9, 24>,           // Bytes 9-11 (Big-Endian)
+                detail::field<&transaction_record::status_, 12, 4, 4>,             // Byte 12, upper nibble
+                detail::field<&transaction_record::rfu_, 12, 4>>;                  // Byte 12, lower nibble
         };
 
         /**
-         * @class history
-         * @brief Represents the 26-byte transaction history for the OSA.
+         * @class basic_history
+         * @brief Represents the transaction history of the OSA: `LogCount` consecutive 13-byte records.
+         *
+         * @details This class manages the last `LogCount` `transaction_record` objects in a circular buffer
+         *          fashion. When a new record is added, it is placed at the front (index 0), the existing records
+         *          are shifted down by one, and the oldest record is discarded if the history is full.
          *
-         * @details This class manages the last two `transaction_record` objects in a circular buffer
-         *          fashion. When a new record is added, it is placed at the front (index 0), the existing record
-         *          is shifted down to index 1, and the oldest record is discarded if the history is full.
+         *          The standard OSA uses `osa::history`, i.e. two records in 26 bytes. Other operator layouts
+         *          pick their own record count through their layout policy (see `standard_layout`).
          *
-         *          The 26-byte data is structured as two consecutive 13-byte `transaction_record` objects.
+         * @tparam LogCount The number of record slots. What to send: A value > 0.
          *
          * @warning The history object is fundamentally tied to a `card_effective_date`. You **must** call
          *          `set_card_effective_date()` before you can add any logs via `add_record()`.
@@ -2166,60 +3228,57 @@ namespace open_loop {
          *     osa::history parsed_hist = osa::history::parse(bytes, effective_date);
          * @endcode
          */
-        class history {
+        template <size_t LogCount>
+        class basic_history {
         public:
 
+            static_assert(LogCount > 0, "An OSA history must hold at least one record.");
+
             //! The maximum number of log entries that can be stored in the OSA history.
-            static constexpr size_t LOG_COUNT = 2;
+            static constexpr size_t LOG_COUNT = LogCount;
             //! The size of a single serialized `transaction_record` object in bytes.
-            static constexpr size_t LOG_SIZE_BYTES = 13; // Should be `transaction_record::DATA_SIZE`
-            //! The total size of the OSA history data block in bytes.
-            static constexpr size_t TOTAL_SIZE = LOG_COUNT * LOG_SIZE_BYTES; // 2 * 13 = 26 bytes
+            static constexpr size_t LOG_SIZE_BYTES = transaction_record::DATA_SIZE;
+            //! The total size of the OSA history data block in bytes (26 for the standard two records).
+            static constexpr size_t TOTAL_SIZE = LOG_COUNT * LOG_SIZE_BYTES;
 
             /**
              * @brief Default constructor. Creates an empty `history` object with no logs.
              */
-            history() = default;
+            basic_history() = default;
 
             /**
              * @brief Sets the card's effective date, which is required for all subsequent operations.
              * @param date_in_minutes The card's effective date. What to send: A `std::time_t` value representing
              *                        the number of **minutes** since the Unix epoch.
              */
-            void set_card_effective_date(std::time_t date_in_minutes) noexcept {
+            void set_card_effective_date(const effective_epoch date_in_minutes) noexcept {
                 card_effective_date_in_minutes_ = date_in_minutes;
             }
 
             /**
              * @brief Adds a new transaction record to the history using circular buffer logic.
-             * @details This method implements "push-down" functionality. The new record is inserted
-             *          at index 0. The existing record at index 0 is shifted to index 1. If the history was
-             *          already full (2 records), the record at index 1 is discarded.
+             * @details This method implements "push-down" semantics. The new record becomes index 0 and the
+             *          existing records move down by one. If the history was already full, the record in the
+             *          last slot is discarded. Records live in a head-indexed ring, so nothing is shifted.
              * @param new_record The `transaction_record` object to add. What to send: A fully populated
              *                   record whose own effective date matches this history's effective date.
              * @throws std::logic_error if this history's effective date has not been set.
              * @throws std::invalid_argument if the `new_record`'s effective date does not match this history's.
              */
             void add_record(const transaction_record& new_record) {
+                const metrics::scoped_timer timer(metrics::operation::osa_add_record);
 
                 // The history object must have its primary effective date set.
                 if (!card_effective_date_in_minutes_.has_value())
-                    throw std::logic_error("Cannot add a record until the history's effective date is set.");
+                    throw metrics::counted(std::logic_error("Cannot add a record until the history's effective date is set."));
 
                 // Precondition: The incoming record must be consistent with the history's date.
                 if (new_record.get_card_effective_date() != *card_effective_date_in_minutes_)
-                    throw std::invalid_argument("Record's effective date must match history's effective date.");
-
-                // Determine how many elements to shift. For LOG_COUNT=2, this will be min(0, 1)=0 or min(1, 1)=1.
-                const size_t elements_to_shift = std::min(valid_log_count_, LOG_COUNT - 1);
-
-                // Perform the shift. Loop backwards from the end to avoid overwriting data.
-                for (size_t i = elements_to_shift; i > 0; --i) {
-                    logs_[i] = logs_[i - 1]; // Move log[0] to log[1]
-                }
+                    throw metrics::counted(std::invalid_argument("Record's effective date must match history's effective date."));
 
-                // Insert the new record at the front.
-                logs_[0] = new_record;
+                // Step the head back one slot; when full, that slot holds the record push-down discards.
+                head_ = (head_ == 0) ? LOG_COUNT - 1 : head_ - 1;
+                logs_[head_] = new_record;
 
                 // Increment the count of valid logs, capping it at the maximum size.
                 if (valid_log_count_ < LOG_COUNT) {
@@ -2234,27 +3293,53 @@ namespace open_loop {
              */
             void clear() noexcept {
                 valid_log_count_ = 0;
+                head_ = 0;
             }
 
             /**
-             * @brief Parses a 26-byte data vector into a `history` object.
-             * @param data A const reference to a `std::vector` containing exactly 26 bytes.
+             * @brief Parses a `TOTAL_SIZE`-byte data vector (26 bytes for `osa::history`) into a history object.
+             * @param data A const reference to a `std::vector` containing exactly `TOTAL_SIZE` bytes.
              * @param card_effective_date_in_minutes The card's effective date in minutes since epoch.
-             * @return A `history` object populated with up to 2 logs from the data.
-             * @throws std::invalid_argument if the data vector is not exactly 26 bytes.
+             * @return A history object populated with up to `LOG_COUNT` logs from the data.
+             * @throws std::invalid_argument if the data vector is not exactly `TOTAL_SIZE` bytes.
              */
-            static history parse(const std::vector<uint8_t>& data, const std::time_t card_effective_date_in_minutes) {
+            static basic_history parse(const std::vector<uint8_t>& data, const std::time_t card_effective_date_in_minutes) {
+                return parse(data.data(), data.size(), card_effective_date_in_minutes);
+            }
 
-                if (data.size() != TOTAL_SIZE)
-                    throw std::invalid_argument("OSA History data must be exactly 26 bytes.");
+            /**
+             * @brief Parses `TOTAL_SIZE` bytes read directly from a raw buffer into a history object.
+             * @param data A pointer to the first byte of the history block.
+             * @param size The number of bytes available at `data`. What to send: Exactly `TOTAL_SIZE` (26 for `osa::history`).
+             * @param card_effective_date_in_minutes The card's effective date in minutes since epoch.
+             * @return A history object populated with up to `LOG_COUNT` logs from the data.
+             * @throws std::invalid_argument if `size` is not exactly `TOTAL_SIZE` bytes.
+             */
+            static basic_history parse(const uint8_t* data, const size_t size, const std::time_t card_effective_date_in_minutes) {
+                if (size != TOTAL_SIZE)
+                    throw metrics::counted(std::invalid_argument("OSA History data must be exactly " + std::to_string(TOTAL_SIZE) + " bytes."));
+                return try_parse(data, size, card_effective_date_in_minutes).value();
+            }
 
-                history h;
+            /**
+             * @brief Non-throwing variant of `parse()` that decodes `TOTAL_SIZE` bytes read directly from a raw buffer.
+             * @param data A pointer to the first byte of the history block.
+             * @param size The number of bytes available at `data`. What to send: Exactly `TOTAL_SIZE`.
+             * @param card_effective_date_in_minutes The card's effective date in minutes since epoch.
+             * @return A `result` holding the parsed history, or `status_code::invalid_size` on a size mismatch.
+             */
+            [[nodiscard]] static result<basic_history> try_parse(const uint8_t* data, const size_t size, const effective_epoch card_effective_date_in_minutes) noexcept {
+
+                if (size != TOTAL_SIZE)
+                    return status_code::invalid_size;
+
+                basic_history h;
                 h.set_card_effective_date(card_effective_date_in_minutes);
 
-                // Iterate through the two possible log slots.
+                // Iterate through the possible log slots.
                 for (size_t i = 0; i < LOG_COUNT; ++i) {
-                    // Get iterators for the current 13-byte slice of data.
-                    const auto begin = data.begin() + (i * LOG_SIZE_BYTES);
+                    // Get pointers to the current 13-byte slice of data.
+                    const uint8_t* begin = data + (i * LOG_SIZE_BYTES);
                     const auto end = begin + LOG_SIZE_BYTES;
 
                     // If a log slot is all zeros, assume it and all subsequent slots are empty.
@@ -2263,36 +3348,76 @@ namespace open_loop {
                     }
 
                     // Delegate the 13-byte chunk to the transaction_record parser.
-                    h.logs_[i] = transaction_record::parse({begin, end}, card_effective_date_in_minutes);
+                    h.logs_[i] = transaction_record::try_parse(begin, LOG_SIZE_BYTES, card_effective_date_in_minutes).value();
                     h.valid_log_count_++;
                 }
                 return h;
             }
 
             /**
-             * @brief Serializes the `history` object into a 26-byte vector.
-             * @details Any unused log slots will be padded with zeros to ensure the output is always 26 bytes.
+             * @brief Serializes the history into a `TOTAL_SIZE`-byte vector.
+             * @details Any unused log slots will be padded with zeros to ensure the output is always `TOTAL_SIZE` bytes.
              * @return A `std::vector<uint8_t>` of the serialized history data.
              */
             [[nodiscard]] std::vector<uint8_t> to_bytes() const {
-                std::vector<uint8_t> data;
-                data.reserve(TOTAL_SIZE);
+                std::vector<uint8_t> data(TOTAL_SIZE);
+                serialize_into(data.data());
+                return data;
+            }
 
-                // Serialize each valid log entry in order.
+            /**
+             * @brief Serializes the `history` object directly into a caller-supplied buffer.
+             * @details Any unused log slots are zero-filled, so exactly `TOTAL_SIZE` bytes are always written.
+             * @param out A pointer to at least `TOTAL_SIZE` writable bytes.
+             */
+            void serialize_into(uint8_t* out) const noexcept {
+                // Serialize each valid log entry in order, newest first, straight into its 13-byte slot.
                 for (size_t i = 0; i < valid_log_count_; ++i) {
-                    auto log_bytes = logs_[i].to_bytes();
-                    data.insert(data.end(), log_bytes.begin(), log_bytes.end());
+                    get_log_unchecked(i).serialize_into(out + (i * LOG_SIZE_BYTES));
                 }
 
-                // Calculate how much padding is needed to reach the full 26-byte size.
-                if (const size_t padding_size = (LOG_COUNT - valid_log_count_) * LOG_SIZE_BYTES; padding_size > 0) {
-                    data.insert(data.end(), padding_size, 0x00);
-                }
-                return data;
+                // Zero-fill the unused slots to reach the full block size.
+                std::fill(out + (valid_log_count_ * LOG_SIZE_BYTES), out + TOTAL_SIZE, 0x00);
+            }
+
+            /**
+             * @brief Returns a copy of every record slot in on-card order (index 0 is the newest).
+             * @details Prefer `get_log()` on hot paths; it returns a reference without copying.
+             */
+            [[nodiscard]] std::array<transaction_record, LOG_COUNT> get_logs() const noexcept {
+                std::array<transaction_record, LOG_COUNT> logs;
+                for (size_t i = 0; i < LOG_COUNT; ++i) logs[i] = get_log_unchecked(i);
+                return logs;
+            }
+
+            /**
+             * @brief Returns the record at logical position `index`, where 0 is the newest.
+             * @throws std::out_of_range if `index` is not below `LOG_COUNT`.
+             */
+            [[nodiscard]] const transaction_record& get_log(const size_t index) const {
+                if (index >= LOG_COUNT) throw metrics::counted(std::out_of_range("History record index is out of range."));
+                return get_log_unchecked(index);
+            }
+
+            //! Non-checking variant of `get_log()`. `index` must be below `LOG_COUNT`.
+            [[nodiscard]] const transaction_record& get_log_unchecked(const size_t index) const noexcept {
+                return logs_[detail::ring_slot(head_, index, LOG_COUNT)];
             }
 
-            [[nodiscard]] const std::array<transaction_record, LOG_COUNT>& get_logs() const noexcept { return logs_; }
             [[nodiscard]] size_t get_valid_log_count() const noexcept { return valid_log_count_; }
+            //! The epoch shared by the stored logs. Unset until `set_card_effective_date()` has been called.
+            [[nodiscard]] const effective_epoch& get_card_epoch() const noexcept { return card_effective_date_in_minutes_; }
+
+            /**
+             * @brief Pushes a serialized record onto a raw history block without decoding it.
+             * @details Rotates the 13-byte slots down by one in place, dropping the oldest, and copies the new
+             *          record into slot 0. The result matches `add_record()` followed by `serialize_into()`.
+             * @param history_data The first byte of the `TOTAL_SIZE`-byte history block.
+             * @param record_data The 13 bytes of the new record. Must not overlap `history_data`.
+             */
+            static void push_record_into(uint8_t* history_data, const uint8_t* record_data) noexcept {
+                detail::push_front_slot(history_data, LOG_COUNT, LOG_SIZE_BYTES, record_data);
+            }
 
             /**
              * @brief Gets the card effective date associated with this history.
@@ -2301,53 +3426,67 @@ namespace open_loop {
              */
             [[nodiscard]] std::time_t get_card_effective_date() const {
                 if (!card_effective_date_in_minutes_.has_value())
-                    throw std::logic_error("Card effective date has not been set.");
+                    throw metrics::counted(std::logic_error("Card effective date has not been set."));
                 return *card_effective_date_in_minutes_;
             }
 
-            friend std::ostream& operator<<(std::ostream& os, const history& obj) {
-                os << "======================== OSA: HISTORY DATA ========================" << std::endl;
-                try {
-                    os << "  CARD EFFECTIVE DATE (MINS): " << obj.get_card_effective_date() << std::endl;
-                } catch (const std::logic_error&) {
-                    os << "  CARD EFFECTIVE DATE (MINS): [Not Set]" << std::endl;
-                }
-                os << "  VALID LOG COUNT           : " << obj.get_valid_log_count() << std::endl;
+            /**
+             * @brief Decodes the timestamps of every stored record in one pass.
+             * @details Fare rules read all timestamps repeatedly; this checks the effective date once and
+             *          then performs one multiply-add per record.
+             * @return The absolute times in milliseconds, newest first. Slots at or beyond `get_valid_log_count()` are 0.
+             * @throws std::logic_error if the effective date has not been set.
+             */
+            [[nodiscard]] std::array<uint64_t, LOG_COUNT> get_dates_and_times() const {
+                if (!card_effective_date_in_minutes_.has_value())
+                    throw metrics::counted(std::logic_error("Card effective date is not set; cannot calculate absolute time."));
+                std::array<uint64_t, LOG_COUNT> times{};
+                for (size_t i = 0; i < valid_log_count_; ++i) times[i] = get_log_unchecked(i).get_date_and_time_unchecked();
+                return times;
+            }
 
-                if (obj.get_valid_log_count() > 0) {
-                    // Iterate through the valid logs and print them, using the transaction_record's stream operator.
-                    for (size_t i = 0; i < obj.get_valid_log_count(); ++i) {
-                        // Add a newline between entries but not after the last one.
-                        os << obj.get_logs()[i] << (i < obj.get_valid_log_count() - 1 ? "\n" : "");
-                    }
-                } else {
-                    os << "  [No log entries]";
-                }
-                os << "\n=================================================================";
-                return os;
+            friend std::ostream& operator<<(std::ostream& os, const basic_history& obj) {
+                std::array<const transaction_record*, LOG_COUNT> logs{};
+                for (size_t i = 0; i < obj.get_valid_log_count(); ++i) logs[i] = &obj.get_log_unchecked(i);
+                return detail::write_osa_history(os, obj.card_effective_date_in_minutes_, logs.data(), obj.get_valid_log_count());
             }
 
-            friend bool operator==(const history& lhs, const history& rhs) {
+            friend bool operator==(const basic_history& lhs, const basic_history& rhs) {
                 // First, compare the inexpensive, non-array members.
                 if (lhs.card_effective_date_in_minutes_ != rhs.card_effective_date_in_minutes_ ||
                     lhs.valid_log_count_ != rhs.valid_log_count_) {
                     return false;
                     }
                 // If those match, compare the contents of the valid log entries.
-                return std::equal(lhs.logs_.begin(), lhs.logs_.begin() + lhs.valid_log_count_, rhs.logs_.begin());
+                for (size_t i = 0; i < lhs.valid_log_count_; ++i)
+                    if (!(lhs.get_log_unchecked(i) == rhs.get_log_unchecked(i))) return false;
+                return true;
             }
 
         private:
 
-            //! A fixed-size array to hold the transaction records.
+            //! A ring of transaction records. Logical index `i` lives in `logs_[(head_ + i) % LOG_COUNT]`.
             std::array<transaction_record, LOG_COUNT> logs_{};
+            //! The physical slot in `logs_` that holds the newest record.
+            size_t head_{ 0 };
             //! A counter for how many slots in the array contain valid data.
             size_t valid_log_count_{ 0 };
             //! The base date for all records in this history, essential for interpreting time offsets.
-            std::optional<std::time_t> card_effective_date_in_minutes_;
+            effective_epoch card_effective_date_in_minutes_;
 
         };
 
+        /**
+         * @brief The standard two-record (26-byte) OSA history.
+         * @usage
+         * @code
+         *     osa::history hist;
+         *     hist.set_card_effective_date(28399680);
+         *     std::vector<uint8_t> bytes = hist.to_bytes(); // A 26-byte vector
+         * @endcode
+         */
+        using history = basic_history<2>;
+
         /**
          * @class trip_pass
          * @brief Represents the 20-byte Trip Pass data block in the OSA.
@@ -2402,14 +3541,19 @@ namespace open_loop {
              *                             milliseconds since the Unix epoch.
              * @throws std::out_of_range if the corresponding second-level timestamp exceeds the 24-bit storage limit.
              */
-            void set_pass_expiry(const uint64_t time_in_milliseconds) {
+            void set_pass_expiry(const uint64_t time_in_milliseconds);
+
+            /**
+             * @brief Non-throwing variant of `set_pass_expiry()`.
+             * @return `status_code::ok`, or `timestamp_overflow` (expiry unchanged) if the seconds exceed 24 bits.
+             */
+            [[nodiscard]] status_code try_set_pass_expiry(const uint64_t time_in_milliseconds) noexcept {
                 // Convert the user-provided millisecond timestamp to seconds for storage.
                 const uint64_t time_in_seconds = time_in_milliseconds / 1000;
                 // Validate that the timestamp can fit within the 24 bits allocated for it.
-                if (time_in_seconds > TIME_MAX) {
-                    throw std::out_of_range("Pass expiry time exceeds 24-bit storage limit.");
-                }
+                if (time_in_seconds > TIME_MAX) return status_code::timestamp_overflow;
                 pass_expiry_ = static_cast<uint32_t>(time_in_seconds);
+                return status_code::ok;
             }
 
             /**
@@ -2418,13 +3562,18 @@ namespace open_loop {
              *                             milliseconds since the Unix epoch.
              * @throws std::out_of_range if the corresponding second-level timestamp exceeds the 24-bit limit.
              */
-            void set_start_date_and_time(const uint64_t time_in_milliseconds) {
-                // This logic is identical to set_pass_expiry.
+            void set_start_date_and_time(const uint64_t time_in_milliseconds);
+
+            /**
+             * @brief Non-throwing variant of `set_start_date_and_time()`.
+             * @return `status_code::ok`, or `timestamp_overflow` (start time unchanged) if the seconds exceed 24 bits.
+             */
+            [[nodiscard]] status_code try_set_start_date_and_time(const uint64_t time_in_milliseconds) noexcept {
+                // This logic is identical to try_set_pass_expiry.
                 const uint64_t time_in_seconds = time_in_milliseconds / 1000;
-                if (time_in_seconds > TIME_MAX) {
-                    throw std::out_of_range("Start time exceeds 24-bit storage limit.");
-                }
+                if (time_in_seconds > TIME_MAX) return status_code::timestamp_overflow;
                 start_date_and_time_ = static_cast<uint32_t>(time_in_seconds);
+                return status_code::ok;
             }
 
             /**
@@ -2435,11 +3584,16 @@ namespace open_loop {
              * @note You must call `set_trips_allotted()` before calling this method to ensure the
              *       validation check works correctly.
              */
-            void set_remaining_trips(const uint16_t trips) {
-                if (trips > trips_allotted_) {
-                    throw std::invalid_argument("Remaining trips cannot be greater than allotted trips.");
-                }
+            void set_remaining_trips(const uint16_t trips);
+
+            /**
+             * @brief Non-throwing variant of `set_remaining_trips()`.
+             * @return `status_code::ok`, or `remaining_trips_exceed_allotted` (count unchanged) if `trips` exceeds the allotment.
+             */
+            [[nodiscard]] status_code try_set_remaining_trips(const uint16_t trips) noexcept {
+                if (trips > trips_allotted_) return status_code::remaining_trips_exceed_allotted;
                 remaining_trips_ = trips;
+                return status_code::ok;
             }
 
             void set_pass_id(const uint8_t id) noexcept { pass_id_ = id; }
@@ -2457,33 +3611,29 @@ namespace open_loop {
              * @return A `trip_pass` object populated with the parsed data.
              * @throws std::invalid_argument if the data vector is not exactly 20 bytes.
              */
-            static trip_pass parse(const std::vector<uint8_t>& data) {
-                if (data.size() != DATA_SIZE) throw std::invalid_argument("OSA Trip Pass data must be 20 bytes.");
+            static trip_pass parse(const std::vector<uint8_t>& data);
 
-                trip_pass pass;
-                // Byte 0: Pass ID (8-bit).
-                pass.pass_id_ = data[0];
-                // Bytes 1-3: Pass Expiry (24-bit, Big-Endian).
-                pass.pass_expiry_ = (static_cast<uint32_t>(data[1]) << 16) | (static_cast<uint32_t>(data[2]) << 8) | data[3];
-                // Byte 4: Priority (8-bit).
-                pass.priority_ = data[4];
-                // Bytes 5-6: Trips Allotted (16-bit, Big-Endian).
-                pass.trips_allotted_ = (static_cast<uint16_t>(data[5]) << 8) | data[6];
-                // Bytes 7-8: Remaining Trips (16-bit, Big-Endian).
-                pass.remaining_trips_ = (static_cast<uint16_t>(data[7]) << 8) | data[8];
-                // Bytes 9-10: Source ID (16-bit, Big-Endian).
-                pass.source_id_ = (static_cast<uint16_t>(data[9]) << 8) | data[10];
-                // Bytes 11-12: Destination ID (16-bit, Big-Endian).
-                pass.destination_id_ = (static_cast<uint16_t>(data[11]) << 8) | data[12];
-                // Byte 13: Flags (8-bit).
-                pass.flags_ = data[13];
-                // Byte 14: Daily Trip Counter (8-bit).
-                pass.daily_trip_counter_ = data[14];
-                // Bytes 15-16: Daily Trip Indicator (16-bit, Big-Endian).
-                pass.daily_trip_indicator_ = (static_cast<uint16_t>(data[15]) << 8) | data[16];
-                // Bytes 17-19: Start Date & Time (24-bit, Big-Endian).
-                pass.start_date_and_time_ = (static_cast<uint32_t>(data[17]) << 16) | (static_cast<uint32_t>(data[18]) << 8) | data[19];
+            /**
+             * @brief Parses 20 bytes read directly from a raw buffer into a `trip_pass` object.
+             * @param data A pointer to the first byte of the trip pass slot.
+             * @param size The number of bytes available at `data`. What to send: Exactly 20.
+             * @return A `trip_pass` object populated with the parsed data.
+             * @throws std::invalid_argument if `size` is not exactly 20 bytes.
+             */
+            static trip_pass parse(const uint8_t* data, const size_t size);
+
+            /**
+             * @brief Non-throwing variant of `parse()` that decodes 20 bytes read directly from a raw buffer.
+             * @param data A pointer to the first byte of the trip pass slot.
+             * @param size The number of bytes available at `data`. What to send: Exactly 20.
+             * @return A `result` holding the parsed `trip_pass`, or `status_code::invalid_size` on a size mismatch.
+             */
+            [[nodiscard]] static result<trip_pass> try_parse(const uint8_t* data, const size_t size) noexcept {
+                if (size != DATA_SIZE) return status_code::invalid_size;
 
+                trip_pass pass;
+                // Every field is decoded from the descriptor table in `layout`.
+                layout::decode(data, pass);
                 return pass;
             }
 
@@ -2491,33 +3641,15 @@ namespace open_loop {
              * @brief Serializes the `trip_pass` object into a 20-byte vector.
              * @return A `std::vector<uint8_t>` containing the serialized data.
              */
-            [[nodiscard]] std::vector<uint8_t> to_bytes() const {
-                std::vector<uint8_t> data;
-                data.reserve(DATA_SIZE); // Pre-allocate memory for efficiency.
-
-                // Deconstruct each multibyte field into its big-endian byte representation.
-                data.push_back(pass_id_);
-                data.push_back((pass_expiry_ >> 16) & 0xFF);
-                data.push_back((pass_expiry_ >> 8) & 0xFF);
-                data.push_back(pass_expiry_ & 0xFF);
-                data.push_back(priority_);
-                data.push_back((trips_allotted_ >> 8) & 0xFF);
-                data.push_back(trips_allotted_ & 0xFF);
-                data.push_back((remaining_trips_ >> 8) & 0xFF);
-                data.push_back(remaining_trips_ & 0xFF);
-                data.push_back((source_id_ >> 8) & 0xFF);
-                data.push_back(source_id_ & 0xFF);
-                data.push_back((destination_id_ >> 8) & 0xFF);
-                data.push_back(destination_id_ & 0xFF);
-                data.push_back(flags_);
-                data.push_back(daily_trip_counter_);
-                data.push_back((daily_trip_indicator_ >> 8) & 0xFF);
-                data.push_back(daily_trip_indicator_ & 0xFF);
-                data.push_back((start_date_and_time_ >> 16) & 0xFF);
-                data.push_back((start_date_and_time_ >> 8) & 0xFF);
-                data.push_back(start_date_and_time_ & 0xFF);
+            [[nodiscard]] std::vector<uint8_t> to_bytes() const;
 
-                return data;
+            /**
+             * @brief Serializes the `trip_pass` object directly into a caller-supplied buffer.
+             * @param out A pointer to at least 20 writable bytes. Exactly 20 bytes are written.
+             */
+            void serialize_into(uint8_t* out) const noexcept {
+                // Every field is encoded from the descriptor table in `layout`.
+                layout::encode(*this, out);
             }
 
             [[nodiscard]] uint8_t get_pass_id() const noexcept { return pass_id_; }
@@ -2549,48 +3681,10 @@ namespace open_loop {
             [[nodiscard]] uint8_t get_daily_trip_counter() const noexcept { return daily_trip_counter_; }
             [[nodiscard]] uint16_t get_daily_trip_indicator() const noexcept { return daily_trip_indicator_; }
 
-            friend std::ostream& operator<<(std::ostream& os, const trip_pass& obj) {
-                // A stateless lambda function to format a millisecond timestamp into a human-readable UTC string.
-                // This avoids duplicating formatting code. `auto` deduces the lambda's type.
-                auto format_time_ms = [](const uint64_t t_ms) {
-                    char buf[100];
-                    // Convert milliseconds to seconds for std::gmtime.
-                    const std::time_t t_sec = t_ms / 1000;
-                    // Format the time. The `gmtime` function is used for UTC.
-                    std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", std::gmtime(&t_sec));
-                    return std::string(buf);
-                };
-
-                os << "--------------------- OSA: TRIP PASS ---------------------" << std::endl;
-                // Cast 8-bit integers to `int` for printing as numbers instead of characters.
-                os << "  PASS ID                : " << static_cast<int>(obj.pass_id_) << std::endl;
-                os << "  PASS EXPIRY            : " << format_time_ms(obj.get_pass_expiry()) << " (UTC)" << std::endl;
-                os << "  PRIORITY               : " << static_cast<int>(obj.priority_) << std::endl;
-                os << "  TRIPS ALLOTTED         : " << obj.trips_allotted_ << std::endl;
-                os << "  REMAINING TRIPS        : " << obj.remaining_trips_ << std::endl;
-                os << "  SOURCE ID              : " << obj.source_id_ << std::endl;
-                os << "  DESTINATION ID         : " << obj.destination_id_ << std::endl;
-                os << "  FLAGS (BINARY)         : " << std::bitset<8>(obj.flags_) << std::endl;
-                os << "  DAILY TRIP COUNTER     : " << static_cast<int>(obj.daily_trip_counter_) << std::endl;
-                os << "  DAILY TRIP INDICATOR   : " << obj.daily_trip_indicator_ << std::endl;
-                os << "  START DATE & TIME      : " << format_time_ms(obj.get_start_date_and_time()) << " (UTC)" << std::endl;
-                os << "------------------------------------------------------------";
-                return os;
-            }
+            friend std::ostream& operator<<(std::ostream& os, const trip_pass& obj);
 
             friend bool operator==(const trip_pass& lhs, const trip_pass& rhs) {
-                // Perform a deep comparison of all data members.
-                return lhs.pass_id_ == rhs.pass_id_ &&
-                       lhs.pass_expiry_ == rhs.pass_expiry_ &&
-                       lhs.priority_ == rhs.priority_ &&
-                       lhs.trips_allotted_ == rhs.trips_allotted_ &&
-                       lhs.remaining_trips_ == rhs.remaining_trips_ &&
-                       lhs.source_id_ == rhs.source_id_ &&
-                       lhs.destination_id_ == rhs.destination_id_ &&
-                       lhs.flags_ == rhs.flags_ &&
-                       lhs.daily_trip_counter_ == rhs.daily_trip_counter_ &&
-                       lhs.daily_trip_indicator_ == rhs.daily_trip_indicator_ &&
-                       lhs.start_date_and_time_ == rhs.start_date_and_time_;
+                return layout::equal(lhs, rhs);
             }
 
         private:
@@ -2609,17 +3703,60 @@ namespace open_loop {
             uint16_t daily_trip_indicator_{ 0 };
             //! The pass start/activation time, stored as a 24-bit integer representing seconds since the Unix epoch.
             uint32_t start_date_and_time_{ 0 };
+
+        public:
+
+            //! The on-card layout of this block. `try_parse()`, `serialize_into()` and `operator==` are generated from it.
+            using layout = detail::layout<DATA_SIZE,
+                detail::field<&trip_pass::pass_id_, 0, 8>,                 // Byte 0
+                detail::field<&trip_pass::pass_expiry_, 1, 24>,            // Bytes 1-3 (Big-Endian, seconds)
+                detail::field<&trip_pass::priority_, 4, 8>,                // Byte 4
+                detail::field<&trip_pass::trips_allotted_, 5, 16>,         // Bytes 5-6 (Big-Endian)
+                detail::field<&trip_pass::remaining_trips_, 7, 16>,        // Bytes 7-8 (Big-Endian)
+                detail::field<&trip_pass::source_id_, 9, 16>,              // Bytes 9-10 (Big-Endian)
+                detail::field<&trip_pass::destination_id_, 11, 16>,        // Bytes 11-12 (Big-Endian)
+                detail::field<&trip_pass::flags_, 13, 8>,                  // Byte 13
+                detail::field<&trip_pass::daily_trip_counter_, 14, 8>,     // Byte 14
+                detail::field<&trip_pass::daily_trip_indicator_, 15, 16>,  // Bytes 15-16 (Big-Endian)
+                detail::field<&trip_pass::start_date_and_time_, 17, 24>>;  // Bytes 17-19 (Big-Endian, seconds)
         };
 
         /**
-         * @class container
+         * @struct standard_layout
+         * @brief The layout policy of the standard OSA: two history records, two trip passes and 10 bytes of padding.
+         *
+         * @details A layout policy tells `basic_container` how many history records and trip passes an operator's
+         *          OSA holds, and `layout_registry` which `general` major versions it applies to. Operator-specific
+         *          layouts are plain structs with the same three members:
+         *
+         * @code
+         *     struct zonal_layout {
+         *         static constexpr size_t HISTORY_RECORDS = 1;
+         *         static constexpr size_t NUM_TRIP_PASSES = 3;
+         *         static constexpr bool accepts(const size_t major_version) noexcept { return major_version == 5; }
+         *     };
+         *     using zonal_container = osa::basic_container<zonal_layout>;
+         * @endcode
+         */
+        struct standard_layout {
+            static constexpr size_t HISTORY_RECORDS = 2;
+            static constexpr size_t NUM_TRIP_PASSES = 2;
+            //! The standard layout accepts every major version, so register it last as the fallback.
+            static constexpr bool accepts(const size_t /*major_version*/) noexcept { return true; }
+        };
+
+        /**
+         * @class basic_container
          * @brief Represents the complete Operator Service Area (OSA) within a 96-byte block.
          *
          * @details This class is the top-level wrapper that orchestrates all OSA components.
          *          It is designed to be created with a default constructor and then configured using
          *          public setter methods. This approach allows for deferred initialization.
          *
-         *          The 96-byte layout is as follows:
+         *          The number of history records and trip passes comes from the `Layout` policy, and every
+         *          offset, the padding size and the patch regions are derived from it at compile time, so each
+         *          operator layout is its own statically specialized type. `osa::container` is the
+         *          `standard_layout` instantiation, whose 96-byte layout is as follows:
          *          - **Bytes 0-6**: `general` data (7 bytes)
          *          - **Bytes 7-19**: `validation` data (13 bytes)
          *          - **Bytes 20-45**: `history` data (2 logs, 26 bytes)
@@ -2654,27 +3791,39 @@ namespace open_loop {
          *
          *     assert(my_osa == parsed_osa);
          * @endcode
+         *
+         * @tparam Layout The layout policy, e.g. `standard_layout`.
          */
-        class container {
+        template <typename Layout>
+        class basic_container {
         public:
+            //! The layout policy this container was specialized for.
+            using layout_type = Layout;
+            //! The history type sized for this layout (`osa::history` for the standard layout).
+            using history_type = basic_history<Layout::HISTORY_RECORDS>;
+
             static constexpr size_t BLOCK_SIZE = 96;
-            static constexpr size_t NUM_TRIP_PASSES = 2;
+            static constexpr size_t NUM_TRIP_PASSES = Layout::NUM_TRIP_PASSES;
             static constexpr size_t GENERAL_OFFSET = 0;
             static constexpr size_t VALIDATION_OFFSET = GENERAL_OFFSET + general::DATA_SIZE; // Offset 7
             static constexpr size_t HISTORY_OFFSET = VALIDATION_OFFSET + transaction_record::DATA_SIZE; // Offset 20
-            static constexpr size_t TRIP_PASS_START_OFFSET = HISTORY_OFFSET + history::TOTAL_SIZE; // Offset 46
+            static constexpr size_t TRIP_PASS_START_OFFSET = HISTORY_OFFSET + history_type::TOTAL_SIZE; // Offset 46 (standard)
             static constexpr size_t ACTUAL_DATA_SIZE = general::DATA_SIZE +
                                                        transaction_record::DATA_SIZE +
-                                                       history::TOTAL_SIZE +
-                                                       (NUM_TRIP_PASSES * trip_pass::DATA_SIZE); // 86 bytes
-            static constexpr size_t PADDING_SIZE = BLOCK_SIZE - ACTUAL_DATA_SIZE; // 10 bytes
+                                                       history_type::TOTAL_SIZE +
+                                                       (NUM_TRIP_PASSES * trip_pass::DATA_SIZE); // 86 bytes (standard)
+            static_assert(ACTUAL_DATA_SIZE <= BLOCK_SIZE, "The OSA layout does not fit in 96 bytes.");
+            static constexpr size_t PADDING_SIZE = BLOCK_SIZE - ACTUAL_DATA_SIZE; // 10 bytes (standard)
+            //! The logical regions compared independently by `patch_into()`.
+            static constexpr auto PATCH_REGIONS = detail::make_osa_patch_regions<Layout::HISTORY_RECORDS, NUM_TRIP_PASSES>(
+                general::DATA_SIZE, transaction_record::DATA_SIZE, trip_pass::DATA_SIZE, BLOCK_SIZE);
 
             /**
              * @brief Default constructor. Creates an `osa::container` in an uninitialized state.
              * @warning `set_card_effective_date()` must be called before this object can be used
              *          for time-sensitive operations like parsing.
              */
-            container() = default;
+            basic_container() = default;
 
             /**
              * @brief Sets the card's effective date and propagates it to all time-sensitive child objects.
@@ -2683,29 +3832,29 @@ namespace open_loop {
              * @param card_effective_date_in_minutes The card's effective date in minutes since the Unix epoch.
              */
             void set_card_effective_date(const std::time_t card_effective_date_in_minutes) noexcept {
-                card_effective_date_ = card_effective_date_in_minutes;
-                // Propagate the date to the child objects to ensure the entire container is in a consistent state.
-                validation_.set_card_effective_date(card_effective_date_in_minutes);
-                history_.set_card_effective_date(card_effective_date_in_minutes);
+                card_effective_date_ = effective_epoch(card_effective_date_in_minutes);
+                // Propagate the epoch to the child objects to ensure the entire container is in a consistent state.
+                validation_.set_card_effective_date(card_effective_date_);
+                history_.set_card_effective_date(card_effective_date_);
             }
 
             void set_general(const general& gen) noexcept { general_ = gen; }
 
             void set_validation(const transaction_record& val) {
                 if (val.get_card_effective_date() != get_card_effective_date())
-                    throw std::logic_error("Validation record's effective date does not match OSA container's.");
+                    throw metrics::counted(std::logic_error("Validation record's effective date does not match OSA container's."));
                 validation_ = val;
             }
 
-            void set_history(const history& hist) {
+            void set_history(const history_type& hist) {
                 if (hist.get_card_effective_date() != get_card_effective_date())
-                    throw std::logic_error("History object's effective date does not match OSA container's.");
+                    throw metrics::counted(std::logic_error("History object's effective date does not match OSA container's."));
                 history_ = hist;
             }
 
             void set_trip_pass(const trip_pass& pass, const size_t index) {
                 if (index >= NUM_TRIP_PASSES)
-                    throw std::out_of_range("Trip pass index is out of bounds.");
+                    throw metrics::counted(std::out_of_range("Trip pass index is out of bounds."));
                 trip_passes_[index] = pass;
             }
 
@@ -2716,53 +3865,133 @@ namespace open_loop {
              * @throws std::invalid_argument if the data vector is not exactly 96 bytes.
              */
             void parse(const std::vector<uint8_t>& data) {
+                parse(data.data(), data.size());
+            }
+
+            //! Parses a 96-byte vector drawn from a memory resource, e.g. one returned by `to_bytes(resource)`.
+            void parse(const std::pmr::vector<uint8_t>& data) {
+                parse(data.data(), data.size());
+            }
+
+            /**
+             * @brief Parses 96 bytes read directly from a raw buffer (e.g., the NFC reader's receive buffer).
+             * @details Every child block is decoded in place from its offset within `data`, so a full
+             *          container parse performs no heap allocation.
+             * @param data A pointer to the first byte of the OSA.
+             * @param size The number of bytes available at `data`. What to send: Exactly 96.
+             * @throws std::logic_error if the card's effective date has not been set first via `set_card_effective_date`.
+             * @throws std::invalid_argument if `size` is not exactly 96 bytes.
+             */
+            void parse(const uint8_t* data, const size_t size) {
+                switch (try_parse(data, size)) {
+                    case status_code::ok: return;
+                    case status_code::effective_date_not_set: throw metrics::counted(std::logic_error("Card effective date must be set before parsing."));
+                    default: throw metrics::counted(std::invalid_argument("Input OSA data must be exactly 96 bytes."));
+                }
+            }
+
+            /**
+             * @brief Non-throwing variant of `parse()` for use on corrupt-card storms and other hot error paths.
+             * @param data A pointer to the first byte of the OSA.
+             * @param size The number of bytes available at `data`. What to send: Exactly 96.
+             * @return `status_code::ok` on success; `status_code::effective_date_not_set` or `status_code::invalid_size`
+             *         on failure, in which case this container is left unchanged.
+             */
+            [[nodiscard]] status_code try_parse(const uint8_t* data, const size_t size) noexcept {
+                const metrics::scoped_timer timer(metrics::operation::osa_parse);
                 // Runtime safety check: ensure the object is in a valid state for parsing.
                 if (!card_effective_date_.has_value())
-                    throw std::logic_error("Card effective date must be set before parsing.");
-                if (data.size() != BLOCK_SIZE)
-                    throw std::invalid_argument("Input OSA data must be exactly 96 bytes.");
+                    return metrics::rejected(status_code::effective_date_not_set);
+                if (size != BLOCK_SIZE)
+                    return metrics::rejected(status_code::invalid_size);
 
-                general_ = general::parse({data.begin() + GENERAL_OFFSET, data.begin() + VALIDATION_OFFSET});
-                validation_ = transaction_record::parse({data.begin() + VALIDATION_OFFSET, data.begin() + HISTORY_OFFSET}, *card_effective_date_);
-                history_ = history::parse({data.begin() + HISTORY_OFFSET, data.begin() + TRIP_PASS_START_OFFSET}, *card_effective_date_);
+                general_ = general::try_parse(data + GENERAL_OFFSET, general::DATA_SIZE).value();
+                validation_ = transaction_record::try_parse(data + VALIDATION_OFFSET, transaction_record::DATA_SIZE, card_effective_date_).value();
+                history_ = history_type::try_parse(data + HISTORY_OFFSET, history_type::TOTAL_SIZE, card_effective_date_).value();
                 for(size_t i = 0; i < NUM_TRIP_PASSES; ++i) {
-                    const auto begin = data.begin() + TRIP_PASS_START_OFFSET + (i * trip_pass::DATA_SIZE);
-                    const auto end = begin + trip_pass::DATA_SIZE;
-                    trip_passes_[i] = trip_pass::parse({begin, end});
+                    const uint8_t* begin = data + TRIP_PASS_START_OFFSET + (i * trip_pass::DATA_SIZE);
+                    trip_passes_[i] = trip_pass::try_parse(begin, trip_pass::DATA_SIZE).value();
                 }
+                return status_code::ok;
             }
 
             [[nodiscard]] std::vector<uint8_t> to_bytes() const {
-                std::vector<uint8_t> data;
-                data.reserve(BLOCK_SIZE);
-                auto general_data = general_.to_bytes();
-                data.insert(data.end(), general_data.begin(), general_data.end());
-                auto validation_data = validation_.to_bytes();
-                data.insert(data.end(), validation_data.begin(), validation_data.end());
-                auto history_data = history_.to_bytes();
-                data.insert(data.end(), history_data.begin(), history_data.end());
+                std::vector<uint8_t> data(BLOCK_SIZE);
+                serialize_into(data.data());
+                return data;
+            }
+
+            /**
+             * @brief Serializes the whole OSA into a vector drawn from a caller-supplied memory resource.
+             * @details Lets a batch job keep every temporary image in one arena and release them all at once,
+             *          instead of returning millions of 96-byte blocks to the global heap one at a time.
+             * @param resource The arena, e.g. a `std::pmr::monotonic_buffer_resource` released after each batch.
+             *                 What to send: A resource that outlives the returned vector.
+             * @return A `std::pmr::vector` holding the 96 serialized bytes.
+             */
+            [[nodiscard]] std::pmr::vector<uint8_t> to_bytes(std::pmr::memory_resource* resource) const {
+                std::pmr::vector<uint8_t> data(BLOCK_SIZE, resource);
+                serialize_into(data.data());
+                return data;
+            }
+
+            /**
+             * @brief Serializes the whole OSA into a fixed-size array without any heap allocation.
+             * @return A `std::array` holding the 96 serialized bytes.
+             */
+            [[nodiscard]] std::array<uint8_t, BLOCK_SIZE> to_array() const noexcept {
+                std::array<uint8_t, BLOCK_SIZE> data{};
+                serialize_into(data.data());
+                return data;
+            }
+
+            /**
+             * @brief Serializes the whole OSA directly into a caller-supplied buffer.
+             * @details Each child block writes itself at its fixed offset; no intermediate buffers are used.
+             * @param out A pointer to at least 96 writable bytes. Exactly 96 bytes are written.
+             */
+            void serialize_into(uint8_t* out) const noexcept {
+                const metrics::scoped_timer timer(metrics::operation::osa_serialize);
+                general_.serialize_into(out + GENERAL_OFFSET);
+                validation_.serialize_into(out + VALIDATION_OFFSET);
+                history_.serialize_into(out + HISTORY_OFFSET);
                 for(size_t i = 0; i < NUM_TRIP_PASSES; ++i) {
-                    auto trip_pass_data = trip_passes_[i].to_bytes();
-                    data.insert(data.end(), trip_pass_data.begin(), trip_pass_data.end());
+                    trip_passes_[i].serialize_into(out + TRIP_PASS_START_OFFSET + (i * trip_pass::DATA_SIZE));
                 }
                 if constexpr (PADDING_SIZE > 0) {
-                    data.insert(data.end(), PADDING_SIZE, 0x00);
+                    std::fill(out + ACTUAL_DATA_SIZE, out + BLOCK_SIZE, 0x00);
                 }
-                return data;
+            }
+
+            /**
+             * @brief Writes back only the bytes that changed since the buffer was parsed.
+             * @details The container is serialized onto the stack and compared region by region (general,
+             *          validation, each history record, each trip pass, padding) against `buffer`. Only the
+             *          differing span of each region is copied, and the touched ranges are reported so the
+             *          reader driver can limit the RF write to the affected card blocks.
+             * @param buffer The 96-byte buffer this container was parsed from. It is updated in place.
+             * @return The byte ranges that were modified, in ascending offset order.
+             */
+            dirty_ranges patch_into(uint8_t* buffer) const noexcept {
+                const std::array<uint8_t, BLOCK_SIZE> fresh = to_array();
+                dirty_ranges dirty;
+                for (const byte_range& region : PATCH_REGIONS)
+                    detail::patch_region(fresh.data(), buffer, region, dirty);
+                return dirty;
             }
 
             [[nodiscard]] general& get_general() noexcept { return general_; }
             [[nodiscard]] const general& get_general() const noexcept { return general_; }
             [[nodiscard]] transaction_record& get_validation() noexcept { return validation_; }
             [[nodiscard]] const transaction_record& get_validation() const noexcept { return validation_; }
-            [[nodiscard]] history& get_history() noexcept { return history_; }
-            [[nodiscard]] const history& get_history() const noexcept { return history_; }
+            [[nodiscard]] history_type& get_history() noexcept { return history_; }
+            [[nodiscard]] const history_type& get_history() const noexcept { return history_; }
             [[nodiscard]] trip_pass& get_trip_pass(size_t index) {
-                if (index >= NUM_TRIP_PASSES) throw std::out_of_range("Trip pass index is out of bounds.");
+                if (index >= NUM_TRIP_PASSES) throw metrics::counted(std::out_of_range("Trip pass index is out of bounds."));
                 return trip_passes_[index];
             }
             [[nodiscard]] const trip_pass& get_trip_pass(size_t index) const {
-                if (index >= NUM_TRIP_PASSES) throw std::out_of_range("Trip pass index is out of bounds.");
+                if (index >= NUM_TRIP_PASSES) throw metrics::counted(std::out_of_range("Trip pass index is out of bounds."));
                 return trip_passes_[index];
             }
 
@@ -2773,26 +4002,53 @@ namespace open_loop {
              */
             [[nodiscard]] std::time_t get_card_effective_date() const {
                 if (!card_effective_date_.has_value()) {
-                    throw std::logic_error("Card effective date has not been set.");
+                    throw metrics::counted(std::logic_error("Card effective date has not been set."));
                 }
                 return *card_effective_date_;
             }
 
-            friend std::ostream& operator<<(std::ostream& os, const container& obj) {
-                os << "==================== OPERATOR SERVICE AREA (OSA) ====================" << std::endl;
-                os << obj.general_ << std::endl;
-                os << obj.validation_ << std::endl;
-                os << obj.history_ << std::endl;
-                for(size_t i = 0; i < container::NUM_TRIP_PASSES; ++i) {
-                    os << obj.trip_passes_[i] << (i < container::NUM_TRIP_PASSES - 1 ? "\n" : "");
-                }
-                os << std::endl << "-------------------------- PADDING ---------------------------" << std::endl;
-                os << "  " << container::PADDING_SIZE << " byte(s) of padding appended during serialization." << std::endl;
-                os << "=================================================================";
-                return os;
+            /**
+             * @brief Gets the precomputed effective date shared with the child blocks.
+             * @return The epoch, which is unset until `set_card_effective_date()` has been called.
+             */
+            [[nodiscard]] const effective_epoch& get_card_epoch() const noexcept { return card_effective_date_; }
+
+            friend std::ostream& operator<<(std::ostream& os, const basic_container& obj) {
+                detail::write_osa_container_head(os, obj.general_, obj.validation_);
+                os << obj.history_;
+                return detail::write_osa_container_tail(os, obj.trip_passes_.data(), NUM_TRIP_PASSES, PADDING_SIZE);
             }
 
-            friend bool operator==(const container& lhs, const container& rhs) {
+            /**
+             * @brief Compares the canonical serialized form of two containers.
+             * @details Serializes both containers into stack buffers and compares the `BLOCK_SIZE` bytes directly,
+             *          together with the effective date. This is cheaper than `operator==`, which walks every
+             *          sub-object. It is the right check for "card unchanged, skip write" and for deduplicating taps.
+             */
+            [[nodiscard]] bool equals_canonical(const basic_container& other) const noexcept {
+                return card_effective_date_ == other.card_effective_date_ && to_array() == other.to_array();
+            }
+
+            /**
+             * @brief Returns true if this container serializes to exactly the `BLOCK_SIZE` bytes at `data`.
+             * @param data What to send: a pointer to at least `BLOCK_SIZE` readable bytes, e.g. the card read before a tap.
+             */
+            [[nodiscard]] bool equals_bytes(const uint8_t* data) const noexcept {
+                const auto bytes = to_array();
+                return std::equal(bytes.begin(), bytes.end(), data);
+            }
+
+            /**
+             * @brief Computes a fast, non-cryptographic 64-bit hash of the canonical bytes and the effective date.
+             * @details Containers that are `equals_canonical()` hash equally, and the value matches
+             *          `compact_card::from_container(*this).hash()`. Also used by `std::hash`.
+             */
+            [[nodiscard]] uint64_t hash() const noexcept {
+                const auto bytes = to_array();
+                return detail::hash_card(bytes.data(), bytes.size(), static_cast<int64_t>(*card_effective_date_));
+            }
+
+            friend bool operator==(const basic_container& lhs, const basic_container& rhs) {
                 return lhs.general_ == rhs.general_ &&
                        lhs.validation_ == rhs.validation_ &&
                        lhs.history_ == rhs.history_ &&
@@ -2803,12 +4059,331 @@ namespace open_loop {
         private:
             general general_{};
             transaction_record validation_{};
-            history history_{};
+            history_type history_{};
             std::array<trip_pass, NUM_TRIP_PASSES> trip_passes_{};
-            // The effective date is now optional, as it's not set at construction.
-            std::optional<std::time_t> card_effective_date_;
+            // The effective date is not set at construction; the epoch starts out unset.
+            effective_epoch card_effective_date_;
+        };
+
+        /**
+         * @brief The standard 96-byte OSA container.
+         */
+        using container = basic_container<standard_layout>;
+
+        // The standard layout is compiled once, in the library; custom layouts are still instantiated on use.
+        extern template class basic_history<standard_layout::HISTORY_RECORDS>;
+        extern template class basic_container<standard_layout>;
+
+        /**
+         * @class layout_registry
+         * @brief Parses a raw OSA with the layout selected by the 3-bit major version of its `general` block.
+         *
+         * @details The registry is a compile-time table with one entry per major version (0-7). For each visitor
+         *          type, every entry is resolved to the first of `Layouts` whose `accepts()` returns true, so a
+         *          dispatch is one indexed call through a function pointer. There is no runtime search and
+         *          no virtual call.
+         *
+         * @tparam Layouts The registered layout policies, in priority order.
+         *
+         * @usage
+         * @code
+         *     using registry = osa::layout_registry<zonal_layout, purse_layout, osa::standard_layout>;
+         *     const status_code code = registry::dispatch(rx_buffer, 96, effective_date, [&](auto& card) {
+         *         // `card` is an osa::basic_container<L>& for the layout L that matched.
+         *         settle(card);
+         *     });
+         * @endcode
+         */
+        template <typename... Layouts>
+        class layout_registry {
+        public:
+            static_assert(sizeof...(Layouts) > 0, "A layout registry needs at least one layout.");
+
+            //! The number of distinct 3-bit major versions.
+            static constexpr size_t VERSION_COUNT = 8;
+
+            //! Reads the 3-bit major version from byte 0 of a raw OSA.
+            [[nodiscard]] static constexpr uint8_t major_version(const uint8_t* data) noexcept {
+                return (data[0] >> 5) & 0x07;
+            }
+
+            /**
+             * @brief Parses `data` with the layout registered for its major version and passes the container to `visitor`.
+             * @param data A pointer to the first byte of the OSA.
+             * @param size The number of bytes available at `data`. What to send: Exactly 96.
+             * @param card_effective_date_in_minutes The card's effective date in minutes since the Unix epoch.
+             * @param visitor Called as `visitor(basic_container<L>&)` only if parsing succeeds.
+             * @return `status_code::ok`, `invalid_size`, or `unsupported_layout` if no layout accepts the version.
+             */
+            template <typename Visitor>
+            static status_code dispatch(const uint8_t* data, const size_t size, const std::time_t card_effective_date_in_minutes, Visitor&& visitor) {
+                if (size != container::BLOCK_SIZE) return status_code::invalid_size;
+                return TABLE<std::remove_reference_t<Visitor>>[major_version(data)](data, card_effective_date_in_minutes, visitor);
+            }
+
+            //! Returns true if some registered layout accepts `major_version`. What to send: A value in [0, 7].
+            [[nodiscard]] static constexpr bool supports(const size_t major_version) noexcept {
+                return (Layouts::accepts(major_version) || ...);
+            }
+
+        private:
+
+            template <typename Visitor>
+            using handler = status_code (*)(const uint8_t*, std::time_t, Visitor&);
+
+            template <typename Visitor, typename Layout>
+            static status_code invoke(const uint8_t* data, const std::time_t card_effective_date_in_minutes, Visitor& visitor) {
+                basic_container<Layout> card;
+                card.set_card_effective_date(card_effective_date_in_minutes);
+                const status_code code = card.try_parse(data, basic_container<Layout>::BLOCK_SIZE);
+                if (code == status_code::ok) visitor(card);
+                return code;
+            }
+
+            template <typename Visitor>
+            static status_code unsupported(const uint8_t*, std::time_t, Visitor&) noexcept {
+                return status_code::unsupported_layout;
+            }
+
+            template <typename Visitor, size_t Version, typename First, typename... Rest>
+            static constexpr handler<Visitor> select() noexcept {
+                if constexpr (First::accepts(Version)) return &invoke<Visitor, First>;
+                else if constexpr (sizeof...(Rest) > 0) return select<Visitor, Version, Rest...>();
+                else return &unsupported<Visitor>;
+            }
+
+            template <typename Visitor, size_t... Versions>
+            static constexpr std::array<handler<Visitor>, VERSION_COUNT> make_table(std::index_sequence<Versions...>) noexcept {
+                return {{ select<Visitor, Versions, Layouts...>()... }};
+            }
+
+            //! The jump table for one visitor type, indexed by major version.
+            template <typename Visitor>
+            static constexpr std::array<handler<Visitor>, VERSION_COUNT> TABLE = make_table<Visitor>(std::make_index_sequence<VERSION_COUNT>{});
         };
 
+        /**
+         * @class view
+         * @brief A non-owning, zero-copy window onto a raw 96-byte OSA that decodes fields on access.
+         *
+         * @details The OSA counterpart of `csa::view`. Gate logic typically only needs the trip pass
+         *          remaining trips and expiry, which are decoded directly from their fixed offsets.
+         *          `to_container()` performs the full parse when a write is required.
+         *
+         * @warning The view does not own the buffer. The caller must keep the 96 bytes alive and unchanged
+         *          for as long as the view is in use.
+         */
+        class view {
+        public:
+
+            //! Absolute offsets of the individual validation fields within the 96-byte OSA.
+            static constexpr size_t VALIDATION_TIME_OFFSET = container::VALIDATION_OFFSET + 2;
+            static constexpr size_t VALIDATION_STATION_OFFSET = container::VALIDATION_OFFSET + 5;
+            static constexpr size_t VALIDATION_FARE_OFFSET = container::VALIDATION_OFFSET + 7;
+            static constexpr size_t VALIDATION_TERMINAL_OFFSET = container::VALIDATION_OFFSET + 9;
+            static constexpr size_t VALIDATION_STATUS_OFFSET = container::VALIDATION_OFFSET + 12;
+
+            //! Offsets of the individual trip pass fields relative to the start of a 20-byte slot.
+            static constexpr size_t PASS_EXPIRY_POS = 1;
+            static constexpr size_t PASS_PRIORITY_POS = 4;
+            static constexpr size_t PASS_ALLOTTED_POS = 5;
+            static constexpr size_t PASS_REMAINING_POS = 7;
+            static constexpr size_t PASS_SOURCE_POS = 9;
+            static constexpr size_t PASS_DESTINATION_POS = 11;
+            static constexpr size_t PASS_FLAGS_POS = 13;
+            static constexpr size_t PASS_DAILY_COUNTER_POS = 14;
+            static constexpr size_t PASS_DAILY_INDICATOR_POS = 15;
+            static constexpr size_t PASS_START_POS = 17;
+
+            /**
+             * @brief Creates a view over a raw OSA buffer.
+             * @param data A pointer to the first byte of the OSA. The buffer is not copied.
+             * @param size The number of bytes available at `data`. What to send: Exactly 96.
+             * @param card_effective_date_in_minutes The card's effective date in minutes since the Unix epoch.
+             * @throws std::invalid_argument if `size` is not exactly 96 bytes.
+             */
+            view(const uint8_t* data, const size_t size, const std::time_t card_effective_date_in_minutes)
+                : data_(data), card_effective_date_in_minutes_(card_effective_date_in_minutes) {
+                if (size != container::BLOCK_SIZE)
+                    throw metrics::counted(std::invalid_argument("Input OSA data must be exactly 96 bytes."));
+            }
+
+            // --- Validation Fields ---
+
+            [[nodiscard]] uint16_t get_validation_station_id() const noexcept { return detail::read_u16_be(data_ + VALIDATION_STATION_OFFSET); }
+            [[nodiscard]] uint16_t get_validation_fare() const noexcept { return detail::read_u16_be(data_ + VALIDATION_FARE_OFFSET); }
+            [[nodiscard]] uint32_t get_validation_terminal_id() const noexcept { return detail::read_u24_be(data_ + VALIDATION_TERMINAL_OFFSET); }
+            [[nodiscard]] txn_status get_validation_txn_status() const noexcept { return static_cast<txn_status>(data_[VALIDATION_STATUS_OFFSET] >> 4); }
+
+            /**
+             * @brief Decodes the absolute time of the last validation.
+             * @return The validation time in milliseconds since the Unix epoch.
+             */
+            [[nodiscard]] uint64_t get_validation_date_and_time() const noexcept {
+                const uint32_t offset = detail::read_u24_be(data_ + VALIDATION_TIME_OFFSET);
+                return card_effective_date_in_minutes_.to_milliseconds(offset);
+            }
+
+            // --- Trip Pass Fields ---
+
+            [[nodiscard]] uint8_t get_trip_pass_id(const size_t index) const { return checked_pass_slot(index)[0]; }
+            [[nodiscard]] uint8_t get_trip_pass_priority(const size_t index) const { return checked_pass_slot(index)[PASS_PRIORITY_POS]; }
+            [[nodiscard]] uint16_t get_trip_pass_trips_allotted(const size_t index) const { return detail::read_u16_be(checked_pass_slot(index) + PASS_ALLOTTED_POS); }
+            [[nodiscard]] uint16_t get_trip_pass_remaining_trips(const size_t index) const { return detail::read_u16_be(checked_pass_slot(index) + PASS_REMAINING_POS); }
+            [[nodiscard]] uint16_t get_trip_pass_source_id(const size_t index) const { return detail::read_u16_be(checked_pass_slot(index) + PASS_SOURCE_POS); }
+            [[nodiscard]] uint16_t get_trip_pass_destination_id(const size_t index) const { return detail::read_u16_be(checked_pass_slot(index) + PASS_DESTINATION_POS); }
+            [[nodiscard]] uint8_t get_trip_pass_daily_trip_counter(const size_t index) const { return checked_pass_slot(index)[PASS_DAILY_COUNTER_POS]; }
+            [[nodiscard]] uint16_t get_trip_pass_daily_trip_indicator(const size_t index) const { return detail::read_u16_be(checked_pass_slot(index) + PASS_DAILY_INDICATOR_POS); }
+
+            /**
+             * @brief Decodes the expiry time of a trip pass slot.
+             * @param index The trip pass slot. What to send: A value in [0, NUM_TRIP_PASSES - 1].
+             * @return The expiry time in milliseconds since the Unix epoch.
+             * @throws std::out_of_range if `index` is not a valid slot.
+             */
+            [[nodiscard]] uint64_t get_trip_pass_expiry(const size_t index) const {
+                return static_cast<uint64_t>(detail::read_u24_be(checked_pass_slot(index) + PASS_EXPIRY_POS)) * 1000;
+            }
+
+            /**
+             * @brief Decodes the start (activation) time of a trip pass slot.
+             * @param index The trip pass slot. What to send: A value in [0, NUM_TRIP_PASSES - 1].
+             * @return The start time in milliseconds since the Unix epoch.
+             * @throws std::out_of_range if `index` is not a valid slot.
+             */
+            [[nodiscard]] uint64_t get_trip_pass_start_date_and_time(const size_t index) const {
+                return static_cast<uint64_t>(detail::read_u24_be(checked_pass_slot(index) + PASS_START_POS)) * 1000;
+            }
+
+            // --- Escape Hatch ---
+
+            /**
+             * @brief Fully parses the viewed bytes into a mutable `osa::container`.
+             * @return A container with its effective date set and all blocks decoded.
+             */
+            [[nodiscard]] container to_container() const {
+                container c;
+                c.set_card_effective_date(*card_effective_date_in_minutes_);
+                c.parse(data_, container::BLOCK_SIZE);
+                return c;
+            }
+
+            [[nodiscard]] const uint8_t* data() const noexcept { return data_; }
+            [[nodiscard]] std::time_t get_card_effective_date() const noexcept { return *card_effective_date_in_minutes_; }
+
+        private:
+
+            [[nodiscard]] const uint8_t* checked_pass_slot(const size_t index) const {
+                if (index >= container::NUM_TRIP_PASSES) throw metrics::counted(std::out_of_range("Trip pass index is out of bounds."));
+                return data_ + container::TRIP_PASS_START_OFFSET + (index * trip_pass::DATA_SIZE);
+            }
+
+            //! The viewed buffer. Not owned.
+            const uint8_t* data_;
+            //! The base date for time calculations, in minutes since epoch.
+            effective_epoch card_effective_date_in_minutes_;
+        };
+
+        /**
+         * @struct compact_card
+         * @brief A trivially copyable, fixed-size snapshot of one OSA: the raw 96-byte image plus its effective date.
+         *
+         * @details `container` keeps each decoded block alongside its own copy of the effective date, which makes
+         *          it several times larger than the card it models. `compact_card` stores the on-card bytes
+         *          verbatim and the effective date exactly once, with no padding (104 bytes). It can be
+         *          `memcpy`-ed, kept in large arrays (deny lists, risk scoring caches) and placed in memory shared
+         *          between processes. Fields are read through `get_view()` without decoding the whole card, and
+         *          `to_container()` / `store()` convert to and from the mutable representation.
+         *
+         * @usage
+         * @code
+         *     std::vector<osa::compact_card> hot_cards;
+         *     hot_cards.push_back(osa::compact_card::from_container(card));
+         *     const osa::view fields = hot_cards.back().get_view();
+         * @endcode
+         */
+        struct compact_card {
+            //! The size of the stored card image in bytes.
+            static constexpr size_t IMAGE_SIZE = container::BLOCK_SIZE;
+
+            //! The on-card bytes, exactly as `container::serialize_into()` writes them.
+            std::array<uint8_t, IMAGE_SIZE> image;
+            //! The card effective date in minutes since the Unix epoch. A fixed-width integer so the
+            //! representation is identical across processes that share it.
+            int64_t card_effective_date_in_minutes;
+
+            /**
+             * @brief Captures a container.
+             * @param card The container to snapshot. What to send: a container whose effective date is set.
+             * @throws std::logic_error if the container's effective date has not been set.
+             */
+            [[nodiscard]] static compact_card from_container(const container& card) {
+                compact_card compact{};
+                compact.store(card);
+                return compact;
+            }
+
+            /**
+             * @brief Overwrites this snapshot with `card`, in place.
+             * @throws std::logic_error if the container's effective date has not been set.
+             */
+            void store(const container& card) {
+                card_effective_date_in_minutes = static_cast<int64_t>(card.get_card_effective_date());
+                card.serialize_into(image.data());
+            }
+
+            //! Fully decodes the snapshot into a mutable container.
+            [[nodiscard]] container to_container() const { return get_view().to_container(); }
+
+            //! Returns a zero-copy view of the stored image. The view is valid while this object is alive and unchanged.
+            [[nodiscard]] view get_view() const {
+                return { image.data(), IMAGE_SIZE, static_cast<std::time_t>(card_effective_date_in_minutes) };
+            }
+
+            //! The same hash as `container::hash()` for the container this snapshot was taken from.
+            [[nodiscard]] uint64_t hash() const noexcept {
+                return detail::hash_card(image.data(), IMAGE_SIZE, card_effective_date_in_minutes);
+            }
+
+            friend bool operator==(const compact_card& lhs, const compact_card& rhs) noexcept {
+                return lhs.card_effective_date_in_minutes == rhs.card_effective_date_in_minutes && lhs.image == rhs.image;
+            }
+            friend bool operator!=(const compact_card& lhs, const compact_card& rhs) noexcept { return !(lhs == rhs); }
+        };
+
+        static_assert(std::is_trivially_copyable_v<compact_card> && std::is_standard_layout_v<compact_card>,
+                      "compact_card must stay safe to memcpy and to place in shared memory.");
+        static_assert(sizeof(compact_card) == compact_card::IMAGE_SIZE + sizeof(int64_t), "compact_card must not contain padding.");
+
     }
 
 }
+
+/**
+ * @brief `std::hash` specializations so containers and compact snapshots can be keys of unordered containers.
+ * @details All of them forward to the types' own `hash()`, which hashes the canonical card bytes. Pair them with
+ *          an equality that agrees, e.g. `operator==` or a functor calling `equals_canonical()`.
+ */
+namespace std {
+
+    template <>
+    struct hash<open_loop::csa::container> {
+        size_t operator()(const open_loop::csa::container& card) const noexcept { return static_cast<size_t>(card.hash()); }
+    };
+
+    template <typename Layout>
+    struct hash<open_loop::osa::basic_container<Layout>> {
+        size_t operator()(const open_loop::osa::basic_container<Layout>& card) const noexcept { return static_cast<size_t>(card.hash()); }
+    };
+
+    template <>
+    struct hash<open_loop::csa::compact_card> {
+        size_t operator()(const open_loop::csa::compact_card& card) const noexcept { return static_cast<size_t>(card.hash()); }
+    };
+
+    template <>
+    struct hash<open_loop::osa::compact_card> {
+        size_t operator()(const open_loop::osa::compact_card& card) const noexcept { return static_cast<size_t>(card.hash()); }
+    };
+
+}
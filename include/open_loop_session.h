@@ -0,0 +1,238 @@
+/**
+ * @file open_loop_session.h
+ * @brief Per-gate and per-card contexts that share the terminal, route, fare table and effective date
+ *        across every container a gate touches.
+ * @details A gate sees thousands of cards a day, and every tap used to rebuild the same inputs: parse the
+ *          terminal ID string, copy the terminal into the validation block and the new log, look up the
+ *          operator and route for pricing, and set the effective date on each container and block.
+ *
+ *          - `csa::gate_context` is built once per gate. It holds the terminal, the route, an optional
+ *            `fare_table` and a `tap_engine` whose terminal bytes are encoded at construction.
+ *          - `csa::card_session` is opened per card from a gate context. It carries the card's
+ *            `effective_epoch`, built once, and applies taps to a `csa::container` or to the raw buffer.
+ *
+ *          The blocks of a container keep their own copy of the terminal: a parsed card holds the
+ *          terminals of other gates, and a 6-byte copy is cheaper than any indirection. What the session
+ *          removes is the per-tap setup in front of those copies.
+ *
+ * @author Govind Yadav
+ * @version 1.1
+ * @date 2025-09-08
+ */
+
+#pragma once
+#include <cstdint>
+#include <ctime>
+#include "open_loop_service.h"
+#include "open_loop_fare.h"
+#include "open_loop_tap.h"
+
+namespace open_loop {
+
+    namespace csa {
+
+        class card_session;
+
+        /**
+         * @class gate_context
+         * @brief The fixed inputs of one gate, shared by every card session it opens.
+         *
+         * @details Immutable after construction, so one context may serve several reader threads. The
+         *          fare table is referenced, not copied, and must outlive the context.
+         *
+         * @usage
+         * @code
+         *     const csa::gate_context gate(gate_terminal, 42, &fares);
+         *     for (;;) {
+         *         const csa::card_session session = gate.open(effective_date);
+         *         csa::container card;
+         *         if (session.parse(card, rx_buffer, 96) != status_code::ok) continue;
+         *         const csa::tap_result r = session.tap(card, now_ms, txn_status::ENTRY);
+         *         if (r.ok()) write_back(card.patch_into(rx_buffer));
+         *     }
+         * @endcode
+         */
+        class gate_context {
+        public:
+
+            /**
+             * @brief Builds the context of one gate.
+             * @param terminal_info The terminal written into the validation block and every new log.
+             * @param route_number The route written into the validation block and used for fare lookups.
+             * @param fares The fare table used by `card_session::quote()` and `tap()`. What to send: a table
+             *              that outlives this context, or `nullptr` if fares are always passed explicitly.
+             */
+            explicit gate_context(const terminal& terminal_info, const uint16_t route_number = 0,
+                                  const fare_table* fares = nullptr) noexcept
+                : terminal_(terminal_info), route_number_(route_number), fares_(fares), engine_(terminal_info, route_number) {}
+
+            /**
+             * @brief Opens a session for one card.
+             * @param card_effective_date_in_minutes The card's effective date in minutes since the Unix epoch.
+             * @note The session refers to this context and must not outlive it.
+             */
+            [[nodiscard]] card_session open(effective_epoch card_effective_date_in_minutes) const noexcept;
+
+            [[nodiscard]] const terminal& get_terminal() const noexcept { return terminal_; }
+            [[nodiscard]] uint16_t get_operator_id() const noexcept { return terminal_.get_operator_id(); }
+            [[nodiscard]] uint16_t get_route_number() const noexcept { return route_number_; }
+            //! The fare table, or `nullptr` if none was given.
+            [[nodiscard]] const fare_table* get_fare_table() const noexcept { return fares_; }
+            //! The raw-buffer engine for this terminal and route.
+            [[nodiscard]] const tap_engine& get_engine() const noexcept { return engine_; }
+
+        private:
+            terminal terminal_;
+            uint16_t route_number_;
+            const fare_table* fares_;
+            tap_engine engine_;
+        };
+
+        /**
+         * @class card_session
+         * @brief One card at one gate: parses, prices and records taps with the gate's shared inputs.
+         *
+         * @details `record_tap()` makes the same update as `tap_engine::apply()` (see there for the steps),
+         *          but on a decoded `container`, so that deny-list checks, pass logic or logging can inspect
+         *          the card before and after. Every check is made before the container is modified, and
+         *          `patch_into()` afterwards yields exactly the bytes `apply()` would have written.
+         *
+         *          A session is a small value (a pointer and an epoch); open one per tap or keep it for as
+         *          long as the card stays in the field.
+         */
+        class card_session {
+        public:
+
+            [[nodiscard]] const gate_context& get_gate() const noexcept { return *gate_; }
+            [[nodiscard]] const effective_epoch& get_card_epoch() const noexcept { return card_effective_date_; }
+
+            /**
+             * @brief Decodes the card into `card` with this session's effective date.
+             * @param card The container to fill. Its effective date is replaced by the session's.
+             * @param data A pointer to the first byte of the CSA.
+             * @param size The number of bytes at `data`. What to send: Exactly 96.
+             * @return The result of `container::try_parse()`, or `effective_date_not_set` if the session has none.
+             */
+            [[nodiscard]] status_code parse(container& card, const uint8_t* data, const size_t size) const noexcept {
+                if (!card_effective_date_.has_value()) return status_code::effective_date_not_set;
+                card.set_card_effective_date(*card_effective_date_);
+                return card.try_parse(data, size);
+            }
+
+            /**
+             * @brief Prices a tap with the gate's fare table, operator and route.
+             * @param card The CSA before the tap.
+             * @param time_in_milliseconds The tap time in milliseconds since the Unix epoch.
+             * @return The quote, or `status_code::no_fare_rule` if the gate has no fare table.
+             */
+            [[nodiscard]] fare_quote quote(const container& card, const uint64_t time_in_milliseconds) const noexcept {
+                if (gate_->get_fare_table() == nullptr) {
+                    fare_quote q;
+                    q.status = status_code::no_fare_rule;
+                    return q;
+                }
+                return gate_->get_fare_table()->evaluate(card, gate_->get_operator_id(), gate_->get_route_number(), time_in_milliseconds);
+            }
+
+            /**
+             * @brief Records a tap on a decoded card: pushes a new log and rewrites the validation block.
+             * @param card The card, decoded by `parse()` or otherwise given this session's effective date.
+             * @param time_in_milliseconds The tap time in milliseconds since the Unix epoch.
+             * @param fare The amount to debit from the card balance. Zero for a plain entry.
+             * @param status The status recorded in both the validation block and the new log.
+             * @return The status and the new balance and sequence number. `dirty` is left empty: the
+             *         container is updated, so call `card.patch_into()` to get the bytes to write.
+             *         `effective_date_not_set` if `card` does not share this session's effective date;
+             *         `card` is unchanged on any failure.
+             */
+            [[nodiscard]] tap_result record_tap(container& card, const uint64_t time_in_milliseconds, const uint16_t fare,
+                                                const txn_status status) const noexcept {
+                tap_result result;
+                if (!card_effective_date_.has_value() || card.get_card_epoch() != card_effective_date_) {
+                    result.status = status_code::effective_date_not_set;
+                    return result;
+                }
+
+                // --- Validate everything before the first write ---
+                uint32_t time_offset = 0;
+                result.status = detail::encode_time_offset(card_effective_date_, time_in_milliseconds, time_offset);
+                if (!result.ok()) return result;
+
+                history& logs = card.get_history();
+                uint32_t balance = 0;
+                uint16_t sq_no = 0;
+                if (logs.get_valid_log_count() > 0) {
+                    const log& latest = logs.get_log_unchecked(0);
+                    balance = latest.get_card_balance();
+                    sq_no = latest.get_txn_sq_no();
+                }
+                if (fare > balance) {
+                    result.status = status_code::insufficient_balance;
+                    return result;
+                }
+                result.card_balance = balance - fare;
+                result.txn_sq_no = static_cast<uint16_t>(sq_no + 1);
+
+                // --- Apply; none of these can fail after the checks above ---
+                log entry;
+                entry.set_card_effective_date(card_effective_date_);
+                entry.set_terminal_info(gate_->get_terminal());
+                (void)entry.try_set_date_and_time(time_in_milliseconds);
+                entry.set_txn_amount(fare);
+                entry.set_txn_sq_no(result.txn_sq_no);
+                (void)entry.try_set_card_balance(result.card_balance);
+                entry.set_txn_status(status);
+                logs.add_log(entry);
+
+                validation& v = card.get_validation();
+                v.set_error_code(0);
+                v.set_terminal_info(gate_->get_terminal());
+                (void)v.try_set_date_and_time(time_in_milliseconds);
+                v.set_fare_amount(fare);
+                v.set_route_number(gate_->get_route_number());
+                v.set_txn_status(status);
+                return result;
+            }
+
+            /**
+             * @brief Prices a tap with `quote()` and records it with `record_tap()`.
+             * @return The quote's status if pricing failed, otherwise the result of `record_tap()`.
+             */
+            [[nodiscard]] tap_result tap(container& card, const uint64_t time_in_milliseconds, const txn_status status) const noexcept {
+                const fare_quote q = quote(card, time_in_milliseconds);
+                if (!q.ok()) {
+                    tap_result result;
+                    result.status = q.status;
+                    return result;
+                }
+                return record_tap(card, time_in_milliseconds, q.fare, status);
+            }
+
+            /**
+             * @brief Applies a tap to the raw CSA in place with the gate's `tap_engine`.
+             * @param card A pointer to the first byte of the CSA. Modified only if the tap succeeds.
+             * @param size The number of bytes at `card`. What to send: Exactly 96.
+             * @return See `tap_engine::apply()`.
+             */
+            [[nodiscard]] tap_result apply(uint8_t* card, const size_t size, const uint64_t time_in_milliseconds,
+                                           const uint16_t fare, const txn_status status) const noexcept {
+                return gate_->get_engine().apply(card, size, { card_effective_date_, time_in_milliseconds, fare, status });
+            }
+
+        private:
+            friend class gate_context;
+
+            card_session(const gate_context& gate, const effective_epoch card_effective_date_in_minutes) noexcept
+                : gate_(&gate), card_effective_date_(card_effective_date_in_minutes) {}
+
+            const gate_context* gate_;
+            effective_epoch card_effective_date_;
+        };
+
+        inline card_session gate_context::open(const effective_epoch card_effective_date_in_minutes) const noexcept {
+            return card_session(*this, card_effective_date_in_minutes);
+        }
+
+    }
+
+}
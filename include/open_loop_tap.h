@@ -0,0 +1,191 @@
+/**
+ * @file open_loop_tap.h
+ * @brief A single-call read-validate-debit-write engine for CSA gate taps.
+ * @details The classic integration of a tap parses the whole CSA into a `csa::container`, reads the latest
+ *          log, builds a new `csa::log` through a chain of validating setters, pushes it into the history,
+ *          updates the validation block and serializes everything back. Each step re-validates and copies
+ *          objects that the next step immediately replaces.
+ *
+ *          `csa::tap_engine` performs the same update directly on the raw 96-byte buffer. The terminal is
+ *          encoded once when the engine is built, every check on the request is done before the first byte
+ *          is written, and the write-back reports only the bytes that changed. A failed tap leaves the
+ *          buffer untouched.
+ *
+ * @author Govind Yadav
+ * @version 1.1
+ * @date 2025-09-08
+ */
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include "open_loop_service.h"
+
+namespace open_loop {
+
+    namespace csa {
+
+        /**
+         * @struct tap_request
+         * @brief The per-tap inputs of `tap_engine::apply()`.
+         */
+        struct tap_request {
+            //! The card's effective date. What to send: minutes since the Unix epoch, or a container's `get_card_epoch()`.
+            effective_epoch card_effective_date;
+            //! The absolute time of the tap in milliseconds since the Unix epoch.
+            uint64_t time_in_milliseconds{ 0 };
+            //! The amount to debit from the card balance. Zero for a plain entry.
+            uint16_t fare{ 0 };
+            //! The status recorded in both the validation block and the new log.
+            txn_status status{ txn_status::ENTRY };
+        };
+
+        /**
+         * @struct tap_result
+         * @brief The outcome of `tap_engine::apply()`.
+         */
+        struct tap_result {
+            //! `status_code::ok`, or the reason the tap was rejected. The buffer is unchanged on failure.
+            status_code status{ status_code::ok };
+            //! The byte ranges of the card that changed and must be written back.
+            dirty_ranges dirty;
+            //! The card balance after the debit.
+            uint32_t card_balance{ 0 };
+            //! The sequence number of the log that was written.
+            uint16_t txn_sq_no{ 0 };
+
+            [[nodiscard]] bool ok() const noexcept { return status == status_code::ok; }
+        };
+
+        /**
+         * @class tap_engine
+         * @brief Applies an entry/exit/penalty tap to a raw CSA in one pass over the buffer.
+         *
+         * @details Per tap, the engine:
+         *          1. checks the buffer size and converts the tap time into the 24-bit minute offset;
+         *          2. reads the balance and sequence number of the newest log (an empty history means balance 0);
+         *          3. rejects the tap with `status_code::insufficient_balance` if the fare exceeds the balance;
+         *          4. pushes a new log (this terminal, the tap time, the fare, sequence number + 1, the new
+         *             balance and the status) onto the history, dropping the oldest log when it is full;
+         *          5. rewrites the validation block with this terminal, route, tap time, fare and status, clears
+         *             its error code and keeps its product type, service provider data and RFU bits.
+         *
+         *          The result is byte-for-byte what the equivalent `csa::container` calls followed by
+         *          `patch_into()` produce. One engine is built per gate and reused for every tap; `apply()`
+         *          is `const` and may be called from several threads at once on different buffers.
+         *
+         * @usage
+         * @code
+         *     const csa::tap_engine gate(terminal_info, route_number);
+         *     const csa::tap_result r = gate.apply(rx_buffer, 96, { effective_date, now_ms, 1500, txn_status::EXIT });
+         *     if (r.ok()) write_blocks(rx_buffer, r.dirty.block_mask(16));
+         * @endcode
+         */
+        class tap_engine {
+        public:
+
+            /**
+             * @brief Builds an engine for one terminal.
+             * @param terminal_info The terminal written into the validation block and every log.
+             * @param route_number The route written into the validation block.
+             */
+            explicit tap_engine(const terminal& terminal_info, const uint16_t route_number = 0) noexcept
+                : route_number_(route_number) {
+                terminal_info.serialize_into(terminal_bytes_.data());
+            }
+
+            /**
+             * @brief Applies a tap to the CSA in place.
+             * @param card A pointer to the first byte of the CSA. Modified only if the tap succeeds.
+             * @param size The number of bytes at `card`. What to send: Exactly 96.
+             * @param request The effective date, time, fare and status of the tap.
+             * @return The status, the changed ranges, and the new balance and sequence number.
+             */
+            [[nodiscard]] tap_result apply(uint8_t* card, const size_t size, const tap_request& request) const noexcept {
+                tap_result result;
+                if (size != container::TOTAL_SIZE) {
+                    result.status = status_code::invalid_size;
+                    return result;
+                }
+
+                // --- Validate everything before the first write ---
+                uint32_t time_offset = 0;
+                result.status = detail::encode_time_offset(request.card_effective_date, request.time_in_milliseconds, time_offset);
+                if (!result.ok()) return result;
+
+                const uint8_t* latest = card + container::HISTORY_OFFSET;
+                uint32_t balance = 0;
+                uint16_t sq_no = 0;
+                if (!detail::is_zero_filled(latest, history::LOG_SIZE_BYTES)) {
+                    balance = (static_cast<uint32_t>(latest[view::LOG_BALANCE_POS]) << 12) |
+                              (static_cast<uint32_t>(latest[view::LOG_BALANCE_POS + 1]) << 4) |
+                              (latest[view::LOG_BALANCE_POS + 2] >> 4);
+                    sq_no = detail::read_u16_be(latest + view::LOG_SQ_NO_POS);
+                }
+                if (request.fare > balance) {
+                    result.status = status_code::insufficient_balance;
+                    return result;
+                }
+                result.card_balance = balance - request.fare;
+                result.txn_sq_no = static_cast<uint16_t>(sq_no + 1);
+
+                // --- Build the updated card in a scratch copy ---
+                std::array<uint8_t, container::TOTAL_SIZE> fresh;
+                std::copy(card, card + container::TOTAL_SIZE, fresh.begin());
+                const uint8_t status = static_cast<uint8_t>(request.status) & 0x0F;
+
+                std::array<uint8_t, history::LOG_SIZE_BYTES> entry;
+                std::copy(terminal_bytes_.begin(), terminal_bytes_.end(), entry.begin());
+                detail::write_u24_be(entry.data() + view::LOG_TIME_POS, time_offset);
+                detail::write_u16_be(entry.data() + view::LOG_AMOUNT_POS, request.fare);
+                detail::write_u16_be(entry.data() + view::LOG_SQ_NO_POS, result.txn_sq_no);
+                // 20-bit balance in the upper bits of bytes 13-15; the low nibble of byte 15 is always 0x0F.
+                entry[view::LOG_BALANCE_POS] = static_cast<uint8_t>(result.card_balance >> 12);
+                entry[view::LOG_BALANCE_POS + 1] = static_cast<uint8_t>(result.card_balance >> 4);
+                entry[view::LOG_BALANCE_POS + 2] = static_cast<uint8_t>(((result.card_balance & 0x0F) << 4) | 0x0F);
+                entry[view::LOG_STATUS_POS] = static_cast<uint8_t>(status << 4);
+                history::push_log_into(fresh.data() + container::HISTORY_OFFSET, entry.data());
+
+                uint8_t* validation_block = fresh.data() + container::VALIDATION_OFFSET;
+                validation_block[0] = 0; // Error code
+                std::copy(terminal_bytes_.begin(), terminal_bytes_.end(), fresh.data() + view::VALIDATION_TERMINAL_OFFSET);
+                detail::write_u24_be(fresh.data() + view::VALIDATION_TIME_OFFSET, time_offset);
+                detail::write_u16_be(fresh.data() + view::VALIDATION_FARE_OFFSET, request.fare);
+                detail::write_u16_be(fresh.data() + view::VALIDATION_ROUTE_OFFSET, route_number_);
+                uint8_t& status_byte = fresh[view::VALIDATION_STATUS_OFFSET];
+                status_byte = static_cast<uint8_t>((status << 4) | (status_byte & 0x0F));
+
+                // --- Write back only what changed ---
+                for (const byte_range& region : container::PATCH_REGIONS)
+                    detail::patch_region(fresh.data(), card, region, result.dirty);
+                return result;
+            }
+
+            /**
+             * @brief Applies a tap to a copy of the CSA, leaving the input untouched.
+             * @param card The 96 bytes read from the card.
+             * @param size The number of bytes at `card`. What to send: Exactly 96.
+             * @param request The effective date, time, fare and status of the tap.
+             * @param out Receives the patched card. What to send: 96 writable bytes. Holds a copy of `card` on failure.
+             */
+            [[nodiscard]] tap_result apply(const uint8_t* card, const size_t size, const tap_request& request, uint8_t* out) const noexcept {
+                if (size != container::TOTAL_SIZE) {
+                    tap_result result;
+                    result.status = status_code::invalid_size;
+                    return result;
+                }
+                std::copy(card, card + container::TOTAL_SIZE, out);
+                return apply(out, size, request);
+            }
+
+            [[nodiscard]] uint16_t get_route_number() const noexcept { return route_number_; }
+
+        private:
+            //! The terminal, serialized once at construction.
+            std::array<uint8_t, terminal::DATA_SIZE> terminal_bytes_{};
+            uint16_t route_number_;
+        };
+
+    }
+
+}
@@ -0,0 +1,243 @@
+/**
+ * @file open_loop_osa.cpp
+ * @brief Out-of-line, cold-path members of the OSA blocks (stream reports, debug strings, the throwing
+ *        setters and parsers, `to_bytes()`) and the standard-layout instantiation.
+ * @details `osa::container` is compiled here once; the header declares it `extern template` so that
+ *          other translation units link against this copy instead of instantiating their own.
+ *
+ * @author Govind Yadav
+ * @version 1.1
+ * @date 2025-09-08
+ */
+
+#include "open_loop_service.h"
+#include <bitset>
+#include <ostream>
+
+namespace open_loop {
+
+    namespace detail {
+
+        std::ostream& write_osa_history(std::ostream& os, const effective_epoch& card_effective_date,
+                                        const osa::transaction_record* const* logs, const size_t count) {
+            os << "======================== OSA: HISTORY DATA ========================" << std::endl;
+            os << "  CARD EFFECTIVE DATE (MINS): ";
+            if (card_effective_date.has_value()) {
+                os << *card_effective_date << std::endl;
+            } else {
+                os << "[Not Set]" << std::endl;
+            }
+            os << "  VALID LOG COUNT           : " << count << std::endl;
+
+            if (count > 0) {
+                // Add a newline between entries but not after the last one.
+                for (size_t i = 0; i < count; ++i) os << *logs[i] << (i < count - 1 ? "\n" : "");
+            } else {
+                os << "  [No log entries]";
+            }
+            os << "\n=================================================================";
+            return os;
+        }
+
+        std::ostream& write_osa_container_head(std::ostream& os, const osa::general& general, const osa::transaction_record& validation) {
+            os << "==================== OPERATOR SERVICE AREA (OSA) ====================" << std::endl;
+            os << general << std::endl;
+            return os << validation << std::endl;
+        }
+
+        std::ostream& write_osa_container_tail(std::ostream& os, const osa::trip_pass* trip_passes, const size_t count, const size_t padding_size) {
+            os << std::endl;
+            for (size_t i = 0; i < count; ++i) os << trip_passes[i] << (i < count - 1 ? "\n" : "");
+            os << std::endl << "-------------------------- PADDING ---------------------------" << std::endl;
+            os << "  " << padding_size << " byte(s) of padding appended during serialization." << std::endl;
+            os << "=================================================================";
+            return os;
+        }
+
+    }
+
+    namespace osa {
+
+        void general::set_version(const uint8_t major, const uint8_t minor, const uint8_t patch) {
+            if (major > MAJOR_VERSION_MAX) throw metrics::counted(std::out_of_range("Major version must be in the range [0, 7]."));
+            if (minor > MINOR_VERSION_MAX) throw metrics::counted(std::out_of_range("Minor version must be in the range [0, 7]."));
+            if (patch > PATCH_VERSION_MAX) throw metrics::counted(std::out_of_range("Patch version must be in the range [0, 3]."));
+            major_version_ = major;
+            minor_version_ = minor;
+            patch_version_ = patch;
+        }
+
+        void general::set_rfu(const uint8_t value) {
+            if (value > RFU_MAX) throw metrics::counted(std::out_of_range("RFU value must be in the range [0, 3]."));
+            rfu_ = value;
+        }
+
+        general general::parse(const std::vector<uint8_t>& data) {
+            return parse(data.data(), data.size());
+        }
+
+        general general::parse(const uint8_t* data, const size_t size) {
+            if (size != DATA_SIZE) throw metrics::counted(std::invalid_argument("OSA General data must be exactly 7 bytes."));
+            return try_parse(data, size).value();
+        }
+
+        std::vector<uint8_t> general::to_bytes() const {
+            std::vector<uint8_t> data(DATA_SIZE);
+            serialize_into(data.data());
+            return data;
+        }
+
+        std::string general::get_version_string() const {
+            return std::to_string(major_version_) + "." + std::to_string(minor_version_) + "." + std::to_string(patch_version_);
+        }
+
+        std::string general::get_service_status_string() const {
+            return (status_ == service_status::active) ? "Active" : "Inactive";
+        }
+
+        std::string general::get_language_string() const {
+            // This helper provides a more user-friendly output than just the raw enum value.
+            switch (language_) {
+                case language_code::English: return "English";
+                case language_code::Hindi:   return "Hindi";
+                case language_code::Marathi: return "Marathi";
+                default: return "Unknown";
+            }
+        }
+
+        void transaction_record::set_date_and_time(const uint64_t absolute_time_in_milliseconds) {
+            if (const status_code code = try_set_date_and_time(absolute_time_in_milliseconds); code != status_code::ok)
+                detail::throw_status(code);
+        }
+
+        void transaction_record::set_rfu(const uint8_t value) {
+            if (value > RFU_MAX) throw metrics::counted(std::out_of_range("RFU value must be in the range [0, 15]."));
+            rfu_ = value;
+        }
+
+        transaction_record transaction_record::parse(const std::vector<uint8_t>& data, std::time_t card_effective_date_in_minutes) {
+            return parse(data.data(), data.size(), card_effective_date_in_minutes);
+        }
+
+        transaction_record transaction_record::parse(const uint8_t* data, const size_t size, std::time_t card_effective_date_in_minutes) {
+            if (size != DATA_SIZE) throw metrics::counted(std::invalid_argument("OSA Transaction Record data must be 13 bytes."));
+            return try_parse(data, size, card_effective_date_in_minutes).value();
+        }
+
+        std::vector<uint8_t> transaction_record::to_bytes() const {
+            std::vector<uint8_t> data(DATA_SIZE);
+            serialize_into(data.data());
+            return data;
+        }
+
+        std::time_t transaction_record::get_card_effective_date() const {
+            if (!card_effective_date_in_minutes_.has_value()) {
+                throw metrics::counted(std::logic_error("Card effective date has not been set for this record."));
+            }
+            return *card_effective_date_in_minutes_;
+        }
+
+        std::string transaction_record::get_txn_status_string() const {
+            return to_string(status_);
+        }
+
+        void trip_pass::set_pass_expiry(const uint64_t time_in_milliseconds) {
+            if (try_set_pass_expiry(time_in_milliseconds) != status_code::ok)
+                throw metrics::counted(std::out_of_range("Pass expiry time exceeds 24-bit storage limit."));
+        }
+
+        void trip_pass::set_start_date_and_time(const uint64_t time_in_milliseconds) {
+            if (try_set_start_date_and_time(time_in_milliseconds) != status_code::ok)
+                throw metrics::counted(std::out_of_range("Start time exceeds 24-bit storage limit."));
+        }
+
+        void trip_pass::set_remaining_trips(const uint16_t trips) {
+            if (const status_code code = try_set_remaining_trips(trips); code != status_code::ok)
+                detail::throw_status(code);
+        }
+
+        trip_pass trip_pass::parse(const std::vector<uint8_t>& data) {
+            return parse(data.data(), data.size());
+        }
+
+        trip_pass trip_pass::parse(const uint8_t* data, const size_t size) {
+            if (size != DATA_SIZE) throw metrics::counted(std::invalid_argument("OSA Trip Pass data must be 20 bytes."));
+            return try_parse(data, size).value();
+        }
+
+        std::vector<uint8_t> trip_pass::to_bytes() const {
+            std::vector<uint8_t> data(DATA_SIZE);
+            serialize_into(data.data());
+            return data;
+        }
+
+        std::ostream& operator<<(std::ostream& os, const general& obj) {
+            os << "-------------------- OSA: GENERAL DATA ---------------------" << std::endl;
+            os << "  VERSION                : " << obj.get_version_string() << std::endl;
+            os << "  PHONE NUMBER           : " << obj.get_phone_number() << std::endl;
+            os << "  LANGUAGE               : " << obj.get_language_string() << " (Code: " << static_cast<int>(obj.get_language()) << ")" << std::endl;
+            os << "  SERVICE STATUS         : " << obj.get_service_status_string() << std::endl;
+            os << "  RFU (BINARY)           : " << std::bitset<2>(obj.get_rfu()) << std::endl;
+            os << "------------------------------------------------------------";
+            return os;
+        }
+
+        std::ostream& operator<<(std::ostream& os, const transaction_record& obj) {
+            os << "---------------- OSA: TRANSACTION RECORD -----------------" << std::endl;
+            os << "  ERROR CODE             : " << static_cast<int>(obj.error_code_) << std::endl;
+            os << "  PRODUCT TYPE           : " << static_cast<int>(obj.product_type_) << std::endl;
+            try {
+                // **BUG FIX**: Convert milliseconds from get_date_and_time() to seconds for std::gmtime.
+                const std::time_t t_sec = obj.get_date_and_time() / 1000;
+                char time_str[100];
+                if (std::strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", std::gmtime(&t_sec))) {
+                    os << "  DATE AND TIME          : " << time_str << " (UTC)" << std::endl;
+                }
+            } catch (const std::logic_error& e) {
+                os << "  DATE AND TIME          : " << "[Not available: " << e.what() << "]" << std::endl;
+            }
+            os << "  STATION ID             : " << obj.station_id_ << std::endl;
+            os << "  FARE                   : " << obj.fare_ << std::endl;
+            os << "  TERMINAL ID            : 0x" << codec::hex_u24(obj.terminal_id_) << std::endl;
+            // **IMPROVEMENT**: Use the helper method for a more readable status.
+            os << "  TRANSACTION STATUS     : " << obj.get_txn_status_string() << std::endl;
+            os << "  RFU (BINARY)           : " << std::bitset<4>(obj.rfu_) << std::endl;
+            os << "------------------------------------------------------------";
+            return os;
+        }
+
+        std::ostream& operator<<(std::ostream& os, const trip_pass& obj) {
+            // A stateless lambda function to format a millisecond timestamp into a human-readable UTC string.
+            // This avoids duplicating formatting code. `auto` deduces the lambda's type.
+            auto format_time_ms = [](const uint64_t t_ms) {
+                char buf[100];
+                // Convert milliseconds to seconds for std::gmtime.
+                const std::time_t t_sec = t_ms / 1000;
+                // Format the time. The `gmtime` function is used for UTC.
+                std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", std::gmtime(&t_sec));
+                return std::string(buf);
+            };
+
+            os << "--------------------- OSA: TRIP PASS ---------------------" << std::endl;
+            // Cast 8-bit integers to `int` for printing as numbers instead of characters.
+            os << "  PASS ID                : " << static_cast<int>(obj.pass_id_) << std::endl;
+            os << "  PASS EXPIRY            : " << format_time_ms(obj.get_pass_expiry()) << " (UTC)" << std::endl;
+            os << "  PRIORITY               : " << static_cast<int>(obj.priority_) << std::endl;
+            os << "  TRIPS ALLOTTED         : " << obj.trips_allotted_ << std::endl;
+            os << "  REMAINING TRIPS        : " << obj.remaining_trips_ << std::endl;
+            os << "  SOURCE ID              : " << obj.source_id_ << std::endl;
+            os << "  DESTINATION ID         : " << obj.destination_id_ << std::endl;
+            os << "  FLAGS (BINARY)         : " << std::bitset<8>(obj.flags_) << std::endl;
+            os << "  DAILY TRIP COUNTER     : " << static_cast<int>(obj.daily_trip_counter_) << std::endl;
+            os << "  DAILY TRIP INDICATOR   : " << obj.daily_trip_indicator_ << std::endl;
+            os << "  START DATE & TIME      : " << format_time_ms(obj.get_start_date_and_time()) << " (UTC)" << std::endl;
+            os << "------------------------------------------------------------";
+            return os;
+        }
+
+        template class basic_history<standard_layout::HISTORY_RECORDS>;
+        template class basic_container<standard_layout>;
+
+    }
+
+}
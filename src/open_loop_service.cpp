@@ -1 +1,306 @@
-#include "open_loop_service.h"
\ No newline at end of file
+/**
+ * @file open_loop_service.cpp
+ * @brief Out-of-line, cold-path members of the CSA blocks: stream reports, debug strings, the throwing
+ *        setters and parsers, and the allocating `to_bytes()` of each block.
+ * @details Anything that needs `<ostream>`, `<iomanip>` or `<bitset>` lives here, so that including
+ *          `open_loop_service.h` stays cheap for translation units that never print a card. The
+ *          containers decode and encode through the inline `try_parse()` and `serialize_into()`, so
+ *          nothing here is on the parse, serialize or tap path.
+ *
+ * @author Govind Yadav
+ * @version 1.1
+ * @date 2025-09-08
+ */
+
+#include "open_loop_service.h"
+#include <bitset>
+#include <iomanip>
+#include <ostream>
+
+namespace open_loop {
+
+    namespace csa {
+
+        void general::set_version(const uint8_t major, const uint8_t minor, const uint8_t patch) {
+            // Validate that the major version fits within its allocated 3 bits.
+            if (major > MAJOR_VERSION_MAX) throw metrics::counted(std::out_of_range("Major version must be in the range [0, 7]."));
+            // Validate that the minor version fits within its allocated 3 bits.
+            if (minor > MINOR_VERSION_MAX) throw metrics::counted(std::out_of_range("Minor version must be in the range [0, 7]."));
+            // Validate that the patch version fits within its allocated 2 bits.
+            if (patch > PATCH_VERSION_MAX) throw metrics::counted(std::out_of_range("Patch version must be in the range [0, 3]."));
+            // If all checks pass, assign the values to the member variables.
+            major_version_ = major;
+            minor_version_ = minor;
+            patch_version_ = patch;
+        }
+
+        void general::set_rfu(const uint8_t value) {
+            // Validate that the RFU value fits within its allocated 3 bits.
+            if (value > RFU_MAX) throw metrics::counted(std::out_of_range("RFU value must be in the range [0, 7]."));
+            rfu_ = value;
+        }
+
+        general general::parse(const std::vector<uint8_t>& data) {
+            return parse(data.data(), data.size());
+        }
+
+        general general::parse(const uint8_t* data, const size_t size) {
+            if (size != DATA_SIZE) throw metrics::counted(std::invalid_argument("General data must be exactly 2 bytes."));
+            return try_parse(data, size).value();
+        }
+
+        std::vector<uint8_t> general::to_bytes() const noexcept {
+            std::vector<uint8_t> data(DATA_SIZE);
+            serialize_into(data.data());
+            return data;
+        }
+
+        std::string general::get_version() const {
+            return std::to_string(major_version_) + "." + std::to_string(minor_version_) + "." + std::to_string(patch_version_);
+        }
+
+        std::string general::get_language_string() const {
+            switch (language_) {
+                case language_code::English: return "English";
+                case language_code::Hindi:   return "Hindi";
+                case language_code::Marathi: return "Marathi";
+                // Note: This is not an exhaustive list of all languages in the enum.
+                // The default case is crucial for handling all other defined and RFU language codes gracefully.
+                default: return "Unknown";
+            }
+        }
+
+        std::string general::get_version_string() const {
+            return std::to_string(major_version_) + "." + std::to_string(minor_version_) + "." + std::to_string(patch_version_);
+        }
+
+        terminal terminal::parse(const std::vector<uint8_t>& data) {
+            return parse(data.data(), data.size());
+        }
+
+        terminal terminal::parse(const uint8_t* data, const size_t size) {
+            if (size != DATA_SIZE) throw metrics::counted(std::invalid_argument("Terminal data must be 6 bytes."));
+            return try_parse(data, size).value();
+        }
+
+        std::vector<uint8_t> terminal::to_bytes() const noexcept {
+            std::vector<uint8_t> data(DATA_SIZE);
+            serialize_into(data.data());
+            return data;
+        }
+
+        void validation::set_date_and_time(const uint64_t absolute_time_in_milliseconds) {
+            if (const status_code code = try_set_date_and_time(absolute_time_in_milliseconds); code != status_code::ok)
+                detail::throw_status(code);
+        }
+
+        void validation::set_service_provider_data(const uint32_t data) {
+            if (data > SERVICE_DATA_MAX) throw metrics::counted(std::out_of_range("Service provider data exceeds 24-bit limit."));
+            service_provider_data_ = data;
+        }
+
+        void validation::set_rfu(const uint8_t value) {
+            if (value > RFU_MAX) throw metrics::counted(std::out_of_range("RFU value must be in the range [0, 15]."));
+            rfu_ = value;
+        }
+
+        validation validation::parse(const std::vector<uint8_t>& data, std::time_t card_effective_date_in_minutes) {
+            return parse(data.data(), data.size(), card_effective_date_in_minutes);
+        }
+
+        validation validation::parse(const uint8_t* data, const size_t size, std::time_t card_effective_date_in_minutes) {
+            if (size != DATA_SIZE) throw metrics::counted(std::invalid_argument("Validation data must be exactly 19 bytes."));
+            return try_parse(data, size, card_effective_date_in_minutes).value();
+        }
+
+        std::vector<uint8_t> validation::to_bytes() const {
+            std::vector<uint8_t> data(DATA_SIZE);
+            serialize_into(data.data());
+            return data;
+        }
+
+        std::time_t validation::get_card_effective_date() const {
+            if (!card_effective_date_in_minutes_.has_value())
+                throw metrics::counted(std::logic_error("Card effective date has not been set for this record."));
+            return *card_effective_date_in_minutes_;
+        }
+
+        std::string validation::get_service_provider_data() const {
+            return codec::hex_u24(service_provider_data_).str();
+        }
+
+        std::string validation::get_txn_status_string() const {
+            return to_string(status_);
+        }
+
+        void log::set_date_and_time(const uint64_t absolute_time_in_milliseconds) {
+            if (const status_code code = try_set_date_and_time(absolute_time_in_milliseconds); code != status_code::ok)
+                detail::throw_status(code);
+        }
+
+        void log::set_card_balance(const uint32_t balance) {
+            if (const status_code code = try_set_card_balance(balance); code != status_code::ok)
+                detail::throw_status(code);
+        }
+
+        void log::set_rfu(const uint8_t value) {
+            if (value > RFU_MAX) throw metrics::counted(std::out_of_range("RFU value must be in the range [0, 15]."));
+            rfu_ = value;
+        }
+
+        log log::parse(const std::vector<uint8_t>& data, std::time_t card_effective_date_in_minutes) {
+            return parse(data.data(), data.size(), card_effective_date_in_minutes);
+        }
+
+        log log::parse(const uint8_t* data, const size_t size, std::time_t card_effective_date_in_minutes) {
+            if (size != DATA_SIZE) throw metrics::counted(std::invalid_argument("Log data must be exactly 17 bytes."));
+            return try_parse(data, size, card_effective_date_in_minutes).value();
+        }
+
+        std::vector<uint8_t> log::to_bytes() const {
+            std::vector<uint8_t> data(DATA_SIZE);
+            serialize_into(data.data());
+            return data;
+        }
+
+        std::time_t log::get_card_effective_date() const {
+            if (!card_effective_date_in_minutes_.has_value())
+                throw metrics::counted(std::logic_error("Card effective date has not been set for this log."));
+            return *card_effective_date_in_minutes_;
+        }
+
+        std::string log::get_txn_status_string() const {
+            return to_string(status_);
+        }
+
+        history history::parse(const std::vector<uint8_t>& data, const std::time_t card_effective_date_in_minutes) {
+            return parse(data.data(), data.size(), card_effective_date_in_minutes);
+        }
+
+        history history::parse(const uint8_t* data, const size_t size, const std::time_t card_effective_date_in_minutes) {
+            if (size != TOTAL_SIZE) throw metrics::counted(std::invalid_argument("History data must be exactly 68 bytes."));
+            return try_parse(data, size, card_effective_date_in_minutes).value();
+        }
+
+        std::vector<uint8_t> history::to_bytes() const {
+            std::vector<uint8_t> data(TOTAL_SIZE);
+            serialize_into(data.data());
+            return data;
+        }
+
+        std::time_t history::get_card_effective_date() const {
+            if (!card_effective_date_in_minutes_.has_value()) {
+                throw metrics::counted(std::logic_error("Card effective date has not been set."));
+            }
+            return *card_effective_date_in_minutes_;
+        }
+
+        std::string validation::get_rfu() const {
+            return std::bitset<4>(rfu_).to_string();
+        }
+
+        std::string log::get_rfu() const noexcept { return std::bitset<4>(rfu_).to_string(); }
+
+        std::ostream& operator<<(std::ostream& os, const general& obj) {
+            return os << "------------------------ GENERAL DATA ------------------------" << std::endl
+                      << "  VERSION                  : " << obj.get_version() << std::endl
+                      // Also print the binary representation of the language code for debugging purposes.
+                      << "  LANGUAGE                 : " << obj.get_language_string() << " (0b"
+                      << std::bitset<5>(static_cast<uint8_t>(obj.get_language())) << ")" << std::endl
+                      << "  RFU                      : " << static_cast<int>(obj.get_rfu()) << std::endl
+                      << "------------------------------------------------------------";
+        }
+
+        std::ostream& operator<<(std::ostream& os, const terminal& obj) {
+            return os << "  [TN] ACQUIRER ID       : " << +obj.get_acquirer_id() << std::endl // Unary `+` promotes uint8_t to int for printing as a number.
+                      << "  [TN] OPERATOR ID       : " << obj.get_operator_id() << std::endl
+                      << "  [TN] TERMINAL ID       : " << obj.get_terminal_id();
+        }
+
+        std::ostream& operator<<(std::ostream& os, const validation& obj) {
+            os << "-------------------------- VALIDATION DATA -------------------------" << std::endl;
+            os << obj.get_terminal_info() << std::endl;
+            os << "  ERROR CODE             : " << static_cast<int>(obj.get_error_code()) << std::endl;
+            os << "  PRODUCT TYPE           : " << static_cast<int>(obj.get_product_type()) << std::endl;
+            try {
+                // Convert the millisecond timestamp from get_date_and_time() to seconds
+                // before passing it to std::gmtime, which expects seconds.
+                const std::time_t t_sec = obj.get_date_and_time() / 1000;
+                char time_str[100];
+                // Format the time as a human-readable UTC string.
+                if (std::strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", std::gmtime(&t_sec))) {
+                    os << "  DATE AND TIME          : " << time_str << " (UTC)" << std::endl;
+                }
+            } catch (const std::logic_error& e) {
+                os << "  DATE AND TIME          : " << "[Not available: " << e.what() << "]" << std::endl;
+            }
+            os << "  FARE AMOUNT            : " << obj.get_fare_amount() << std::endl;
+            os << "  ROUTE NUMBER           : " << obj.get_route_number() << std::endl;
+            os << "  SERVICE PROVIDER DATA  : 0x" << obj.get_service_provider_data() << std::endl;
+            os << "  TRANSACTION STATUS     : " << obj.get_txn_status_string() << std::endl;
+            os << "  RFU (BINARY)           : " << obj.get_rfu() << std::endl;
+            os << "--------------------------------------------------------------------";
+            return os;
+        }
+
+        std::ostream& operator<<(std::ostream& os, const log& obj) {
+            os << "--------------------------- LOG ENTRY ----------------------------" << std::endl;
+            os << obj.get_terminal_info() << std::endl;
+            try {
+                const uint64_t time_ms = obj.get_date_and_time();
+                const std::time_t time_sec = time_ms / 1000;
+                char time_str[100];
+                if (std::strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", std::gmtime(&time_sec))) {
+                    os << "  DATE AND TIME          : " << time_str << " (UTC)" << std::endl;
+                }
+            } catch (const std::logic_error& e) {
+                os << "  DATE AND TIME          : " << "[Not available: " << e.what() << "]" << std::endl;
+            }
+            os << "  TRANSACTION SQ NO      : " << obj.get_txn_sq_no() << std::endl;
+            os << "  TRANSACTION AMOUNT     : " << obj.get_txn_amount() << std::endl;
+            os << "  CARD BALANCE           : " << obj.get_card_balance() << std::endl;
+            os << "  TRANSACTION STATUS     : " << obj.get_txn_status_string() << std::endl;
+            os << "  RFU (BINARY)           : " << obj.get_rfu() << std::endl;
+            os << "--------------------------------------------------------------------";
+            return os;
+        }
+
+        std::ostream& operator<<(std::ostream& os, const history& obj) {
+            os << "=========================== HISTORY DATA ===========================" << std::endl;
+            try {
+                os << "  CARD EFFECTIVE DATE (MINS): " << obj.get_card_effective_date() << std::endl;
+            } catch ([[maybe_unused]] const std::logic_error& e) {
+                // `[[maybe_unused]]` prevents a compiler warning if exceptions are turned off.
+                os << "  CARD EFFECTIVE DATE (MINS): [Not Set]" << std::endl;
+            }
+            os << "  VALID LOG COUNT           : " << obj.get_valid_log_count() << std::endl;
+
+            if (obj.get_valid_log_count() > 0) {
+                // Print each valid log entry. The log's own stream operator will be used.
+                for (size_t i = 0; i < obj.get_valid_log_count(); ++i) {
+                    os << obj.get_log_unchecked(i) << std::endl;
+                }
+            } else {
+                os << "  [No log entries]" << std::endl;
+            }
+            os << "==================================================================";
+            return os;
+        }
+
+        std::ostream& operator<<(std::ostream& os, const container& obj) {
+            os << "======================= COMMON SERVICE AREA (CSA) =======================" << std::endl;
+            os << obj.general_ << std::endl;
+            os << obj.validation_ << std::endl;
+            os << obj.history_ << std::endl;
+            os << "-------------------------- RFU (7 Bytes) --------------------------" << std::endl << "  ";
+            for (const auto& byte : obj.rfu_) {
+                os << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte) << " ";
+            }
+            os << std::dec << std::endl;
+            os << "=======================================================================";
+            return os;
+        }
+
+    }
+
+}
@@ -1,13 +1,42 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <memory_resource>
+#include <sstream>
 #include <vector>
 #include <iomanip>
 #include <cassert>
+#include <cstring>
 #include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <unordered_set>
 #include <functional>
+#include <numeric>
 #include "date_time.h"
 #include "open_loop_service.h"
+#include "open_loop_batch.h"
+#include "open_loop_card_cache.h"
+#include "open_loop_deny_list.h"
+#include "open_loop_diff.h"
+#include "open_loop_export.h"
+#include "open_loop_journal.h"
+#include "open_loop_metrics.h"
+#include "open_loop_fare.h"
+#include "open_loop_format.h"
+#include "open_loop_pass.h"
+#include "open_loop_pipeline.h"
+#include "open_loop_reader.h"
+#include "open_loop_session.h"
+#include "open_loop_tap.h"
 #ifdef _WIN32
 #include <windows.h>
+#else
+#include <csignal>
+#include <sys/resource.h>
 #endif
 
 using namespace open_loop;
@@ -150,7 +179,7 @@ void csa_test_history_cyclical_buffer() {
     csa::history hist;
     hist.set_card_effective_date(1000);
     csa::log logs[6];
-    for(int i=0; i<6; ++i) { logs[i].set_card_effective_date(1000); logs[i].set_txn_sq_no(i+1); }
+    for(int i=0; i<6; ++i) { logs[i].set_card_effective_date(1000); logs[i].set_txn_sq_no(static_cast<uint16_t>(i + 1)); }
     hist.add_log(logs[0]); hist.add_log(logs[1]); hist.add_log(logs[2]); hist.add_log(logs[3]);
     hist.add_log(logs[4]); // Buffer should be [5, 4, 3, 2]
     assert(hist.get_logs()[3].get_txn_sq_no() == 2);
@@ -269,6 +298,1710 @@ void osa_test_bcd_and_time_formats() {
     assert(pass_bytes[1] == 0x0F && pass_bytes[2] == 0x42 && pass_bytes[3] == 0x40);
 }
 
+// --- Fast-Path Test Cases ---
+
+/**
+ * @brief Verifies that parsing straight out of a raw reader buffer matches the vector-based parse.
+ * @details Both CSA and OSA containers are parsed from a plain `std::array` via the pointer+length
+ *          overloads and compared against containers parsed from the equivalent `std::vector`.
+ */
+void test_raw_buffer_parse() {
+    constexpr std::time_t csa_date = 28399680;
+    const std::vector<uint8_t> csa_bytes = create_csa_golden_data(csa_date);
+    std::array<uint8_t, csa::container::TOTAL_SIZE> csa_buffer{};
+    std::copy(csa_bytes.begin(), csa_bytes.end(), csa_buffer.begin());
+    csa::container from_vector, from_buffer;
+    from_vector.set_card_effective_date(csa_date);
+    from_buffer.set_card_effective_date(csa_date);
+    from_vector.parse(csa_bytes);
+    from_buffer.parse(csa_buffer.data(), csa_buffer.size());
+    assert(from_vector == from_buffer);
+
+    osa::container osa;
+    osa.set_card_effective_date(28300000);
+    osa.get_general().set_phone_number("7977192875");
+    osa.get_trip_pass(1).set_trips_allotted(10);
+    const std::vector<uint8_t> osa_bytes = osa.to_bytes();
+    std::array<uint8_t, osa::container::BLOCK_SIZE> osa_buffer{};
+    std::copy(osa_bytes.begin(), osa_bytes.end(), osa_buffer.begin());
+    osa::container parsed_osa;
+    parsed_osa.set_card_effective_date(28300000);
+    parsed_osa.parse(osa_buffer.data(), osa_buffer.size());
+    assert(osa == parsed_osa);
+
+    bool thrown = false;
+    try { csa::general::parse(csa_buffer.data(), 3); } catch (const std::invalid_argument&) { thrown = true; } assert(thrown);
+}
+
+/**
+ * @brief Verifies that `serialize_into` and `to_array` produce exactly the bytes of `to_bytes`.
+ * @details The CSA is serialized into a pre-poisoned buffer to prove every one of the 96 bytes
+ *          is written, and the OSA with a single history record to exercise the zero-filled slots.
+ */
+void test_serialize_into_buffer() {
+    constexpr std::time_t csa_date = 28399680;
+    const std::vector<uint8_t> golden = create_csa_golden_data(csa_date);
+    csa::container parsed_csa;
+    parsed_csa.set_card_effective_date(csa_date);
+    parsed_csa.parse(golden);
+    std::array<uint8_t, csa::container::TOTAL_SIZE> csa_buffer{};
+    csa_buffer.fill(0xAA);
+    parsed_csa.serialize_into(csa_buffer.data());
+    assert(std::equal(csa_buffer.begin(), csa_buffer.end(), golden.begin()));
+    assert(parsed_csa.to_array() == csa_buffer);
+
+    osa::container osa;
+    osa.set_card_effective_date(28300000);
+    osa.get_general().set_phone_number("7977192875");
+    osa::transaction_record rec;
+    rec.set_card_effective_date(28300000);
+    rec.set_fare(50);
+    osa.get_history().add_record(rec);
+    std::array<uint8_t, osa::container::BLOCK_SIZE> osa_buffer{};
+    osa_buffer.fill(0xAA);
+    osa.serialize_into(osa_buffer.data());
+    const std::vector<uint8_t> osa_bytes = osa.to_bytes();
+    assert(std::equal(osa_buffer.begin(), osa_buffer.end(), osa_bytes.begin()));
+    assert(osa.to_array() == osa_buffer);
+}
+
+/**
+ * @brief Verifies that lazily decoded `csa::view` / `osa::view` fields match a full container parse.
+ */
+void test_lazy_card_views() {
+    constexpr std::time_t csa_date = 28399680;
+    const std::vector<uint8_t> golden = create_csa_golden_data(csa_date);
+    const csa::view card(golden.data(), golden.size(), csa_date);
+    const csa::container full = card.to_container();
+    assert(card.get_validation_date_and_time() == full.get_validation().get_date_and_time());
+    assert(card.get_validation_fare_amount() == 1500);
+    assert(card.get_validation_txn_status() == full.get_validation().get_txn_status());
+    assert(card.get_validation_terminal() == full.get_validation().get_terminal_info());
+    assert(card.get_log_count() == full.get_history().get_valid_log_count());
+    assert(card.get_latest_card_balance() == 20000);
+    assert(card.get_log_txn_sq_no(0) == 101);
+    assert(card.get_log_date_and_time(0) == full.get_history().get_logs()[0].get_date_and_time());
+
+    osa::container osa;
+    osa.set_card_effective_date(28300000);
+    osa.get_trip_pass(1).set_trips_allotted(40);
+    osa.get_trip_pass(1).set_remaining_trips(12);
+    osa.get_trip_pass(1).set_pass_expiry(15552000000ULL);
+    const std::vector<uint8_t> osa_bytes = osa.to_bytes();
+    const osa::view osa_card(osa_bytes.data(), osa_bytes.size(), 28300000);
+    assert(osa_card.get_trip_pass_remaining_trips(1) == 12);
+    assert(osa_card.get_trip_pass_expiry(1) == 15552000000ULL);
+    assert(osa_card.to_container() == osa);
+
+    bool thrown = false;
+    try { (void)card.get_log_card_balance(4); } catch (const std::out_of_range&) { thrown = true; } assert(thrown);
+}
+
+/**
+ * @brief Verifies that `patch_into` rewrites only the changed bytes and reports exact dirty ranges.
+ * @details A CSA is parsed from a buffer, only the validation fare is changed, and the patch must
+ *          touch exactly the 2 fare bytes. An unchanged container must produce no dirty ranges.
+ */
+void test_patch_dirty_ranges() {
+    constexpr std::time_t csa_date = 28399680;
+    const std::vector<uint8_t> golden = create_csa_golden_data(csa_date);
+    std::array<uint8_t, csa::container::TOTAL_SIZE> card{};
+    std::copy(golden.begin(), golden.end(), card.begin());
+    csa::container csa;
+    csa.set_card_effective_date(csa_date);
+    csa.parse(card.data(), card.size());
+    const dirty_ranges clean = csa.patch_into(card.data());
+    assert(clean.empty());
+
+    csa.get_validation().set_fare_amount(1501);
+    const dirty_ranges dirty = csa.patch_into(card.data());
+    assert(dirty.size() == 1);
+    assert(dirty[0].offset == csa::view::VALIDATION_FARE_OFFSET + 1 && dirty[0].length == 1);
+    assert(card == csa.to_array());
+    assert(dirty.block_mask(16) == 0x1);
+
+    osa::container osa;
+    osa.set_card_effective_date(28300000);
+    osa.get_trip_pass(1).set_trips_allotted(40);
+    osa.get_trip_pass(1).set_remaining_trips(12);
+    std::array<uint8_t, osa::container::BLOCK_SIZE> osa_card = osa.to_array();
+    osa.get_trip_pass(1).set_remaining_trips(11);
+    const dirty_ranges osa_dirty = osa.patch_into(osa_card.data());
+    assert(osa_dirty.size() == 1 && osa_dirty.total_bytes() == 1);
+    assert(osa_card == osa.to_array());
+}
+
+void test_try_api_status_codes() {
+    constexpr std::time_t csa_date = 28399680;
+    const std::vector<uint8_t> golden = create_csa_golden_data(csa_date);
+
+    csa::container csa;
+    status_code sc = csa.try_parse(golden.data(), golden.size());
+    assert(sc == status_code::effective_date_not_set);
+    csa.set_card_effective_date(csa_date);
+    sc = csa.try_parse(golden.data(), golden.size() - 1);
+    assert(sc == status_code::invalid_size);
+    sc = csa.try_parse(golden.data(), golden.size());
+    assert(sc == status_code::ok);
+    assert(csa.to_bytes() == golden);
+
+    const result<csa::terminal> bad_term = csa::terminal::try_parse(golden.data(), 5);
+    assert(!bad_term && bad_term.status() == status_code::invalid_size);
+    assert(std::string(to_string(bad_term.status())) == "Input data has an invalid size.");
+
+    csa::terminal term;
+    sc = term.try_set_terminal_id("1A2B");
+    assert(sc == status_code::invalid_terminal_id_length);
+    sc = term.try_set_terminal_id("1A2B3G");
+    assert(sc == status_code::invalid_terminal_id);
+    sc = term.try_set_terminal_id("1a2b3c");
+    assert(sc == status_code::ok && term.get_terminal_id() == "1A2B3C");
+
+    csa::log entry;
+    entry.set_card_effective_date(csa_date);
+    sc = entry.try_set_card_balance(0x100000);
+    assert(sc == status_code::card_balance_overflow);
+    sc = entry.try_set_date_and_time(0);
+    assert(sc == status_code::time_before_effective_date);
+
+    osa::trip_pass pass;
+    pass.set_trips_allotted(10);
+    sc = pass.try_set_remaining_trips(11);
+    assert(sc == status_code::remaining_trips_exceed_allotted);
+    sc = pass.try_set_remaining_trips(10);
+    assert(sc == status_code::ok && pass.get_remaining_trips() == 10);
+
+    osa::general general;
+    sc = general.try_set_phone_number("98765");
+    assert(sc == status_code::invalid_phone_number_length);
+    sc = general.try_set_phone_number("98765x3210");
+    assert(sc == status_code::invalid_phone_number_digit);
+}
+
+void test_batch_soa_decoder() {
+    constexpr std::time_t csa_date = 28399680;
+    const std::vector<uint8_t> golden = create_csa_golden_data(csa_date);
+    std::vector<uint8_t> csa_images;
+    for (uint8_t i = 0; i < 5; ++i) {
+        std::vector<uint8_t> image = golden;
+        image[csa::view::VALIDATION_FARE_OFFSET + 1] = i;   // Vary the fare...
+        image[csa::container::HISTORY_OFFSET + 13] ^= i;    // ...and the latest balance.
+        csa_images.insert(csa_images.end(), image.begin(), image.end());
+    }
+
+    csa::batch cards;
+    cards.decode(csa_images);
+    assert(cards.size() == 5);
+    for (size_t i = 0; i < cards.size(); ++i) {
+        const csa::view card(csa_images.data() + (i * csa::container::TOTAL_SIZE), csa::container::TOTAL_SIZE, csa_date);
+        assert(cards.get_validation_fare_amount()[i] == card.get_validation_fare_amount());
+        assert(cards.get_validation_route_number()[i] == card.get_validation_route_number());
+        assert(cards.get_validation_date_and_time_offset()[i] == card.get_validation_date_and_time_offset());
+        assert(cards.get_validation_terminal_id()[i] == std::stoul(card.get_validation_terminal().get_terminal_id(), nullptr, 16));
+        assert(cards.get_validation_txn_status()[i] == card.get_validation_txn_status());
+        assert(cards.get_log_count()[i] == card.get_log_count());
+        for (size_t slot = 0; slot < csa::history::LOG_COUNT; ++slot) {
+            const size_t at = csa::batch::log_index(i, slot);
+            assert(cards.get_log_card_balance()[at] == card.get_log_card_balance(slot));
+            assert(cards.get_log_txn_amount()[at] == card.get_log_txn_amount(slot));
+            assert(cards.get_log_txn_sq_no()[at] == card.get_log_txn_sq_no(slot));
+            assert(cards.get_log_txn_status()[at] == card.get_log_txn_status(slot));
+        }
+    }
+
+    osa::container osa;
+    osa.set_card_effective_date(28300000);
+    osa.get_validation().set_station_id(0x1234);
+    osa.get_validation().set_terminal_id("ABCDEF");
+    osa.get_trip_pass(1).set_trips_allotted(40);
+    osa.get_trip_pass(1).set_remaining_trips(12);
+    osa.get_trip_pass(1).set_destination_id(0x0BEE);
+    osa.get_trip_pass(1).set_start_date_and_time(15552000000ULL);
+    std::vector<uint8_t> osa_images = osa.to_bytes();
+    osa_images.insert(osa_images.end(), osa_images.begin(), osa_images.end());
+
+    osa::batch passes;
+    passes.decode(osa_images);
+    assert(passes.size() == 2);
+    assert(passes.get_validation_station_id()[1] == 0x1234 && passes.get_validation_terminal_id()[1] == 0xABCDEF);
+    const size_t at = osa::batch::pass_index(1, 1);
+    assert(passes.get_trip_pass_trips_allotted()[at] == 40 && passes.get_trip_pass_remaining_trips()[at] == 12);
+    assert(passes.get_trip_pass_destination_id()[at] == 0x0BEE);
+    assert(passes.get_trip_pass_start_date_and_time()[at] == 15552000);
+
+    bool thrown = false;
+    try { cards.decode(golden.data(), golden.size() - 1); } catch (const std::invalid_argument&) { thrown = true; } assert(thrown);
+}
+
+void test_pipeline_over_mapped_file() {
+    constexpr std::time_t csa_date = 28399680;
+    constexpr size_t record_count = 1000;
+    const std::vector<uint8_t> golden = create_csa_golden_data(csa_date);
+    std::vector<uint8_t> images;
+    std::vector<std::time_t> dates;
+    uint64_t expected_fares = 0;
+    for (size_t i = 0; i < record_count; ++i) {
+        std::vector<uint8_t> image = golden;
+        image[csa::view::VALIDATION_FARE_OFFSET + 1] = static_cast<uint8_t>(i);
+        expected_fares += csa::view(image.data(), image.size(), csa_date).get_validation_fare_amount();
+        images.insert(images.end(), image.begin(), image.end());
+        dates.push_back(csa_date + static_cast<std::time_t>(i));
+    }
+
+    const std::string path = (std::filesystem::temp_directory_path() / "open_loop_pipeline_test.csa").string();
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(images.data()), static_cast<std::streamsize>(images.size()));
+    }
+
+    {
+        const pipeline::mapped_file file(path);
+        assert(file.size() == images.size());
+
+        const pipeline::csa_runner runner(4, 7);
+        std::vector<uint64_t> fares(runner.worker_count(), 0);
+        std::vector<size_t> records(runner.worker_count(), 0);
+        std::vector<uint8_t> time_mismatch(runner.worker_count(), 0);
+        runner.run(file, pipeline::effective_dates(dates.data(), dates.size()), [&](const pipeline::chunk<csa::batch>& c) {
+            for (size_t i = 0; i < c.records.size(); ++i) {
+                fares[c.worker] += c.records.get_validation_fare_amount()[i];
+                const uint64_t expected = csa::view(images.data() + ((c.first_record + i) * csa::batch::RECORD_SIZE),
+                                                    csa::batch::RECORD_SIZE, dates[c.first_record + i]).get_validation_date_and_time();
+                if (c.to_milliseconds(i, c.records.get_validation_date_and_time_offset()[i]) != expected) time_mismatch[c.worker] = 1;
+            }
+            records[c.worker] += c.records.size();
+        });
+        assert(std::accumulate(fares.begin(), fares.end(), uint64_t{ 0 }) == expected_fares);
+        assert(std::accumulate(records.begin(), records.end(), size_t{ 0 }) == record_count);
+        assert(std::none_of(time_mismatch.begin(), time_mismatch.end(), [](const uint8_t m) { return m != 0; }));
+
+        bool thrown = false;
+        try {
+            runner.run(file, pipeline::effective_dates(csa_date), [](const pipeline::chunk<csa::batch>& c) {
+                if (c.first_record > 500) throw std::runtime_error("visitor failure");
+            });
+        } catch (const std::runtime_error&) { thrown = true; }
+        assert(thrown);
+    }
+    std::filesystem::remove(path);
+}
+
+void test_layout_descriptors() {
+    static_assert(csa::validation::layout::SIZE == csa::validation::DATA_SIZE);
+    static_assert(csa::log::layout::FIELD_COUNT == 8);
+    static_assert(osa::trip_pass::layout::SIZE == osa::trip_pass::DATA_SIZE);
+
+    // Blocks without filler bits must reproduce any byte pattern exactly.
+    std::array<uint8_t, osa::trip_pass::DATA_SIZE> pass_bytes{};
+    std::array<uint8_t, osa::transaction_record::DATA_SIZE> record_bytes{};
+    for (uint8_t seed = 1; seed < 20; ++seed) {
+        for (size_t i = 0; i < pass_bytes.size(); ++i) pass_bytes[i] = static_cast<uint8_t>((seed * 37) + (i * 11));
+        for (size_t i = 0; i < record_bytes.size(); ++i) record_bytes[i] = static_cast<uint8_t>((seed * 53) ^ (i * 29));
+
+        std::array<uint8_t, osa::trip_pass::DATA_SIZE> pass_out{};
+        osa::trip_pass::parse(pass_bytes.data(), pass_bytes.size()).serialize_into(pass_out.data());
+        assert(pass_out == pass_bytes);
+
+        std::array<uint8_t, osa::transaction_record::DATA_SIZE> record_out{};
+        osa::transaction_record::parse(record_bytes.data(), record_bytes.size(), 28300000).serialize_into(record_out.data());
+        assert(record_out == record_bytes);
+    }
+
+    // The log's filler nibble is ignored on decode and always written back as 1s.
+    std::array<uint8_t, csa::log::DATA_SIZE> log_bytes{};
+    log_bytes[13] = 0x12; log_bytes[14] = 0x34; log_bytes[15] = 0x50; log_bytes[16] = 0x2A;
+    const csa::log entry = csa::log::parse(log_bytes.data(), log_bytes.size(), 28399680);
+    assert(entry.get_card_balance() == 0x12345 && entry.get_txn_status() == txn_status::PENALTY);
+    const std::vector<uint8_t> written = entry.to_bytes();
+    assert(written[15] == 0x5F && written[16] == 0x2A);
+}
+
+struct zonal_test_layout {
+    static constexpr size_t HISTORY_RECORDS = 1;
+    static constexpr size_t NUM_TRIP_PASSES = 3;
+    static constexpr bool accepts(const size_t major_version) noexcept { return major_version == 5; }
+};
+
+void test_templated_osa_layouts() {
+    using zonal_container = osa::basic_container<zonal_test_layout>;
+    static_assert(std::is_same_v<osa::container::history_type, osa::history>);
+    static_assert(osa::container::TRIP_PASS_START_OFFSET == 46 && osa::container::PADDING_SIZE == 10);
+    static_assert(zonal_container::TRIP_PASS_START_OFFSET == 33 && zonal_container::PADDING_SIZE == 3);
+    static_assert(zonal_container::PATCH_REGIONS.size() == 7 && zonal_container::PATCH_REGIONS[6].offset == 93);
+
+    zonal_container zonal;
+    zonal.set_card_effective_date(28300000);
+    zonal.get_general().set_version(5, 0, 0);
+    zonal.get_trip_pass(2).set_trips_allotted(30);
+    zonal.get_trip_pass(2).set_remaining_trips(29);
+    const auto zonal_bytes = zonal.to_array();
+
+    osa::container standard;
+    standard.set_card_effective_date(28300000);
+    standard.get_general().set_version(2, 0, 1);
+    const auto standard_bytes = standard.to_array();
+
+    using registry = osa::layout_registry<zonal_test_layout, osa::standard_layout>;
+    static_assert(registry::supports(5) && registry::supports(0));
+    size_t zonal_hits = 0;
+    size_t standard_hits = 0;
+    const auto visitor = [&](auto& card) {
+        if constexpr (std::is_same_v<std::decay_t<decltype(card)>, zonal_container>) {
+            assert(card.get_trip_pass(2).get_remaining_trips() == 29);
+            ++zonal_hits;
+        } else {
+            assert(card == standard);
+            ++standard_hits;
+        }
+    };
+    status_code sc = registry::dispatch(zonal_bytes.data(), zonal_bytes.size(), 28300000, visitor);
+    assert(sc == status_code::ok);
+    sc = registry::dispatch(standard_bytes.data(), standard_bytes.size(), 28300000, visitor);
+    assert(sc == status_code::ok);
+    assert(zonal_hits == 1 && standard_hits == 1);
+
+    using zonal_only = osa::layout_registry<zonal_test_layout>;
+    sc = zonal_only::dispatch(standard_bytes.data(), standard_bytes.size(), 28300000, visitor);
+    assert(sc == status_code::unsupported_layout);
+    sc = zonal_only::dispatch(standard_bytes.data(), 95, 28300000, visitor);
+    assert(sc == status_code::invalid_size);
+}
+
+void test_hex_and_bcd_codecs() {
+    // 1. Single-value hex round trips, including leading zeros and lower-case input.
+    assert(codec::hex_u24(0x00A1B2) == "00A1B2");
+    assert(codec::hex_u24(0xFFFFFF) == "FFFFFF");
+    uint32_t value = 7;
+    bool decoded_ok = codec::hex_decode("a1b2c3", 6, value);
+    assert(decoded_ok && value == 0xA1B2C3);
+    decoded_ok = codec::hex_decode("A1B2G3", 6, value);
+    assert(!decoded_ok && value == 0xA1B2C3);
+
+    // 2. Terminal accessors share the codec; the inline variant matches the std::string getter.
+    csa::terminal term;
+    term.set_terminal_id("0f0e0d");
+    assert(term.get_terminal_id() == "0F0E0D");
+    const fixed_string<6> chars = term.get_terminal_id_chars();
+    assert(chars.size() == 6 && chars == term.get_terminal_id() && std::string_view(chars.c_str()) == "0F0E0D");
+    status_code sc = term.try_set_terminal_id("0F0E0Z");
+    assert(sc == status_code::invalid_terminal_id);
+    assert(term.get_terminal_id() == "0F0E0D");
+
+    // 3. BCD phone numbers: invalid digits leave the stored number untouched.
+    osa::general general;
+    assert(general.get_phone_number_chars().empty());
+    general.set_phone_number("9876543210");
+    assert(general.get_phone_number_chars() == "9876543210");
+    sc = general.try_set_phone_number("98765432a0");
+    assert(sc == status_code::invalid_phone_number_digit);
+    assert(general.get_phone_number() == "9876543210");
+
+    // 4. Batch variants convert whole columns.
+    const uint32_t ids[3] = { 0x000001, 0xABCDEF, 0x123456 };
+    char packed[18];
+    codec::hex_encode_u24_batch(ids, 3, packed);
+    assert(std::string_view(packed, 18) == "000001ABCDEF123456");
+    uint32_t decoded[3] = {};
+    size_t decoded_count = codec::hex_decode_u24_batch(packed, 3, decoded);
+    assert(decoded_count == 3);
+    assert(std::equal(std::begin(ids), std::end(ids), std::begin(decoded)));
+    packed[7] = 'x';
+    decoded_count = codec::hex_decode_u24_batch(packed, 3, decoded);
+    assert(decoded_count == 1);
+
+    const uint8_t phones[10] = { 0x98, 0x76, 0x54, 0x32, 0x10, 0x01, 0x23, 0x45, 0x67, 0x89 };
+    char digits[20];
+    codec::bcd_decode_batch(phones, 2, 5, digits);
+    assert(std::string_view(digits, 20) == "98765432100123456789");
+}
+
+void test_effective_epoch_and_bulk_timestamps() {
+    constexpr std::time_t effective_date = 28399680; // 2024-01-01 00:00 UTC in minutes
+    csa::container card;
+    card.set_card_effective_date(effective_date);
+    card.parse(create_csa_golden_data(effective_date));
+
+    // 1. The container precomputes the epoch once and shares it with its children.
+    const effective_epoch& epoch = card.get_card_epoch();
+    assert(epoch.has_value() && *epoch == effective_date);
+    assert(epoch.milliseconds() == static_cast<uint64_t>(effective_date) * 60000);
+    assert(card.get_validation().get_date_and_time_unchecked() == card.get_validation().get_date_and_time());
+    assert(!effective_epoch().has_value() && effective_epoch() != epoch);
+    assert(effective_epoch(0).has_value() && effective_epoch(0) != effective_epoch());
+    assert(!effective_epoch(effective_epoch::UNSET).has_value() && effective_epoch(effective_epoch::UNSET) == effective_epoch());
+
+    // 2. The bulk accessor matches the per-log getters and zero-fills empty slots.
+    const std::array<uint64_t, csa::history::LOG_COUNT> times = card.get_history().get_dates_and_times();
+    assert(card.get_history().get_valid_log_count() == 1);
+    assert(times[0] == card.get_history().get_logs()[0].get_date_and_time());
+    assert(times[1] == 0 && times[3] == 0);
+
+    // 3. Encoding through the cached epoch keeps the original minute truncation and range checks.
+    osa::transaction_record record;
+    record.set_card_effective_date(effective_date);
+    status_code sc = record.try_set_date_and_time(epoch.milliseconds() + 90 * 60000 + 59999);
+    assert(sc == status_code::ok);
+    assert(record.get_date_and_time() == epoch.milliseconds() + 90 * 60000);
+    sc = record.try_set_date_and_time(epoch.milliseconds() - 1);
+    assert(sc == status_code::time_before_effective_date);
+    sc = record.try_set_date_and_time(epoch.to_milliseconds(0xFFFFFF));
+    assert(sc == status_code::ok);
+    sc = record.try_set_date_and_time(epoch.to_milliseconds(0xFFFFFF) + 60000);
+    assert(sc == status_code::time_offset_overflow);
+
+    osa::history osa_history;
+    bool threw = false;
+    try { (void)osa_history.get_dates_and_times(); } catch (const std::logic_error&) { threw = true; }
+    assert(threw);
+}
+
+void test_history_ring_buffer() {
+    constexpr std::time_t effective_date = 28399680;
+    csa::history hist;
+    hist.set_card_effective_date(effective_date);
+    std::array<uint8_t, csa::history::TOTAL_SIZE> raw{};
+
+    // 1. Wrap the ring several times; the logical order and the raw-buffer rotation must agree.
+    for (uint16_t sq = 1; sq <= 9; ++sq) {
+        csa::log entry;
+        entry.set_card_effective_date(effective_date);
+        entry.set_txn_sq_no(sq);
+        entry.set_card_balance(1000 + sq);
+        hist.add_log(entry);
+        csa::history::push_log_into(raw.data(), entry);
+
+        const std::vector<uint8_t> bytes = hist.to_bytes();
+        assert(std::equal(bytes.begin(), bytes.end(), raw.begin()));
+        assert(hist.get_log(0).get_txn_sq_no() == sq);
+        assert(hist.get_logs()[0] == hist.get_log(0));
+    }
+    assert(hist.get_valid_log_count() == 4);
+    assert(hist.get_log(3).get_txn_sq_no() == 6);
+
+    // 2. Parsing the rotated buffer yields an equal history, even though the ring heads differ.
+    assert(csa::history::parse(raw.data(), raw.size(), effective_date) == hist);
+    bool threw = false;
+    try { (void)hist.get_log(4); } catch (const std::out_of_range&) { threw = true; }
+    assert(threw);
+
+    // 3. The OSA history wraps the same way.
+    osa::history osa_hist;
+    osa_hist.set_card_effective_date(effective_date);
+    std::array<uint8_t, osa::history::TOTAL_SIZE> osa_raw{};
+    for (uint8_t fare = 1; fare <= 5; ++fare) {
+        osa::transaction_record rec;
+        rec.set_card_effective_date(effective_date);
+        rec.set_fare(fare);
+        osa_hist.add_record(rec);
+        std::array<uint8_t, osa::transaction_record::DATA_SIZE> rec_bytes{};
+        rec.serialize_into(rec_bytes.data());
+        osa::history::push_record_into(osa_raw.data(), rec_bytes.data());
+    }
+    const std::vector<uint8_t> osa_bytes = osa_hist.to_bytes();
+    assert(std::equal(osa_bytes.begin(), osa_bytes.end(), osa_raw.begin()));
+    assert(osa_hist.get_log(0).get_fare() == 5 && osa_hist.get_log(1).get_fare() == 4);
+}
+
+void test_compact_card_representation() {
+    constexpr std::time_t effective_date = 28399680;
+    csa::container card;
+    card.set_card_effective_date(effective_date);
+    card.parse(create_csa_golden_data(effective_date));
+
+    // 1. The compact form is a padding-free, trivially copyable 104-byte object.
+    static_assert(std::is_trivially_copyable_v<csa::compact_card>);
+    static_assert(sizeof(csa::compact_card) == 104 && sizeof(osa::compact_card) == 104);
+    assert(sizeof(csa::compact_card) < sizeof(csa::container));
+
+    // 2. It survives a raw memcpy (as into shared memory) and converts back losslessly.
+    const csa::compact_card compact = csa::compact_card::from_container(card);
+    std::array<uint8_t, sizeof(csa::compact_card)> shared{};
+    std::memcpy(shared.data(), &compact, sizeof(compact));
+    csa::compact_card copy;
+    std::memcpy(&copy, shared.data(), sizeof(copy));
+    assert(copy == compact);
+    assert(copy.to_container() == card);
+    assert(copy.get_view().get_latest_card_balance() == 20000);
+
+    // 3. Storing a modified container updates the snapshot in place.
+    card.get_validation().set_fare_amount(2500);
+    copy.store(card);
+    assert(copy != compact && copy.get_view().get_validation_fare_amount() == 2500);
+
+    // 4. The OSA snapshot behaves the same and requires an effective date.
+    osa::container osa_card;
+    osa_card.set_card_effective_date(effective_date);
+    osa_card.get_general().set_phone_number("9876543210");
+    const osa::compact_card osa_compact = osa::compact_card::from_container(osa_card);
+    assert(osa_compact.to_container() == osa_card);
+    bool threw = false;
+    try { (void)osa::compact_card::from_container(osa::container{}); } catch (const std::logic_error&) { threw = true; }
+    assert(threw);
+}
+
+void test_canonical_equality_and_hashing() {
+    constexpr std::time_t effective_date = 28399680;
+    const std::vector<uint8_t> golden = create_csa_golden_data(effective_date);
+    csa::container a, b;
+    a.set_card_effective_date(effective_date);
+    b.set_card_effective_date(effective_date);
+    a.parse(golden);
+    b.parse(golden);
+
+    // 1. Byte-level equality agrees with the structural operator and with the source buffer.
+    assert(a.equals_canonical(b) && a == b);
+    assert(a.equals_bytes(golden.data()));
+    assert(a.hash() == b.hash());
+    assert(a.hash() == csa::compact_card::from_container(a).hash());
+
+    // 2. A one-field change or a different effective date changes both the equality and the hash.
+    b.get_validation().set_fare_amount(1501);
+    assert(!a.equals_canonical(b) && !a.equals_bytes(b.to_array().data()));
+    assert(a.hash() != b.hash());
+    csa::container shifted;
+    shifted.set_card_effective_date(effective_date + 1);
+    shifted.parse(golden);
+    assert(!a.equals_canonical(shifted) && a.hash() != shifted.hash());
+
+    // 3. The hash is fixed across platforms: it only depends on the bytes and the effective date.
+    static constexpr std::array<uint8_t, 96> zeros{};
+    static_assert(detail::hash_card(zeros.data(), zeros.size(), 0) == 0xDD8C52F98A544B82ULL);
+    assert(detail::hash_card(zeros.data(), zeros.size(), 0) != detail::hash_card(zeros.data(), zeros.size(), 1));
+
+    // 4. std::hash lets containers and snapshots key unordered containers for deduplication.
+    std::unordered_set<csa::container> csa_seen{ a, b, a };
+    assert(csa_seen.size() == 2);
+    std::unordered_set<osa::compact_card> osa_seen;
+    osa::container osa_card;
+    osa_card.set_card_effective_date(effective_date);
+    osa_seen.insert(osa::compact_card::from_container(osa_card));
+    osa_seen.insert(osa::compact_card::from_container(osa_card));
+    assert(osa_seen.size() == 1);
+    assert(std::hash<osa::container>{}(osa_card) == osa::compact_card::from_container(osa_card).hash());
+}
+
+void test_csa_tap_engine() {
+    constexpr std::time_t effective_date = 28399680;
+    const std::vector<uint8_t> golden = create_csa_golden_data(effective_date);
+    const uint64_t now = 1735700000000ULL;
+
+    csa::terminal gate_terminal;
+    gate_terminal.set_acquirer_id(7);
+    gate_terminal.set_operator_id(2024);
+    gate_terminal.set_terminal_id("0A0B0C");
+    const csa::tap_engine engine(gate_terminal, 42);
+
+    // 1. Reference result through the classic container API.
+    csa::container expected;
+    expected.set_card_effective_date(effective_date);
+    expected.parse(golden);
+    const csa::log& latest = expected.get_history().get_log(0);
+    csa::log entry;
+    entry.set_card_effective_date(effective_date);
+    entry.set_terminal_info(gate_terminal);
+    entry.set_date_and_time(now);
+    entry.set_txn_amount(1500);
+    entry.set_txn_sq_no(latest.get_txn_sq_no() + 1);
+    entry.set_card_balance(latest.get_card_balance() - 1500);
+    entry.set_txn_status(txn_status::EXIT);
+    expected.get_history().add_log(entry);
+    csa::validation& validation = expected.get_validation();
+    validation.set_error_code(0);
+    validation.set_terminal_info(gate_terminal);
+    validation.set_date_and_time(now);
+    validation.set_fare_amount(1500);
+    validation.set_route_number(42);
+    validation.set_txn_status(txn_status::EXIT);
+    std::vector<uint8_t> reference = golden;
+    const dirty_ranges reference_dirty = expected.patch_into(reference.data());
+
+    // 2. The engine produces the same bytes and dirty ranges in one call.
+    std::vector<uint8_t> card = golden;
+    const csa::tap_result r = engine.apply(card.data(), card.size(), { effective_date, now, 1500, txn_status::EXIT });
+    assert(r.ok());
+    assert(card == reference);
+    assert(r.card_balance == 18500 && r.txn_sq_no == 102);
+    assert(r.dirty.size() == reference_dirty.size() && r.dirty.total_bytes() == reference_dirty.total_bytes());
+
+    // 3. Rejected taps leave the buffer untouched.
+    const std::vector<uint8_t> before = card;
+    status_code sc = engine.apply(card.data(), card.size(), { effective_date, now, 60000, txn_status::EXIT }).status;
+    assert(sc == status_code::insufficient_balance);
+    sc = engine.apply(card.data(), card.size(), { effective_date, 0, 0, txn_status::ENTRY }).status;
+    assert(sc == status_code::time_before_effective_date);
+    sc = engine.apply(card.data(), card.size(), { effective_epoch(), now, 0, txn_status::ENTRY }).status;
+    assert(sc == status_code::effective_date_not_set);
+    sc = engine.apply(card.data(), 95, { effective_date, now, 0, txn_status::ENTRY }).status;
+    assert(sc == status_code::invalid_size);
+    assert(card == before);
+
+    // 4. The copying overload leaves the input alone; an empty history starts from balance 0.
+    std::array<uint8_t, csa::container::TOTAL_SIZE> blank{}, out{};
+    const csa::tap_result first = engine.apply(blank.data(), blank.size(), { effective_date, now, 0, txn_status::ENTRY }, out.data());
+    assert(first.ok() && first.txn_sq_no == 1 && first.card_balance == 0);
+    assert(std::all_of(blank.begin(), blank.end(), [](const uint8_t b) { return b == 0; }));
+    const csa::view tapped(out.data(), out.size(), effective_date);
+    assert(tapped.get_validation_txn_status() == txn_status::ENTRY && tapped.get_validation_date_and_time() == (now / 60000) * 60000);
+}
+
+void test_osa_pass_selector() {
+    constexpr std::time_t effective_date = 28399680;
+    const uint64_t now = 1000000ULL * 1000; // Trip pass timestamps are 24-bit seconds.
+    const uint16_t today = osa::pass_selector::day_indicator(now);
+
+    osa::container card;
+    card.set_card_effective_date(effective_date);
+    // Slot 0: any-route pass with lower precedence. Slot 1: 10 <-> 20 pass with the best priority.
+    osa::trip_pass& general_pass = card.get_trip_pass(0);
+    general_pass.set_pass_id(1); general_pass.set_priority(5);
+    general_pass.set_trips_allotted(10); general_pass.set_remaining_trips(10);
+    general_pass.set_pass_expiry(2000000ULL * 1000);
+    osa::trip_pass& route_pass = card.get_trip_pass(1);
+    route_pass.set_pass_id(2); route_pass.set_priority(1);
+    route_pass.set_trips_allotted(2); route_pass.set_remaining_trips(1);
+    route_pass.set_source_id(10); route_pass.set_destination_id(20);
+    route_pass.set_pass_expiry(2000000ULL * 1000);
+    route_pass.set_daily_trip_indicator(static_cast<uint16_t>(today - 1));
+    route_pass.set_daily_trip_counter(7);
+    std::array<uint8_t, osa::container::BLOCK_SIZE> raw = card.to_array();
+
+    const osa::pass_selector selector(2);
+    const osa::journey reverse_trip{ 20, 10, now, today };
+
+    // 1. The route pass wins on priority (in the reverse direction); its stale daily counter resets.
+    assert(selector.select(raw.data() + osa::pass_selector::REGION_OFFSET, reverse_trip) == 1);
+    const osa::pass_result first = selector.consume(raw.data(), raw.size(), reverse_trip);
+    assert(first.ok() && first.slot == 1 && first.remaining_trips == 0 && first.daily_trip_counter == 1);
+    assert(first.dirty.size() == 1 && first.dirty[0].offset == osa::container::TRIP_PASS_START_OFFSET + 20 + 7);
+
+    // 2. The patched bytes match the same changes made through the container API.
+    route_pass.set_remaining_trips(0);
+    route_pass.set_daily_trip_counter(1);
+    route_pass.set_daily_trip_indicator(today);
+    assert(raw == card.to_array());
+
+    // 3. With the route pass exhausted the general pass applies, until the daily limit of 2 is hit.
+    const osa::pass_result second = selector.consume(raw.data(), raw.size(), reverse_trip);
+    assert(second.slot == 0);
+    const osa::pass_result third = selector.consume(raw.data(), raw.size(), reverse_trip);
+    assert(third.ok() && third.slot == 0 && third.daily_trip_counter == 2 && third.remaining_trips == 8);
+    const std::array<uint8_t, osa::container::BLOCK_SIZE> before = raw;
+    const osa::pass_result limited = selector.consume(raw.data(), raw.size(), reverse_trip);
+    assert(limited.status == status_code::no_applicable_pass);
+    assert(raw == before);
+
+    // 4. The next day resets the limit; expired passes and bad sizes are rejected.
+    const osa::journey tomorrow{ 20, 10, now + 86400000ULL, static_cast<uint16_t>(today + 1) };
+    const osa::pass_result next_day = selector.consume(raw.data(), raw.size(), tomorrow);
+    assert(next_day.daily_trip_counter == 1);
+    const osa::journey too_late{ 1, 2, 2000001ULL * 1000, today };
+    assert(selector.select(raw.data() + osa::pass_selector::REGION_OFFSET, too_late) == osa::pass_selector::NO_PASS);
+    const osa::pass_result short_buffer = selector.consume(raw.data(), 40, tomorrow);
+    assert(short_buffer.status == status_code::invalid_size);
+}
+
+void test_csa_fare_table() {
+    constexpr std::time_t effective_date = 28399680;
+    const uint64_t now = 1735700000000ULL;
+    constexpr uint64_t minute = 60000;
+
+    // 1. Every rule of a large table is found with a single probe; unknown keys and duplicates are rejected.
+    std::vector<csa::fare_rule> many;
+    for (uint16_t op = 1; op <= 20; ++op)
+        for (uint16_t route = 1; route <= 25; ++route)
+            many.push_back({ op, route, static_cast<uint16_t>(op * 100 + route), 0, 0, 0, 0 });
+    const csa::fare_table big(many);
+    assert(big.size() == 500 && big.capacity() >= 1000 && (big.capacity() & (big.capacity() - 1)) == 0);
+    for (const csa::fare_rule& rule : many) {
+        const csa::fare_rule* found = big.find(rule.operator_id, rule.route_number);
+        assert(found != nullptr && found->base_fare == rule.base_fare);
+    }
+    assert(big.find(21, 1) == nullptr && big.find(1, 26) == nullptr);
+    bool threw = false;
+    try { const csa::fare_table dup({ { 1, 1, 10, 0, 0, 0, 0 }, { 1, 1, 20, 0, 0, 0, 0 } }); }
+    catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+
+    // Random keys keep the table at a fixed load factor, so capacity grows linearly with the rule count.
+    uint64_t state = 12345;
+    for (const size_t count : { size_t{ 1 }, size_t{ 2 }, size_t{ 3 }, size_t{ 256 }, size_t{ 1024 }, size_t{ 4096 } }) {
+        std::unordered_set<uint32_t> seen;
+        std::vector<csa::fare_rule> random_rules;
+        while (random_rules.size() < count) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            const uint32_t key = static_cast<uint32_t>(state >> 32);
+            if (!seen.insert(key).second) continue;
+            random_rules.push_back({ static_cast<uint16_t>(key >> 16), static_cast<uint16_t>(key), static_cast<uint16_t>(key), 0, 0, 0, 0 });
+        }
+        const csa::fare_table sparse(random_rules);
+        assert(sparse.size() == count && sparse.capacity() * 4 >= count * 5 && sparse.capacity() * 2 <= count * 5);
+        for (const csa::fare_rule& rule : random_rules) {
+            const csa::fare_rule* found = sparse.find(rule.operator_id, rule.route_number);
+            assert(found != nullptr && found->base_fare == rule.base_fare);
+        }
+    }
+    assert(csa::fare_table({}).find(1, 1) == nullptr);
+
+    // 2. Routes 42-44 of operator 2024 transfer to each other within 90 minutes, at most twice.
+    const csa::fare_table fares({
+        { 2024, 42, 2500, 500, 90, 2, 1 },
+        { 2024, 43, 3000, 500, 90, 2, 1 },
+        { 2024, 44, 3500, 700, 90, 2, 1 },
+        { 2024, 99, 4000, 0, 0, 0, 0 },
+    });
+    csa::terminal gate_terminal;
+    gate_terminal.set_acquirer_id(7);
+    gate_terminal.set_operator_id(2024);
+    gate_terminal.set_terminal_id("0A0B0C");
+
+    std::vector<uint8_t> card = create_csa_golden_data(effective_date);
+    const auto quote = [&](const uint16_t route, const uint64_t at) {
+        const csa::fare_quote from_view = fares.evaluate(csa::view(card.data(), card.size(), effective_date), 2024, route, at);
+        csa::container decoded;
+        decoded.set_card_effective_date(effective_date);
+        decoded.parse(card);
+        const csa::fare_quote from_container = fares.evaluate(decoded, 2024, route, at);
+        assert(from_view.status == from_container.status && from_view.fare == from_container.fare &&
+               from_view.transfer == from_container.transfer && from_view.legs_in_window == from_container.legs_in_window);
+        return from_view;
+    };
+    const auto tap = [&](const uint16_t route, const uint64_t at, const uint16_t fare) {
+        const csa::tap_result r = csa::tap_engine(gate_terminal, route).apply(card.data(), card.size(), { effective_date, at, fare, txn_status::ENTRY });
+        assert(r.ok());
+    };
+
+    // The golden card's last validation is unrelated, so the first leg pays the base fare.
+    csa::fare_quote q = quote(42, now);
+    assert(q.ok() && q.fare == 2500 && !q.transfer);
+    tap(42, now, q.fare);
+
+    // A different route of the same group within the window is a transfer; the same route is not.
+    q = quote(43, now + 10 * minute);
+    assert(q.ok() && q.fare == 500 && q.transfer && q.legs_in_window == 1);
+    assert(quote(42, now + 10 * minute).fare == 2500);
+    tap(43, now + 10 * minute, q.fare);
+
+    q = quote(44, now + 20 * minute);
+    assert(q.transfer && q.fare == 700 && q.legs_in_window == 2);
+    tap(44, now + 20 * minute, q.fare);
+
+    // A third leg in the window exceeds max_transfers.
+    q = quote(42, now + 30 * minute);
+    assert(!q.transfer && q.fare == 2500 && q.legs_in_window == 3);
+
+    // Outside the window, or onto a route without transfers, the base fare applies.
+    assert(!quote(43, now + 200 * minute).transfer);
+    assert(quote(99, now + 25 * minute).fare == 4000);
+
+    // 3. Errors are reported as status codes.
+    assert(quote(77, now).status == status_code::no_fare_rule);
+    assert(quote(42, 0).status == status_code::time_before_effective_date);
+    csa::container unset;
+    assert(fares.evaluate(unset, 2024, 42, now).status == status_code::effective_date_not_set);
+}
+
+void test_deny_list_snapshots() {
+    constexpr std::time_t effective_date = 28399680;
+    const std::vector<uint8_t> golden = create_csa_golden_data(effective_date);
+    const csa::view card(golden.data(), golden.size(), effective_date);
+    const csa::terminal last_terminal = card.get_validation_terminal();
+
+    // 1. Every listed token is found; unlisted tokens are never reported (the filter is confirmed exactly).
+    deny::builder nightly;
+    for (uint64_t i = 0; i < 20000; ++i) nightly.add_card(i * 0x9E3779B97F4A7C15ULL);
+    nightly.add_card(7).add_card(7); // Duplicates are harmless.
+    nightly.add_terminal(0x1234, 0xABCDEF).add_operator(4321);
+    const deny::snapshot hot = deny::snapshot::from_bytes(nightly.build(20250908));
+    assert(hot.generation() == 20250908 && hot.card_count() == 20001 && hot.terminal_count() == 1 && hot.operator_count() == 1);
+    for (uint64_t i = 0; i < 20000; ++i) assert(hot.contains_card(i * 0x9E3779B97F4A7C15ULL));
+    for (uint64_t i = 1; i < 20000; ++i) assert(!hot.contains_card(i * 0x9E3779B97F4A7C15ULL + 1));
+    assert(hot.contains_terminal(0x1234, 0xABCDEF) && !hot.contains_terminal(0x1234, 0xABCDEE));
+    assert(hot.check_terminal(4321, 1) == deny::reason::operator_id);
+
+    // 2. Card checks read the terminals straight from the view.
+    assert(hot.check(card, 7) == deny::reason::card_token);
+    assert(hot.check(card, 8) == deny::reason::none);
+    deny::builder terminals;
+    terminals.add_terminal(last_terminal.get_operator_id(), static_cast<uint32_t>(std::stoul(last_terminal.get_terminal_id(), nullptr, 16)));
+    assert(deny::snapshot::from_bytes(terminals.build(1)).check(card, 8) == deny::reason::terminal);
+    deny::builder operators;
+    operators.add_operator(last_terminal.get_operator_id());
+    assert(deny::snapshot::from_bytes(operators.build(1)).check(card, 8) == deny::reason::operator_id);
+
+    osa::container osa_card;
+    osa_card.set_card_effective_date(effective_date);
+    osa_card.get_validation().set_terminal_id("ABCDEF");
+    const std::vector<uint8_t> osa_bytes = osa_card.to_bytes();
+    const osa::view osa_view(osa_bytes.data(), osa_bytes.size(), effective_date);
+    assert(hot.check(osa_view, 0x1234, 8) == deny::reason::terminal);
+    assert(hot.check(osa_view, 0x1235, 8) == deny::reason::none);
+
+    // 3. Deltas build on a published snapshot; readers holding the old one keep using it.
+    deny::list published(std::make_shared<const deny::snapshot>(hot));
+    const std::shared_ptr<const deny::snapshot> before = published.current();
+    deny::builder delta(*before);
+    delta.remove_card(7).add_card(8).remove_terminal(0x1234, 0xABCDEF);
+    published.publish(std::make_shared<const deny::snapshot>(deny::snapshot::from_bytes(delta.build(20250909))));
+    const std::shared_ptr<const deny::snapshot> after = published.current();
+    assert(before->contains_card(7) && !after->contains_card(7) && after->contains_card(8));
+    assert(after->generation() == 20250909 && after->card_count() == 20001 && after->terminal_count() == 0);
+    assert(after->contains_card(0x9E3779B97F4A7C15ULL) && after->contains_operator(4321));
+    assert(deny::list().current()->check(card, 7) == deny::reason::none);
+
+    // Readers racing a publisher always see a complete snapshot, and generations never go backwards.
+    deny::list racing;
+    std::atomic<bool> publishing{ true };
+    std::atomic<bool> monotonic{ true };
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&] {
+            uint64_t last = 0;
+            while (publishing.load()) {
+                const std::shared_ptr<const deny::snapshot> seen = racing.current();
+                if (!seen || seen->generation() < last) monotonic = false;
+                if (seen) last = seen->generation();
+            }
+        });
+    }
+    for (uint64_t generation = 1; generation <= 2000; ++generation)
+        racing.publish(std::make_shared<const deny::snapshot>(deny::snapshot::from_bytes(deny::builder().add_card(generation).build(generation))));
+    publishing = false;
+    for (std::thread& reader : readers) reader.join();
+    assert(monotonic.load() && racing.current()->generation() == 2000 && racing.current()->contains_card(2000));
+
+    // 4. Images round-trip through a mapped file; damaged images are rejected.
+    const std::string path = (std::filesystem::temp_directory_path() / "open_loop_deny_test.bin").string();
+    delta.write(path, 20250909);
+    {
+        const deny::snapshot mapped = deny::snapshot::map(path);
+        assert(mapped.generation() == 20250909 && mapped.contains_card(8) && !mapped.contains_card(7));
+    }
+    std::filesystem::remove(path);
+
+    std::vector<uint8_t> damaged = nightly.build(1);
+    damaged[200] ^= 0x01;
+    bool threw = false;
+    try { (void)deny::snapshot::from_bytes(damaged); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+    threw = false;
+    try { (void)deny::snapshot::from_bytes(std::vector<uint8_t>(10, 0)); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+}
+
+void test_csa_card_cache() {
+    constexpr std::time_t effective_date = 28399680;
+    csa::container source;
+    source.set_card_effective_date(effective_date);
+    source.parse(create_csa_golden_data(effective_date));
+    const csa::compact_card golden = csa::compact_card::from_container(source);
+    const uint16_t golden_sq = csa::card_cache::sequence_of(golden);
+    assert(golden_sq == source.get_history().get_log(0).get_txn_sq_no());
+
+    // Stamps a sequence number into the newest log, and its low byte into the RFU, so torn reads are detectable.
+    const auto with_sequence = [](csa::compact_card card, const uint16_t sq) {
+        card.image[csa::container::HISTORY_OFFSET + csa::view::LOG_SQ_NO_POS] = static_cast<uint8_t>(sq >> 8);
+        card.image[csa::container::HISTORY_OFFSET + csa::view::LOG_SQ_NO_POS + 1] = static_cast<uint8_t>(sq);
+        std::fill(card.image.begin() + csa::container::RFU_OFFSET, card.image.end(), static_cast<uint8_t>(sq));
+        return card;
+    };
+
+    // 1. Single-threaded compare-and-swap semantics.
+    csa::card_cache cache(1000);
+    assert(cache.capacity() >= 1000);
+    csa::compact_card out{};
+    bool found = cache.find(42, out);
+    assert(!found);
+    csa::cache_update u = cache.compare_and_swap(42, 0, golden);
+    assert(u.swapped && !u.found && u.txn_sq_no == golden_sq);
+    found = cache.find(42, out);
+    assert(found && out == golden);
+    u = cache.compare_and_swap(42, static_cast<uint16_t>(golden_sq - 1), with_sequence(golden, 500));
+    assert(!u.swapped && u.found && u.txn_sq_no == golden_sq);
+    u = cache.compare_and_swap(42, golden_sq, with_sequence(golden, static_cast<uint16_t>(golden_sq + 1)));
+    assert(u.swapped && u.txn_sq_no == golden_sq + 1);
+    found = cache.find(42, out);
+    assert(found && csa::card_cache::sequence_of(out) == golden_sq + 1);
+    const bool erased = cache.erase(42);
+    const bool erased_again = cache.erase(42);
+    found = cache.find(42, out);
+    assert(erased && !erased_again && !found);
+
+    // A full bucket evicts its least recently written entry.
+    csa::card_cache tiny(1);
+    assert(tiny.capacity() == csa::card_cache::WAYS);
+    for (uint64_t token = 1; token <= csa::card_cache::WAYS + 1; ++token) (void)tiny.assign(token, golden);
+    const bool found_oldest = tiny.find(1, out);
+    const bool found_second = tiny.find(2, out);
+    const bool found_newest = tiny.find(csa::card_cache::WAYS + 1, out);
+    assert(!found_oldest && found_second && found_newest);
+
+    // 2. Concurrent taps on one card never lose an update, and readers never observe a torn state.
+    constexpr size_t writers = 4;
+    constexpr uint16_t taps_per_writer = 2000;
+    csa::card_cache shared(64);
+    (void)shared.assign(7, with_sequence(golden, 0));
+    std::atomic<bool> done{ false };
+    std::atomic<size_t> torn{ 0 };
+    std::vector<std::thread> threads;
+    for (size_t w = 0; w < writers; ++w)
+        threads.emplace_back([&] {
+            for (uint16_t i = 0; i < taps_per_writer; ++i) {
+                for (;;) {
+                    csa::compact_card state{};
+                    (void)shared.find(7, state);
+                    const uint16_t sq = csa::card_cache::sequence_of(state);
+                    if (shared.compare_and_swap(7, sq, with_sequence(state, static_cast<uint16_t>(sq + 1))).swapped) break;
+                }
+            }
+        });
+    for (size_t r = 0; r < 2; ++r)
+        threads.emplace_back([&] {
+            while (!done.load()) {
+                csa::compact_card state{};
+                if (shared.find(7, state) && state.image[csa::container::RFU_OFFSET] != static_cast<uint8_t>(csa::card_cache::sequence_of(state)))
+                    torn.fetch_add(1);
+            }
+        });
+    for (size_t w = 0; w < writers; ++w) threads[w].join();
+    done.store(true);
+    for (size_t r = writers; r < threads.size(); ++r) threads[r].join();
+    assert(torn.load() == 0);
+    found = shared.find(7, out);
+    assert(found && csa::card_cache::sequence_of(out) == writers * taps_per_writer);
+}
+
+void test_tap_journal() {
+    constexpr std::time_t effective_date = 28399680;
+    const uint64_t now = 1735700000000ULL;
+    const std::string path = (std::filesystem::temp_directory_path() / "open_loop_journal_test.olj").string();
+    std::filesystem::remove(path);
+
+    csa::container csa_card;
+    csa_card.set_card_effective_date(effective_date);
+    csa_card.parse(create_csa_golden_data(effective_date));
+    osa::container osa_card;
+    osa_card.set_card_effective_date(effective_date + 1);
+    osa_card.get_general().set_phone_number("9876543210");
+    csa::terminal gate_terminal;
+    gate_terminal.set_acquirer_id(7);
+    gate_terminal.set_operator_id(2024);
+    gate_terminal.set_terminal_id("0A0B0C");
+
+    // 1. Records are staged in groups and written on the group boundary, then on sync.
+    {
+        journal::writer out(path, 4);
+        for (uint64_t i = 0; i < 9; ++i) out.append(csa_card, now + i, gate_terminal);
+        assert(out.size() == 9 && out.staged() == 1);
+        out.append(osa_card, now + 9, gate_terminal);
+        out.sync();
+        assert(out.staged() == 0);
+    }
+
+    // 2. The reader exposes every record as a zero-copy view.
+    {
+        const journal::reader in(path);
+        assert(in.size() == 10 && in.discarded_bytes() == 0);
+        const std::vector<uint8_t> csa_bytes = csa_card.to_bytes();
+        for (size_t i = 0; i < 9; ++i) {
+            assert(in[i].get_area() == journal::area::csa && in[i].get_index() == i && in[i].get_timestamp() == now + i);
+            assert(std::equal(csa_bytes.begin(), csa_bytes.end(), in[i].image()));
+            assert(in[i].get_csa_view().get_validation_fare_amount() == csa_card.get_validation().get_fare_amount());
+        }
+        assert(in[9].get_area() == journal::area::osa && in[9].get_card_effective_date() == effective_date + 1);
+        assert(in[9].get_osa_view().to_container().get_general().get_phone_number() == "9876543210");
+        assert(in[9].get_terminal() == gate_terminal);
+        bool threw = false;
+        try { (void)in[9].get_csa_view(); } catch (const std::logic_error&) { threw = true; }
+        assert(threw);
+    }
+
+    // 3. A torn tail (half a record) and a damaged record both end the readable journal.
+    {
+        std::ofstream tail(path, std::ios::binary | std::ios::app);
+        const std::vector<uint8_t> partial(70, 0xAB);
+        tail.write(reinterpret_cast<const char*>(partial.data()), static_cast<std::streamsize>(partial.size()));
+    }
+    assert(journal::reader(path).size() == 10 && journal::reader(path).discarded_bytes() == 70);
+    {
+        std::fstream damage(path, std::ios::binary | std::ios::in | std::ios::out);
+        damage.seekp(static_cast<std::streamoff>(journal::format::HEADER_SIZE + 7 * journal::format::RECORD_SIZE + 20));
+        damage.put(0x5A);
+    }
+    assert(journal::reader(path).size() == 7);
+
+    // 4. Reopening truncates the torn tail and continues the numbering.
+    {
+        journal::writer out(path, 1);
+        assert(out.size() == 7);
+        out.append(journal::area::csa, csa_card.to_bytes().data(), effective_date, now + 100, gate_terminal);
+    }
+    {
+        const journal::reader in(path);
+        assert(in.size() == 8 && in.discarded_bytes() == 0 && in[7].get_index() == 7 && in[7].get_timestamp() == now + 100);
+    }
+    std::filesystem::remove(path);
+
+    // 5. Files that are not journals are refused.
+    { std::ofstream junk(path, std::ios::binary); junk << "not a journal at all, just some text that is long enough to trip up the reader"; }
+    bool threw = false;
+    try { const journal::writer out(path); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+    threw = false;
+    try { const journal::reader in(path); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+    std::filesystem::remove(path);
+
+    // 6. A crash before the header was complete leaves a file that is started over, not refused.
+    for (const size_t kept : { size_t{ 5 }, journal::format::HEADER_SIZE - 1 }) {
+        { journal::writer out(path, 1); }
+        std::filesystem::resize_file(path, kept);
+        {
+            journal::writer out(path, 1);
+            assert(out.size() == 0);
+            out.append(csa_card, now, gate_terminal);
+        }
+        const journal::reader in(path);
+        assert(in.size() == 1 && in.discarded_bytes() == 0 && in[0].get_index() == 0);
+    }
+    { std::ofstream zeroed(path, std::ios::binary | std::ios::trunc); zeroed << std::string(journal::format::HEADER_SIZE, '\0'); }
+    {
+        journal::writer out(path, 1);
+        assert(out.size() == 0);
+    }
+    assert(journal::reader(path).size() == 0);
+    std::filesystem::remove(path);
+
+#ifndef _WIN32
+    // 7. A group cut short by a full disk is rolled back and rewritten in place on the next flush.
+    {
+        journal::writer out(path, 4);
+        for (uint64_t i = 0; i < 8; ++i) out.append(csa_card, now + i, gate_terminal);
+        rlimit saved{};
+        getrlimit(RLIMIT_FSIZE, &saved);
+        rlimit limited = saved;
+        limited.rlim_cur = journal::format::HEADER_SIZE + 6 * journal::format::RECORD_SIZE;
+        const auto previous = std::signal(SIGXFSZ, SIG_IGN);
+        setrlimit(RLIMIT_FSIZE, &limited);
+        threw = false;
+        try { out.append(csa_card, now + 8, gate_terminal); } catch (const std::system_error&) { threw = true; }
+        setrlimit(RLIMIT_FSIZE, &saved);
+        std::signal(SIGXFSZ, previous);
+        assert(threw && out.staged() == 4 && out.size() == 8);
+        assert(std::filesystem::file_size(path) == journal::format::HEADER_SIZE + 4 * journal::format::RECORD_SIZE);
+        out.append(csa_card, now + 8, gate_terminal);
+        out.sync();
+    }
+    {
+        const journal::reader in(path);
+        assert(in.size() == 9 && in.discarded_bytes() == 0);
+        for (size_t i = 0; i < 9; ++i) assert(in[i].get_index() == i && in[i].get_timestamp() == now + i);
+    }
+    std::filesystem::remove(path);
+#endif
+}
+
+void test_csa_log_export() {
+    constexpr std::time_t effective_date = 28399680;
+    const uint64_t now = 1735700000000ULL;
+    const std::vector<uint8_t> golden = create_csa_golden_data(effective_date);
+    csa::terminal gate_terminal;
+    gate_terminal.set_acquirer_id(7);
+    gate_terminal.set_operator_id(2024);
+    gate_terminal.set_terminal_id("0A0B0C");
+    const csa::tap_engine engine(gate_terminal, 42);
+
+    // The expected rows of one card, oldest first, read through the container API.
+    const auto rows_of = [&](const uint64_t token, const std::vector<uint8_t>& image, const size_t newest) {
+        csa::container c;
+        c.set_card_effective_date(effective_date);
+        c.parse(image);
+        std::vector<csa::log_row> rows;
+        for (size_t i = newest; i-- > 0;) {
+            const csa::log& l = c.get_history().get_log(i);
+            csa::log_row row;
+            row.card_token = token;
+            row.acquirer_id = l.get_terminal_info().get_acquirer_id();
+            row.operator_id = l.get_terminal_info().get_operator_id();
+            row.terminal_id = static_cast<uint32_t>(std::stoul(l.get_terminal_info().get_terminal_id(), nullptr, 16));
+            row.time_in_milliseconds = l.get_date_and_time();
+            row.txn_amount = l.get_txn_amount();
+            row.card_balance = l.get_card_balance();
+            row.txn_sq_no = l.get_txn_sq_no();
+            row.status = l.get_txn_status();
+            rows.push_back(row);
+        }
+        return rows;
+    };
+
+    // 1. Re-uploads export only the logs after each card's watermark.
+    std::ostringstream out(std::ios::binary);
+    std::vector<csa::log_row> expected;
+    csa::log_exporter exporter(out, 16);
+    const csa::view golden_view(golden.data(), golden.size(), effective_date);
+    const size_t golden_logs = golden_view.get_log_count();
+    size_t n = exporter.add(1, golden_view);
+    assert(n == golden_logs);
+    expected = rows_of(1, golden, golden_logs);
+    n = exporter.add(1, golden_view);
+    assert(n == 0);
+
+    std::vector<uint8_t> card = golden;
+    csa::tap_result r = engine.apply(card.data(), card.size(), { effective_date, now, 1500, txn_status::EXIT });
+    assert(r.ok());
+    r = engine.apply(card.data(), card.size(), { effective_date, now + 60000, 0, txn_status::ENTRY });
+    assert(r.ok());
+    n = exporter.add(1, csa::view(card.data(), card.size(), effective_date));
+    assert(n == 2);
+    const std::vector<csa::log_row> taps = rows_of(1, card, 2);
+    expected.insert(expected.end(), taps.begin(), taps.end());
+    n = exporter.add(1, golden_view);
+    assert(n == 0); // A stale upload does not rewind the watermark.
+
+    exporter.set_watermark(2, golden_view.get_log_txn_sq_no(1));
+    csa::container decoded;
+    decoded.set_card_effective_date(effective_date);
+    decoded.parse(golden);
+    n = exporter.add(2, decoded);
+    assert(n == 1);
+    const std::vector<csa::log_row> seeded = rows_of(2, golden, 1);
+    expected.insert(expected.end(), seeded.begin(), seeded.end());
+
+    // 2. Many cards uploaded repeatedly: the columns round-trip and are far smaller than raw dumps.
+    size_t raw_bytes = 0;
+    for (uint64_t token = 100; token < 300; ++token) {
+        std::vector<uint8_t> image = golden;
+        for (uint64_t upload = 0; upload < 10; ++upload) {
+            raw_bytes += image.size();
+            const size_t before = exporter.rows_exported();
+            const size_t added = exporter.add(token, csa::view(image.data(), image.size(), effective_date));
+            assert(exporter.rows_exported() == before + added);
+            const std::vector<csa::log_row> fresh = rows_of(token, image, added);
+            expected.insert(expected.end(), fresh.begin(), fresh.end());
+            r = engine.apply(image.data(), image.size(), { effective_date, now + upload * 600000 + token * 60000, 10, txn_status::ENTRY });
+            assert(r.ok());
+        }
+    }
+    exporter.finish();
+    const std::string bytes = out.str();
+    assert(exporter.bytes_written() == bytes.size());
+    assert(bytes.size() * 10 < raw_bytes);
+
+    const std::vector<csa::log_row> decoded_rows = csa::log_block_reader::decode(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size());
+    assert(decoded_rows == expected);
+
+    // 3. Damaged streams are rejected.
+    std::string damaged = bytes;
+    damaged[20] = static_cast<char>(damaged[20] ^ 0x40);
+    bool threw = false;
+    try { (void)csa::log_block_reader::decode(reinterpret_cast<const uint8_t*>(damaged.data()), damaged.size()); }
+    catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+    threw = false;
+    try { (void)csa::log_block_reader::decode(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size() - 1); }
+    catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+}
+
+/**
+ * @brief Verifies the allocation-free text and JSON formatters.
+ * @details Checks the cached date formatter against `std::gmtime`/`std::strftime`, the exact output for a
+ *          known card, the `unset`/`null` spelling of times without an effective date, that every JSON
+ *          object is balanced, and that worst-case blocks stay within the advertised size bounds.
+ */
+void test_text_and_json_formatters() {
+    // 1. Dates match strftime, whether or not the cached day is reused.
+    format::date_formatter dates;
+    for (uint64_t seconds = 0; seconds < 253402300800ULL; seconds += 86399ULL * 367 + 1234567) {
+        for (const uint64_t t : { seconds, seconds + 1, seconds + 86399 }) {
+            const std::time_t t_sec = static_cast<std::time_t>(t);
+            char expected[32];
+            const size_t expected_size = std::strftime(expected, sizeof(expected), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&t_sec));
+            assert(expected_size == 20);
+            char actual[format::date_formatter::MAX_SIZE];
+            const char* end = dates.write(actual, t * 1000 + 999);
+            assert(std::string_view(actual, static_cast<size_t>(end - actual)) == expected);
+        }
+    }
+    char far_future[format::date_formatter::MAX_SIZE];
+    const char* far_future_end = dates.write(far_future, UINT64_MAX);
+    assert(static_cast<size_t>(far_future_end - far_future) <= format::date_formatter::MAX_SIZE);
+
+    // 2. The exact output for a known card.
+    constexpr std::time_t effective_date = 28399680;
+    csa::container card;
+    card.set_card_effective_date(effective_date);
+    card.parse(create_csa_golden_data(effective_date));
+    assert(format::to_text(card.get_validation().get_terminal_info()) == "acquirer=10 operator=1000 terminal=ABCDEF");
+    assert(format::to_json(card.get_validation().get_terminal_info()) ==
+           R"({"acquirer_id":10,"operator_id":1000,"terminal_id":"ABCDEF"})");
+    assert(format::to_text(card.get_history().get_log(0)) ==
+           "acquirer=10 operator=1000 terminal=ABCDEF time=2024-12-31T00:00:00Z sq=101 amount=0 balance=20000 status=ENTRY rfu=0");
+    assert(format::to_json(card.get_general()) == R"({"version":"1.2.3","language":"English","language_code":0,"rfu":0})");
+    const std::string text = format::to_text(card).str();
+    assert(text.rfind("general={version=1.2.3 language=English rfu=0} validation={error=0 product=0 acquirer=10", 0) == 0);
+    assert(text.find(" time=2025-01-01T00:00:00Z fare=1500 route=0 service_provider_data=000000 status=ENTRY") != std::string::npos);
+    assert(text.find("history={effective_date=28399680 logs=1 log[0]={acquirer=10") != std::string::npos);
+    const std::string suffix = "rfu=0}} rfu=DEADBEEF010203";
+    assert(text.size() > suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0);
+
+    // 3. Times without an effective date, and call-by-call equivalence with the buffer API.
+    const csa::log loose;
+    assert(format::to_text(loose).view().find("time=unset") != std::string_view::npos);
+    assert(format::to_json(loose).view().find(R"("date_and_time":null)") != std::string_view::npos);
+    char buffer[format::max_json_size<csa::container>];
+    const char* end = format::format_json_to(buffer, card, dates);
+    assert(format::to_json(card) == std::string_view(buffer, static_cast<size_t>(end - buffer)));
+
+    // 4. JSON objects are balanced and never contain characters that would need escaping.
+    const auto well_formed = [](const std::string_view json) {
+        int depth = 0;
+        bool in_string = false;
+        for (const char c : json) {
+            if (c == '\\' || static_cast<unsigned char>(c) < 0x20) return false;
+            if (c == '"') in_string = !in_string;
+            else if (!in_string && (c == '{' || c == '[')) ++depth;
+            else if (!in_string && (c == '}' || c == ']') && --depth < 0) return false;
+        }
+        return depth == 0 && !in_string && json.find(",}") == std::string_view::npos && json.find(",]") == std::string_view::npos;
+    };
+    assert(well_formed(format::to_json(card)));
+
+    // 5. Worst-case blocks (every bit set, the latest representable times) stay within the bounds.
+    const std::vector<uint8_t> all_ones(96, 0xFF);
+    csa::container worst_csa;
+    worst_csa.set_card_effective_date(static_cast<std::time_t>(UINT64_MAX / 60000 - 0xFFFFFF));
+    worst_csa.parse(all_ones);
+    assert(worst_csa.get_history().get_valid_log_count() == csa::history::LOG_COUNT);
+    osa::container worst_osa;
+    worst_osa.set_card_effective_date(static_cast<std::time_t>(UINT64_MAX / 60000 - 0xFFFFFF));
+    worst_osa.parse(all_ones);
+    const auto within_bounds = [&](const auto& block) {
+        using block_type = std::decay_t<decltype(block)>;
+        char out[format::max_text_size<block_type> + format::max_json_size<block_type>];
+        const size_t text_size = static_cast<size_t>(format::format_to(out, block) - out);
+        const size_t json_size = static_cast<size_t>(format::format_json_to(out, block) - out);
+        return text_size <= format::max_text_size<block_type> && json_size <= format::max_json_size<block_type> &&
+               well_formed(std::string_view(out, json_size));
+    };
+    assert(within_bounds(worst_csa));
+    assert(within_bounds(worst_csa.get_general()));
+    assert(within_bounds(worst_csa.get_validation()));
+    assert(within_bounds(worst_csa.get_history()));
+    assert(within_bounds(worst_osa));
+    assert(within_bounds(worst_osa.get_general()));
+    assert(within_bounds(worst_osa.get_validation()));
+    assert(within_bounds(worst_osa.get_history()));
+    assert(within_bounds(worst_osa.get_trip_pass(0)));
+    assert(format::to_text(worst_csa.get_history().get_log(0)).view().find("status=UNKNOWN") != std::string_view::npos);
+}
+
+/**
+ * @brief Verifies the opt-in instrumentation counters.
+ * @details With `OPEN_LOOP_METRICS`, every instrumented call, thrown exception and rejected parse must
+ *          show up exactly once in the next snapshot, including calls made on a thread that has exited.
+ *          Without it, the snapshot must stay all zero.
+ */
+void test_metrics_instrumentation() {
+    constexpr std::time_t effective_date = 28399680;
+    const std::vector<uint8_t> golden = create_csa_golden_data(effective_date);
+    csa::container card;
+    card.set_card_effective_date(effective_date);
+    osa::container osa_card;
+    osa_card.set_card_effective_date(effective_date);
+    osa::transaction_record record;
+    record.set_card_effective_date(effective_date);
+    const std::vector<uint8_t> osa_bytes = osa_card.to_bytes();
+
+    const metrics::snapshot before = metrics::collect();
+    card.parse(golden);
+    (void)card.to_bytes();
+    (void)card.to_array();
+    card.get_history().add_log(card.get_history().get_log(0));
+    const status_code short_parse = card.try_parse(golden.data(), 95);
+    assert(short_parse == status_code::invalid_size);
+    bool threw = false;
+    try { card.get_general().set_version(8, 0, 0); } catch (const std::out_of_range&) { threw = true; }
+    assert(threw);
+    threw = false;
+    try { csa::container unset; unset.parse(golden); } catch (const std::logic_error&) { threw = true; }
+    assert(threw);
+    std::thread worker([&] {
+        osa::container local;
+        local.set_card_effective_date(effective_date);
+        for (int i = 0; i < 100; ++i) local.parse(osa_bytes);
+        local.get_history().add_record(record);
+    });
+    worker.join();
+    (void)osa_card.to_array();
+    const metrics::snapshot after = metrics::collect();
+
+    const auto calls = [&](const metrics::operation op) { return after[op].calls - before[op].calls; };
+    const auto exceptions = [&](const metrics::exception_kind kind) { return after.exception_count(kind) - before.exception_count(kind); };
+    const auto statuses = [&](const status_code code) {
+        return after.statuses[static_cast<size_t>(code)] - before.statuses[static_cast<size_t>(code)];
+    };
+    if constexpr (metrics::ENABLED) {
+        assert(calls(metrics::operation::csa_parse) == 3);
+        assert(calls(metrics::operation::csa_serialize) == 2);
+        assert(calls(metrics::operation::csa_add_log) == 1);
+        assert(calls(metrics::operation::osa_parse) == 100);
+        assert(calls(metrics::operation::osa_serialize) == 1);
+        assert(calls(metrics::operation::osa_add_record) == 1);
+        assert(exceptions(metrics::exception_kind::out_of_range) == 1);
+        assert(exceptions(metrics::exception_kind::logic_error) == 1);
+        assert(exceptions(metrics::exception_kind::invalid_argument) == 0);
+        assert(statuses(status_code::invalid_size) == 1);
+        assert(statuses(status_code::effective_date_not_set) == 1);
+        // Every call lands in exactly one histogram bucket.
+        for (size_t op = 0; op < metrics::OPERATION_COUNT; ++op) {
+            uint64_t bucketed = 0;
+            for (size_t b = 0; b < metrics::HISTOGRAM_BUCKETS; ++b) bucketed += after.operations[op].histogram[b] - before.operations[op].histogram[b];
+            assert(bucketed == after.operations[op].calls - before.operations[op].calls);
+        }
+    } else {
+        for (size_t op = 0; op < metrics::OPERATION_COUNT; ++op) assert(after.operations[op].calls == 0 && after.operations[op].ticks == 0);
+        for (const uint64_t count : after.exceptions) assert(count == 0);
+        for (const uint64_t count : after.statuses) assert(count == 0);
+    }
+    assert(std::string(metrics::to_string(metrics::operation::osa_add_record)) == "osa_add_record");
+
+#ifdef OPEN_LOOP_METRICS
+    // The shared fallback slot ends the registry list and must stay claimed when a lease on it ends.
+    detail::metrics_registry& registry = detail::metrics_registry::instance();
+    detail::metrics_slot* shared = registry.head();
+    while (shared->next != nullptr) shared = shared->next;
+    registry.release(shared);
+    assert(shared->in_use.load());
+#endif
+}
+
+/**
+ * @brief Verifies the pipelined reader loop against an in-memory transport.
+ * @details Taps must reach the handler and the card in the order they were read, the handler must run off the
+ *          I/O thread, only changed ranges of accepted cards may be written, and a handler exception must stop
+ *          the loop after the taps it already finished have been written.
+ */
+void test_station_loop() {
+    constexpr std::time_t effective_date = 28399680;
+    const std::vector<uint8_t> golden = create_csa_golden_data(effective_date);
+    csa::container expected;
+    expected.set_card_effective_date(effective_date);
+    expected.parse(golden);
+    expected.get_history().add_log(expected.get_history().get_log(0));
+    const std::array<uint8_t, csa::container::TOTAL_SIZE> debited = expected.to_array();
+
+    struct memory_transport final : reader::transport<csa::container> {
+        std::vector<std::array<uint8_t, csa::container::TOTAL_SIZE>> cards;
+        std::vector<uint64_t> written;
+        size_t next = 0;
+        std::thread::id io_thread;
+        std::atomic<bool>* keep_running = nullptr;
+        std::time_t effective_date = 0;
+
+        bool read(reader::tap_slot<csa::container>& slot) override {
+            assert(std::this_thread::get_id() == io_thread);
+            if (next == cards.size()) {
+                keep_running->store(false);
+                return false;
+            }
+            slot.image = cards[next];
+            slot.card_token = next;
+            slot.card_effective_date = effective_date;
+            // Every tenth card leaves the field mid-read and must fail to decode.
+            if (next % 10 == 9) slot.image_length = 40;
+            slot.time_in_milliseconds = 1000 * next;
+            ++next;
+            return true;
+        }
+        void write(const reader::tap_slot<csa::container>& slot) override {
+            assert(std::this_thread::get_id() == io_thread);
+            assert(written.empty() || written.back() < slot.card_token);
+            for (const byte_range& range : slot.dirty) {
+                std::copy_n(slot.image.begin() + range.offset, range.length, cards[slot.card_token].begin() + range.offset);
+            }
+            written.push_back(slot.card_token);
+        }
+    };
+
+    for (const size_t depth : { size_t{ 1 }, size_t{ 4 } }) {
+        std::atomic<bool> keep_running{ true };
+        memory_transport driver;
+        driver.cards.assign(64, {});
+        for (auto& card : driver.cards) std::copy(golden.begin(), golden.end(), card.begin());
+        driver.io_thread = std::this_thread::get_id();
+        driver.keep_running = &keep_running;
+        driver.effective_date = effective_date;
+
+        reader::csa_station_loop loop(depth);
+        assert(loop.depth() == depth);
+        uint64_t handled = 0;
+        const uint64_t taps = loop.run(driver, [&](reader::tap_slot<csa::container>& tap) {
+            assert(std::this_thread::get_id() != driver.io_thread);
+            assert(tap.sequence == handled && tap.card_token == handled);
+            ++handled;
+            assert(tap.write_back == (tap.status == status_code::ok));
+            if (tap.card_token % 10 == 9) assert(tap.status == status_code::invalid_size);
+            if (!tap.write_back) return;
+            if (tap.card_token % 3 == 0) {
+                tap.write_back = false;
+                return;
+            }
+            tap.card.get_history().add_log(tap.card.get_history().get_log(0));
+        }, keep_running);
+
+        assert(taps == 64 && handled == 64);
+        for (uint64_t token = 0; token < 64; ++token) {
+            const bool accepted = token % 10 != 9 && token % 3 != 0;
+            assert(std::count(driver.written.begin(), driver.written.end(), token) == (accepted ? 1 : 0));
+            assert(accepted ? driver.cards[token] == debited : std::equal(golden.begin(), golden.end(), driver.cards[token].begin()));
+        }
+    }
+
+    // A failing handler stops the loop; the taps before it are still written.
+    std::atomic<bool> keep_running{ true };
+    memory_transport driver;
+    driver.cards.assign(64, {});
+    for (auto& card : driver.cards) std::copy(golden.begin(), golden.end(), card.begin());
+    driver.io_thread = std::this_thread::get_id();
+    driver.keep_running = &keep_running;
+    driver.effective_date = effective_date;
+    reader::csa_station_loop loop(4);
+    bool threw = false;
+    try {
+        loop.run(driver, [](reader::tap_slot<csa::container>& tap) {
+            if (tap.card_token == 20) throw std::runtime_error("fare table unavailable");
+            if (tap.write_back) tap.card.get_history().add_log(tap.card.get_history().get_log(0));
+        }, keep_running);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    assert(driver.next <= 20 + loop.depth());
+    assert(driver.written.size() == 18 && driver.written.back() == 18);
+
+    // The decode stage may finish taps and fail between the I/O stage's last write-back and its check
+    // for failure; those taps were approved and must still be written. Repeat to exercise the window.
+    for (int run = 0; run < 500; ++run) {
+        memory_transport racing;
+        racing.cards.assign(8, {});
+        for (auto& card : racing.cards) std::copy(golden.begin(), golden.end(), card.begin());
+        racing.io_thread = std::this_thread::get_id();
+        keep_running = true;
+        racing.keep_running = &keep_running;
+        racing.effective_date = effective_date;
+        reader::csa_station_loop fast(1 + (run % 4));
+        threw = false;
+        try {
+            fast.run(racing, [&](reader::tap_slot<csa::container>& tap) {
+                if (tap.card_token == 3) throw std::runtime_error("deny list unavailable");
+                tap.card.get_history().add_log(tap.card.get_history().get_log(0));
+            }, keep_running);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert(threw && racing.written == std::vector<uint64_t>({ 0, 1, 2 }));
+    }
+
+    threw = false;
+    try { reader::csa_station_loop empty(0); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+}
+
+/**
+ * @brief Verifies that container images can live entirely in a caller-supplied arena.
+ * @details The arena's upstream is `null_memory_resource()`, so any fallback to the global heap would throw.
+ */
+void test_pmr_container_images() {
+    constexpr std::time_t effective_date = 28399680;
+    const std::vector<uint8_t> golden = create_csa_golden_data(effective_date);
+    csa::container card;
+    card.set_card_effective_date(effective_date);
+    card.parse(golden);
+    osa::container osa_card;
+    osa_card.set_card_effective_date(effective_date);
+
+    alignas(std::max_align_t) static uint8_t storage[64 * 1024];
+    std::pmr::monotonic_buffer_resource arena(storage, sizeof(storage), std::pmr::null_memory_resource());
+    for (int round = 0; round < 3; ++round) {
+        std::pmr::vector<std::pmr::vector<uint8_t>> images(&arena);
+        images.reserve(200);
+        for (int i = 0; i < 100; ++i) {
+            images.push_back(card.to_bytes(&arena));
+            images.push_back(osa_card.to_bytes(&arena));
+        }
+        for (size_t i = 0; i < images.size(); i += 2) {
+            assert(images[i].get_allocator().resource() == &arena);
+            assert(std::equal(images[i].begin(), images[i].end(), golden.begin(), golden.end()));
+            csa::container parsed;
+            parsed.set_card_effective_date(effective_date);
+            parsed.parse(images[i]);
+            assert(parsed == card);
+            osa::container parsed_osa;
+            parsed_osa.set_card_effective_date(effective_date);
+            parsed_osa.parse(images[i + 1]);
+            assert(parsed_osa == osa_card);
+        }
+
+        std::pmr::vector<uint8_t> concatenated(&arena);
+        for (size_t i = 0; i < images.size(); i += 2) concatenated.insert(concatenated.end(), images[i].begin(), images[i].end());
+        csa::batch cards;
+        cards.decode(concatenated);
+        assert(cards.size() == 100);
+        assert(cards.get_validation_fare_amount()[99] == card.get_validation().get_fare_amount());
+
+        // One release returns the whole batch's scratch; the next round reuses the same storage.
+        images = std::pmr::vector<std::pmr::vector<uint8_t>>(&arena);
+        concatenated = std::pmr::vector<uint8_t>(&arena);
+        arena.release();
+    }
+
+    bool threw = false;
+    std::pmr::monotonic_buffer_resource empty(std::pmr::null_memory_resource());
+    try { (void)card.to_bytes(&empty); } catch (const std::bad_alloc&) { threw = true; }
+    assert(threw);
+}
+
+/**
+ * @brief Verifies the raw-image diff: region bits, history advances, rollbacks and rewrites.
+ */
+void test_card_image_diff() {
+    constexpr std::time_t effective_date = 28399680;
+    const std::vector<uint8_t> golden = create_csa_golden_data(effective_date);
+    csa::container server;
+    server.set_card_effective_date(effective_date);
+    server.parse(golden);
+
+    const auto tap = [&](csa::container card, const uint16_t sq_no, const int count) {
+        for (int i = 0; i < count; ++i) {
+            csa::log entry = card.get_history().get_log(0);
+            entry.set_txn_sq_no(static_cast<uint16_t>(sq_no + i));
+            card.get_history().add_log(entry);
+        }
+        card.get_validation().set_fare_amount(static_cast<uint16_t>(1000 + sq_no));
+        return card;
+    };
+
+    card_diff d = csa::diff(server, server);
+    assert(d.identical() && d.history == history_change::unchanged && d.shift == 0);
+
+    const csa::container one_tap = tap(server, 200, 1);
+    const csa::container three_taps = tap(server, 200, 3);
+    d = csa::diff(server, one_tap);
+    assert(d.history == history_change::advanced && d.shift == 1);
+    assert(d.differs(csa::diff_mask::VALIDATION) && !d.differs(csa::diff_mask::GENERAL | csa::diff_mask::RFU));
+    assert(d.differs(csa::diff_mask::log(0)) && d.differs(csa::diff_mask::log(1)) && !d.differs(csa::diff_mask::log(3)));
+    d = csa::diff(server, three_taps);
+    assert(d.history == history_change::advanced && d.shift == 3);
+    d = csa::diff(one_tap, three_taps);
+    assert(d.history == history_change::advanced && d.shift == 2);
+
+    // Restoring an older image is a rollback by the number of taps undone.
+    d = csa::diff(three_taps, one_tap);
+    assert(d.history == history_change::rolled_back && d.shift == 2);
+    d = csa::diff(three_taps.to_array().data(), golden.data());
+    assert(d.history == history_change::rolled_back && d.shift == 3);
+
+    // Editing a log in place is not explained by any sequence of taps.
+    csa::container forged = three_taps;
+    csa::log edited = forged.get_history().get_log(2);
+    edited.set_card_balance(99999);
+    csa::history rebuilt;
+    rebuilt.set_card_effective_date(effective_date);
+    for (size_t i = forged.get_history().get_valid_log_count(); i-- > 0;) rebuilt.add_log(i == 2 ? edited : forged.get_history().get_log(i));
+    forged.set_history(rebuilt);
+    d = csa::diff(three_taps, forged);
+    assert(d.fields == csa::diff_mask::log(2) && d.history == history_change::rewritten && d.shift == 0);
+
+    std::array<uint8_t, csa::container::TOTAL_SIZE> tampered = server.to_array();
+    tampered[csa::container::TOTAL_SIZE - 1] ^= 0x01;
+    d = csa::diff(golden.data(), tampered.data());
+    assert(d.fields == csa::diff_mask::RFU && d.history == history_change::unchanged);
+    tampered = server.to_array();
+    tampered[0] ^= 0x80;
+    assert(csa::diff(golden.data(), tampered.data()).fields == csa::diff_mask::GENERAL);
+
+    // OSA: history records and trip passes get their own bits.
+    osa::container osa_server;
+    osa_server.set_card_effective_date(effective_date);
+    osa::transaction_record record;
+    record.set_card_effective_date(effective_date);
+    record.set_station_id(12);
+    osa_server.get_history().add_record(record);
+    osa::container osa_upload = osa_server;
+    record.set_station_id(13);
+    osa_upload.get_history().add_record(record);
+    osa_upload.get_trip_pass(1).set_trips_allotted(10);
+    osa_upload.get_trip_pass(1).set_remaining_trips(7);
+    d = osa::diff(osa_server, osa_upload);
+    assert(d.history == history_change::advanced && d.shift == 1);
+    assert(d.differs(osa::diff_mask::trip_pass(1)) && !d.differs(osa::diff_mask::trip_pass(0)));
+    assert(!d.differs(osa::diff_mask::GENERAL | osa::diff_mask::VALIDATION | osa::diff_mask::PADDING));
+    assert((d.fields & ~(osa::diff_mask::HISTORY | osa::diff_mask::TRIP_PASSES)) == 0);
+    d = osa::diff(osa_upload, osa_server);
+    assert(d.history == history_change::rolled_back && d.shift == 1);
+    assert(std::string(to_string(history_change::rolled_back)) == "rolled_back");
+}
+
+void test_gate_session() {
+    constexpr std::time_t effective_date = 28399680;
+    const std::vector<uint8_t> golden = create_csa_golden_data(effective_date);
+    const uint64_t now = 1735700000000ULL;
+
+    csa::terminal gate_terminal;
+    gate_terminal.set_acquirer_id(7);
+    gate_terminal.set_operator_id(2024);
+    gate_terminal.set_terminal_id("0A0B0C");
+    const csa::fare_table fares({ { 2024, 42, 2500, 500, 90, 2, 1 } });
+    const csa::gate_context gate(gate_terminal, 42, &fares);
+    assert(gate.get_operator_id() == 2024 && gate.get_route_number() == 42 && gate.get_fare_table() == &fares);
+
+    // 1. Recording on a container matches the raw engine byte for byte.
+    const csa::card_session session = gate.open(effective_date);
+    csa::container card;
+    status_code sc = session.parse(card, golden.data(), golden.size());
+    assert(sc == status_code::ok);
+    assert(card.get_card_epoch() == session.get_card_epoch());
+    const csa::tap_result r = session.record_tap(card, now, 1500, txn_status::EXIT);
+    assert(r.ok() && r.card_balance == 18500 && r.txn_sq_no == 102 && r.dirty.empty());
+    std::vector<uint8_t> patched = golden;
+    const dirty_ranges dirty = card.patch_into(patched.data());
+    std::vector<uint8_t> raw = golden;
+    const csa::tap_result engine = session.apply(raw.data(), raw.size(), now, 1500, txn_status::EXIT);
+    assert(engine.ok() && raw == patched);
+    assert(engine.dirty.total_bytes() == dirty.total_bytes());
+
+    // 2. Failed taps leave the container untouched.
+    const std::array<uint8_t, csa::container::TOTAL_SIZE> before = card.to_array();
+    sc = session.record_tap(card, now, 60000, txn_status::EXIT).status;
+    assert(sc == status_code::insufficient_balance);
+    sc = session.record_tap(card, 0, 0, txn_status::ENTRY).status;
+    assert(sc == status_code::time_before_effective_date);
+    csa::container other;
+    other.set_card_effective_date(effective_date + 1);
+    other.parse(golden);
+    sc = session.record_tap(other, now, 0, txn_status::ENTRY).status;
+    assert(sc == status_code::effective_date_not_set);
+    assert(card.to_array() == before);
+
+    // 3. tap() prices with the gate's fare table; a gate without one reports no_fare_rule.
+    csa::container priced;
+    sc = session.parse(priced, golden.data(), golden.size());
+    assert(sc == status_code::ok);
+    const csa::fare_quote q = session.quote(priced, now);
+    assert(q.ok() && q.fare == fares.evaluate(priced, 2024, 42, now).fare);
+    const csa::tap_result t = session.tap(priced, now, txn_status::ENTRY);
+    assert(t.ok() && t.card_balance == 20000u - q.fare && priced.get_validation().get_fare_amount() == q.fare);
+    const csa::gate_context unpriced(gate_terminal, 42);
+    sc = unpriced.open(effective_date).tap(priced, now, txn_status::ENTRY).status;
+    assert(sc == status_code::no_fare_rule);
+
+    // 4. Sessions of different cards share the gate but keep their own effective date.
+    const csa::card_session later = gate.open(effective_date + 1440);
+    assert(&later.get_gate() == &session.get_gate() && *later.get_card_epoch() == effective_date + 1440);
+    sc = later.record_tap(card, now, 0, txn_status::ENTRY).status;
+    assert(sc == status_code::effective_date_not_set);
+}
+
 // --- Main Test Runner ---
 int main() {
     // Enable color support on Windows
@@ -291,6 +2024,35 @@ int main() {
     run_test("8. Full serialization/deserialization round-trip", osa_test_serialization_round_trip);
     run_test("9. BCD phone number and absolute time format integrity", osa_test_bcd_and_time_formats);
 
+    std::cout << "\n----- FAST PATHS -----" << std::endl;
+    run_test("10. Raw buffer parse matches vector parse", test_raw_buffer_parse);
+    run_test("11. serialize_into/to_array match to_bytes", test_serialize_into_buffer);
+    run_test("12. Lazy CSA/OSA views decode fields on access", test_lazy_card_views);
+    run_test("13. In-place patch writes only dirty byte ranges", test_patch_dirty_ranges);
+    run_test("14. Non-throwing try_parse/try_set API", test_try_api_status_codes);
+    run_test("15. Batch SoA decoder matches per-card views", test_batch_soa_decoder);
+    run_test("16. Multi-threaded pipeline over a mapped image file", test_pipeline_over_mapped_file);
+    run_test("17. Layout descriptors generate exact codecs", test_layout_descriptors);
+    run_test("18. Templated OSA layouts dispatched by version", test_templated_osa_layouts);
+    run_test("19. Table-driven hex and BCD codecs", test_hex_and_bcd_codecs);
+    run_test("20. Precomputed effective epoch and bulk timestamps", test_effective_epoch_and_bulk_timestamps);
+    run_test("21. Ring-buffer histories and raw log rotation", test_history_ring_buffer);
+    run_test("22. Compact trivially copyable card snapshots", test_compact_card_representation);
+    run_test("23. Canonical byte equality and 64-bit card hashing", test_canonical_equality_and_hashing);
+    run_test("24. Single-call CSA tap engine", test_csa_tap_engine);
+    run_test("25. Raw-buffer OSA trip pass selection", test_osa_pass_selector);
+    run_test("26. Perfect-hash fare table and transfer windows", test_csa_fare_table);
+    run_test("27. Memory-mappable deny-list snapshots", test_deny_list_snapshots);
+    run_test("28. Concurrent compare-and-swap card cache", test_csa_card_cache);
+    run_test("29. Crash-safe tap journal with mapped replay", test_tap_journal);
+    run_test("30. De-duplicating columnar log export", test_csa_log_export);
+    run_test("31. Allocation-free text and JSON formatters", test_text_and_json_formatters);
+    run_test("32. Opt-in parse/serialize/failure instrumentation", test_metrics_instrumentation);
+    run_test("33. Pipelined station loop", test_station_loop);
+    run_test("34. Arena-backed container images", test_pmr_container_images);
+    run_test("35. Raw card image diff", test_card_image_diff);
+    run_test("36. Gate and card session contexts", test_gate_session);
+
     std::cout << "\n" << console_color::BOLD << "========================================================================" << std::endl;
     std::cout << "                           TEST REPORT" << std::endl;
     std::cout << "========================================================================" << std::endl;